@@ -52,6 +52,28 @@ struct IndexSt {
     std::vector<ColInfo> keys;  ///< first keys set
 };
 
+/// Statistics of an index, used by the planner to estimate the rows
+/// scanned by a lookup on the index
+struct IndexStatistics {
+    uint64_t key_cnt = 0;  ///< number of distinct keys
+    uint64_t row_cnt = 0;  ///< number of rows in the index
+
+    /// Return the average rows under one key, rounded up
+    uint64_t RowsPerKey() const {
+        return key_cnt == 0 ? 0 : (row_cnt + key_cnt - 1) / key_cnt;
+    }
+};
+
+/// A comparison between a column and a literal, which the storage can
+/// evaluate to skip the rows before they are read
+struct ColumnFilter {
+    enum CompareOp { kCmpEq, kCmpNe, kCmpLt, kCmpLe, kCmpGt, kCmpGe };
+
+    uint32_t col_idx = 0;    ///< position of the column in the table schema
+    CompareOp op = kCmpEq;   ///< the column is the left operand
+    std::string value;       ///< the literal in string format, e.g. "10", "1.5", "true"
+};
+
 /// \typedef IndexList repeated fields of IndexDef
 typedef ::google::protobuf::RepeatedPtrField<::hybridse::type::IndexDef>
     IndexList;
@@ -258,6 +280,18 @@ class TableHandler : public DataHandler {
         return std::shared_ptr<Tablet>();
     }
 
+    /// Return the statistics of the given index.
+    /// Return false if they are unknown, which is the default.
+    virtual bool GetIndexStatistics(const std::string& index_name, IndexStatistics* stat) { return false; }
+
+    /// Return a handler of the same dataset which may skip the rows not
+    /// matching all the filters before they are read, so the rows still
+    /// need to be filtered by the caller.
+    /// Return `null` if the filters can't be pushed down, which is the default.
+    virtual std::shared_ptr<TableHandler> PushDownFilter(const std::vector<ColumnFilter>& filters) {
+        return std::shared_ptr<TableHandler>();
+    }
+
     static std::shared_ptr<TableHandler> Cast(std::shared_ptr<DataHandler> in);
 };
 
@@ -28,6 +28,7 @@
 #include "vm/catalog.h"
 #include "vm/engine_context.h"
 #include "vm/router.h"
+#include "vm/runner_profile.h"
 
 namespace hybridse {
 namespace vm {
@@ -163,6 +164,18 @@ class RunSession {
     /// Return if this run session support printing debug information.
     bool IsDebug() { return is_debug_; }
 
+    /// Enable recording the time and output of every runner while running a query.
+    /// The statistics of all runs of this session are accumulated into one profile.
+    void EnableProfile() {
+        if (!profile_) {
+            profile_ = std::make_shared<RunnerProfile>();
+        }
+    }
+    /// Return the recorded statistics, or null if profiling is not enabled.
+    const std::shared_ptr<RunnerProfile>& GetProfile() const { return profile_; }
+    /// Return the runner tree of the compiled query annotated with the recorded statistics.
+    std::string GetProfileString() const;
+
     /// Bind this run session with specific procedure
     void SetSpName(const std::string& sp_name) { sp_name_ = sp_name; }
     /// Return the engine mode of this run session
@@ -182,6 +195,7 @@ class RunSession {
     std::shared_ptr<hybridse::vm::CompileInfo> compile_info_;
     hybridse::vm::EngineMode engine_mode_;
     bool is_debug_;
+    std::shared_ptr<RunnerProfile> profile_;
     std::string sp_name_;
     std::shared_ptr<const std::unordered_map<std::string, std::string>> options_ = nullptr;
 
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2023 OpenMLDB authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYBRIDSE_INCLUDE_VM_RUNNER_PROFILE_H_
+#define HYBRIDSE_INCLUDE_VM_RUNNER_PROFILE_H_
+
+#include <map>
+#include <string>
+
+namespace hybridse {
+namespace vm {
+
+/// \brief Execution statistics of one runner
+struct RunnerStatistics {
+    std::string runner_type;    ///< name of the runner type
+    uint64_t run_cnt = 0;       ///< times the runner is run, cache hits are not counted
+    uint64_t time_us = 0;       ///< time spent in the runner itself, the producers are not included
+    uint64_t lazy_cnt = 0;      ///< times the output is lazy, its rows are produced by the consumers
+    uint64_t output_rows = 0;   ///< rows of the outputs which are not lazy
+    uint64_t output_bytes = 0;  ///< bytes of the outputs which are not lazy
+};
+
+/// \brief Execution statistics of the runners in one run of a query, keyed by runner id.
+///
+/// Not thread safe, a profile is filled by one run at a time.
+class RunnerProfile {
+ public:
+    /// Return the statistics of the runner, create it if not exist
+    RunnerStatistics& Get(int32_t runner_id) { return stats_[runner_id]; }
+
+    /// Return the statistics of the runner, or null if it has not been run
+    const RunnerStatistics* Find(int32_t runner_id) const {
+        auto it = stats_.find(runner_id);
+        return it == stats_.end() ? nullptr : &it->second;
+    }
+
+    const std::map<int32_t, RunnerStatistics>& GetAll() const { return stats_; }
+
+    void Clear() { stats_.clear(); }
+
+ private:
+    std::map<int32_t, RunnerStatistics> stats_;
+};
+
+}  // namespace vm
+}  // namespace hybridse
+#endif  // HYBRIDSE_INCLUDE_VM_RUNNER_PROFILE_H_
@@ -58,6 +58,10 @@ class SimpleCatalogTableHandler : public TableHandler {
 
     RowIterator *GetRawIterator() override;
 
+    bool GetIndexStatistics(const std::string &index_name, IndexStatistics *stat) override;
+    // set the statistics returned by `GetIndexStatistics`, there is none by default
+    void SetIndexStatistics(const std::string &index_name, const IndexStatistics &stat);
+
     bool AddRow(const Row row);
     bool DecodeKeysAndTs(const IndexSt &index, const int8_t *buf, uint32_t size,
                          std::string &key, int64_t *time_ptr);  // NOLINT
@@ -74,6 +78,7 @@ class SimpleCatalogTableHandler : public TableHandler {
     hybridse::type::TableDef table_def_;
     Types types_dict_;
     IndexHint index_hint_;
+    std::map<std::string, IndexStatistics> index_stats_;
     codec::RowView row_view_;
     std::map<std::string, std::shared_ptr<MemPartitionHandler>> table_storage;
     std::shared_ptr<MemTableHandler> full_table_storage_;
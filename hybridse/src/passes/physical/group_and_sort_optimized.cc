@@ -982,7 +982,7 @@ bool GroupAndSortOptimized::MatchBestIndex(const std::vector<std::string>& colum
                 } else {
                     auto org_index = index_hint.at(best_index_name);
                     auto new_index = index_hint.at(name);
-                    if (org_index.keys.size() < new_index.keys.size()) {
+                    if (IsBetterIndex(table_handler.get(), org_index, new_index)) {
                         // override with better index
                         best_index_name = name;
                         best_index_bitmap = sub_best_bitmap;
@@ -997,6 +997,19 @@ bool GroupAndSortOptimized::MatchBestIndex(const std::vector<std::string>& colum
     return succ;
 }
 
+bool GroupAndSortOptimized::IsBetterIndex(TableHandler* table_handler, const IndexSt& org_index,
+                                          const IndexSt& new_index) {
+    vm::IndexStatistics org_stat;
+    vm::IndexStatistics new_stat;
+    if (table_handler->GetIndexStatistics(org_index.name, &org_stat) &&
+        table_handler->GetIndexStatistics(new_index.name, &new_stat) && org_stat.key_cnt > 0 &&
+        new_stat.key_cnt > 0 && org_stat.RowsPerKey() != new_stat.RowsPerKey()) {
+        // a lookup scans all rows under the key, the rest key columns are filtered after
+        return new_stat.RowsPerKey() < org_stat.RowsPerKey();
+    }
+    return org_index.keys.size() < new_index.keys.size();
+}
+
 std::vector<std::optional<std::string>> GroupAndSortOptimized::ResolveExprToSrcColumnName(
     const node::ExprListNode* exprs, vm::PhysicalDataProviderNode* data_node) {
     std::vector<std::optional<std::string>> columns;
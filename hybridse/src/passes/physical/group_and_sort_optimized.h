@@ -149,6 +149,9 @@ class GroupAndSortOptimized : public TransformUpPysicalPass {
                         IndexBitMap* bitmap,
                         std::string* index_name,
                         IndexBitMap* best_bitmap);
+    // whether `new_index` is expected to scan less rows than `org_index`. Decided by the rows under a key if the
+    // statistics of both are known, otherwise the index with more key columns is better
+    static bool IsBetterIndex(TableHandler* table_handler, const IndexSt& org_index, const IndexSt& new_index);
 
     std::vector<std::optional<std::string>> ResolveExprToSrcColumnName(const node::ExprListNode*,
                                                                        vm::PhysicalDataProviderNode*);
@@ -17,6 +17,7 @@
 #include "passes/physical/group_and_sort_optimized.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -110,6 +111,87 @@ TEST_P(GroupAndSortOptOnCombinedIndexTest, OptimizeOutOfOrderFilter) {
     EXPECT_EQ(cs.physical_tree_str, physical_plan->GetTreeString());
 }
 
+class GroupAndSortOptWithStatisticsTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        hybridse::type::Database db;
+        db.set_name("db");
+
+        hybridse::type::TableDef table_def;
+        table_def.set_name("t2");
+        table_def.set_catalog("db");
+        {
+            auto* c1 = table_def.add_columns();
+            c1->set_type(::hybridse::type::kVarchar);
+            c1->set_name("a");
+
+            auto* c2 = table_def.add_columns();
+            c2->set_type(::hybridse::type::kInt32);
+            c2->set_name("b");
+
+            auto* index = table_def.add_indexes();
+            index->set_name("idx_a");
+            index->add_first_keys("a");
+
+            index = table_def.add_indexes();
+            index->set_name("idx_b");
+            index->add_first_keys("b");
+        }
+        vm::AddTable(db, table_def);
+
+        catalog_ = vm::BuildSimpleCatalog(db);
+    }
+
+    std::string GetPlan(const std::string& sql) {
+        ::hybridse::node::PlanNodeList plan_trees;
+        ::hybridse::base::Status base_status;
+        EXPECT_TRUE(plan::PlanAPI::CreatePlanTreeFromScript(sql, plan_trees, &manager_, base_status)) << base_status;
+
+        auto ctx = llvm::make_unique<llvm::LLVMContext>();
+        auto m = llvm::make_unique<llvm::Module>("test_op_generator", *ctx);
+        auto lib = ::hybridse::udf::DefaultUdfLibrary::get();
+        const codec::Schema empty_schema;
+
+        vm::BatchModeTransformer tf(&manager_, "db", catalog_, &empty_schema, m.get(), lib);
+        tf.AddDefaultPasses();
+
+        PhysicalOpNode* physical_plan = nullptr;
+        base::Status status = tf.TransformPhysicalPlan(plan_trees, &physical_plan);
+        EXPECT_TRUE(status.isOK()) << status;
+        return physical_plan == nullptr ? "" : physical_plan->GetTreeString();
+    }
+
+ protected:
+    node::NodeManager manager_;
+    std::shared_ptr<vm::SimpleCatalog> catalog_;
+};
+
+TEST_F(GroupAndSortOptWithStatisticsTest, ChooseIndexWithLessRowsPerKey) {
+    auto table = std::dynamic_pointer_cast<vm::SimpleCatalogTableHandler>(catalog_->GetTable("db", "t2"));
+    ASSERT_TRUE(table != nullptr);
+    const std::string sql = "select * from t2 where a = 'aaa' and b = 12;";
+
+    // no statistics, the first matched one of the indexes with the same key count is used
+    std::string plan = GetPlan(sql);
+    EXPECT_NE(std::string::npos, plan.find("index=idx_b)")) << plan;
+
+    vm::IndexStatistics stat_a;
+    stat_a.key_cnt = 50000;
+    stat_a.row_cnt = 100000;
+    table->SetIndexStatistics("idx_a", stat_a);
+    vm::IndexStatistics stat_b;
+    stat_b.key_cnt = 10;
+    stat_b.row_cnt = 100000;
+    table->SetIndexStatistics("idx_b", stat_b);
+    plan = GetPlan(sql);
+    EXPECT_NE(std::string::npos, plan.find("index=idx_a, est_rows=2)")) << plan;
+
+    stat_a.key_cnt = 1;
+    table->SetIndexStatistics("idx_a", stat_a);
+    plan = GetPlan(sql);
+    EXPECT_NE(std::string::npos, plan.find("index=idx_b, est_rows=10000)")) << plan;
+}
+
 }  // namespace passes
 }  // namespace hybridse
 
@@ -19,10 +19,17 @@
 #include <stdint.h>
 #include <time.h>
 
+#include <algorithm>
 #include <ctime>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "absl/time/civil_time.h"
 #include "absl/time/time.h"
@@ -495,6 +502,56 @@ bool like_internal(std::string_view name, std::string_view pattern, const char *
     return name_it == name_end;
 }
 
+struct CharEqual {
+    bool operator()(char lhs, char rhs) const { return lhs == rhs; }
+};
+
+/*
+* match the patterns which are a literal with (%) at the start or the end only, without (_) or escape: exact, prefix,
+* suffix and contains. They are the most used ones, and are matched by comparing or searching the literal instead of
+* backtracking. The case sensitive search is done by `std::string_view::find`, which is backed by the vectorized
+* memchr and memcmp.
+*
+* return false if the pattern is not simple, `out` is not set then
+*/
+template <typename EQUAL>
+bool like_simple(std::string_view name, std::string_view pattern, const char *escape, const EQUAL &equal, bool *out) {
+    size_t start = pattern.find_first_not_of('%');
+    if (start == std::string_view::npos) {
+        // empty or only (%)s
+        *out = pattern.empty() ? name.empty() : true;
+        return true;
+    }
+    size_t end = pattern.find_last_not_of('%') + 1;
+    std::string_view literal = pattern.substr(start, end - start);
+    if (literal.find_first_of("%_") != std::string_view::npos ||
+        (escape != nullptr && pattern.find(*escape) != std::string_view::npos)) {
+        return false;
+    }
+    bool any_prefix = start > 0;
+    bool any_suffix = end < pattern.size();
+    if (name.size() < literal.size()) {
+        *out = false;
+        return true;
+    }
+    auto equal_at = [&](size_t pos) {
+        return std::equal(literal.begin(), literal.end(), name.begin() + pos, equal);
+    };
+    if (!any_prefix && !any_suffix) {
+        *out = name.size() == literal.size() && equal_at(0);
+    } else if (!any_prefix) {
+        *out = equal_at(0);
+    } else if (!any_suffix) {
+        *out = equal_at(name.size() - literal.size());
+    } else if constexpr (std::is_same_v<EQUAL, CharEqual>) {
+        *out = name.find(literal) != std::string_view::npos;
+    } else {
+        *out = std::search(name.begin(), name.end(), literal.begin(), literal.end(), equal) !=
+               name.end();
+    }
+    return true;
+}
+
 /*
 * if escape is null or ref to empty string, disable escape feature
 *
@@ -522,13 +579,15 @@ void like_internal(StringRef *name, StringRef *pattern, StringRef *escape, EQUAL
         }
         esc = escape->data_;
     }
+    if (like_simple(name_view, pattern_view, esc, equal, out)) {
+        return;
+    }
     *out = like_internal(name_view, pattern_view, esc, std::forward<EQUAL>(equal));
 }
 
 void like(StringRef *name, StringRef *pattern, StringRef *escape, bool *out,
           bool *is_null) {
-    like_internal(
-        name, pattern, escape, [](char lhs, char rhs) { return lhs == rhs; }, out, is_null);
+    like_internal(name, pattern, escape, CharEqual(), out, is_null);
 }
 
 void like(StringRef* name, StringRef* pattern, bool* out, bool* is_null) {
@@ -551,6 +610,53 @@ void ilike(StringRef* name, StringRef* pattern, bool* out, bool* is_null) {
 }
 
 
+// compiled regexes recently used by the thread, the pattern is mostly a constant of the sql, it's compiled once then
+constexpr size_t kRegexCacheSize = 64;
+
+// the least recently used regex is dropped when the cache is full
+
+class RegexCache {
+ public:
+    std::shared_ptr<RE2> Get(const std::string& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        // move to the front as the most recently used
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void Put(const std::string& key, std::shared_ptr<RE2> re) {
+        if (entries_.size() >= kRegexCacheSize) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, std::move(re));
+        index_[key] = entries_.begin();
+    }
+
+ private:
+    std::list<std::pair<std::string, std::shared_ptr<RE2>>> entries_;
+    std::unordered_map<std::string, std::list<std::pair<std::string, std::shared_ptr<RE2>>>::iterator> index_;
+};
+
+static std::shared_ptr<RE2> GetRegex(std::string_view pattern, const RE2::Options &opts) {
+    thread_local RegexCache cache;
+    // the options which can be set by the flags
+    std::string key = absl::StrCat(opts.case_sensitive(), opts.one_line(), opts.dot_nl(), pattern);
+    if (auto cached = cache.Get(key)) {
+        return cached;
+    }
+    auto re = std::make_shared<RE2>(pattern, opts);
+    if (re->error_code() != 0) {
+        LOG(ERROR) << "Error parsing '" << pattern << "': " << re->error();
+    }
+    // the invalid one is cached too, so it's not parsed again
+    cache.Put(key, re);
+    return re;
+}
+
 // The options are (defaults in parentheses):
 //
 //   utf8             (true)  text and pattern are UTF-8; otherwise Latin-1
@@ -608,15 +714,14 @@ void regexp_like(StringRef *name, StringRef *pattern, StringRef *flags, bool *ou
         }
     }
 
-    RE2 re(pattern_view, opts);
-    if (re.error_code() != 0) {
-        LOG(ERROR) << "Error parsing '" << pattern_view << "': " << re.error();
+    auto re = GetRegex(pattern_view, opts);
+    if (re->error_code() != 0) {
         out = nullptr;
         *is_null = true;
         return;
     }
     *is_null = false;
-    *out = RE2::FullMatch(name_view, re);
+    *out = RE2::FullMatch(name_view, *re);
 }
 
 void regexp_like(StringRef *name, StringRef *pattern, bool *out, bool *is_null) {
@@ -739,6 +739,47 @@ TEST_F(ExternUdfTest, LikeMatchTest) {
     check_like(false, false, R"r(Evan_w\)r", R"r(Evan_w\)r", "\\");
 }
 
+TEST_F(ExternUdfTest, LikeSimplePatternTest) {
+    auto check = [](bool match, const std::string_view name, const std::string_view pattern, bool ignore_case) {
+        codec::StringRef name_ref(name.size(), name.data());
+        codec::StringRef pattern_ref(pattern.size(), pattern.data());
+        bool ret = false;
+        bool ret_null = true;
+        if (ignore_case) {
+            v1::ilike(&name_ref, &pattern_ref, &ret, &ret_null);
+        } else {
+            v1::like(&name_ref, &pattern_ref, &ret, &ret_null);
+        }
+        EXPECT_FALSE(ret_null);
+        EXPECT_EQ(match, ret) << (ignore_case ? "ilike(" : "like(") << name << ", " << pattern << ")";
+    };
+    // only (%)
+    check(true, "", "%", false);
+    check(true, "abc", "%%", false);
+    // exact
+    check(true, "abc", "abc", false);
+    check(false, "abcd", "abc", false);
+    check(true, "ABC", "abc", true);
+    // prefix
+    check(true, "abcd", "abc%", false);
+    check(true, "abc", "abc%%", false);
+    check(false, "ab", "abc%", false);
+    check(false, "xabc", "abc%", false);
+    check(true, "ABCD", "abc%", true);
+    // suffix
+    check(true, "xabc", "%abc", false);
+    check(true, "abc", "%abc", false);
+    check(false, "abcx", "%abc", false);
+    check(true, "XABC", "%abc", true);
+    // contains
+    check(true, "xxabcxx", "%abc%", false);
+    check(true, "abc", "%%abc%", false);
+    check(false, "xxabxcx", "%abc%", false);
+    check(false, "xxABCxx", "%abc%", false);
+    check(true, "xxABCxx", "%abc%", true);
+    check(false, "ab", "%abc%", true);
+}
+
 TEST_F(ExternUdfTest, LikeMatchNullable) {
     auto check_null = [](bool expect, bool is_null, codec::StringRef* name_ref, codec::StringRef* pattern_ref,
                          codec::StringRef* escape) -> void {
@@ -930,6 +971,12 @@ TEST_F(ExternUdfTest, RLikeMatchTest) {
     // multiple flags
     check_rlike(true, false, "The Lord of the Rings\nJ. R. R. Tolkien",
                 "^the Lord of the Rings$.J\\. R\\. R\\. Tolkien", "mis");
+
+    // the same pattern with other flags is not taken from the cached one
+    for (int i = 0; i < 3; i++) {
+        check_rlike(true, false, "The Lord of the Rings", "the L.rd .f the Rings", "i");
+        check_rlike(false, false, "The Lord of the Rings", "the L.rd .f the Rings", "c");
+    }
 }
 
 TEST_F(ExternUdfTest, RLikeMatchNullable) {
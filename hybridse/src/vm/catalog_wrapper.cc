@@ -28,6 +28,15 @@ std::shared_ptr<TableHandler> PartitionProjectWrapper::GetSegment(
             new TableProjectWrapper(segment, parameter_, fun_));
     }
 }
+std::vector<std::shared_ptr<TableHandler>> PartitionProjectWrapper::GetSegments(const std::vector<std::string>& keys) {
+    auto segments = partition_handler_->GetSegments(keys);
+    for (auto& segment : segments) {
+        if (segment) {
+            segment = std::make_shared<TableProjectWrapper>(segment, parameter_, fun_);
+        }
+    }
+    return segments;
+}
 codec::RowIterator* PartitionProjectWrapper::GetRawIterator() {
     auto iter = partition_handler_->GetIterator();
     if (!iter) {
@@ -47,6 +56,15 @@ std::shared_ptr<TableHandler> PartitionFilterWrapper::GetSegment(
             new TableFilterWrapper(segment, parameter_, fun_));
     }
 }
+std::vector<std::shared_ptr<TableHandler>> PartitionFilterWrapper::GetSegments(const std::vector<std::string>& keys) {
+    auto segments = partition_handler_->GetSegments(keys);
+    for (auto& segment : segments) {
+        if (segment) {
+            segment = std::make_shared<TableFilterWrapper>(segment, parameter_, fun_);
+        }
+    }
+    return segments;
+}
 codec::RowIterator* PartitionFilterWrapper::GetRawIterator() {
     auto iter = partition_handler_->GetIterator();
     if (!iter) {
@@ -242,6 +242,8 @@ class PartitionProjectWrapper : public PartitionHandler {
 
     std::shared_ptr<TableHandler> GetSegment(const std::string& key) override;
 
+    std::vector<std::shared_ptr<TableHandler>> GetSegments(const std::vector<std::string>& keys) override;
+
     const OrderType GetOrderType() const override { return partition_handler_->GetOrderType(); }
 
     const std::string GetHandlerTypeName() override {
@@ -290,6 +292,8 @@ class PartitionFilterWrapper : public PartitionHandler {
 
     std::shared_ptr<TableHandler> GetSegment(const std::string& key) override;
 
+    std::vector<std::shared_ptr<TableHandler>> GetSegments(const std::vector<std::string>& keys) override;
+
     const OrderType GetOrderType() const override { return partition_handler_->GetOrderType(); }
 
     const std::string GetHandlerTypeName() override {
@@ -37,13 +37,13 @@ const std::string RouteInfo::ToString() const {
     }
 }
 const bool RouteInfo::IsCluster() const { return table_handler_ && !index_.empty(); }
-void ClusterTask::Print(std::ostream& output, const std::string& tab) const {
+void ClusterTask::Print(std::ostream& output, const std::string& tab, const RunnerProfile* profile) const {
     output << route_info_.ToString() << "\n";
     if (nullptr == root_) {
         output << tab << "NULL RUNNER\n";
     } else {
         std::set<int32_t> visited_ids;
-        root_->Print(output, tab, &visited_ids);
+        root_->Print(output, tab, &visited_ids, profile);
     }
 }
 void ClusterTask::ResetInputs(std::shared_ptr<ClusterTask> input) {
@@ -116,7 +116,7 @@ bool ClusterJob::AddRunnerToTask(Runner* runner, const int32_t id) {
     tasks_[id].SetRoot(runner);
     return true;
 }
-void ClusterJob::Print(std::ostream& output, const std::string& tab) const {
+void ClusterJob::Print(std::ostream& output, const std::string& tab, const RunnerProfile* profile) const {
     if (tasks_.empty()) {
         output << "EMPTY CLUSTER JOB\n";
         return;
@@ -127,7 +127,7 @@ void ClusterJob::Print(std::ostream& output, const std::string& tab) const {
         } else {
             output << "TASK ID " << i;
         }
-        tasks_[i].Print(output, tab);
+        tasks_[i].Print(output, tab, profile);
         output << "\n";
     }
 }
@@ -90,7 +90,7 @@ class ClusterTask {
         : root_(root), input_runners_(input_runners), route_info_(route_info) {}
     ~ClusterTask() {}
 
-    void Print(std::ostream& output, const std::string& tab) const;
+    void Print(std::ostream& output, const std::string& tab, const RunnerProfile* profile = nullptr) const;
 
     friend std::ostream& operator<<(std::ostream& os, const ClusterTask& output) {
         output.Print(os, "");
@@ -165,7 +165,8 @@ class ClusterJob {
     const std::string& sql() const { return sql_; }
     const std::string& db() const { return db_; }
     const std::set<size_t>& common_column_indices() const { return common_column_indices_; }
-    void Print(std::ostream& output, const std::string& tab) const;
+    // the runners are annotated with the statistics in `profile` if it's not null
+    void Print(std::ostream& output, const std::string& tab, const RunnerProfile* profile = nullptr) const;
     void Print() const;
 
  private:
@@ -15,6 +15,7 @@
  */
 
 #include "vm/engine.h"
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -375,6 +376,16 @@ bool RunSession::SetCompileInfo(const std::shared_ptr<CompileInfo>& compile_info
     return true;
 }
 
+std::string RunSession::GetProfileString() const {
+    auto sql_compile_info = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_);
+    if (!sql_compile_info || !sql_compile_info->get_sql_context().cluster_job) {
+        return "";
+    }
+    std::ostringstream oss;
+    sql_compile_info->get_sql_context().cluster_job->Print(oss, "", profile_.get());
+    return oss.str();
+}
+
 int32_t RequestRunSession::Run(const Row& in_row, Row* out_row) {
     DLOG(INFO) << "Request Row Run with main task";
     return Run(std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job->main_task_id(),
@@ -392,6 +403,7 @@ int32_t RequestRunSession::Run(const uint32_t task_id, const Row& in_row, Row* o
     DLOG(INFO) << "Request Row Run with task_id " << task_id;
     RunnerContext ctx(std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job, in_row,
                       sp_name_, is_debug_);
+    ctx.SetProfile(profile_.get());
     auto output = task->RunWithCache(ctx);
     if (!output) {
         LOG(WARNING) << "Run request plan output is null";
@@ -412,6 +424,7 @@ int32_t BatchRequestRunSession::Run(const uint32_t id, const std::vector<Row>& r
                                     std::vector<Row>& output) {
     RunnerContext ctx(std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job,
                       request_batch, sp_name_, is_debug_);
+    ctx.SetProfile(profile_.get());
     auto task =
         std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job->GetTask(id).GetRoot();
     if (nullptr == task) {
@@ -436,6 +449,7 @@ int32_t BatchRunSession::Run(std::vector<Row>& rows, uint64_t limit) {
 int32_t BatchRunSession::Run(const Row& parameter_row, std::vector<Row>& rows, uint64_t limit) {
     auto& sql_ctx = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context();
     RunnerContext ctx(sql_ctx.cluster_job, parameter_row, is_debug_);
+    ctx.SetProfile(profile_.get());
     auto output = sql_ctx.cluster_job->GetTask(0).GetRoot()->RunWithCache(ctx);
     if (!output) {
         DLOG(INFO) << "Run batch plan output is empty";
@@ -16,6 +16,8 @@
 
 #include "vm/generator.h"
 
+#include <iomanip>
+#include <sstream>
 #include <utility>
 
 #include "node/sql_node.h"
@@ -239,6 +241,12 @@ Row JoinGenerator::RowLastJoinDropLeftSlices(
 
 std::shared_ptr<TableHandler> JoinGenerator::LazyJoin(std::shared_ptr<DataHandler> left,
                                                       std::shared_ptr<DataHandler> right, const Row& parameter) {
+    if (join_type_ == node::kJoinTypeLeft && CanHashJoin(right)) {
+        right = BuildHashTable(std::dynamic_pointer_cast<TableHandler>(right), parameter);
+        if (!right) {
+            return {};
+        }
+    }
     if (left->GetHandlerType() == kPartitionHandler) {
         return std::make_shared<LazyJoinPartitionHandler>(std::dynamic_pointer_cast<PartitionHandler>(left), right,
                                                           parameter, shared_from_this());
@@ -261,7 +269,8 @@ std::shared_ptr<PartitionHandler> JoinGenerator::LazyJoinOptimized(std::shared_p
 
 std::unique_ptr<RowIterator> JoinGenerator::InitRight(const Row& left_row, std::shared_ptr<PartitionHandler> right,
                                                       const Row& param) {
-    auto partition_key = index_key_gen_.Gen(left_row, param);
+    auto partition_key =
+        index_key_gen_.Valid() ? index_key_gen_.Gen(left_row, param) : left_key_gen_.Gen(left_row, param);
     auto right_seg = right->GetSegment(partition_key);
     if (!right_seg) {
         return {};
@@ -452,6 +461,89 @@ bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
     return true;
 }
 
+bool JoinGenerator::CanHashJoin(const std::shared_ptr<DataHandler>& right) const {
+    return right && right->GetHandlerType() == kTableHandler && !index_key_gen_.Valid() && left_key_gen_.Valid() &&
+           right_group_gen_.Valid();
+}
+
+std::shared_ptr<PartitionHandler> JoinGenerator::BuildHashTable(std::shared_ptr<TableHandler> right,
+                                                                const Row& parameter) {
+    if (!right) {
+        return {};
+    }
+    auto iter = right->GetIterator();
+    if (!iter) {
+        LOG(WARNING) << "fail to build join hash table: right table is empty";
+        return {};
+    }
+    // last join takes the first matched row in the reverse order of the right sort
+    bool sort = join_type_ == node::kJoinTypeLast && right_sort_gen_.Valid();
+    bool sort_by_order_key = sort && right_sort_gen_.order_gen().Valid();
+    auto output = std::make_shared<MemPartitionHandler>(right->GetSchema());
+    output->SetOrderType(right->GetOrderType());
+    iter->SeekToFirst();
+    while (iter->Valid()) {
+        const Row& row = iter->GetValue();
+        uint64_t ts = sort_by_order_key ? static_cast<uint64_t>(right_sort_gen_.order_gen().Gen(row)) : iter->GetKey();
+        output->AddRow(right_group_gen_.GetKey(row, parameter), ts, row);
+        iter->Next();
+    }
+    if (sort) {
+        bool is_asc = !right_sort_gen_.is_asc();
+        if (sort_by_order_key) {
+            output->Sort(is_asc);
+        } else if (is_asc != (right->GetOrderType() == kAscOrder)) {
+            output->Reverse();
+        }
+        output->SetOrderType(is_asc ? kAscOrder : kDescOrder);
+    }
+    return output;
+}
+
+bool JoinGenerator::TableHashJoin(std::shared_ptr<TableHandler> left, std::shared_ptr<PartitionHandler> right,
+                                  const Row& parameter, std::shared_ptr<MemTimeTableHandler> output) {
+    auto left_iter = left->GetIterator();
+    if (!left_iter) {
+        LOG(WARNING) << "fail to run last join: left input empty";
+        return false;
+    }
+    left_iter->SeekToFirst();
+    while (left_iter->Valid()) {
+        const Row& left_row = left_iter->GetValue();
+        auto right_iter = InitRight(left_row, right, parameter);
+        output->AddRow(left_iter->GetKey(), RowJoinIterator(left_row, right_iter, parameter).first);
+        left_iter->Next();
+    }
+    return true;
+}
+
+bool JoinGenerator::PartitionHashJoin(std::shared_ptr<PartitionHandler> left, std::shared_ptr<PartitionHandler> right,
+                                      const Row& parameter, std::shared_ptr<MemPartitionHandler> output) {
+    auto left_window_iter = left->GetWindowIterator();
+    if (!left_window_iter) {
+        LOG(WARNING) << "fail to run last join: left iter empty";
+        return false;
+    }
+    left_window_iter->SeekToFirst();
+    while (left_window_iter->Valid()) {
+        auto left_iter = left_window_iter->GetValue();
+        if (!left_iter) {
+            left_window_iter->Next();
+            continue;
+        }
+        auto key_str = left_window_iter->GetKey().ToString();
+        left_iter->SeekToFirst();
+        while (left_iter->Valid()) {
+            const Row& left_row = left_iter->GetValue();
+            auto right_iter = InitRight(left_row, right, parameter);
+            output->AddRow(key_str, left_iter->GetKey(), RowJoinIterator(left_row, right_iter, parameter).first);
+            left_iter->Next();
+        }
+        left_window_iter->Next();
+    }
+    return true;
+}
+
 bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
                                   std::shared_ptr<TableHandler> right,
                                   const Row& parameter,
@@ -717,6 +809,39 @@ std::shared_ptr<TableHandler> IndexSeekGenerator::SegmnetOfConstKey(
         }
     }
 }
+std::vector<std::shared_ptr<TableHandler>> IndexSeekGenerator::SegmentsOfKeys(
+    const std::vector<Row>& rows, const Row& parameter, std::shared_ptr<DataHandler> input) {
+    if (!input || !index_key_gen_.Valid() || input->GetHandlerType() != kPartitionHandler) {
+        std::vector<std::shared_ptr<TableHandler>> segments;
+        segments.reserve(rows.size());
+        for (const auto& row : rows) {
+            segments.push_back(SegmentOfKey(row, parameter, input));
+        }
+        return segments;
+    }
+    // an empty key row gets a null segment, the same as SegmentOfKey
+    std::vector<std::shared_ptr<TableHandler>> segments(rows.size());
+    std::vector<std::string> keys;
+    std::vector<size_t> positions;
+    keys.reserve(rows.size());
+    positions.reserve(rows.size());
+    for (size_t idx = 0; idx < rows.size(); idx++) {
+        if (rows[idx].empty()) {
+            LOG(WARNING) << "fail to seek segment: key row is empty";
+            continue;
+        }
+        keys.push_back(index_key_gen_.Gen(rows[idx], parameter));
+        positions.push_back(idx);
+    }
+    if (keys.empty()) {
+        return segments;
+    }
+    auto key_segments = std::dynamic_pointer_cast<PartitionHandler>(input)->GetSegments(keys);
+    for (size_t idx = 0; idx < positions.size() && idx < key_segments.size(); idx++) {
+        segments[positions[idx]] = key_segments[idx];
+    }
+    return segments;
+}
 std::shared_ptr<TableHandler> IndexSeekGenerator::SegmentOfKey(
     const Row& row, const Row& parameter, std::shared_ptr<DataHandler> input) {
     auto fail_ptr = std::shared_ptr<TableHandler>();
@@ -758,6 +883,138 @@ std::shared_ptr<TableHandler> IndexSeekGenerator::SegmentOfKey(
     }
 }
 
+static bool ToColumnFilterOp(node::FnOperator op, bool reverse, ColumnFilter::CompareOp* out) {
+    switch (op) {
+        case node::kFnOpEq:
+            *out = ColumnFilter::kCmpEq;
+            return true;
+        case node::kFnOpNeq:
+            *out = ColumnFilter::kCmpNe;
+            return true;
+        case node::kFnOpLt:
+            *out = reverse ? ColumnFilter::kCmpGt : ColumnFilter::kCmpLt;
+            return true;
+        case node::kFnOpLe:
+            *out = reverse ? ColumnFilter::kCmpGe : ColumnFilter::kCmpLe;
+            return true;
+        case node::kFnOpGt:
+            *out = reverse ? ColumnFilter::kCmpLt : ColumnFilter::kCmpGt;
+            return true;
+        case node::kFnOpGe:
+            *out = reverse ? ColumnFilter::kCmpLe : ColumnFilter::kCmpGe;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// format the literal for a column of type `type`, only if the storage compares them exactly as the condition does
+static bool FormatColumnLiteral(type::Type type, const node::ConstNode* literal, std::string* out) {
+    auto literal_type = literal->GetDataType();
+    bool is_int = literal_type == node::kInt16 || literal_type == node::kInt32 || literal_type == node::kInt64;
+    switch (type) {
+        case type::kInt16:
+        case type::kInt32:
+        case type::kInt64:
+            if (!is_int) {
+                return false;
+            }
+            *out = std::to_string(literal->GetAsInt64());
+            return true;
+        case type::kDouble: {
+            // the integers up to int32 are exact in double
+            std::ostringstream oss;
+            if (literal_type == node::kDouble) {
+                oss << std::setprecision(17) << literal->GetDouble();
+            } else if (literal_type == node::kInt16 || literal_type == node::kInt32) {
+                oss << literal->GetAsInt64();
+            } else {
+                return false;
+            }
+            *out = oss.str();
+            return true;
+        }
+        case type::kVarchar:
+            if (literal_type != node::kVarchar) {
+                return false;
+            }
+            *out = literal->GetStr();
+            return true;
+        case type::kBool:
+            if (literal_type != node::kBool) {
+                return false;
+            }
+            *out = literal->GetBool() ? "true" : "false";
+            return true;
+        default:
+            // the float, date and timestamp columns are compared after a cast in the condition
+            return false;
+    }
+}
+
+static bool ResolveColumn(const node::ExprNode* expr, const SchemasContext* schemas_ctx, size_t* col_idx) {
+    size_t schema_idx = 0;
+    base::Status status;
+    if (expr->GetExprType() == node::kExprColumnRef) {
+        status = schemas_ctx->ResolveColumnRefIndex(dynamic_cast<const node::ColumnRefNode*>(expr), &schema_idx,
+                                                    col_idx);
+    } else if (expr->GetExprType() == node::kExprColumnId) {
+        status = schemas_ctx->ResolveColumnIndexByID(dynamic_cast<const node::ColumnIdNode*>(expr)->GetColumnID(),
+                                                     &schema_idx, col_idx);
+    } else {
+        return false;
+    }
+    return status.isOK() && schema_idx == 0;
+}
+
+static void CollectColumnFilters(const node::ExprNode* expr, const SchemasContext* schemas_ctx,
+                                 std::vector<ColumnFilter>* filters) {
+    if (expr == nullptr || expr->GetExprType() != node::kExprBinary) {
+        return;
+    }
+    auto op = dynamic_cast<const node::BinaryExpr*>(expr)->GetOp();
+    if (op == node::kFnOpAnd) {
+        CollectColumnFilters(expr->GetChild(0), schemas_ctx, filters);
+        CollectColumnFilters(expr->GetChild(1), schemas_ctx, filters);
+        return;
+    }
+    const node::ExprNode* column = expr->GetChild(0);
+    const node::ExprNode* literal = expr->GetChild(1);
+    bool reverse = false;
+    if (column->GetExprType() == node::kExprPrimary) {
+        std::swap(column, literal);
+        reverse = true;
+    }
+    ColumnFilter filter;
+    size_t col_idx = 0;
+    if (literal->GetExprType() != node::kExprPrimary || !ToColumnFilterOp(op, reverse, &filter.op) ||
+        !ResolveColumn(column, schemas_ctx, &col_idx)) {
+        return;
+    }
+    auto schema = schemas_ctx->GetSchema(0);
+    if (schema == nullptr || col_idx >= static_cast<size_t>(schema->size())) {
+        return;
+    }
+    auto type = schema->Get(col_idx).type();
+    // only the equality of strings, the order may depend on the collation
+    if (type == type::kVarchar && filter.op != ColumnFilter::kCmpEq && filter.op != ColumnFilter::kCmpNe) {
+        return;
+    }
+    if (!FormatColumnLiteral(type, dynamic_cast<const node::ConstNode*>(literal), &filter.value)) {
+        return;
+    }
+    filter.col_idx = col_idx;
+    filters->push_back(filter);
+}
+
+void FilterGenerator::InitPushDownFilters(const SchemasContext* schemas_ctx) {
+    push_down_filters_.clear();
+    if (schemas_ctx == nullptr || schemas_ctx->GetSchemaSourceSize() != 1) {
+        return;
+    }
+    CollectColumnFilters(condition_, schemas_ctx, &push_down_filters_);
+}
+
 std::shared_ptr<DataHandler> FilterGenerator::Filter(std::shared_ptr<PartitionHandler> partition, const Row& parameter,
                                                      std::optional<int32_t> limit) {
     if (!partition) {
@@ -767,6 +1024,13 @@ std::shared_ptr<DataHandler> FilterGenerator::Filter(std::shared_ptr<PartitionHa
     if (index_seek_gen_.Valid()) {
         return Filter(index_seek_gen_.SegmnetOfConstKey(parameter, partition), parameter, limit);
     } else {
+        if (!push_down_filters_.empty()) {
+            // the pushed down conditions only reduce the rows read, the whole condition is still applied below
+            auto pushed = std::dynamic_pointer_cast<PartitionHandler>(partition->PushDownFilter(push_down_filters_));
+            if (pushed) {
+                partition = pushed;
+            }
+        }
         if (condition_gen_.Valid()) {
             partition = std::make_shared<PartitionFilterWrapper>(partition, parameter, this);
         }
@@ -787,6 +1051,12 @@ std::shared_ptr<DataHandler> FilterGenerator::Filter(std::shared_ptr<TableHandle
         return fail_ptr;
     }
 
+    if (!push_down_filters_.empty()) {
+        auto pushed = table->PushDownFilter(push_down_filters_);
+        if (pushed) {
+            table = pushed;
+        }
+    }
     if (condition_gen_.Valid()) {
         table = std::make_shared<TableFilterWrapper>(table, parameter, this);
     }
@@ -858,6 +1128,29 @@ std::vector<std::shared_ptr<TableHandler>> RequestWindowUnionGenerator::GetReque
     }
     return union_segments;
 }
+std::vector<std::vector<std::shared_ptr<TableHandler>>> RequestWindowUnionGenerator::GetRequestWindows(
+    const std::vector<Row>& rows, const Row& parameter, std::vector<std::shared_ptr<DataHandler>> union_inputs) {
+    std::vector<std::vector<std::shared_ptr<TableHandler>>> union_segments(
+        rows.size(), std::vector<std::shared_ptr<TableHandler>>(union_inputs.size()));
+    for (size_t i = 0; i < union_inputs.size(); i++) {
+        auto segments = windows_gen_[i].GetRequestWindows(rows, parameter, union_inputs[i]);
+        for (size_t idx = 0; idx < rows.size() && idx < segments.size(); idx++) {
+            union_segments[idx][i] = segments[idx];
+        }
+    }
+    return union_segments;
+}
+std::string RequestWindowUnionGenerator::GetWindowKeys(const Row& row, const Row& parameter) {
+    std::string keys;
+    for (auto& window_gen : windows_gen_) {
+        // keys are length prefixed, so different key lists never have the same encoding
+        auto key = window_gen.GetWindowKey(row, parameter);
+        uint32_t size = key.size();
+        keys.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        keys.append(key);
+    }
+    return keys;
+}
 void RequestWindowUnionGenerator::AddWindowUnion(const RequestWindowOp& window_op, Runner* runner) {
     windows_gen_.emplace_back(window_op);
     AddInput(runner);
@@ -879,6 +1172,29 @@ std::shared_ptr<TableHandler> RequestWindowGenertor::GetRequestWindow(const Row&
     }
     return segment;
 }
+std::vector<std::shared_ptr<TableHandler>> RequestWindowGenertor::GetRequestWindows(
+    const std::vector<Row>& rows, const Row& parameter, std::shared_ptr<DataHandler> input) {
+    auto segments = index_seek_gen_.SegmentsOfKeys(rows, parameter, input);
+    for (size_t idx = 0; idx < rows.size() && idx < segments.size(); idx++) {
+        if (filter_gen_.Valid()) {
+            auto filter_key = filter_gen_.GetKey(rows[idx], parameter);
+            segments[idx] = filter_gen_.Filter(parameter, segments[idx], filter_key);
+        }
+        if (sort_gen_.Valid()) {
+            segments[idx] = sort_gen_.Sort(segments[idx], true);
+        }
+    }
+    return segments;
+}
+std::string RequestWindowGenertor::GetWindowKey(const Row& row, const Row& parameter) {
+    std::string index_key = index_seek_gen_.Valid() ? index_seek_gen_.index_key_gen_.Gen(row, parameter) : "";
+    std::string filter_key = filter_gen_.GetKey(row, parameter);
+    uint32_t size = index_key.size();
+    std::string key(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(index_key);
+    key.append(filter_key);
+    return key;
+}
 std::shared_ptr<TableHandler> FilterKeyGenerator::Filter(const Row& parameter, std::shared_ptr<TableHandler> table,
                                                          const std::string& request_keys) {
     if (!filter_key_.Valid()) {
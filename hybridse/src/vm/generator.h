@@ -198,6 +198,7 @@ class SortGenerator {
     virtual ~SortGenerator() {}
 
     const bool Valid() const { return is_valid_; }
+    const bool is_asc() const { return is_asc_; }
 
     std::shared_ptr<DataHandler> Sort(std::shared_ptr<DataHandler> input, const bool reverse = false);
     std::shared_ptr<PartitionHandler> Sort(std::shared_ptr<PartitionHandler> partition, const bool reverse = false);
@@ -217,6 +218,9 @@ class IndexSeekGenerator {
     std::shared_ptr<TableHandler> SegmnetOfConstKey(const Row& parameter, std::shared_ptr<DataHandler> input);
     std::shared_ptr<TableHandler> SegmentOfKey(const Row& row, const Row& parameter,
                                                std::shared_ptr<DataHandler> input);
+    // segments of the keys of all rows, fetched by `PartitionHandler::GetSegments` in one call
+    std::vector<std::shared_ptr<TableHandler>> SegmentsOfKeys(const std::vector<Row>& rows, const Row& parameter,
+                                                              std::shared_ptr<DataHandler> input);
     const bool Valid() const { return index_key_gen_.Valid(); }
 
     KeyGenerator index_key_gen_;
@@ -225,13 +229,19 @@ class IndexSeekGenerator {
 class FilterGenerator : public PredicateFun {
  public:
     explicit FilterGenerator(const Filter& filter)
-        : condition_gen_(filter.condition_.fn_info()), index_seek_gen_(filter.index_key_) {}
+        : condition_(filter.condition_.condition()),
+          condition_gen_(filter.condition_.fn_info()),
+          index_seek_gen_(filter.index_key_) {}
 
     const bool Valid() const { return index_seek_gen_.Valid() || condition_gen_.Valid(); }
 
     // return if index seek exists
     bool ValidIndex() const;
 
+    // collect the conjuncts `column op literal` of the condition, which are pushed down to the table read directly
+    // from the storage. `schemas_ctx` is the context of the table
+    void InitPushDownFilters(const SchemasContext* schemas_ctx);
+
     std::shared_ptr<DataHandler> Filter(std::shared_ptr<TableHandler> table, const Row& parameter,
                                         std::optional<int32_t> limit);
 
@@ -246,8 +256,10 @@ class FilterGenerator : public PredicateFun {
     }
 
  private:
+    const node::ExprNode* condition_;
     ConditionGenerator condition_gen_;
     IndexSeekGenerator index_seek_gen_;
+    std::vector<ColumnFilter> push_down_filters_;
 };
 class WindowGenerator {
  public:
@@ -274,6 +286,10 @@ class RequestWindowGenertor {
     virtual ~RequestWindowGenertor() {}
     std::shared_ptr<TableHandler> GetRequestWindow(const Row& row, const Row& parameter,
                                                    std::shared_ptr<DataHandler> input);
+    std::vector<std::shared_ptr<TableHandler>> GetRequestWindows(const std::vector<Row>& rows, const Row& parameter,
+                                                                 std::shared_ptr<DataHandler> input);
+    // the keys which decide the segment of the request row: the index key and the partition filter key
+    std::string GetWindowKey(const Row& row, const Row& parameter);
     RequestWindowOp window_op_;
     FilterKeyGenerator filter_gen_;
     SortGenerator sort_gen_;
@@ -294,12 +310,24 @@ class JoinGenerator : public std::enable_shared_from_this<JoinGenerator> {
                    std::shared_ptr<MemTimeTableHandler> output);  // NOLINT
     bool TableJoin(std::shared_ptr<TableHandler> left, std::shared_ptr<PartitionHandler> right, const Row& parameter,
                    std::shared_ptr<MemTimeTableHandler> output);  // NOLINT
+    // last join the right hash table built by `BuildHashTable`
+    bool TableHashJoin(std::shared_ptr<TableHandler> left, std::shared_ptr<PartitionHandler> right,
+                       const Row& parameter, std::shared_ptr<MemTimeTableHandler> output);  // NOLINT
     bool PartitionJoin(std::shared_ptr<PartitionHandler> left, std::shared_ptr<TableHandler> right,
                        const Row& parameter,
                        std::shared_ptr<MemPartitionHandler> output);  // NOLINT
     bool PartitionJoin(std::shared_ptr<PartitionHandler> left, std::shared_ptr<PartitionHandler> right,
                        const Row& parameter,
                        std::shared_ptr<MemPartitionHandler>);  // NOLINT
+    bool PartitionHashJoin(std::shared_ptr<PartitionHandler> left, std::shared_ptr<PartitionHandler> right,
+                           const Row& parameter, std::shared_ptr<MemPartitionHandler> output);  // NOLINT
+
+    // if the right input can be joined by a hash table: a table without index, joined by equal keys
+    bool CanHashJoin(const std::shared_ptr<DataHandler>& right) const;
+    // group the right rows by the right key in one pass, so the left rows find their right rows by the left key
+    // instead of scanning the right table. For last join, the rows of every key are sorted once here rather than
+    // for every left row.
+    std::shared_ptr<PartitionHandler> BuildHashTable(std::shared_ptr<TableHandler> right, const Row& parameter);
 
     Row RowLastJoin(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
     Row RowLastJoinDropLeftSlices(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
@@ -311,7 +339,8 @@ class JoinGenerator : public std::enable_shared_from_this<JoinGenerator> {
                                                         std::shared_ptr<PartitionHandler> right, const Row& parameter);
 
     // init right iterator from left row, returns right iterator, nullptr if no match
-    // apply to standard SQL joins like left join, not for last join & concat join
+    // the right partition is found by the index key, or the left key if it's a hash table
+    // apply to standard SQL joins like left join, and last join on hash table, not for concat join
     std::unique_ptr<RowIterator> InitRight(const Row& left_row, std::shared_ptr<PartitionHandler> right,
                                            const Row& param);
 
@@ -383,6 +412,11 @@ class RequestWindowUnionGenerator : public InputsGenerator,
 
     std::vector<std::shared_ptr<TableHandler>> GetRequestWindows(
         const Row& row, const Row& parameter, std::vector<std::shared_ptr<DataHandler>> union_inputs);
+    // the union windows of a batch of request rows, result[i][j] is the window of rows[i] in union_inputs[j]
+    std::vector<std::vector<std::shared_ptr<TableHandler>>> GetRequestWindows(
+        const std::vector<Row>& rows, const Row& parameter, std::vector<std::shared_ptr<DataHandler>> union_inputs);
+    // request rows with the same window keys get the same union segments
+    std::string GetWindowKeys(const Row& row, const Row& parameter);
     std::vector<RequestWindowGenertor> windows_gen_;
 
  private:
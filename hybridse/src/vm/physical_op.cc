@@ -211,7 +211,13 @@ void PhysicalRequestProviderNodeWithCommonColumn::Print(std::ostream& output, co
 void PhysicalPartitionProviderNode::Print(std::ostream& output, const std::string& tab) const {
     PhysicalOpNode::Print(output, tab);
     output << "(type=" << DataProviderTypeName(provider_type_) << ", table=" << table_handler_->GetName()
-           << ", index=" << index_name_ << ")";
+           << ", index=" << index_name_;
+    IndexStatistics stat;
+    if (table_handler_->GetIndexStatistics(index_name_, &stat) && stat.key_cnt > 0) {
+        // the estimated cost of a lookup
+        output << ", est_rows=" << stat.RowsPerKey();
+    }
+    output << ")";
 }
 
 Status PhysicalGroupNode::WithNewChildren(node::NodeManager* nm, const std::vector<PhysicalOpNode*>& children,
@@ -16,8 +16,10 @@
 
 #include "vm/runner.h"
 
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -291,6 +293,10 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
         batch_inputs[idx - 1] = producers_[idx - 1]->BatchRequestRun(ctx);
     }
 
+    // the output only depends on the inputs, request rows sharing the same inputs (the interned request row,
+    // the same window or the repeated common result) share the output as well
+    std::map<std::vector<const DataHandler*>, std::shared_ptr<DataHandler>> computed;
+    std::vector<const DataHandler*> inputs_key(producers_.size());
     for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
         inputs.clear();
         for (size_t producer_idx = 0; producer_idx < producers_.size(); producer_idx++) {
@@ -299,8 +305,16 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
                 return nullptr;
             }
             inputs.push_back(batch_inputs[producer_idx]->Get(idx));
+            inputs_key[producer_idx] = inputs.back().get();
         }
-        auto res = Run(ctx, inputs);
+        if (!need_batch_cache_) {
+            auto iter = computed.find(inputs_key);
+            if (iter != computed.end()) {
+                outputs->Add(iter->second);
+                continue;
+            }
+        }
+        auto res = ProfiledRun(ctx, inputs);
         if (need_batch_cache_) {
             if (ctx.is_debug()) {
                 std::ostringstream oss;
@@ -317,6 +331,7 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
             }
             return repeated_data;
         }
+        computed.emplace(inputs_key, res);
         outputs->Add(res);
     }
     if (ctx.is_debug()) {
@@ -337,6 +352,79 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
     }
     return outputs;
 }
+// the rows of a materialized output, return false if the output is lazy
+static bool CountOutput(const std::shared_ptr<DataHandler>& output, uint64_t* rows, uint64_t* bytes) {
+    switch (output->GetHandlerType()) {
+        case kRowHandler: {
+            *rows = 1;
+            *bytes = std::dynamic_pointer_cast<RowHandler>(output)->GetValue().size();
+            return true;
+        }
+        case kTableHandler: {
+            if (!std::dynamic_pointer_cast<MemTableHandler>(output) &&
+                !std::dynamic_pointer_cast<MemTimeTableHandler>(output)) {
+                return false;
+            }
+            auto iter = std::dynamic_pointer_cast<TableHandler>(output)->GetIterator();
+            if (!iter) {
+                return false;
+            }
+            iter->SeekToFirst();
+            while (iter->Valid()) {
+                (*rows)++;
+                *bytes += iter->GetValue().size();
+                iter->Next();
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+std::shared_ptr<DataHandler> Runner::ProfiledRun(RunnerContext& ctx,
+                                                 const std::vector<std::shared_ptr<DataHandler>>& inputs) {
+    auto* profile = ctx.profile();
+    if (profile == nullptr) {
+        return Run(ctx, inputs);
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto res = Run(ctx, inputs);
+    auto& stat = profile->Get(id_);
+    stat.time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                        .count();
+    stat.run_cnt++;
+    if (stat.runner_type.empty()) {
+        stat.runner_type = RunnerTypeName(type_);
+    }
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    if (res && CountOutput(res, &rows, &bytes)) {
+        stat.output_rows += rows;
+        stat.output_bytes += bytes;
+    } else if (res) {
+        stat.lazy_cnt++;
+    }
+    return res;
+}
+
+void Runner::PrintProfileInfo(std::ostream& output, const RunnerProfile* profile) const {
+    if (profile == nullptr) {
+        return;
+    }
+    auto* stat = profile->Find(id_);
+    if (stat == nullptr) {
+        output << " [no stats]";
+        return;
+    }
+    output << " [time=" << stat->time_us / 1000.0 << "ms, runs=" << stat->run_cnt << ", rows=" << stat->output_rows
+           << ", bytes=" << stat->output_bytes;
+    if (stat->lazy_cnt > 0) {
+        output << ", lazy=" << stat->lazy_cnt;
+    }
+    output << "]";
+}
+
 std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
     if (need_cache_) {
         auto cached = ctx.GetCache(id_);
@@ -350,7 +438,7 @@ std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
         inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
     }
 
-    auto res = Run(ctx, inputs);
+    auto res = ProfiledRun(ctx, inputs);
     if (ctx.is_debug()) {
         std::ostringstream oss;
         oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_ << "\n";
@@ -407,9 +495,15 @@ std::shared_ptr<DataHandlerList> RequestRunner::BatchRequestRun(
     }
     std::shared_ptr<DataHandlerVector> res =
         std::shared_ptr<DataHandlerVector>(new DataHandlerVector());
+    // identical request rows are interned to one handler, so the runners consuming them compute only once
+    std::map<Row, std::shared_ptr<DataHandler>> interned;
     for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
-        res->Add(std::shared_ptr<MemRowHandler>(
-            new MemRowHandler(ctx.GetRequest(idx))));
+        const Row& request = ctx.GetRequest(idx);
+        auto iter = interned.find(request);
+        if (iter == interned.end()) {
+            iter = interned.emplace(request, std::make_shared<MemRowHandler>(request)).first;
+        }
+        res->Add(iter->second);
     }
 
     if (ctx.is_debug()) {
@@ -811,9 +905,13 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
         return join_gen_->LazyJoin(left, right, parameter);
     }
 
+    // the right table without index is joined by a hash table built once
+    bool hash_join = join_gen_->CanHashJoin(right) && left->GetHandlerType() != kRowHandler;
     switch (left->GetHandlerType()) {
         case kTableHandler: {
-            if (join_gen_->right_group_gen_.Valid()) {
+            if (hash_join) {
+                right = join_gen_->BuildHashTable(std::dynamic_pointer_cast<TableHandler>(right), parameter);
+            } else if (join_gen_->right_group_gen_.Valid()) {
                 right = join_gen_->right_group_gen_.Partition(right, parameter);
             }
             if (!right) {
@@ -825,7 +923,12 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
             auto output_table =
                 std::shared_ptr<MemTimeTableHandler>(new MemTimeTableHandler());
             output_table->SetOrderType(left_table->GetOrderType());
-            if (kPartitionHandler == right->GetHandlerType()) {
+            if (hash_join) {
+                if (!join_gen_->TableHashJoin(left_table, std::dynamic_pointer_cast<PartitionHandler>(right),
+                                              parameter, output_table)) {
+                    return fail_ptr;
+                }
+            } else if (kPartitionHandler == right->GetHandlerType()) {
                 if (!join_gen_->TableJoin(
                         left_table,
                         std::dynamic_pointer_cast<PartitionHandler>(right),
@@ -845,7 +948,9 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
             return output_table;
         }
         case kPartitionHandler: {
-            if (join_gen_->right_group_gen_.Valid()) {
+            if (hash_join) {
+                right = join_gen_->BuildHashTable(std::dynamic_pointer_cast<TableHandler>(right), parameter);
+            } else if (join_gen_->right_group_gen_.Valid()) {
                 right = join_gen_->right_group_gen_.Partition(right, parameter);
             }
             if (!right) {
@@ -857,7 +962,12 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
             auto left_partition =
                 std::dynamic_pointer_cast<PartitionHandler>(left);
             output_partition->SetOrderType(left_partition->GetOrderType());
-            if (kPartitionHandler == right->GetHandlerType()) {
+            if (hash_join) {
+                if (!join_gen_->PartitionHashJoin(left_partition, std::dynamic_pointer_cast<PartitionHandler>(right),
+                                                  parameter, output_partition)) {
+                    return fail_ptr;
+                }
+            } else if (kPartitionHandler == right->GetHandlerType()) {
                 if (!join_gen_->PartitionJoin(
                         left_partition,
                         std::dynamic_pointer_cast<PartitionHandler>(right),
@@ -1982,6 +2092,102 @@ std::shared_ptr<DataHandler> RequestUnionRunner::Run(RunnerContext& ctx,
     LOG(WARNING) << "skip due to performance: left source of request union is table handler(unoptimized)";
     return std::shared_ptr<DataHandler>();
 }
+std::shared_ptr<DataHandlerList> RequestUnionRunner::BatchRequestRun(RunnerContext& ctx) {
+    if (need_batch_cache_) {
+        // all the request rows share one window
+        return Runner::BatchRequestRun(ctx);
+    }
+    if (need_cache_) {
+        auto cached = ctx.GetBatchCache(id_);
+        if (cached != nullptr) {
+            DLOG(INFO) << "RUNNER ID " << id_ << " HIT CACHE!";
+            return cached;
+        }
+    }
+    std::vector<std::shared_ptr<DataHandlerList>> batch_inputs(producers_.size());
+    for (size_t idx = producers_.size(); idx > 0; idx--) {
+        batch_inputs[idx - 1] = producers_[idx - 1]->BatchRequestRun(ctx);
+        if (batch_inputs[idx - 1] == nullptr) {
+            LOG(WARNING) << "the result of producer " << idx - 1 << " is null";
+            return nullptr;
+        }
+    }
+    if (batch_inputs.size() < 2u) {
+        LOG(WARNING) << "inputs size < 2";
+        return nullptr;
+    }
+
+    std::shared_ptr<DataHandlerVector> outputs = std::make_shared<DataHandlerVector>();
+    std::vector<Row> requests;
+    requests.reserve(ctx.GetRequestSize());
+    for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
+        auto left = batch_inputs[0]->Get(idx);
+        if (!left || kRowHandler != left->GetHandlerType()) {
+            break;
+        }
+        requests.push_back(std::dynamic_pointer_cast<RowHandler>(left)->GetValue());
+    }
+    if (requests.size() == ctx.GetRequestSize()) {
+        // request rows with the same window keys share the union segments, so they are seeked once per
+        // distinct key. The window is shared as well if the ts is the same too and the request row isn't part
+        // of the window, or the request rows are identical
+        std::map<std::string, size_t> segments_pos;
+        std::vector<Row> distinct_requests;
+        std::vector<size_t> request_segments(requests.size());
+        for (size_t idx = 0; idx < requests.size(); idx++) {
+            auto pos = segments_pos.emplace(windows_union_gen_->GetWindowKeys(requests[idx], ctx.GetParameterRow()),
+                                            distinct_requests.size());
+            if (pos.second) {
+                distinct_requests.push_back(requests[idx]);
+            }
+            request_segments[idx] = pos.first->second;
+        }
+        auto union_inputs = windows_union_gen_->RunInputs(ctx);
+        auto union_segments =
+            windows_union_gen_->GetRequestWindows(distinct_requests, ctx.GetParameterRow(), union_inputs);
+        std::map<std::tuple<size_t, int64_t, const DataHandler*>, std::shared_ptr<DataHandler>> windows;
+        for (size_t idx = 0; idx < requests.size(); idx++) {
+            if (!batch_inputs[1]->Get(idx)) {
+                outputs->Add(std::shared_ptr<DataHandler>());
+                continue;
+            }
+            // ts_gen < 0 if there is no ORDER BY clause for WINDOW
+            int64_t ts_gen = range_gen_->Valid() ? range_gen_->ts_gen_.Gen(requests[idx]) : -1;
+            auto window_key = std::make_tuple(request_segments[idx], ts_gen,
+                                              output_request_row_ ? batch_inputs[0]->Get(idx).get() : nullptr);
+            auto iter = windows.find(window_key);
+            if (iter == windows.end()) {
+                auto window = RequestUnionWindow(requests[idx], union_segments[request_segments[idx]], ts_gen,
+                                                 range_gen_->window_range_, output_request_row_,
+                                                 exclude_current_time_);
+                iter = windows.emplace(window_key, window).first;
+            }
+            outputs->Add(iter->second);
+        }
+    } else {
+        // the left source isn't request rows, run them one by one
+        for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
+            outputs->Add(Run(ctx, {batch_inputs[0]->Get(idx), batch_inputs[1]->Get(idx)}));
+        }
+    }
+    if (ctx.is_debug()) {
+        std::ostringstream oss;
+        oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_ << "\n";
+        for (size_t idx = 0; idx < outputs->GetSize(); idx++) {
+            if (idx >= MAX_DEBUG_BATCH_SiZE) {
+                oss << ">= MAX_DEBUG_BATCH_SiZE...\n";
+                break;
+            }
+            Runner::PrintData(oss, output_schemas_, outputs->Get(idx));
+        }
+        LOG(INFO) << oss.str();
+    }
+    if (need_cache_) {
+        ctx.SetBatchCache(id_, outputs);
+    }
+    return outputs;
+}
+
 std::shared_ptr<TableHandler> RequestUnionRunner::RunOneRequest(RunnerContext* ctx, const Row& request) {
     // ts_gen < 0 if there is no ORDER BY clause for WINDOW
     int64_t ts_gen = range_gen_->Valid() ? range_gen_->ts_gen_.Gen(request) : -1;
@@ -32,6 +32,7 @@
 #include "vm/generator.h"
 #include "vm/mem_catalog.h"
 #include "vm/physical_op.h"
+#include "vm/runner_profile.h"
 
 namespace hybridse {
 namespace vm {
@@ -130,10 +131,12 @@ class Runner : public node::NodeBase<Runner> {
             output << " lazy";
         }
     }
+    // print the runner tree, annotated with the statistics in `profile` if it's not null
     virtual void Print(std::ostream& output, const std::string& tab,
-                       std::set<int32_t>* visited_ids) const {  // NOLINT
+                       std::set<int32_t>* visited_ids, const RunnerProfile* profile = nullptr) const {  // NOLINT
         PrintRunnerInfo(output, tab);
         PrintCacheInfo(output);
+        PrintProfileInfo(output, profile);
         if (nullptr != visited_ids &&
             visited_ids->find(id_) != visited_ids->cend()) {
             output << "\n";
@@ -146,7 +149,7 @@ class Runner : public node::NodeBase<Runner> {
         if (!producers_.empty()) {
             for (auto producer : producers_) {
                 output << "\n";
-                producer->Print(output, "  " + tab, visited_ids);
+                producer->Print(output, "  " + tab, visited_ids, profile);
             }
         }
     }
@@ -225,6 +228,11 @@ class Runner : public node::NodeBase<Runner> {
  protected:
     bool is_lazy_;
 
+    // run with the time and the output recorded into the profile of ctx
+    std::shared_ptr<DataHandler> ProfiledRun(RunnerContext& ctx,  // NOLINT
+                                             const std::vector<std::shared_ptr<DataHandler>>& inputs);
+    void PrintProfileInfo(std::ostream& output, const RunnerProfile* profile) const;
+
     void PrintCacheInfo(std::ostream& output) const {
         if (need_cache_ && need_batch_cache_) {
             output << " (cache_enable, batch_common)";
@@ -526,6 +534,10 @@ class RequestUnionRunner : public Runner {
     std::shared_ptr<DataHandler> Run(RunnerContext& ctx,  // NOLINT
                                      const std::vector<std::shared_ptr<DataHandler>>& inputs) override;
 
+    // the windows of all request rows are seeked together, so the segments on the remote partitions can be
+    // fetched in one round trip per partition instead of one per request row
+    std::shared_ptr<DataHandlerList> BatchRequestRun(RunnerContext& ctx) override;  // NOLINT
+
     std::shared_ptr<TableHandler> RunOneRequest(RunnerContext* ctx, const Row& request);
 
     static std::shared_ptr<TableHandler> RequestUnionWindow(const Row& request,
@@ -537,11 +549,11 @@ class RequestUnionRunner : public Runner {
     }
 
     void Print(std::ostream& output, const std::string& tab,
-                       std::set<int32_t>* visited_ids) const override {
-        Runner::Print(output, tab, visited_ids);
+                       std::set<int32_t>* visited_ids, const RunnerProfile* profile = nullptr) const override {
+        Runner::Print(output, tab, visited_ids, profile);
         output << "\n" << tab << "window unions:\n";
         for (auto& r : windows_union_gen_->input_runners_) {
-            r->Print(output, tab + "  ", visited_ids);
+            r->Print(output, tab + "  ", visited_ids, profile);
         }
     }
 
@@ -743,13 +755,14 @@ class ProxyRequestRunner : public Runner {
             output << " lazy";
         }
     }
-    virtual void Print(std::ostream& output, const std::string& tab,
-                       std::set<int32_t>* visited_ids) const {  // NOLINT
+    void Print(std::ostream& output, const std::string& tab,
+                       std::set<int32_t>* visited_ids, const RunnerProfile* profile = nullptr) const override {
         PrintRunnerInfo(output, tab);
         PrintCacheInfo(output);
+        PrintProfileInfo(output, profile);
         if (nullptr != index_input_) {
             output << "\n    " << tab << "proxy_index_input:\n";
-            index_input_->Print(output, "    " + tab + "+-", nullptr);
+            index_input_->Print(output, "    " + tab + "+-", nullptr, profile);
         }
         if (nullptr != visited_ids &&
             visited_ids->find(id_) != visited_ids->cend()) {
@@ -763,7 +776,7 @@ class ProxyRequestRunner : public Runner {
         if (!producers_.empty()) {
             for (auto producer : producers_) {
                 output << "\n";
-                producer->Print(output, "  " + tab, visited_ids);
+                producer->Print(output, "  " + tab, visited_ids, profile);
             }
         }
     }
@@ -459,6 +459,14 @@ ClusterTask RunnerBuilder::Build(PhysicalOpNode* node, Status& status) {
             auto op = dynamic_cast<const PhysicalFilterNode*>(node);
             FilterRunner* runner =
                 CreateRunner<FilterRunner>(id_++, node->schemas_ctx(), op->GetLimitCnt(), op->filter_);
+            if (node->GetProducer(0)->GetOpType() == kPhysicalOpDataProvider) {
+                auto provider = dynamic_cast<const PhysicalDataProviderNode*>(node->GetProducer(0));
+                if (provider->provider_type_ == kProviderTypeTable ||
+                    provider->provider_type_ == kProviderTypePartition) {
+                    // the rows are read from the storage directly, which may skip them by the simple conditions
+                    runner->filter_gen_.InitPushDownFilters(provider->schemas_ctx());
+                }
+            }
             // under cluster, filter task might be completed or uncompleted
             // based on whether filter node has the index_key underlaying DataTask requires
             ClusterTask out;
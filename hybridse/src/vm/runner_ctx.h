@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "vm/cluster_task.h"
+#include "vm/runner_profile.h"
 
 namespace hybridse {
 namespace vm {
@@ -71,6 +72,9 @@ class RunnerContext {
     void SetRequest(const hybridse::codec::Row& request);
     void SetRequests(const std::vector<hybridse::codec::Row>& requests);
     bool is_debug() const { return is_debug_; }
+    // the runners record their statistics into the profile if it's set
+    RunnerProfile* profile() const { return profile_; }
+    void SetProfile(RunnerProfile* profile) { profile_ = profile; }
 
     const std::string& sp_name() { return sp_name_; }
     std::shared_ptr<DataHandler> GetCache(int64_t id) const;
@@ -87,6 +91,7 @@ class RunnerContext {
     hybridse::codec::Row parameter_;
     size_t idx_;
     const bool is_debug_;
+    RunnerProfile* profile_ = nullptr;
     // TODO(chenjing): optimize
     std::map<int64_t, std::shared_ptr<DataHandler>> cache_;
     std::map<int64_t, std::shared_ptr<DataHandlerList>> batch_cache_;
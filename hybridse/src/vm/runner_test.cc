@@ -509,6 +509,95 @@ TEST_F(RunnerTest, RunnerPrintDataMemTimeTableTest) {
         LOG(INFO) << oss.str();
     }
 }
+
+// runner that records how many times it really runs
+class CountRunner : public Runner {
+ public:
+    CountRunner(const int32_t id, const SchemasContext* schema) : Runner(id, kRunnerLimit, schema) {}
+    std::shared_ptr<DataHandler> Run(RunnerContext& ctx,  // NOLINT
+                                     const std::vector<std::shared_ptr<DataHandler>>& inputs) override {
+        run_cnt_++;
+        return std::make_shared<MemRowHandler>(std::dynamic_pointer_cast<RowHandler>(inputs[0])->GetValue());
+    }
+    int run_cnt_ = 0;
+};
+
+TEST_F(RunnerTest, BatchRequestInternTest) {
+    hybridse::type::TableDef table_def;
+    std::vector<Row> rows;
+    BuildRows(table_def, rows);
+    ASSERT_GE(rows.size(), 2u);
+    SchemasContext schemas_ctx;
+    auto source = schemas_ctx.AddSource();
+    source->SetSourceDBAndTableName("", "t1");
+    source->SetSchema(&table_def.columns());
+
+    RequestRunner request_runner(0, &schemas_ctx);
+    CountRunner count_runner(1, &schemas_ctx);
+    count_runner.AddProducer(&request_runner);
+
+    // the copy of the row has its own buffer, it's still the same request
+    Row copied(std::string(reinterpret_cast<char*>(rows[0].buf()), rows[0].size()));
+    std::vector<Row> requests = {rows[0], rows[1], copied, rows[1], rows[0]};
+    RunnerContext ctx(std::shared_ptr<ClusterJob>(), requests);
+    auto outputs = count_runner.BatchRequestRun(ctx);
+    ASSERT_TRUE(outputs != nullptr);
+    ASSERT_EQ(requests.size(), outputs->GetSize());
+    ASSERT_EQ(2, count_runner.run_cnt_);
+    ASSERT_EQ(outputs->Get(0), outputs->Get(2));
+    ASSERT_EQ(outputs->Get(0), outputs->Get(4));
+    ASSERT_EQ(outputs->Get(1), outputs->Get(3));
+    ASSERT_NE(outputs->Get(0), outputs->Get(1));
+    for (size_t idx = 0; idx < requests.size(); idx++) {
+        auto row = std::dynamic_pointer_cast<RowHandler>(outputs->Get(idx))->GetValue();
+        ASSERT_EQ(requests[idx], row);
+    }
+}
+
+TEST_F(RunnerTest, ProfileTest) {
+    hybridse::type::TableDef table_def;
+    std::vector<Row> rows;
+    BuildRows(table_def, rows);
+    ASSERT_GE(rows.size(), 2u);
+    SchemasContext schemas_ctx;
+    auto source = schemas_ctx.AddSource();
+    source->SetSourceDBAndTableName("", "t1");
+    source->SetSchema(&table_def.columns());
+
+    RequestRunner request_runner(0, &schemas_ctx);
+    CountRunner count_runner(1, &schemas_ctx);
+    count_runner.AddProducer(&request_runner);
+
+    RunnerProfile profile;
+    RunnerContext ctx(std::shared_ptr<ClusterJob>(), rows[0], std::string());
+    ctx.SetProfile(&profile);
+    ASSERT_TRUE(count_runner.RunWithCache(ctx) != nullptr);
+    auto* stat = profile.Find(1);
+    ASSERT_TRUE(stat != nullptr);
+    ASSERT_EQ(RunnerTypeName(kRunnerLimit), stat->runner_type);
+    ASSERT_EQ(1u, stat->run_cnt);
+    ASSERT_EQ(1u, stat->output_rows);
+    ASSERT_EQ(static_cast<uint64_t>(rows[0].size()), stat->output_bytes);
+    ASSERT_EQ(0u, stat->lazy_cnt);
+
+    // the interned requests are run once
+    std::vector<Row> requests = {rows[0], rows[1], rows[0]};
+    RunnerContext batch_ctx(std::shared_ptr<ClusterJob>(), requests);
+    batch_ctx.SetProfile(&profile);
+    ASSERT_TRUE(count_runner.BatchRequestRun(batch_ctx) != nullptr);
+    ASSERT_EQ(3u, profile.Find(1)->run_cnt);
+    ASSERT_EQ(3u, profile.Find(1)->output_rows);
+
+    std::ostringstream oss;
+    std::set<int32_t> visited_ids;
+    count_runner.Print(oss, "", &visited_ids, &profile);
+    ASSERT_NE(std::string::npos, oss.str().find("runs=3, rows=3")) << oss.str();
+
+    // not recorded without a profile
+    RunnerContext no_profile_ctx(std::shared_ptr<ClusterJob>(), rows[1], std::string());
+    ASSERT_TRUE(count_runner.RunWithCache(no_profile_ctx) != nullptr);
+    ASSERT_EQ(3u, profile.Find(1)->run_cnt);
+}
 }  // namespace vm
 }  // namespace hybridse
 
@@ -115,6 +115,19 @@ const IndexHint &SimpleCatalogTableHandler::GetIndex() {
     return this->index_hint_;
 }
 
+bool SimpleCatalogTableHandler::GetIndexStatistics(const std::string &index_name, IndexStatistics *stat) {
+    auto it = index_stats_.find(index_name);
+    if (it == index_stats_.end()) {
+        return false;
+    }
+    *stat = it->second;
+    return true;
+}
+
+void SimpleCatalogTableHandler::SetIndexStatistics(const std::string &index_name, const IndexStatistics &stat) {
+    index_stats_[index_name] = stat;
+}
+
 const Schema *SimpleCatalogTableHandler::GetSchema() {
     return &this->table_def_.columns();
 }
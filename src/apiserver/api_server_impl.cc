@@ -24,6 +24,7 @@
 #include "apiserver/interface_provider.h"
 
 #include "absl/cleanup/cleanup.h"
+#include "absl/strings/match.h"
 #include "brpc/server.h"
 #include "butil/time.h"
 
@@ -85,6 +86,7 @@ bool APIServerImpl::Init(::openmldb::sdk::DBSDK* cluster) {
     RegisterPut();
     RegisterExecSP();
     RegisterExecDeployment();
+    RegisterExecDeploymentRowCodec();
     RegisterGetSP();
     RegisterGetDeployment();
     RegisterGetDB();
@@ -100,6 +102,16 @@ void APIServerImpl::Refresh() {
     }
 }
 
+bool IsRowCodecRequest(const brpc::HttpHeader& header) {
+    // the content type may have parameters, e.g. charset
+    return absl::StartsWith(header.content_type(), kRowCodecContentType);
+}
+
+bool AcceptsRowCodec(const brpc::HttpHeader& header) {
+    const std::string* accept = header.GetHeader("Accept");
+    return accept != nullptr && absl::StrContains(*accept, kRowCodecContentType);
+}
+
 void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const HttpRequest*, HttpResponse*,
                             google::protobuf::Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -110,6 +122,17 @@ void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const Ht
     DLOG(INFO) << "unresolved path: " << unresolved_path << ", method: " << HttpMethod2Str(method);
     const butil::IOBuf& req_body = cntl->request_attachment();
 
+    // the raw handlers take the requests whose body is row codec encoded or which accept a row codec response
+    if (IsRowCodecRequest(cntl->http_request()) || AcceptsRowCodec(cntl->http_request())) {
+        butil::IOBuf resp_body;
+        if (provider_.handle_raw(unresolved_path, method, cntl->http_request(), req_body, &cntl->http_response(),
+                                 &resp_body)) {
+            cntl->response_attachment().swap(resp_body);
+            return;
+        }
+        // no raw handler for this path, fall back to json
+    }
+
     JsonWriter writer;
     provider_.handle(unresolved_path, method, req_body, writer);
     cntl->response_attachment().append(writer.GetString());
@@ -452,12 +475,68 @@ void APIServerImpl::RegisterExecDeployment() {
                              std::placeholders::_2, std::placeholders::_3));
 }
 
+void APIServerImpl::RegisterExecDeploymentRowCodec() {
+    provider_.post_raw("/dbs/:db_name/deployments/:sp_name",
+                       std::bind(&APIServerImpl::ExecuteDeploymentRaw, this, std::placeholders::_1,
+                                 std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
+                                 std::placeholders::_5));
+}
+
 void APIServerImpl::RegisterExecSP() {
     provider_.post("/dbs/:db_name/procedures/:sp_name",
                    std::bind(&APIServerImpl::ExecuteProcedure, this, true, std::placeholders::_1, std::placeholders::_2,
                              std::placeholders::_3));
 }
 
+absl::Status APIServerImpl::JsonRows2RowBatch(const hybridse::sdk::ProcedureInfo& sp_info, bool has_common_col,
+                                             const Value& rows, const Value& common_cols_v,
+                                             std::shared_ptr<sdk::SQLRequestRowBatch>* row_batch) {
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info.GetInputSchema());
+    // Hard copy, and RequestRow needs shared schema
+    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    auto common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema);
+    decltype(common_cols_v.Size()) expected_common_size = 0;
+    if (has_common_col) {
+        for (int i = 0; i < input_schema->GetColumnCnt(); ++i) {
+            if (input_schema->IsConstant(i)) {
+                common_column_indices->AddCommonColumnIdx(i);
+                ++expected_common_size;
+            }
+        }
+        if (common_cols_v.Size() != expected_common_size) {
+            return absl::InvalidArgumentError("Invalid common cols size");
+        }
+    }
+    auto expected_input_size = input_schema->GetColumnCnt() - expected_common_size;
+
+    // TODO(hw): SQLRequestRowBatch should add common & non-common cols directly
+    *row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema, common_column_indices);
+    std::set<std::string> col_set;
+    for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
+        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema, col_set);
+        // row can be array or map
+        if (rows[i].IsArray()) {
+            if (rows[i].Size() != expected_input_size) {
+                return absl::InvalidArgumentError("Invalid input data size in row " + std::to_string(i));
+            }
+            if (auto st = JsonArray2SQLRequestRow(rows[i], common_cols_v, row); !st.ok()) {
+                return absl::InvalidArgumentError("Translate to request row failed in array row " +
+                                                  std::to_string(i) + ", " + st.ToString());
+            }
+        } else if (rows[i].IsObject()) {
+            if (auto st = JsonMap2SQLRequestRow(rows[i], common_cols_v, row); !st.ok()) {
+                return absl::InvalidArgumentError("Translate to request row failed in map row " + std::to_string(i) +
+                                                  ", " + st.ToString());
+            }
+        } else {
+            return absl::InvalidArgumentError("Must be array or map, row " + std::to_string(i));
+        }
+        row->Build();
+        (*row_batch)->AddRow(row);
+    }
+    return absl::OkStatus();
+}
+
 void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param,
                                      const butil::IOBuf& req_body, JsonWriter& writer) {
     auto start = absl::Now();
@@ -520,53 +599,10 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
         return;
     }
 
-    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
-    // Hard copy, and RequestRow needs shared schema
-    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
-    auto common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema);
-    decltype(common_cols_v.Size()) expected_common_size = 0;
-    if (has_common_col) {
-        for (int i = 0; i < input_schema->GetColumnCnt(); ++i) {
-            if (input_schema->IsConstant(i)) {
-                common_column_indices->AddCommonColumnIdx(i);
-                ++expected_common_size;
-            }
-        }
-        if (common_cols_v.Size() != expected_common_size) {
-            writer << resp.Set("Invalid common cols size");
-            return;
-        }
-    }
-    auto expected_input_size = input_schema->GetColumnCnt() - expected_common_size;
-
-    // TODO(hw): SQLRequestRowBatch should add common & non-common cols directly
-    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema, common_column_indices);
-    std::set<std::string> col_set;
-    for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
-        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema, col_set);
-        // row can be array or map
-        if (rows[i].IsArray()) {
-            if (rows[i].Size() != expected_input_size) {
-                writer << resp.Set("Invalid input data size in row " + std::to_string(i));
-                return;
-            }
-            if (auto st = JsonArray2SQLRequestRow(rows[i], common_cols_v, row); !st.ok()) {
-                writer << resp.Set("Translate to request row failed in array row " + std::to_string(i) + ", " +
-                                   st.ToString());
-                return;
-            }
-        } else if (rows[i].IsObject()) {
-            if (auto st = JsonMap2SQLRequestRow(rows[i], common_cols_v, row); !st.ok()) {
-                writer << resp.Set("Translate to request row failed in map row " + std::to_string(i) + ", " +
-                                   st.ToString());
-                return;
-            }
-        } else {
-            writer << resp.Set("Must be array or map, row " + std::to_string(i));
-            return;
-        }
-        row->Build();
-        row_batch->AddRow(row);
+    std::shared_ptr<sdk::SQLRequestRowBatch> row_batch;
+    if (auto st = JsonRows2RowBatch(*sp_info, has_common_col, rows, common_cols_v, &row_batch); !st.ok()) {
+        writer << resp.Set(std::string(st.message()));
+        return;
     }
 
     auto rs = sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status);
@@ -590,6 +626,117 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
     writer << sp_resp;
 }
 
+void APIServerImpl::ExecuteDeploymentRaw(const InterfaceProvider::Params& param, const brpc::HttpHeader& req_header,
+                                         const butil::IOBuf& req_body, brpc::HttpHeader* resp_header,
+                                         butil::IOBuf* resp_body) {
+    auto start = absl::Now();
+    absl::Cleanup method_latency = [this, start]() {
+        absl::Duration time = absl::Now() - start;
+        *md_recorder_.get_stats({"deployment_row_codec"}) << absl::ToInt64Microseconds(time);
+    };
+    // the request body is decoded by its Content-Type, the response is encoded by the Accept header
+    bool row_codec_resp = AcceptsRowCodec(req_header);
+    resp_header->set_content_type(row_codec_resp ? kRowCodecContentType : "application/json");
+    auto fail = [row_codec_resp, resp_body](const std::string& msg) {
+        if (row_codec_resp) {
+            WriteRowCodecResp(-1, msg, nullptr, resp_body);
+        } else {
+            JsonWriter writer;
+            writer << GeneralResp().Set(msg);
+            resp_body->append(writer.GetString());
+        }
+    };
+    auto db_it = param.find("db_name");
+    auto sp_it = param.find("sp_name");
+    if (db_it == param.end() || sp_it == param.end()) {
+        fail("Invalid db or sp name");
+        return;
+    }
+    const auto& db = db_it->second;
+    const auto& sp = sp_it->second;
+
+    hybridse::sdk::Status status;
+    auto sp_info = sql_router_->ShowProcedure(db, sp, &status);
+    if (!sp_info) {
+        fail(status.msg);
+        return;
+    }
+    std::shared_ptr<sdk::SQLRequestRowBatch> row_batch;
+    if (IsRowCodecRequest(req_header)) {
+        if (auto st = RowCodecRows2RowBatch(*sp_info, req_body, &row_batch); !st.ok()) {
+            fail(std::string(st.message()));
+            return;
+        }
+    } else {
+        Document document;
+        if (document.Parse<rapidjson::kParseNanAndInfFlag>(req_body.to_string().c_str()).HasParseError()) {
+            fail("Request body json parse failed");
+            return;
+        }
+        auto input = document.FindMember("input");
+        if (input == document.MemberEnd() || !input->value.IsArray() || input->value.Empty()) {
+            fail("Field input is invalid");
+            return;
+        }
+        Value common_cols_v;
+        common_cols_v.SetArray();
+        if (auto st = JsonRows2RowBatch(*sp_info, false, input->value, common_cols_v, &row_batch); !st.ok()) {
+            fail(std::string(st.message()));
+            return;
+        }
+    }
+
+    auto rs = std::dynamic_pointer_cast<sdk::SQLBatchRequestResultSet>(
+        sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status));
+    if (!rs) {
+        fail(status.IsOK() ? "Unexpected result set type" : status.msg);
+        return;
+    }
+    if (row_codec_resp) {
+        WriteRowCodecResp(0, "ok", rs, resp_body);
+    } else {
+        ExecSPResp sp_resp;
+        sp_resp.sp_info = sp_info;
+        sp_resp.rs = rs;
+        JsonWriter writer;
+        writer << sp_resp;
+        resp_body->append(writer.GetString());
+    }
+}
+
+absl::Status APIServerImpl::RowCodecRows2RowBatch(const hybridse::sdk::ProcedureInfo& sp_info,
+                                                  const butil::IOBuf& req_body,
+                                                  std::shared_ptr<sdk::SQLRequestRowBatch>* row_batch) {
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info.GetInputSchema());
+    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    // deployments have no common columns, every row is a complete request row
+    *row_batch = std::make_shared<sdk::SQLRequestRowBatch>(
+        input_schema, std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema));
+
+    // rows are self-delimited, the row size is stored in the row header(2 bytes version + 4 bytes size)
+    std::string row;
+    size_t pos = 0;
+    const size_t body_size = req_body.size();
+    while (pos < body_size) {
+        uint32_t row_size = 0;
+        if (body_size - pos < ::hybridse::codec::HEADER_LENGTH ||
+            req_body.copy_to(&row_size, sizeof(row_size), pos + ::hybridse::codec::VERSION_LENGTH) !=
+                sizeof(row_size) ||
+            row_size > body_size - pos) {
+            return absl::InvalidArgumentError("Truncated row " + std::to_string((*row_batch)->Size()));
+        }
+        req_body.copy_to(&row, row_size, pos);
+        if (!(*row_batch)->AddEncodedRow(reinterpret_cast<const int8_t*>(row.data()), row.size())) {
+            return absl::InvalidArgumentError("Invalid encoded row " + std::to_string((*row_batch)->Size()));
+        }
+        pos += row_size;
+    }
+    if ((*row_batch)->Size() == 0) {
+        return absl::InvalidArgumentError("Empty input rows");
+    }
+    return absl::OkStatus();
+}
+
 void APIServerImpl::RegisterGetSP() {
     provider_.get("/dbs/:db_name/procedures/:sp_name",
                   [this](const InterfaceProvider::Params& param, const butil::IOBuf& req_body, JsonWriter& writer) {
@@ -1033,6 +1180,28 @@ void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, in
     }
 }
 
+void WriteRowCodecResp(int code, const std::string& msg,
+                       const std::shared_ptr<openmldb::sdk::SQLBatchRequestResultSet>& rs, butil::IOBuf* buf) {
+    auto append_u32 = [buf](uint32_t v) { buf->append(&v, sizeof(v)); };
+    int32_t c = code;
+    buf->append(&c, sizeof(c));
+    append_u32(msg.size());
+    buf->append(msg);
+    if (code != 0 || !rs) {
+        return;
+    }
+    const auto& response = rs->GetResponse();
+    append_u32(response.schema().size());
+    buf->append(response.schema());
+    append_u32(response.common_column_indices_size());
+    for (auto idx : response.common_column_indices()) {
+        append_u32(idx);
+    }
+    append_u32(response.count());
+    // shares the blocks of the rpc attachment, no copy
+    buf->append(rs->GetRowsBuf());
+}
+
 // ExecSPResp reading is unsupported now, cuz we decode ResultSet with Schema here, it's irreversible
 JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s) {  // NOLINT
     ar.StartObject();
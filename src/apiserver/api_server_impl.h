@@ -31,6 +31,7 @@
 #include "bvar/multi_dimension.h"  // latency recorder
 #include "proto/api_server.pb.h"
 #include "rapidjson/document.h"  // raw rapidjson 1.1.0, not in butil
+#include "sdk/batch_request_result_set_sql.h"
 #include "sdk/sql_cluster_router.h"
 #include "sdk/sql_request_row.h"
 
@@ -40,11 +41,21 @@ namespace apiserver {
 using rapidjson::Document;
 using rapidjson::Value;
 
+// Content type of the compact binary encoding for deployment calls. The request body is row codec encoded if it's
+// the `Content-Type` of the request, and the response is if it's in the `Accept` header. The request body is the
+// concatenation of input rows encoded by the row codec with the deployment input schema, the response layout is
+// documented in `WriteRowCodecResp()`.
+constexpr const char* kRowCodecContentType = "application/x-openmldb-row";
+
+bool IsRowCodecRequest(const brpc::HttpHeader& header);
+bool AcceptsRowCodec(const brpc::HttpHeader& header);
+
 // APIServer is a service for brpc::Server. The entire implement is `StartAPIServer()` in src/cmd/openmldb.cc
 // Every request is handled by `Process()`, we will choose the right method of the request by `InterfaceProvider`.
 // InterfaceProvider's url parser supports to parse urls like "/a/:arg1/b/:arg2/:arg3", but doesn't support wildcards.
 // Methods should be registered in `InterfaceProvider` in the init phase.
-// Both input and output are json data. We use rapidjson to handle it.
+// Both input and output are json data. We use rapidjson to handle it. Deployments can also be called with the row
+// codec encoding(`kRowCodecContentType`), which skips the json translation of every column.
 class APIServerImpl : public APIServer {
  public:
     explicit APIServerImpl(const std::string& endpoint);
@@ -62,6 +73,7 @@ class APIServerImpl : public APIServer {
     void RegisterPut();
     void RegisterExecSP();
     void RegisterExecDeployment();
+    void RegisterExecDeploymentRowCodec();
     void RegisterGetSP();
     void RegisterGetDeployment();
     void RegisterGetDB();
@@ -70,6 +82,17 @@ class APIServerImpl : public APIServer {
 
     void ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param, const butil::IOBuf& req_body,
                           JsonWriter& writer);  // NOLINT
+    // the deployment call whose request body or response is row codec encoded
+    void ExecuteDeploymentRaw(const InterfaceProvider::Params& param, const brpc::HttpHeader& req_header,
+                              const butil::IOBuf& req_body, brpc::HttpHeader* resp_header, butil::IOBuf* resp_body);
+
+    // the error message is the msg of the response
+    static absl::Status JsonRows2RowBatch(const hybridse::sdk::ProcedureInfo& sp_info, bool has_common_col,
+                                          const Value& rows, const Value& common_cols_v,
+                                          std::shared_ptr<openmldb::sdk::SQLRequestRowBatch>* row_batch);
+    static absl::Status RowCodecRows2RowBatch(const hybridse::sdk::ProcedureInfo& sp_info,
+                                              const butil::IOBuf& req_body,
+                                              std::shared_ptr<openmldb::sdk::SQLRequestRowBatch>* row_batch);
 
     static absl::Status JsonArray2SQLRequestRow(const Value& non_common_cols_v, const Value& common_cols_v,
                                                 std::shared_ptr<openmldb::sdk::SQLRequestRow> row);
@@ -152,6 +175,15 @@ void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, in
 // ExecSPResp reading is unsupported now, cuz we decode ResultSet with Schema here, it's irreversible
 JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s);  // NOLINT
 
+// Row codec response, all integers are little-endian:
+// | code: int32 | msg size: uint32 | msg | schema size: uint32 | schema | common column cnt: uint32 |
+// | common column idx: uint32 * cnt | row cnt: uint32 | rows |
+// The schema is encoded by hybridse SchemaCodec. If there are common columns, rows start with one common row which
+// holds the common columns, then one row per request row holds the others. Otherwise each row holds all columns.
+// rs is nullptr when code is not 0, and the body ends after msg.
+void WriteRowCodecResp(int code, const std::string& msg,
+                       const std::shared_ptr<openmldb::sdk::SQLBatchRequestResultSet>& rs, butil::IOBuf* buf);
+
 struct GetSPResp {
     GetSPResp() = default;
     int code = 0;
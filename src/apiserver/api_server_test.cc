@@ -22,6 +22,8 @@
 #include "brpc/restful.h"
 #include "brpc/server.h"
 #include "butil/logging.h"
+#include "codec/fe_row_codec.h"
+#include "codec/fe_schema_codec.h"
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
 #include "rapidjson/error/en.h"
@@ -1128,6 +1130,135 @@ TEST_F(APIServerTest, no_common_not_first_string) {
     ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table trans1;", &status));
 }
 
+TEST_F(APIServerTest, rowCodecDeployment) {
+    const auto env = APIServerTestEnv::Instance();
+
+    std::string ddl =
+        "create table trans2(c1 string,\n"
+        "                   c3 int,\n"
+        "                   c4 bigint,\n"
+        "                   c7 timestamp,\n"
+        "                   index(key=c1, ts=c7));";
+    hybridse::sdk::Status status;
+    env->cluster_remote->ExecuteDDL(env->db, "drop table trans2;", &status);
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, ddl, &status)) << "fail to create table";
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+    ASSERT_TRUE(env->cluster_remote->ExecuteInsert(env->db, "insert into trans2 values(\"bb\",24,34,1590738994000);",
+                                                   &status));
+    std::string sp_name = "d_row_codec";
+    std::string deploy = "deploy " + sp_name +
+                         " SELECT c1, c3, sum(c4) OVER w1 as w1_c4_sum FROM trans2 WINDOW w1 AS"
+                         " (PARTITION BY trans2.c1 ORDER BY trans2.c7 ROWS BETWEEN 2 PRECEDING AND CURRENT ROW);";
+    env->cluster_remote->ExecuteSQL(env->db, deploy, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+
+    // encode request rows by the sdk, the same bytes as any other row codec client
+    auto sp_info = env->cluster_remote->ShowProcedure(env->db, sp_name, &status);
+    ASSERT_TRUE(sp_info) << status.msg;
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
+    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    std::string body;
+    for (int64_t c4 : {123, 234}) {
+        sdk::SQLRequestRow row(input_schema, {});
+        ASSERT_TRUE(row.Init(2));
+        ASSERT_TRUE(row.AppendString("bb"));
+        ASSERT_TRUE(row.AppendInt32(23));
+        ASSERT_TRUE(row.AppendInt64(c4));
+        ASSERT_TRUE(row.AppendTimestamp(1590738994000));
+        ASSERT_TRUE(row.Build());
+        body.append(row.GetRow());
+    }
+
+    auto call = [&env, &sp_name](const std::string& content_type, bool accept_row_codec, const std::string& req,
+                                 brpc::Controller* cntl) {
+        cntl->http_request().set_method(brpc::HTTP_METHOD_POST);
+        cntl->http_request().set_content_type(content_type);
+        if (accept_row_codec) {
+            cntl->http_request().SetHeader("Accept", kRowCodecContentType);
+        }
+        cntl->http_request().uri() = env->api_server_url + "/dbs/" + env->db + "/deployments/" + sp_name;
+        cntl->request_attachment().append(req);
+        env->http_channel.CallMethod(NULL, cntl, NULL, NULL, NULL);
+    };
+    auto check_row_codec_resp = [](const std::string& resp) {
+        size_t pos = 0;
+        auto read_u32 = [&resp, &pos]() {
+            uint32_t v = *reinterpret_cast<const uint32_t*>(resp.data() + pos);
+            pos += sizeof(v);
+            return v;
+        };
+        ASSERT_EQ(0u, read_u32());
+        uint32_t msg_size = read_u32();
+        ASSERT_EQ("ok", resp.substr(pos, msg_size));
+        pos += msg_size;
+        uint32_t schema_size = read_u32();
+        ::hybridse::codec::Schema output_schema;
+        ASSERT_TRUE(::hybridse::codec::SchemaCodec::Decode(resp.substr(pos, schema_size), &output_schema));
+        pos += schema_size;
+        ASSERT_EQ(3, output_schema.size());
+        ASSERT_EQ(0u, read_u32());  // no common column
+        ASSERT_EQ(2u, read_u32());
+        ::hybridse::codec::RowView view(output_schema);
+        int64_t expect_sum[] = {34 + 123, 34 + 234};
+        for (int i = 0; i < 2; i++) {
+            ASSERT_TRUE(view.Reset(reinterpret_cast<const int8_t*>(resp.data() + pos)));
+            int64_t sum = 0;
+            ASSERT_EQ(0, view.GetInt64(2, &sum));
+            ASSERT_EQ(expect_sum[i], sum);
+            pos += view.GetSize();
+        }
+        ASSERT_EQ(resp.size(), pos);
+    };
+
+    // row codec request and response
+    {
+        brpc::Controller cntl;
+        call(kRowCodecContentType, true, body, &cntl);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        ASSERT_EQ(kRowCodecContentType, cntl.http_response().content_type());
+        check_row_codec_resp(cntl.response_attachment().to_string());
+    }
+
+    // json request, row codec response
+    {
+        brpc::Controller cntl;
+        call("application/json", true,
+             R"({"input": [["bb", 23, 123, 1590738994000], ["bb", 23, 234, 1590738994000]]})", &cntl);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        ASSERT_EQ(kRowCodecContentType, cntl.http_response().content_type());
+        check_row_codec_resp(cntl.response_attachment().to_string());
+    }
+
+    // row codec request, json response since the row codec is not accepted
+    {
+        brpc::Controller cntl;
+        call(kRowCodecContentType, false, body, &cntl);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        ASSERT_EQ("application/json", cntl.http_response().content_type());
+        rapidjson::Document document;
+        ASSERT_FALSE(document.Parse(cntl.response_attachment().to_string().c_str()).HasParseError());
+        ASSERT_EQ(0, document["code"].GetInt()) << document["msg"].GetString();
+        const auto& data = document["data"]["data"];
+        ASSERT_EQ(2, data.Size());
+        ASSERT_EQ(34 + 123, data[0][2].GetInt64());
+        ASSERT_EQ(34 + 234, data[1][2].GetInt64());
+    }
+
+    // truncated row
+    {
+        brpc::Controller cntl;
+        call(kRowCodecContentType, true, body.substr(0, body.size() - 1), &cntl);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        std::string resp = cntl.response_attachment().to_string();
+        ASSERT_NE(0, *reinterpret_cast<const int32_t*>(resp.data()));
+    }
+
+    env->cluster_remote->ExecuteSQL(env->db, "drop deployment " + sp_name, &status);
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table trans2;", &status));
+}
+
 TEST_F(APIServerTest, getDBs) {
     const auto env = APIServerTestEnv::Instance();
     std::default_random_engine e;
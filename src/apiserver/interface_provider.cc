@@ -114,6 +114,16 @@ InterfaceProvider& InterfaceProvider::post(const std::string& path, std::functio
     return *this;
 }
 
+InterfaceProvider& InterfaceProvider::post_raw(const std::string& path, std::function<raw_func> callback) {
+    Url parsed;
+    if (!ReducedUrlParser::parse(path, &parsed)) {
+        LOG(ERROR) << "Fail to parse url " << path;
+        return *this;
+    }
+    raw_requests_[brpc::HttpMethod::HTTP_METHOD_POST].push_back(BuiltRawRequest{parsed, std::move(callback)});
+    return *this;
+}
+
 bool InterfaceProvider::matching(const Url& received, const Url& registered) {
     auto registeredParts = registered.parsePath();
     auto receivedParts = received.parsePath(true);
@@ -159,46 +169,76 @@ void InterfaceProvider::registerRequest(brpc::HttpMethod type, std::string const
     requests_[type].push_back(req);
 }
 
-bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
-                               JsonWriter& writer) {
-    butil::Timer tm;
-    tm.start();
-    auto err = GeneralResp();
+template <typename Request>
+const Request* InterfaceProvider::findRequest(const std::unordered_map<int, std::vector<Request>>& requests,
+                                              const std::string& path, const brpc::HttpMethod& method,
+                                              Params* params, std::string* err) {
     Url url;
-
     if (!ReducedUrlParser::parse(path, &url)) {
-        writer << err.Set("invalid url");
-        return false;
+        *err = "invalid url";
+        return nullptr;
     }
 
-    auto requestList = requests_.find(method);
+    auto requestList = requests.find(method);
 
     // is there any request matching the request type?
-    if (requestList == std::end(requests_)) {
+    if (requestList == std::end(requests)) {
         if (strncmp(HttpMethod2Str(method), "UNKNOWN", 7) != 0) {
-            writer << err.Set("unsupported method");
-            return false;
+            *err = "unsupported method";
+            return nullptr;
         }
 
-        writer << err.Set("invalid method");
-        return false;
+        *err = "invalid method";
+        return nullptr;
     }
 
     // is there a registered request, that matches the url?
     auto request = std::find_if(std::begin(requestList->second), std::end(requestList->second),
-                                [&, this](BuiltRequest const& request) { return matching(url, request.url); });
+                                [&](Request const& request) { return matching(url, request.url); });
 
     if (request == std::end(requestList->second)) {
-        writer << err.Set("no match method");
-        return false;
+        *err = "no match method";
+        return nullptr;
     }
 
-    auto params = extractParameters(url, request->url);
+    *params = extractParameters(url, request->url);
+    return &(*request);
+}
+
+bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
+                               JsonWriter& writer) {
+    butil::Timer tm;
+    tm.start();
+    Params params;
+    std::string err;
+    auto request = findRequest(requests_, path, method, &params, &err);
+    if (request == nullptr) {
+        writer << GeneralResp().Set(err);
+        return false;
+    }
     tm.stop();
     route_recorder_ << tm.u_elapsed();
 
     request->callback(params, req_body, writer);
     return true;
 }
+
+bool InterfaceProvider::handle_raw(const std::string& path, const brpc::HttpMethod& method,
+                                   const brpc::HttpHeader& req_header, const butil::IOBuf& req_body,
+                                   brpc::HttpHeader* resp_header, butil::IOBuf* resp_body) {
+    butil::Timer tm;
+    tm.start();
+    Params params;
+    std::string err;
+    auto request = findRequest(raw_requests_, path, method, &params, &err);
+    if (request == nullptr) {
+        return false;
+    }
+    tm.stop();
+    route_recorder_ << tm.u_elapsed();
+
+    request->callback(params, req_header, req_body, resp_header, resp_body);
+    return true;
+}
 }  // namespace apiserver
 }  // namespace openmldb
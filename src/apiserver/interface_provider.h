@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "apiserver/json_helper.h"
+#include "brpc/http_header.h"  // HttpHeader
 #include "brpc/http_method.h"  // HttpMethod
 #include "butil/iobuf.h"       // IOBuf
 #include "bvar/bvar.h"         // latency recorder
@@ -118,6 +119,8 @@ class InterfaceProvider {
 
     typedef std::unordered_map<std::string, std::string> Params;
     using func = void(const Params& params, const butil::IOBuf& req_body, JsonWriter& writer);  // NOLINT
+    using raw_func = void(const Params& params, const brpc::HttpHeader& req_header, const butil::IOBuf& req_body,
+                          brpc::HttpHeader* resp_header, butil::IOBuf* resp_body);
     /**
      *  Registers a new get request handler.
      *
@@ -145,16 +148,38 @@ class InterfaceProvider {
      */
     InterfaceProvider& post(std::string const& path, std::function<func> callback);
 
+    /**
+     *  Registers a new post request handler for the non-json bodies, e.g. the binary row codec encoding.
+     *
+     *  @param path The url to listen on, same syntax as the json handlers.
+     *  @param callback The function called when a client sends a raw request on the url.
+     *
+     */
+    InterfaceProvider& post_raw(std::string const& path, std::function<raw_func> callback);
+
     bool handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
                 JsonWriter& writer);  // NOLINT
 
+    // return false if no raw handler matches, the caller should fall back to `handle()`
+    bool handle_raw(const std::string& path, const brpc::HttpMethod& method, const brpc::HttpHeader& req_header,
+                    const butil::IOBuf& req_body, brpc::HttpHeader* resp_header, butil::IOBuf* resp_body);
+
  private:
     struct BuiltRequest {
         Url url;
         std::function<func> callback;
     };
+    struct BuiltRawRequest {
+        Url url;
+        std::function<raw_func> callback;
+    };
 
     static bool matching(const Url& received, const Url& registered);
+    // find the handler of the method and the url in `requests`, set `err` if there is none
+    template <typename Request>
+    static const Request* findRequest(const std::unordered_map<int, std::vector<Request>>& requests,
+                                      const std::string& path, const brpc::HttpMethod& method, Params* params,
+                                      std::string* err);
     static std::unordered_map<std::string, std::string> extractParameters(const Url& received, const Url& registered);
 
  private:
@@ -165,6 +190,7 @@ class InterfaceProvider {
     // api server impl
     bvar::LatencyRecorder route_recorder_;
     std::unordered_map<int, std::vector<BuiltRequest>> requests_;
+    std::unordered_map<int, std::vector<BuiltRawRequest>> raw_requests_;
 };
 
 struct GeneralResp {
@@ -362,6 +362,8 @@ class Skiplist {
     // delete the iterator after it's used
     Iterator* NewIterator() { return new Iterator(this); }
 
+    uint8_t GetMaxHeight() const { return max_height_.load(std::memory_order_relaxed); }
+
  private:
     Node<K, V>* NewNode(const K& key, V& value, uint8_t height) {  // NOLINT
         Node<K, V>* node = new Node<K, V>(key, value, height);
@@ -431,8 +433,6 @@ class Skiplist {
         return (node != NULL) && (compare_(key, node->GetKey()) > 0);
     }
 
-    uint8_t GetMaxHeight() const { return max_height_.load(std::memory_order_relaxed); }
-
     Node<K, V>* SplitOnPosNode(uint64_t pos, Node<K, V>* pos_node) {
         Node<K, V>* node = head_;
         Node<K, V>* pre = head_;
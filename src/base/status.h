@@ -97,6 +97,10 @@ enum ReturnCode {
     kCheckIndexFailed = 162,
     kCatalogUpdateFailed = 163,
     kExceedPutMemoryLimit = 164,
+    kFollowerLagTooLarge = 165,
+    kFailToReadBinlog = 166,
+    kServerOverloaded = 167,
+    kFailToApplyFilter = 168,
     kNameserverIsNotLeader = 300,
     kAutoFailoverIsEnabled = 301,
     kEndpointIsNotExist = 302,
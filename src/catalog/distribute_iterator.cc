@@ -27,9 +27,10 @@ namespace catalog {
 constexpr uint32_t INVALID_PID = UINT32_MAX;
 
 FullTableIterator::FullTableIterator(uint32_t tid, std::shared_ptr<Tables> tables,
-        const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients)
-    : tid_(tid), tables_(tables), tablet_clients_(tablet_clients), in_local_(true), cur_pid_(INVALID_PID),
-    it_(), kv_it_(), key_(0), last_ts_(0), last_pk_(), value_() {
+        const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients,
+        const ::openmldb::codec::FilterList& filters)
+    : tid_(tid), tables_(tables), tablet_clients_(tablet_clients), filters_(filters), in_local_(true),
+    cur_pid_(INVALID_PID), it_(), kv_it_(), key_(0), value_() {
 }
 
 void FullTableIterator::SeekToFirst() {
@@ -63,6 +64,7 @@ void FullTableIterator::Next() {
 void FullTableIterator::Reset() {
     it_.reset();
     kv_it_.reset();
+    prefetch_group_.reset();
     cur_pid_ = INVALID_PID;
     in_local_ = true;
     ResetValue();
@@ -130,43 +132,21 @@ bool FullTableIterator::NextFromRemote() {
             return true;
         }
     }
-    auto iter = tablet_clients_.begin();
-    if (cur_pid_ == INVALID_PID) {
-        cur_pid_ = iter->first;
-    } else {
-        iter = tablet_clients_.find(cur_pid_);
+    if (!prefetch_group_) {
+        prefetch_group_ = std::make_unique<TraversePrefetchGroup>(tid_, "", false, filters_, tablet_clients_);
     }
-    do {
-        if (iter == tablet_clients_.end()) {
-            return false;
-        }
+    // partitions are concatenated in pid order, the following pages and partitions are prefetched meanwhile
+    auto iter = cur_pid_ == INVALID_PID ? tablet_clients_.begin() : tablet_clients_.find(cur_pid_);
+    for (; iter != tablet_clients_.end(); iter++) {
         cur_pid_ = iter->first;
-        uint32_t count = 0;
-        if (kv_it_) {
-            if (!kv_it_->IsFinish()) {
-                kv_it_ = iter->second->Traverse(tid_, cur_pid_, "", last_pk_, last_ts_,
-                            FLAGS_traverse_cnt_limit, false, kv_it_->GetTSPos(), count);
-                DLOG(INFO) << "pid " << cur_pid_ << " last pk " << last_pk_ <<
-                    " key " << last_ts_ << " ts_pos " << kv_it_->GetTSPos() << " count " << count;
-            } else {
-                iter++;
-                kv_it_.reset();
-                continue;
+        while ((kv_it_ = prefetch_group_->NextPage(cur_pid_))) {
+            if (kv_it_->Valid()) {
+                key_ = kv_it_->GetKey();
+                return true;
             }
-        } else {
-            kv_it_ = iter->second->Traverse(tid_, cur_pid_, "", "", 0, FLAGS_traverse_cnt_limit, false, 0, count);
-            DLOG(INFO) << "count " << count;
         }
-        if (kv_it_ && kv_it_->Valid()) {
-            last_pk_ = kv_it_->GetLastPK();
-            last_ts_ = kv_it_->GetLastTS();
-            key_ = kv_it_->GetKey();
-            break;
-        }
-        iter++;
-        kv_it_.reset();
-    } while (true);
-    return true;
+    }
+    return false;
 }
 
 const ::hybridse::codec::Row& FullTableIterator::GetValue() {
@@ -192,14 +172,17 @@ const ::hybridse::codec::Row& FullTableIterator::GetValue() {
 
 DistributeWindowIterator::DistributeWindowIterator(uint32_t tid, uint32_t pid_num, std::shared_ptr<Tables> tables,
         uint32_t index, const std::string& index_name,
-        const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients)
+        const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients,
+        const ::openmldb::codec::FilterList& filters)
     : tid_(tid), pid_num_(pid_num), tables_(tables), tablet_clients_(tablet_clients),
-    index_(index), index_name_(index_name),
+    index_(index), index_name_(index_name), filters_(filters),
     cur_pid_(0), it_(), kv_it_() {}
 
 void DistributeWindowIterator::Reset() {
     it_.reset();
     kv_it_.reset();
+    kv_it_from_seek_ = false;
+    prefetch_group_.reset();
     cur_pid_ = INVALID_PID;
     pk_cnt_ = 0;
 }
@@ -218,6 +201,7 @@ void DistributeWindowIterator::Seek(const std::string& key) {
         it_.reset(stat.it);
     } else if (stat.kv_it != nullptr) {
         kv_it_ = stat.kv_it;
+        kv_it_from_seek_ = true;
     } else {
         DLOG(INFO) << "no pos found for key " << key;
         return;
@@ -225,11 +209,22 @@ void DistributeWindowIterator::Seek(const std::string& key) {
     cur_pid_ = stat.pid;
 }
 
-DistributeWindowIterator::ItStat DistributeWindowIterator::SeekToFirstRemote() const {
+DistributeWindowIterator::KV_IT DistributeWindowIterator::NextRemotePage(uint32_t pid) {
+    if (!prefetch_group_) {
+        prefetch_group_ = std::make_unique<TraversePrefetchGroup>(tid_, index_name_, true, filters_, tablet_clients_);
+    }
+    while (auto it = prefetch_group_->NextPage(pid)) {
+        if (it->Valid()) {
+            return it;
+        }
+    }
+    return {};
+}
+
+DistributeWindowIterator::ItStat DistributeWindowIterator::SeekToFirstRemote() {
     for (const auto& kv : tablet_clients_) {
-        uint32_t count = 0;
-        auto it = kv.second->Traverse(tid_, kv.first, index_name_, "", 0, FLAGS_traverse_cnt_limit, false, 0, count);
-        if (it && it->Valid()) {
+        auto it = NextRemotePage(kv.first);
+        if (it) {
             DLOG(INFO) << "first pos in remote: pid=" << kv.first;
             return {kv.first, nullptr, it};
         }
@@ -288,10 +283,20 @@ DistributeWindowIterator::ItStat DistributeWindowIterator::SeekByKey(const std::
     auto client_iter = tablet_clients_.find(pid);
     if (client_iter != tablet_clients_.end()) {
         uint32_t count = 0;
-        auto it = client_iter->second->Traverse(tid_, pid, index_name_, key, UINT64_MAX,
-                FLAGS_traverse_cnt_limit, false, 0, count);
-        if (it != nullptr && it->Valid() && key == it->GetPK()) {
-            return {pid, {}, it};
+        uint64_t ts = UINT64_MAX;
+        uint32_t ts_pos = 0;
+        while (true) {
+            auto it = client_iter->second->Traverse(tid_, pid, index_name_, key, ts,
+                    FLAGS_traverse_cnt_limit, false, ts_pos, count, filters_);
+            if (it != nullptr && it->Valid() && key == it->GetPK()) {
+                return {pid, {}, it};
+            }
+            // all the rows of the page are filtered out, go on if the key is not passed yet
+            if (it == nullptr || it->Valid() || it->IsFinish() || it->GetLastPK() != key) {
+                break;
+            }
+            ts = it->GetLastTS();
+            ts_pos = it->GetTSPos();
         }
     }
 
@@ -342,28 +347,27 @@ void DistributeWindowIterator::Next() {
         if (iter == tablet_clients_.end()) {
             return;
         }
-        uint32_t count = 0;
-        kv_it_ = iter->second->Traverse(tid_, cur_pid_, index_name_, cur_pk, last_ts,
-                FLAGS_traverse_cnt_limit, true, ts_pos, count);
-        DLOG(INFO) << "pid " << cur_pid_ << " last pk " << cur_pk << " key " << last_ts << " count " << count;
-        if (kv_it_ && kv_it_->Valid()) {
+        if (kv_it_from_seek_ || !traverse_it) {
+            // continue the partition after the seeked page, the following pages are prefetched from now on
+            if (!prefetch_group_) {
+                prefetch_group_ =
+                    std::make_unique<TraversePrefetchGroup>(tid_, index_name_, true, filters_, tablet_clients_);
+            }
+            prefetch_group_->SeekPartition(cur_pid_, cur_pk, last_ts, ts_pos, true);
+            kv_it_from_seek_ = false;
+        }
+        kv_it_ = NextRemotePage(cur_pid_);
+        DLOG(INFO) << "pid " << cur_pid_ << " last pk " << cur_pk << " key " << last_ts;
+        if (kv_it_) {
             return;
         }
-        do {
-            iter++;
-            if (iter == tablet_clients_.end()) {
-                return;
-            }
+        for (iter++; iter != tablet_clients_.end(); iter++) {
             cur_pid_ = iter->first;
-            uint32_t count = 0;
-            kv_it_ =
-                iter->second->Traverse(tid_, cur_pid_, index_name_, "", 0, FLAGS_traverse_cnt_limit, false, 0, count);
-            DLOG(INFO) << "count " << count;
-            if (kv_it_ && kv_it_->Valid()) {
-                break;
+            kv_it_ = NextRemotePage(cur_pid_);
+            if (kv_it_) {
+                return;
             }
-            kv_it_.reset();
-        } while (true);
+        }
     } else {
         const auto& stat = SeekToFirstRemote();
         if (stat.kv_it) {
@@ -387,14 +391,26 @@ std::unique_ptr<::hybridse::codec::RowIterator> DistributeWindowIterator::GetVal
 
 ::hybridse::codec::RowIterator* DistributeWindowIterator::GetRawValue() {
     if (it_ && it_->Valid()) {
-        return it_->GetRawValue();
+        auto* it = it_->GetRawValue();
+        auto table_it = tables_->find(cur_pid_);
+        if (it == nullptr || table_it == tables_->end()) {
+            return it;
+        }
+        if (auto watermark = table_it->second->GetAggrWatermark(); watermark) {
+            auto key = it_->GetKey();
+            if (auto ts = watermark->Get(std::string(reinterpret_cast<const char*>(key.buf()), key.size())); ts) {
+                return new CompleteBucketIterator(it, watermark, ts.value());
+            }
+        }
+        return it;
     }
     auto traverse_it = std::dynamic_pointer_cast<openmldb::base::TraverseKvIterator>(kv_it_);
     if (traverse_it) {
         auto response = std::dynamic_pointer_cast<::openmldb::api::TraverseResponse>(traverse_it->GetResponse());
         auto new_traverse_it = std::make_shared<openmldb::base::TraverseKvIterator>(response);
         new_traverse_it->Seek(traverse_it->GetPK());
-        return new RemoteWindowIterator(tid_, cur_pid_, index_name_, new_traverse_it, tablet_clients_[cur_pid_]);
+        return new RemoteWindowIterator(tid_, cur_pid_, index_name_, new_traverse_it, tablet_clients_[cur_pid_],
+                                        filters_);
     } else {
         auto response = std::dynamic_pointer_cast<::openmldb::api::ScanResponse>(kv_it_->GetResponse());
         auto scan_it = std::make_shared<openmldb::base::ScanKvIterator>(kv_it_->GetPK(), response);
@@ -430,8 +446,8 @@ const ::hybridse::codec::Row& RemoteWindowIterator::GetValue() {
 
 RemoteWindowIterator::RemoteWindowIterator(uint32_t tid, uint32_t pid, const std::string& index_name,
         const std::shared_ptr<::openmldb::base::KvIterator>& kv_it,
-        const std::shared_ptr<openmldb::client::TabletClient>& client)
-    : tid_(tid), pid_(pid), index_name_(index_name), kv_it_(kv_it), tablet_client_(client),
+        const std::shared_ptr<openmldb::client::TabletClient>& client, const ::openmldb::codec::FilterList& filters)
+    : tid_(tid), pid_(pid), index_name_(index_name), kv_it_(kv_it), tablet_client_(client), filters_(filters),
         is_traverse_data_(false), ts_(0) {
     if (kv_it_ && kv_it_->Valid()) {
         pk_ = kv_it_->GetPK();
@@ -456,8 +472,17 @@ bool RemoteWindowIterator::Valid() const {
 
 void RemoteWindowIterator::ScanRemote(uint64_t key, uint32_t ts_pos) {
     uint32_t count = 0;
-    kv_it_ = tablet_client_->Traverse(tid_, pid_, index_name_, pk_, key,
-                FLAGS_traverse_cnt_limit, false, ts_pos, count);
+    while (true) {
+        auto traverse_it = tablet_client_->Traverse(tid_, pid_, index_name_, pk_, key,
+                FLAGS_traverse_cnt_limit, false, ts_pos, count, filters_);
+        kv_it_ = traverse_it;
+        // all the rows of the page are filtered out, go on if the key is not passed yet
+        if (!traverse_it || traverse_it->Valid() || traverse_it->IsFinish() || traverse_it->GetLastPK() != pk_) {
+            break;
+        }
+        key = traverse_it->GetLastTS();
+        ts_pos = traverse_it->GetTSPos();
+    }
     DLOG(INFO) << "traverse key " << pk_ << " ts " << key << " from remote. tid "
         << tid_ << " pid " << pid_ << " ts_pos " << ts_pos;
     if (kv_it_ && kv_it_->Valid()) {
@@ -497,6 +522,10 @@ void RemoteWindowIterator::Next() {
         ts_ = kv_it_->GetKey();
     } else {
         auto traverse_it = std::dynamic_pointer_cast<openmldb::base::TraverseKvIterator>(kv_it_);
+        if (!traverse_it || traverse_it->IsFinish() || traverse_it->GetLastPK() != pk_) {
+            // no more records of the key on the remote partition
+            return;
+        }
         ScanRemote(traverse_it->GetLastTS(), traverse_it->GetTSPos());
     }
 }
@@ -24,7 +24,10 @@
 
 #include "base/hash.h"
 #include "base/kv_iterator.h"
+#include "catalog/traverse_prefetcher.h"
 #include "client/tablet_client.h"
+#include "codec/codec.h"
+#include "storage/aggr_watermark.h"
 #include "storage/table.h"
 #include "vm/catalog.h"
 
@@ -35,8 +38,10 @@ using Tables = std::map<uint32_t, std::shared_ptr<::openmldb::storage::Table>>;
 
 class FullTableIterator : public ::hybridse::codec::ConstIterator<uint64_t, ::hybridse::codec::Row> {
  public:
+    // the remote partitions only send the rows matching `filters`, the local rows are not filtered
     FullTableIterator(uint32_t tid, std::shared_ptr<Tables> tables,
-            const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients);
+            const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients,
+            const ::openmldb::codec::FilterList& filters = {});
     void Seek(const uint64_t& ts) override {
         LOG(ERROR) << "Unsupport Seek in FullTableIterator";
     }
@@ -66,13 +71,14 @@ class FullTableIterator : public ::hybridse::codec::ConstIterator<uint64_t, ::hy
     uint32_t tid_;
     std::shared_ptr<Tables> tables_;
     std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients_;
+    ::openmldb::codec::FilterList filters_;
     bool in_local_;
     uint32_t cur_pid_;
     std::unique_ptr<::openmldb::storage::TableIterator> it_;
     std::shared_ptr<::openmldb::base::TraverseKvIterator> kv_it_;
+    // pages of the remote partitions, created when the local partitions are done
+    std::unique_ptr<TraversePrefetchGroup> prefetch_group_;
     uint64_t key_;
-    uint64_t last_ts_;
-    std::string last_pk_;
     ::hybridse::codec::Row value_;
     // use an extra flag to indicate whether the `value_` contains a valid value
     // the logic is:
@@ -89,7 +95,8 @@ class RemoteWindowIterator : public ::hybridse::vm::RowIterator {
  public:
     RemoteWindowIterator(uint32_t tid, uint32_t pid, const std::string& index_name,
             const std::shared_ptr<::openmldb::base::KvIterator>& kv_it,
-            const std::shared_ptr<openmldb::client::TabletClient>& client);
+            const std::shared_ptr<openmldb::client::TabletClient>& client,
+            const ::openmldb::codec::FilterList& filters = {});
 
     bool Valid() const override;
 
@@ -125,6 +132,7 @@ class RemoteWindowIterator : public ::hybridse::vm::RowIterator {
     std::string index_name_;
     std::shared_ptr<::openmldb::base::KvIterator> kv_it_;
     std::shared_ptr<openmldb::client::TabletClient> tablet_client_;
+    ::openmldb::codec::FilterList filters_;
     ::hybridse::codec::Row row_;
     // use an extra flag to indicate whether the `row_` contains a valid value
     // the logic is:
@@ -138,11 +146,60 @@ class RemoteWindowIterator : public ::hybridse::vm::RowIterator {
     mutable uint64_t ts_;
 };
 
+// the buckets of a key in a pre-aggr table which end before the watermark of the key, the others may miss the rows
+// which are not applied by the aggregator yet. The queries read the raw rows of the base table after them instead
+class CompleteBucketIterator : public ::hybridse::vm::RowIterator {
+ public:
+    CompleteBucketIterator(::hybridse::vm::RowIterator* it,
+                           const std::shared_ptr<::openmldb::storage::AggrWatermark>& watermark, int64_t ts)
+        : it_(it), watermark_(watermark), ts_(ts) {
+        SkipIncomplete();
+    }
+
+    bool Valid() const override { return it_->Valid(); }
+
+    void Next() override {
+        it_->Next();
+        SkipIncomplete();
+    }
+
+    const uint64_t& GetKey() const override { return it_->GetKey(); }
+
+    const ::hybridse::codec::Row& GetValue() override { return it_->GetValue(); }
+
+    void Seek(const uint64_t& key) override {
+        it_->Seek(key);
+        SkipIncomplete();
+    }
+
+    void SeekToFirst() override {
+        it_->SeekToFirst();
+        SkipIncomplete();
+    }
+
+    bool IsSeekable() const override { return it_->IsSeekable(); }
+
+ private:
+    void SkipIncomplete() {
+        while (it_->Valid() && !watermark_->IsComplete(it_->GetValue().buf(), ts_)) {
+            it_->Next();
+        }
+    }
+
+ private:
+    std::unique_ptr<::hybridse::vm::RowIterator> it_;
+    std::shared_ptr<::openmldb::storage::AggrWatermark> watermark_;
+    int64_t ts_;
+};
+
 class DistributeWindowIterator : public ::hybridse::codec::WindowIterator {
  public:
+    // the remote partitions only send the rows matching `filters`, so a remote key is skipped if none of its rows
+    // matches. The local rows are not filtered
     DistributeWindowIterator(uint32_t tid, uint32_t pid_num, std::shared_ptr<Tables> tables,
             uint32_t index, const std::string& index_name,
-            const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients);
+            const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients,
+            const ::openmldb::codec::FilterList& filters = {});
     void Seek(const std::string& key) override;
     void SeekToFirst() override;
     void Next() override;
@@ -170,7 +227,10 @@ class DistributeWindowIterator : public ::hybridse::codec::WindowIterator {
 
     ItStat SeekByKey(const std::string& key) const;
 
-    ItStat SeekToFirstRemote() const;
+    ItStat SeekToFirstRemote();
+
+    // the next non-empty page of the remote partition `pid`, nullptr if the partition has no more keys
+    KV_IT NextRemotePage(uint32_t pid);
 
  private:
     const uint32_t tid_;
@@ -179,12 +239,16 @@ class DistributeWindowIterator : public ::hybridse::codec::WindowIterator {
     std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients_;
     const uint32_t index_;
     const std::string index_name_;
+    const ::openmldb::codec::FilterList filters_;
 
     uint32_t cur_pid_;
     // iterator to locally data
     IT it_;
     // iterator to remote data, only zero or one of `it_` and `kv_it_` can be non-null
     KV_IT kv_it_;
+    // `kv_it_` is fetched by `Seek` directly, the following pages of the partition are not prefetched yet
+    bool kv_it_from_seek_ = false;
+    std::unique_ptr<TraversePrefetchGroup> prefetch_group_;
     int64_t pk_cnt_ = 0;
 };
 
@@ -16,10 +16,13 @@
 
 #include "catalog/distribute_iterator.h"
 
+#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <utility>
 
+#include "catalog/tablet_catalog.h"
 #include "client/tablet_client.h"
 #include "codec/sdk_codec.h"
 #include "common/timer.h"
@@ -34,6 +37,9 @@ DECLARE_string(db_root_path);
 DECLARE_uint32(traverse_cnt_limit);
 DECLARE_uint32(max_traverse_cnt);
 DECLARE_uint32(max_traverse_key_cnt);
+DECLARE_uint32(traverse_prefetch_depth);
+DECLARE_uint32(traverse_prefetch_partition_num);
+DECLARE_uint64(traverse_prefetch_max_bytes);
 
 namespace openmldb {
 namespace catalog {
@@ -449,6 +455,92 @@ TEST_F(DistributeIteratorTest, WindowIterator) {
     ASSERT_EQ(count, 10);
 }
 
+TEST_F(DistributeIteratorTest, TraverseWithFilter) {
+    uint32_t old_limit = FLAGS_traverse_cnt_limit;
+    FLAGS_traverse_cnt_limit = 3;
+    uint32_t tid = 3;
+    ::openmldb::test::TempPath tmp_path;
+    FLAGS_db_root_path = tmp_path.GetTempPath();
+    auto tables = std::make_shared<Tables>();
+    tables->emplace(0, CreateTable(tid, 0));
+    tables->emplace(2, CreateTable(tid, 2));
+    std::vector<std::string> endpoints = {"127.0.0.1:9230", "127.0.0.1:9231"};
+    brpc::Server tablet1;
+    ASSERT_TRUE(::openmldb::test::StartTablet(endpoints[0], &tablet1));
+    brpc::Server tablet2;
+    ASSERT_TRUE(::openmldb::test::StartTablet(endpoints[1], &tablet2));
+    auto client1 = std::make_shared<openmldb::client::TabletClient>(endpoints[0], endpoints[0]);
+    ASSERT_EQ(client1->Init(), 0);
+    auto client2 = std::make_shared<openmldb::client::TabletClient>(endpoints[1], endpoints[1]);
+    ASSERT_EQ(client2->Init(), 0);
+    std::vector<::openmldb::api::TableMeta> metas = {CreateTableMeta(tid, 1), CreateTableMeta(tid, 3)};
+    ASSERT_TRUE(client1->CreateTable(metas[0]).OK());
+    ASSERT_TRUE(client2->CreateTable(metas[1]).OK());
+    std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients = {{1, client1}, {3, client2}};
+    int local_keys = 0;
+    for (int i = 0; i < 20; i++) {
+        std::string key = "card" + std::to_string(i);
+        uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(key)) % 4;
+        if (pid % 2 == 0) {
+            PutKey(key, (*tables)[pid]);
+            local_keys++;
+        } else {
+            PutKey(key, metas[pid == 1 ? 0 : 1], tablet_clients[pid]);
+        }
+    }
+    int remote_keys = 20 - local_keys;
+    // ts >= 9, the remote partitions only send the last 2 rows of each key
+    ::openmldb::codec::FilterList filters;
+    auto filter = filters.Add();
+    filter->set_col_idx(2);
+    filter->set_op(::openmldb::common::kCmpGe);
+    filter->set_value("9");
+    FullTableIterator it(tid, tables, tablet_clients, filters);
+    it.SeekToFirst();
+    int count = 0;
+    while (it.Valid()) {
+        count++;
+        it.Next();
+    }
+    ASSERT_EQ(local_keys * 10 + remote_keys * 2, count);
+
+    DistributeWindowIterator w_it(tid, 4, tables, 0, "card", tablet_clients, filters);
+    for (int i = 0; i < 20; i++) {
+        std::string key = "card" + std::to_string(i);
+        uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(key)) % 4;
+        w_it.Seek(key);
+        ASSERT_TRUE(w_it.Valid());
+        ASSERT_EQ(w_it.GetKey().ToString(), key);
+        auto row_it = w_it.GetValue();
+        row_it->SeekToFirst();
+        count = 0;
+        while (row_it->Valid()) {
+            count++;
+            row_it->Next();
+        }
+        ASSERT_EQ(pid % 2 == 0 ? 10 : 2, count) << key;
+    }
+    count = 0;
+    w_it.SeekToFirst();
+    while (w_it.Valid()) {
+        count++;
+        w_it.Next();
+    }
+    ASSERT_EQ(20, count);
+
+    // the remote keys without any matched row are skipped
+    filter->set_value("100");
+    DistributeWindowIterator empty_it(tid, 4, tables, 0, "card", tablet_clients, filters);
+    count = 0;
+    empty_it.SeekToFirst();
+    while (empty_it.Valid()) {
+        count++;
+        empty_it.Next();
+    }
+    ASSERT_EQ(local_keys, count);
+    FLAGS_traverse_cnt_limit = old_limit;
+}
+
 TEST_F(DistributeIteratorTest, RemoteIterator) {
     uint32_t old_limit = FLAGS_traverse_cnt_limit;
     FLAGS_traverse_cnt_limit = 7;
@@ -784,6 +876,76 @@ TEST_F(DistributeIteratorTest, TraverseSameTs) {
     FLAGS_traverse_cnt_limit = old_limit;
 }
 
+TEST_F(DistributeIteratorTest, PrefetchTraverse) {
+    uint32_t old_limit = FLAGS_traverse_cnt_limit;
+    uint32_t old_depth = FLAGS_traverse_prefetch_depth;
+    uint32_t old_partition_num = FLAGS_traverse_prefetch_partition_num;
+    uint64_t old_max_bytes = FLAGS_traverse_prefetch_max_bytes;
+    FLAGS_traverse_cnt_limit = 7;
+    uint32_t tid = 3;
+    ::openmldb::test::TempPath tmp_path;
+    FLAGS_db_root_path = tmp_path.GetTempPath();
+    auto tables = std::make_shared<Tables>();
+    std::vector<std::string> endpoints = {"127.0.0.1:9230", "127.0.0.1:9231"};
+    brpc::Server tablet1;
+    ASSERT_TRUE(::openmldb::test::StartTablet(endpoints[0], &tablet1));
+    brpc::Server tablet2;
+    ASSERT_TRUE(::openmldb::test::StartTablet(endpoints[1], &tablet2));
+    auto client1 = std::make_shared<openmldb::client::TabletClient>(endpoints[0], endpoints[0]);
+    ASSERT_EQ(client1->Init(), 0);
+    auto client2 = std::make_shared<openmldb::client::TabletClient>(endpoints[1], endpoints[1]);
+    ASSERT_EQ(client2->Init(), 0);
+    // all partitions are remote
+    std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients = {
+        {0, client1}, {1, client2}, {2, client1}, {3, client2}};
+    std::map<uint32_t, ::openmldb::api::TableMeta> metas;
+    for (const auto& kv : tablet_clients) {
+        metas.emplace(kv.first, CreateTableMeta(tid, kv.first));
+        ASSERT_TRUE(kv.second->CreateTable(metas[kv.first]).OK());
+    }
+    for (int i = 0; i < 100; i++) {
+        std::string key = "card" + std::to_string(i);
+        uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(key)) % 4;
+        PutKey(key, metas[pid], tablet_clients[pid]);
+    }
+    // depth 0 fetches pages on demand, a tiny budget stops prefetching but the consumer still makes progress
+    std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> options = {
+        {0, 1, 64 << 20}, {2, 1, 64 << 20}, {2, 4, 64 << 20}, {8, 4, 64 << 20}, {8, 4, 1}};
+    for (const auto& [depth, partition_num, max_bytes] : options) {
+        FLAGS_traverse_prefetch_depth = depth;
+        FLAGS_traverse_prefetch_partition_num = partition_num;
+        FLAGS_traverse_prefetch_max_bytes = max_bytes;
+        FullTableIterator it(tid, tables, tablet_clients);
+        for (int round = 0; round < 2; round++) {
+            it.SeekToFirst();
+            int count = 0;
+            while (it.Valid()) {
+                count++;
+                it.Next();
+            }
+            ASSERT_EQ(count, 1000) << "depth " << depth << " partition num " << partition_num;
+        }
+        DistributeWindowIterator w_it(tid, 4, tables, 0, "card", tablet_clients);
+        w_it.SeekToFirst();
+        std::set<std::string> keys;
+        while (w_it.Valid()) {
+            keys.insert(w_it.GetKey().ToString());
+            w_it.Next();
+        }
+        ASSERT_EQ(keys.size(), 100u) << "depth " << depth << " partition num " << partition_num;
+        // stop in the middle, the prefetched pages are dropped
+        FullTableIterator it2(tid, tables, tablet_clients);
+        it2.SeekToFirst();
+        for (int i = 0; i < 10 && it2.Valid(); i++) {
+            it2.Next();
+        }
+    }
+    FLAGS_traverse_cnt_limit = old_limit;
+    FLAGS_traverse_prefetch_depth = old_depth;
+    FLAGS_traverse_prefetch_partition_num = old_partition_num;
+    FLAGS_traverse_prefetch_max_bytes = old_max_bytes;
+}
+
 TEST_F(DistributeIteratorTest, WindowIteratorLimit) {
     uint32_t old_max_pk_cnt = FLAGS_max_traverse_key_cnt;
     uint32_t tid = 3;
@@ -1006,6 +1168,97 @@ TEST_F(DistributeIteratorTest, IteratorZero) {
     FLAGS_traverse_cnt_limit = old_limit;
 }
 
+TEST_F(DistributeIteratorTest, RemoteSegments) {
+    uint32_t tid = 3;
+    ::openmldb::test::TempPath tmp_path;
+    FLAGS_db_root_path = tmp_path.GetTempPath();
+    std::vector<std::string> endpoints = {"127.0.0.1:9230"};
+    brpc::Server tablet1;
+    ASSERT_TRUE(::openmldb::test::StartTablet(endpoints[0], &tablet1));
+    auto client1 = std::make_shared<openmldb::client::TabletClient>(endpoints[0], endpoints[0]);
+    ASSERT_EQ(client1->Init(), 0);
+    // pid 0 is local and pid 1 is on tablet1
+    auto table_meta = CreateTableMeta(tid, 1);
+    ASSERT_TRUE(client1->CreateTable(table_meta).OK());
+    auto local_table = CreateTable(tid, 0);
+    ::openmldb::nameserver::TableInfo table_info;
+    table_info.set_db(table_meta.db());
+    table_info.set_name(table_meta.name());
+    table_info.set_tid(tid);
+    table_info.mutable_column_desc()->CopyFrom(table_meta.column_desc());
+    table_info.mutable_column_key()->CopyFrom(table_meta.column_key());
+    for (uint32_t pid = 0; pid < 2; pid++) {
+        auto partition = table_info.add_table_partition();
+        partition->set_pid(pid);
+        auto meta = partition->add_partition_meta();
+        meta->set_endpoint(pid == 0 ? "127.0.0.1:9229" : endpoints[0]);
+        meta->set_is_leader(true);
+        meta->set_is_alive(true);
+    }
+    ClientManager client_manager;
+    client_manager.UpdateClient(
+        std::map<std::string, std::shared_ptr<openmldb::client::TabletClient>>{{endpoints[0], client1}});
+    auto handler = std::make_shared<TabletTableHandler>(table_info, std::shared_ptr<hybridse::vm::Tablet>());
+    ASSERT_TRUE(handler->Init(client_manager));
+    handler->AddTable(local_table);
+
+    std::vector<std::string> local_keys;
+    std::vector<std::string> remote_keys;
+    for (int i = 0; local_keys.size() < 2 || remote_keys.size() < 2; i++) {
+        std::string key = "card" + std::to_string(i);
+        if (::openmldb::base::hash64(key) % 2 == 0) {
+            PutKey(key, local_table, 5);
+            local_keys.push_back(key);
+        } else {
+            PutKey(key, table_meta, client1, 5 + i);
+            remote_keys.push_back(key);
+        }
+    }
+    std::string remote_not_exist;
+    for (int i = 0; remote_not_exist.empty(); i++) {
+        std::string key = "not_exist" + std::to_string(i);
+        if (::openmldb::base::hash64(key) % 2 == 1) {
+            remote_not_exist = key;
+        }
+    }
+    // the remote keys of one partition are fetched by a single MultiKeyTraverse
+    std::vector<std::string> keys = {remote_keys[0], local_keys[0], remote_keys[1], remote_not_exist,
+                                     remote_keys[0], local_keys[1]};
+    auto partition = handler->GetPartition("card");
+    ASSERT_TRUE(partition);
+    auto segments = partition->GetSegments(keys);
+    ASSERT_EQ(keys.size(), segments.size());
+    for (size_t idx = 0; idx < keys.size(); idx++) {
+        ASSERT_TRUE(segments[idx]);
+        auto iter = segments[idx]->GetIterator();
+        int count = 0;
+        if (iter) {
+            iter->SeekToFirst();
+            uint64_t last_ts = UINT64_MAX;
+            while (iter->Valid()) {
+                codec::RowView row_view(table_meta.column_desc(),
+                                        iter->GetValue().buf(), iter->GetValue().size());
+                std::string card;
+                row_view.GetStrValue(0, &card);
+                ASSERT_EQ(keys[idx], card);
+                ASSERT_LT(iter->GetKey(), last_ts);
+                last_ts = iter->GetKey();
+                count++;
+                iter->Next();
+            }
+        }
+        int expect = 0;
+        if (keys[idx] == remote_not_exist) {
+            expect = 0;
+        } else if (::openmldb::base::hash64(keys[idx]) % 2 == 0) {
+            expect = 5;
+        } else {
+            expect = 5 + std::stoi(keys[idx].substr(4));
+        }
+        ASSERT_EQ(expect, count) << keys[idx];
+    }
+}
+
 }  // namespace catalog
 }  // namespace openmldb
 
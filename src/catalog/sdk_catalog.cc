@@ -135,38 +135,60 @@ bool SDKTableHandler::GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* ta
 }
 
 bool SDKCatalog::Init(const std::vector<::openmldb::nameserver::TableInfo>& tables, const Procedures& db_sp_map) {
-    for (size_t i = 0; i < tables.size(); i++) {
-        const ::openmldb::nameserver::TableInfo& table_meta = tables[i];
-        std::shared_ptr<SDKTableHandler> table = std::make_shared<SDKTableHandler>(table_meta, *client_manager_);
-        if (!table->Init()) {
-            LOG(WARNING) << "fail to init table " << table_meta.name();
+    for (const auto& table_meta : tables) {
+        if (!AddTable(table_meta)) {
             return false;
         }
-        auto db_it = tables_.find(table->GetDatabase());
-        if (db_it == tables_.end()) {
-            auto result_pair = tables_.insert(
-                std::make_pair(table->GetDatabase(), std::map<std::string, std::shared_ptr<SDKTableHandler>>()));
-            db_it = result_pair.first;
+    }
+    db_sp_map_ = db_sp_map;
+    return true;
+}
+
+bool SDKCatalog::Init(const std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>>& tables,
+                      const Procedures& db_sp_map, const SDKCatalog* base, const std::set<uint32_t>& changed_tids) {
+    for (const auto& table_meta : tables) {
+        if (base != nullptr && changed_tids.count(table_meta->tid()) == 0) {
+            auto table = base->FindTable(table_meta->db(), table_meta->name());
+            if (table && table->GetTid() == table_meta->tid()) {
+                tables_[table->GetDatabase()].emplace(table->GetName(), table);
+                continue;
+            }
+        }
+        if (!AddTable(*table_meta)) {
+            return false;
         }
-        db_it->second.insert(std::make_pair(table->GetName(), table));
     }
     db_sp_map_ = db_sp_map;
     return true;
 }
 
-std::shared_ptr<::hybridse::vm::TableHandler> SDKCatalog::GetTable(const std::string& db,
-                                                                   const std::string& table_name) {
+bool SDKCatalog::AddTable(const ::openmldb::nameserver::TableInfo& table_meta) {
+    std::shared_ptr<SDKTableHandler> table = std::make_shared<SDKTableHandler>(table_meta, *client_manager_);
+    if (!table->Init()) {
+        LOG(WARNING) << "fail to init table " << table_meta.name();
+        return false;
+    }
+    tables_[table->GetDatabase()].emplace(table->GetName(), table);
+    return true;
+}
+
+std::shared_ptr<SDKTableHandler> SDKCatalog::FindTable(const std::string& db, const std::string& table_name) const {
     auto db_it = tables_.find(db);
     if (db_it == tables_.end()) {
-        return std::shared_ptr<::hybridse::vm::TableHandler>();
+        return {};
     }
     auto it = db_it->second.find(table_name);
     if (it == db_it->second.end()) {
-        return std::shared_ptr<::hybridse::vm::TableHandler>();
+        return {};
     }
     return it->second;
 }
 
+std::shared_ptr<::hybridse::vm::TableHandler> SDKCatalog::GetTable(const std::string& db,
+                                                                   const std::string& table_name) {
+    return FindTable(db, table_name);
+}
+
 std::shared_ptr<TabletAccessor> SDKCatalog::GetTablet() const { return client_manager_->GetTablet(); }
 
 std::vector<std::shared_ptr<TabletAccessor>> SDKCatalog::GetAllTablet() const {
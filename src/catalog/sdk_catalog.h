@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <mutex> // NOLINT
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -121,6 +122,10 @@ class SDKCatalog : public ::hybridse::vm::Catalog {
 
     bool Init(const std::vector<::openmldb::nameserver::TableInfo>& tables, const Procedures& db_sp_map);
 
+    // the handlers of `base` are shared if the table is not in `changed_tids`, build all if `base` is null
+    bool Init(const std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>>& tables,
+              const Procedures& db_sp_map, const SDKCatalog* base, const std::set<uint32_t>& changed_tids);
+
     std::shared_ptr<::hybridse::type::Database> GetDatabase(const std::string& db) override {
         return std::shared_ptr<::hybridse::type::Database>();
     }
@@ -140,6 +145,9 @@ class SDKCatalog : public ::hybridse::vm::Catalog {
     const Procedures& GetProcedures() { return db_sp_map_; }
 
  private:
+    bool AddTable(const ::openmldb::nameserver::TableInfo& table_meta);
+    std::shared_ptr<SDKTableHandler> FindTable(const std::string& db, const std::string& table_name) const;
+
     SDKTables tables_;
     SDKDB db_;
     std::shared_ptr<ClientManager> client_manager_;
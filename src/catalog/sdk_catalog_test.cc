@@ -73,6 +73,31 @@ TEST_F(SDKCatalogTest, SdkSmokeTest) {
     std::cout << ss.str() << std::endl;*/
 }
 
+TEST_F(SDKCatalogTest, InitFromBase) {
+    std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>> tables;
+    for (uint32_t tid = 1; tid <= 3; tid++) {
+        TestArgs* args = PrepareTable("t" + std::to_string(tid), "db1");
+        args->meta.set_tid(tid);
+        tables.push_back(std::make_shared<::openmldb::nameserver::TableInfo>(args->meta));
+        delete args;
+    }
+    auto client_manager = std::make_shared<ClientManager>();
+    Procedures procedures;
+    auto base = std::make_shared<SDKCatalog>(client_manager);
+    ASSERT_TRUE(base->Init(tables, procedures, nullptr, {}));
+
+    // t2 is changed, t3 is dropped and created again with a new tid
+    tables[1]->mutable_column_desc(0)->set_name("col0");
+    tables[2]->set_tid(4);
+    auto catalog = std::make_shared<SDKCatalog>(client_manager);
+    ASSERT_TRUE(catalog->Init(tables, procedures, base.get(), {2}));
+    ASSERT_EQ(base->GetTable("db1", "t1"), catalog->GetTable("db1", "t1"));
+    ASSERT_NE(base->GetTable("db1", "t2"), catalog->GetTable("db1", "t2"));
+    ASSERT_EQ("col0", catalog->GetTable("db1", "t2")->GetSchema()->Get(0).name());
+    ASSERT_NE(base->GetTable("db1", "t3"), catalog->GetTable("db1", "t3"));
+    ASSERT_EQ(4u, std::dynamic_pointer_cast<SDKTableHandler>(catalog->GetTable("db1", "t3"))->GetTid());
+}
+
 TEST_F(SDKCatalogTest, SdkWindowSmokeTest) {
     TestArgs* args = PrepareTable("t1", "db1");
     std::vector<::openmldb::nameserver::TableInfo> tables;
@@ -20,15 +20,21 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
+#include "base/hash.h"
 #include "catalog/distribute_iterator.h"
 #include "codec/list_iterator_codec.h"
 #include "glog/logging.h"
 #include "schema/index_util.h"
 #include "schema/schema_adapter.h"
+#include "storage/mem_table.h"
 
 DECLARE_bool(enable_localtablet);
+DECLARE_int32(request_timeout_ms);
+DECLARE_uint32(traverse_cnt_limit);
 namespace openmldb {
 namespace catalog {
 
@@ -131,6 +137,11 @@ std::unique_ptr<::hybridse::codec::RowIterator> TabletTableHandler::GetIterator(
 }
 
 std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindowIterator(const std::string& idx_name) {
+    return GetWindowIterator(idx_name, ::openmldb::codec::FilterList());
+}
+
+std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindowIterator(
+    const std::string& idx_name, const ::openmldb::codec::FilterList& filters) {
     const auto& index_hint = GetIndex();
     auto iter = index_hint.find(idx_name);
     if (iter == index_hint.end()) {
@@ -154,7 +165,7 @@ std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindow
     }
     DLOG(INFO) << "table size " << tables->size() << " tablet_clients size " << tablet_clients.size();
     return std::make_unique<DistributeWindowIterator>(GetTid(), partition_num_, tables,
-            iter->second.index, idx_name, tablet_clients);
+            iter->second.index, idx_name, tablet_clients, filters);
 }
 
 // TODO(chenjing): optimize Get(int pos) base segment
@@ -167,6 +178,10 @@ const ::hybridse::codec::Row TabletTableHandler::Get(int32_t pos) {
 }
 
 ::hybridse::codec::RowIterator* TabletTableHandler::GetRawIterator() {
+    return GetRawIterator(::openmldb::codec::FilterList());
+}
+
+::hybridse::codec::RowIterator* TabletTableHandler::GetRawIterator(const ::openmldb::codec::FilterList& filters) {
     auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
     std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients;
     for (uint32_t pid = 0; pid < partition_num_; pid++) {
@@ -178,7 +193,7 @@ const ::hybridse::codec::Row TabletTableHandler::Get(int32_t pos) {
         }
     }
     DLOG(INFO) << "table size " << tables->size() << " tablet_clients size " << tablet_clients.size();
-    return new catalog::FullTableIterator(GetTid(), tables, tablet_clients);
+    return new catalog::FullTableIterator(GetTid(), tables, tablet_clients, filters);
 }
 
 const uint64_t TabletTableHandler::GetCount() {
@@ -207,6 +222,166 @@ std::shared_ptr<::hybridse::vm::PartitionHandler> TabletTableHandler::GetPartiti
     return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name);
 }
 
+std::shared_ptr<::hybridse::vm::TableHandler> TabletTableHandler::PushDownFilter(
+    const std::vector<::hybridse::vm::ColumnFilter>& filters) {
+    ::openmldb::codec::FilterList conditions;
+    for (const auto& filter : filters) {
+        auto condition = conditions.Add();
+        condition->set_col_idx(filter.col_idx);
+        switch (filter.op) {
+            case ::hybridse::vm::ColumnFilter::kCmpEq:
+                condition->set_op(::openmldb::common::kCmpEq);
+                break;
+            case ::hybridse::vm::ColumnFilter::kCmpNe:
+                condition->set_op(::openmldb::common::kCmpNe);
+                break;
+            case ::hybridse::vm::ColumnFilter::kCmpLt:
+                condition->set_op(::openmldb::common::kCmpLt);
+                break;
+            case ::hybridse::vm::ColumnFilter::kCmpLe:
+                condition->set_op(::openmldb::common::kCmpLe);
+                break;
+            case ::hybridse::vm::ColumnFilter::kCmpGt:
+                condition->set_op(::openmldb::common::kCmpGt);
+                break;
+            case ::hybridse::vm::ColumnFilter::kCmpGe:
+                condition->set_op(::openmldb::common::kCmpGe);
+                break;
+            default:
+                return {};
+        }
+        condition->set_value(filter.value);
+    }
+    if (conditions.empty()) {
+        return {};
+    }
+    return std::make_shared<TabletFilterTableHandler>(
+        std::dynamic_pointer_cast<TabletTableHandler>(shared_from_this()), conditions);
+}
+
+const uint64_t TabletFilterTableHandler::GetCount() {
+    auto iter = GetIterator();
+    uint64_t cnt = 0;
+    while (iter->Valid()) {
+        iter->Next();
+        cnt++;
+    }
+    return cnt;
+}
+
+::hybridse::codec::Row TabletFilterTableHandler::At(uint64_t pos) {
+    auto iter = GetIterator();
+    while (pos-- > 0 && iter->Valid()) {
+        iter->Next();
+    }
+    return iter->Valid() ? iter->GetValue() : ::hybridse::codec::Row();
+}
+
+std::shared_ptr<::hybridse::vm::PartitionHandler> TabletFilterTableHandler::GetPartition(
+    const std::string& index_name) {
+    if (GetIndex().count(index_name) == 0) {
+        LOG(WARNING) << "fail to get partition for tablet filter table handler, index name " << index_name;
+        return std::shared_ptr<::hybridse::vm::PartitionHandler>();
+    }
+    return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name);
+}
+
+std::vector<std::shared_ptr<RemoteWindow>> TabletTableHandler::GetRemoteWindows(const std::string& index_name,
+                                                                              const std::vector<std::string>& keys) {
+    std::vector<std::shared_ptr<RemoteWindow>> windows(keys.size());
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (!tables || partition_num_ == 0) {
+        return windows;
+    }
+    // pid -> key -> the positions of the key in `keys`, the same key is fetched only once
+    std::map<uint32_t, std::map<std::string, std::vector<size_t>>> remote_keys;
+    for (size_t idx = 0; idx < keys.size(); idx++) {
+        uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(keys[idx]) % partition_num_);
+        if (tables->count(pid) > 0) {
+            continue;
+        }
+        remote_keys[pid][keys[idx]].push_back(idx);
+    }
+    using Callback = openmldb::RpcCallback<::openmldb::api::MultiKeyTraverseResponse>;
+    std::vector<std::tuple<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>, Callback*>> calls;
+    for (const auto& kv : remote_keys) {
+        uint32_t pid = kv.first;
+        auto accessor = table_client_manager_->GetTablet(pid);
+        auto client = accessor ? accessor->GetClient() : nullptr;
+        if (!client) {
+            LOG(WARNING) << "no client for remote partition. tid " << GetTid() << " pid " << pid;
+            continue;
+        }
+        ::openmldb::api::MultiKeyTraverseRequest request;
+        request.set_tid(GetTid());
+        request.set_pid(pid);
+        request.set_idx_name(index_name);
+        request.set_limit(FLAGS_traverse_cnt_limit);
+        for (const auto& key_pos : kv.second) {
+            request.add_pk(key_pos.first);
+        }
+        auto callback = new Callback(std::make_shared<::openmldb::api::MultiKeyTraverseResponse>(),
+                                     std::make_shared<brpc::Controller>());
+        callback->GetController()->set_timeout_ms(FLAGS_request_timeout_ms);
+        // keep the callback until the response is read
+        callback->Ref();
+        if (!client->AsyncMultiKeyTraverse(request, callback)) {
+            LOG(WARNING) << "fail to send multi key traverse request. tid " << GetTid() << " pid " << pid;
+            callback->UnRef();
+            callback->UnRef();
+            continue;
+        }
+        calls.emplace_back(pid, client, callback);
+    }
+    for (const auto& [pid, client, callback] : calls) {
+        brpc::Join(callback->GetController()->call_id());
+        auto response = callback->GetResponse();
+        if (callback->GetController()->Failed() || response->code() != 0 ||
+            response->windows_size() != static_cast<int>(remote_keys[pid].size())) {
+            LOG(WARNING) << "fail to fetch windows. tid " << GetTid() << " pid " << pid << " "
+                         << (callback->GetController()->Failed() ? callback->GetController()->ErrorText()
+                                                                 : response->msg());
+            callback->UnRef();
+            continue;
+        }
+        int window_idx = 0;
+        for (const auto& key_pos : remote_keys[pid]) {
+            auto window = std::make_shared<RemoteWindow>();
+            window->tid = GetTid();
+            window->pid = pid;
+            window->index_name = index_name;
+            window->client = client;
+            // share the ownership of the whole response
+            window->response = std::shared_ptr<::openmldb::api::TraverseResponse>(
+                response, response->mutable_windows(window_idx++));
+            for (size_t pos : key_pos.second) {
+                windows[pos] = window;
+            }
+        }
+        callback->UnRef();
+    }
+    return windows;
+}
+
+std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> TabletPartitionHandler::GetSegments(
+    const std::vector<std::string>& keys) {
+    auto table_handler = std::dynamic_pointer_cast<TabletTableHandler>(table_handler_);
+    if (!table_handler) {
+        return PartitionHandler::GetSegments(keys);
+    }
+    auto windows = table_handler->GetRemoteWindows(index_name_, keys);
+    std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> segments;
+    segments.reserve(keys.size());
+    for (size_t idx = 0; idx < keys.size(); idx++) {
+        if (windows[idx]) {
+            segments.push_back(std::make_shared<RemoteSegmentHandler>(shared_from_this(), keys[idx], windows[idx]));
+        } else {
+            segments.push_back(GetSegment(keys[idx]));
+        }
+    }
+    return segments;
+}
+
 void TabletTableHandler::AddTable(std::shared_ptr<::openmldb::storage::Table> table) {
     std::shared_ptr<Tables> old_tables;
     std::shared_ptr<Tables> new_tables;
@@ -217,6 +392,33 @@ void TabletTableHandler::AddTable(std::shared_ptr<::openmldb::storage::Table> ta
     } while (!atomic_compare_exchange_weak(&tables_, &old_tables, new_tables));
 }
 
+bool TabletTableHandler::GetIndexStatistics(const std::string &index_name, ::hybridse::vm::IndexStatistics *stat) {
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (!tables || tables->empty() || stat == nullptr) {
+        return false;
+    }
+    uint64_t pk_cnt = 0;
+    uint64_t record_cnt = 0;
+    for (const auto &kv : *tables) {
+        auto mem_table = std::dynamic_pointer_cast<::openmldb::storage::MemTable>(kv.second);
+        if (!mem_table) {
+            return false;
+        }
+        auto index_def = mem_table->GetIndex(index_name);
+        uint64_t cur_pk_cnt = 0;
+        uint64_t cur_record_cnt = 0;
+        if (!index_def || !mem_table->GetIndexStat(index_def->GetId(), &cur_pk_cnt, &cur_record_cnt)) {
+            return false;
+        }
+        pk_cnt += cur_pk_cnt;
+        record_cnt += cur_record_cnt;
+    }
+    // a key lives in one partition only, so the counts of all partitions scale with the partition num
+    stat->key_cnt = pk_cnt * partition_num_ / tables->size();
+    stat->row_cnt = record_cnt * partition_num_ / tables->size();
+    return true;
+}
+
 bool TabletTableHandler::HasLocalTable() {
     return !std::atomic_load_explicit(&tables_, std::memory_order_acquire)->empty();
 }
@@ -643,6 +845,14 @@ std::unique_ptr<::hybridse::vm::RowIterator> TabletSegmentHandler::GetIterator()
     return nullptr;
 }
 
+::hybridse::vm::RowIterator* RemoteSegmentHandler::GetRawIterator() {
+    if (!window_ || window_->response->count() == 0) {
+        return nullptr;
+    }
+    auto kv_it = std::make_shared<::openmldb::base::TraverseKvIterator>(window_->response);
+    return new RemoteWindowIterator(window_->tid, window_->pid, window_->index_name, kv_it, window_->client);
+}
+
 const uint64_t TabletSegmentHandler::GetCount() {
     auto iter = GetIterator();
     if (!iter) return 0;
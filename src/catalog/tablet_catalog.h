@@ -28,6 +28,7 @@
 #include "catalog/client_manager.h"
 #include "catalog/distribute_iterator.h"
 #include "client/tablet_client.h"
+#include "codec/codec.h"
 #include "codec/row.h"
 #include "storage/schema.h"
 #include "storage/table.h"
@@ -84,6 +85,35 @@ class TabletSegmentHandler : public ::hybridse::vm::TableHandler {
     std::string key_;
 };
 
+// the window of one key fetched from a remote partition in advance
+struct RemoteWindow {
+    uint32_t tid;
+    uint32_t pid;
+    std::string index_name;
+    std::shared_ptr<::openmldb::client::TabletClient> client;
+    std::shared_ptr<::openmldb::api::TraverseResponse> response;
+};
+
+class RemoteSegmentHandler : public TabletSegmentHandler {
+ public:
+    RemoteSegmentHandler(std::shared_ptr<::hybridse::vm::PartitionHandler> partition_handler, const std::string &key,
+                         const std::shared_ptr<RemoteWindow> &window)
+        : TabletSegmentHandler(partition_handler, key), window_(window) {}
+
+    ~RemoteSegmentHandler() {}
+
+    std::unique_ptr<::hybridse::vm::RowIterator> GetIterator() override {
+        return std::unique_ptr<::hybridse::vm::RowIterator>(GetRawIterator());
+    }
+
+    ::hybridse::vm::RowIterator *GetRawIterator() override;
+
+    const std::string GetHandlerTypeName() override { return "RemoteSegmentHandler"; }
+
+ private:
+    std::shared_ptr<RemoteWindow> window_;
+};
+
 class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
                                public std::enable_shared_from_this<hybridse::vm::PartitionHandler> {
  public:
@@ -124,6 +154,20 @@ class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
     std::shared_ptr<::hybridse::vm::TableHandler> GetSegment(const std::string &key) override {
         return std::make_shared<TabletSegmentHandler>(shared_from_this(), key);
     }
+
+    // the windows of the keys on the remote partitions are fetched in one rpc per partition
+    std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> GetSegments(
+        const std::vector<std::string> &keys) override;
+
+    std::shared_ptr<::hybridse::vm::TableHandler> PushDownFilter(
+        const std::vector<::hybridse::vm::ColumnFilter> &filters) override {
+        auto table_handler = table_handler_->PushDownFilter(filters);
+        if (!table_handler) {
+            return {};
+        }
+        return std::make_shared<TabletPartitionHandler>(table_handler, index_name_);
+    }
+
     const std::string GetHandlerTypeName() override { return "TabletPartitionHandler"; }
 
  private:
@@ -161,8 +205,14 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
 
     ::hybridse::codec::RowIterator *GetRawIterator() override;
 
+    // the remote partitions only send the rows matching all `filters`
+    ::hybridse::codec::RowIterator *GetRawIterator(const ::openmldb::codec::FilterList &filters);
+
     std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name) override;
 
+    std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name,
+                                                                         const ::openmldb::codec::FilterList &filters);
+
     const uint64_t GetCount() override;
 
     ::hybridse::codec::Row At(uint64_t pos) override;
@@ -170,6 +220,18 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     std::shared_ptr<::hybridse::vm::PartitionHandler> GetPartition(const std::string &index_name) override;
     const std::string GetHandlerTypeName() override { return "TabletTableHandler"; }
 
+    // the filters are sent to the remote partitions in the traverse requests
+    std::shared_ptr<::hybridse::vm::TableHandler> PushDownFilter(
+        const std::vector<::hybridse::vm::ColumnFilter> &filters) override;
+
+    // estimated from the local memory partitions, the distribution of the remote ones is assumed to be the same
+    bool GetIndexStatistics(const std::string &index_name, ::hybridse::vm::IndexStatistics *stat) override;
+
+    // fetch the windows of the keys which are on the remote partitions, one rpc per partition.
+    // windows[i] is null if keys[i] is on a local partition or the rpc failed
+    std::vector<std::shared_ptr<RemoteWindow>> GetRemoteWindows(const std::string &index_name,
+                                                                const std::vector<std::string> &keys);
+
     std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name, const std::string &pk) override;
     std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name,
                                                       const std::vector<std::string> &pks) override;
@@ -206,6 +268,47 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     std::shared_ptr<hybridse::vm::Tablet> local_tablet_;
 };
 
+// the table of a TabletTableHandler whose remote partitions skip the rows not matching the filters
+class TabletFilterTableHandler : public ::hybridse::vm::TableHandler,
+                                 public std::enable_shared_from_this<hybridse::vm::TableHandler> {
+ public:
+    TabletFilterTableHandler(std::shared_ptr<TabletTableHandler> table_handler,
+                             const ::openmldb::codec::FilterList &filters)
+        : TableHandler(), table_handler_(table_handler), filters_(filters) {}
+
+    const ::hybridse::vm::Schema *GetSchema() override { return table_handler_->GetSchema(); }
+
+    const std::string &GetName() override { return table_handler_->GetName(); }
+
+    const std::string &GetDatabase() override { return table_handler_->GetDatabase(); }
+
+    const ::hybridse::vm::Types &GetTypes() override { return table_handler_->GetTypes(); }
+
+    const ::hybridse::vm::IndexHint &GetIndex() override { return table_handler_->GetIndex(); }
+
+    std::unique_ptr<::hybridse::codec::RowIterator> GetIterator() override {
+        return std::unique_ptr<::hybridse::codec::RowIterator>(GetRawIterator());
+    }
+
+    ::hybridse::codec::RowIterator *GetRawIterator() override { return table_handler_->GetRawIterator(filters_); }
+
+    std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name) override {
+        return table_handler_->GetWindowIterator(idx_name, filters_);
+    }
+
+    const uint64_t GetCount() override;
+
+    ::hybridse::codec::Row At(uint64_t pos) override;
+
+    std::shared_ptr<::hybridse::vm::PartitionHandler> GetPartition(const std::string &index_name) override;
+
+    const std::string GetHandlerTypeName() override { return "TabletFilterTableHandler"; }
+
+ private:
+    std::shared_ptr<TabletTableHandler> table_handler_;
+    const ::openmldb::codec::FilterList filters_;
+};
+
 typedef std::map<std::string, std::map<std::string, std::shared_ptr<TabletTableHandler>>> TabletTables;
 typedef std::map<std::string, std::shared_ptr<::hybridse::type::Database>> TabletDB;
 typedef std::map<std::string, std::map<std::string, std::shared_ptr<::hybridse::sdk::ProcedureInfo>>> Procedures;
@@ -294,6 +294,22 @@ TEST_F(TabletCatalogTest, tablet_smoke_test) {
     ASSERT_EQ(args.row, second_it->GetValue().ToString());
 }
 
+TEST_F(TabletCatalogTest, index_statistics_test) {
+    TestArgs args = PrepareTable("t1", 10, 5);
+    TabletTableHandler handler(args.meta[0], std::shared_ptr<hybridse::vm::Tablet>());
+    ClientManager client_manager;
+    ASSERT_TRUE(handler.Init(client_manager));
+    ::hybridse::vm::IndexStatistics stat;
+    // no local partition
+    ASSERT_FALSE(handler.GetIndexStatistics(args.idx_name, &stat));
+    handler.AddTable(args.tables[0]);
+    ASSERT_TRUE(handler.GetIndexStatistics(args.idx_name, &stat));
+    ASSERT_EQ(10u, stat.key_cnt);
+    ASSERT_EQ(50u, stat.row_cnt);
+    ASSERT_EQ(5u, stat.RowsPerKey());
+    ASSERT_FALSE(handler.GetIndexStatistics("index_not_exist", &stat));
+}
+
 TEST_F(TabletCatalogTest, segment_handler_test) {
     TestArgs args = PrepareTable("t1");
     auto handler = std::shared_ptr<TabletTableHandler>(
@@ -356,6 +372,28 @@ TEST_F(TabletCatalogTest, segment_handler_pk_not_exist_test) {
     }
 }
 
+TEST_F(TabletCatalogTest, segments_handler_test) {
+    TestArgs args = PrepareTable("t1");
+    auto handler = std::shared_ptr<TabletTableHandler>(
+        new TabletTableHandler(args.meta[0], std::shared_ptr<hybridse::vm::Tablet>()));
+    ClientManager client_manager;
+    ASSERT_TRUE(handler->Init(client_manager));
+    handler->AddTable(args.tables[0]);
+    auto partition = handler->GetPartition(args.idx_name);
+    auto segments = partition->GetSegments({args.pk, "KEY_NOT_EXIST", args.pk});
+    ASSERT_EQ(3u, segments.size());
+    for (size_t idx : {0, 2}) {
+        ASSERT_TRUE(segments[idx]);
+        auto iter = segments[idx]->GetIterator();
+        ASSERT_TRUE(iter);
+        iter->SeekToFirst();
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(args.ts, iter->GetKey());
+    }
+    ASSERT_TRUE(segments[1]);
+    ASSERT_FALSE(segments[1]->GetIterator());
+}
+
 TEST_F(TabletCatalogTest, sql_smoke_test) {
     std::shared_ptr<TabletCatalog> catalog(new TabletCatalog());
     ASSERT_TRUE(catalog->Init());
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catalog/traverse_prefetcher.h"
+
+#include <algorithm>
+
+#include "base/glog_wrapper.h"
+#include "gflags/gflags.h"
+
+DECLARE_int32(request_max_retry);
+DECLARE_int32(request_timeout_ms);
+DECLARE_uint32(traverse_cnt_limit);
+DECLARE_uint32(traverse_prefetch_depth);
+DECLARE_uint32(traverse_prefetch_partition_num);
+DECLARE_uint64(traverse_prefetch_max_bytes);
+
+namespace openmldb {
+namespace catalog {
+
+// holds the prefetcher until the page arrives, so the prefetcher can be released by its owner at any time
+class TraversePrefetcher::PageCallback : public openmldb::RpcCallback<::openmldb::api::TraverseResponse> {
+ public:
+    explicit PageCallback(const std::shared_ptr<TraversePrefetcher>& owner)
+        : RpcCallback(std::make_shared<::openmldb::api::TraverseResponse>(), std::make_shared<brpc::Controller>()),
+          owner_(owner) {}
+
+    void Run() override {
+        owner_->OnPage(GetController(), GetResponse());
+        owner_.reset();
+        RpcCallback::Run();
+    }
+
+ private:
+    std::shared_ptr<TraversePrefetcher> owner_;
+};
+
+TraversePrefetcher::TraversePrefetcher(uint32_t tid, uint32_t pid, const std::string& index_name,
+                                       bool skip_current_pk, const ::openmldb::codec::FilterList& filters,
+                                       const std::shared_ptr<::openmldb::client::TabletClient>& client,
+                                       uint32_t depth, uint64_t max_bytes,
+                                       const std::shared_ptr<std::atomic<uint64_t>>& used_bytes)
+    : tid_(tid),
+      pid_(pid),
+      index_name_(index_name),
+      skip_current_pk_(skip_current_pk),
+      filters_(filters),
+      client_(client),
+      depth_(depth),
+      max_bytes_(max_bytes),
+      used_bytes_(used_bytes) {}
+
+TraversePrefetcher::~TraversePrefetcher() = default;
+
+void TraversePrefetcher::Start(const std::string& pk, uint64_t ts, uint32_t ts_pos, bool skip_first_pk) {
+    bool issue = false;
+    {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        first_request_ = true;
+        skip_first_pk_ = skip_first_pk;
+        last_pk_ = pk;
+        last_ts_ = ts;
+        ts_pos_ = ts_pos;
+        issue = ShouldPrefetch();
+        if (issue) {
+            in_flight_ = true;
+        }
+    }
+    if (issue) {
+        Issue();
+    }
+}
+
+bool TraversePrefetcher::ShouldPrefetch() const {
+    return !stopped_ && !finished_ && !in_flight_ && pages_.size() < depth_ &&
+           used_bytes_->load(std::memory_order_relaxed) < max_bytes_;
+}
+
+void TraversePrefetcher::Issue() {
+    ::openmldb::api::TraverseRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_limit(FLAGS_traverse_cnt_limit);
+    if (!index_name_.empty()) {
+        request.set_idx_name(index_name_);
+    }
+    if (!last_pk_.empty()) {
+        request.set_pk(last_pk_);
+        request.set_ts(last_ts_);
+        request.set_ts_pos(ts_pos_);
+    }
+    request.set_skip_current_pk(first_request_ ? skip_first_pk_ : skip_current_pk_);
+    request.mutable_filter()->CopyFrom(filters_);
+    first_request_ = false;
+
+    auto callback = new PageCallback(shared_from_this());
+    callback->GetController()->set_timeout_ms(FLAGS_request_timeout_ms);
+    callback->GetController()->set_max_retry(FLAGS_request_max_retry);
+    if (!client_->AsyncTraverse(request, callback)) {
+        PDLOG(WARNING, "fail to send traverse request. tid %u pid %u", tid_, pid_);
+        callback->UnRef();
+        {
+            std::lock_guard<bthread::Mutex> lock(mu_);
+            in_flight_ = false;
+            finished_ = true;
+        }
+        cv_.notify_all();
+    }
+}
+
+void TraversePrefetcher::OnPage(const std::shared_ptr<brpc::Controller>& cntl,
+                                const std::shared_ptr<::openmldb::api::TraverseResponse>& response) {
+    bool issue = false;
+    {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        in_flight_ = false;
+        if (stopped_) {
+            // the owner doesn't need it any more
+        } else if (cntl->Failed() || response->code() != 0) {
+            PDLOG(WARNING, "traverse failed. tid %u pid %u, %s", tid_, pid_,
+                  cntl->Failed() ? cntl->ErrorText().c_str() : response->msg().c_str());
+            finished_ = true;
+        } else {
+            DLOG(INFO) << "tid " << tid_ << " pid " << pid_ << " traverse page count " << response->count()
+                       << " last pk " << response->pk() << " ts " << response->ts();
+            last_pk_ = response->pk();
+            last_ts_ = response->ts();
+            ts_pos_ = response->ts_pos();
+            finished_ = response->is_finish();
+            used_bytes_->fetch_add(response->pairs().size(), std::memory_order_relaxed);
+            pages_.push_back(response);
+            issue = ShouldPrefetch();
+            if (issue) {
+                in_flight_ = true;
+            }
+        }
+    }
+    cv_.notify_all();
+    if (issue) {
+        Issue();
+    }
+}
+
+std::shared_ptr<::openmldb::api::TraverseResponse> TraversePrefetcher::Take() {
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    while (pages_.empty()) {
+        if (finished_ || stopped_) {
+            return {};
+        }
+        if (!in_flight_) {
+            // nothing prefetched, e.g. the budget is used up or depth is 0, request it for the consumer
+            in_flight_ = true;
+            lock.unlock();
+            Issue();
+            lock.lock();
+            continue;
+        }
+        cv_.wait(lock);
+    }
+    auto page = pages_.front();
+    pages_.pop_front();
+    used_bytes_->fetch_sub(page->pairs().size(), std::memory_order_relaxed);
+    bool issue = ShouldPrefetch();
+    if (issue) {
+        in_flight_ = true;
+    }
+    lock.unlock();
+    if (issue) {
+        Issue();
+    }
+    return page;
+}
+
+void TraversePrefetcher::Stop() {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    stopped_ = true;
+    for (const auto& page : pages_) {
+        used_bytes_->fetch_sub(page->pairs().size(), std::memory_order_relaxed);
+    }
+    pages_.clear();
+}
+
+TraversePrefetchGroup::TraversePrefetchGroup(
+    uint32_t tid, const std::string& index_name, bool skip_current_pk, const ::openmldb::codec::FilterList& filters,
+    const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients)
+    : tid_(tid),
+      index_name_(index_name),
+      skip_current_pk_(skip_current_pk),
+      filters_(filters),
+      tablet_clients_(tablet_clients),
+      used_bytes_(std::make_shared<std::atomic<uint64_t>>(0)) {}
+
+TraversePrefetchGroup::~TraversePrefetchGroup() {
+    for (auto& kv : prefetchers_) {
+        kv.second->Stop();
+    }
+}
+
+std::shared_ptr<TraversePrefetcher> TraversePrefetchGroup::NewPrefetcher(uint32_t pid) {
+    auto iter = tablet_clients_.find(pid);
+    if (iter == tablet_clients_.end()) {
+        return {};
+    }
+    return std::make_shared<TraversePrefetcher>(tid_, pid, index_name_, skip_current_pk_, filters_, iter->second,
+                                                FLAGS_traverse_prefetch_depth, FLAGS_traverse_prefetch_max_bytes,
+                                                used_bytes_);
+}
+
+void TraversePrefetchGroup::SeekPartition(uint32_t pid, const std::string& pk, uint64_t ts, uint32_t ts_pos,
+                                          bool skip_pk) {
+    auto iter = prefetchers_.find(pid);
+    if (iter != prefetchers_.end()) {
+        iter->second->Stop();
+        prefetchers_.erase(iter);
+    }
+    finished_.erase(pid);
+    auto prefetcher = NewPrefetcher(pid);
+    if (!prefetcher) {
+        return;
+    }
+    prefetcher->Start(pk, ts, ts_pos, skip_pk);
+    prefetchers_.emplace(pid, prefetcher);
+}
+
+std::shared_ptr<::openmldb::base::TraverseKvIterator> TraversePrefetchGroup::NextPage(uint32_t pid) {
+    if (finished_.count(pid) > 0) {
+        return {};
+    }
+    // make sure the current and the following partitions are being traversed
+    auto iter = tablet_clients_.find(pid);
+    uint32_t parallel = std::max(FLAGS_traverse_prefetch_partition_num, 1u);
+    for (uint32_t i = 0; i < parallel && iter != tablet_clients_.end(); i++, iter++) {
+        if (prefetchers_.count(iter->first) > 0 || finished_.count(iter->first) > 0) {
+            continue;
+        }
+        auto prefetcher = NewPrefetcher(iter->first);
+        prefetcher->Start("", 0, 0, false);
+        prefetchers_.emplace(iter->first, prefetcher);
+    }
+    auto it = prefetchers_.find(pid);
+    if (it == prefetchers_.end()) {
+        return {};
+    }
+    auto page = it->second->Take();
+    if (!page) {
+        it->second->Stop();
+        prefetchers_.erase(it);
+        finished_.insert(pid);
+        return {};
+    }
+    return std::make_shared<::openmldb::base::TraverseKvIterator>(page);
+}
+
+}  // namespace catalog
+}  // namespace openmldb
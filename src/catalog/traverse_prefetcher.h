@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_CATALOG_TRAVERSE_PREFETCHER_H_
+#define SRC_CATALOG_TRAVERSE_PREFETCHER_H_
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/kv_iterator.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "client/tablet_client.h"
+#include "codec/codec.h"
+
+namespace openmldb {
+namespace catalog {
+
+// Traverse pages of one remote partition ahead of the consumer.
+// A page can only be requested after the previous one is received, because the request carries the last pk/ts of
+// the previous page. So the next page is requested as soon as the previous one arrives, until `depth` pages are
+// buffered or the shared memory budget is used up. The consumer always gets progress: if nothing is buffered or in
+// flight when it asks for a page, the page is requested regardless of the budget.
+class TraversePrefetcher : public std::enable_shared_from_this<TraversePrefetcher> {
+ public:
+    TraversePrefetcher(uint32_t tid, uint32_t pid, const std::string& index_name, bool skip_current_pk,
+                       const ::openmldb::codec::FilterList& filters,
+                       const std::shared_ptr<::openmldb::client::TabletClient>& client, uint32_t depth,
+                       uint64_t max_bytes, const std::shared_ptr<std::atomic<uint64_t>>& used_bytes);
+    ~TraversePrefetcher();
+
+    // start traversing from the first key if pk is empty, or from the position of pk and ts otherwise.
+    // `skip_first_pk` is only used by the first request, the following requests use `skip_current_pk`
+    void Start(const std::string& pk, uint64_t ts, uint32_t ts_pos, bool skip_first_pk);
+
+    // block until the next page is received, return nullptr if the partition has no more data or the rpc failed
+    std::shared_ptr<::openmldb::api::TraverseResponse> Take();
+
+    // the pages in flight are dropped when they arrive, no more page will be requested
+    void Stop();
+
+ private:
+    class PageCallback;
+
+    void OnPage(const std::shared_ptr<brpc::Controller>& cntl,
+                const std::shared_ptr<::openmldb::api::TraverseResponse>& response);
+    // mu_ must be held
+    bool ShouldPrefetch() const;
+    // request the next page, in_flight_ must be set before
+    void Issue();
+
+ private:
+    const uint32_t tid_;
+    const uint32_t pid_;
+    const std::string index_name_;
+    const bool skip_current_pk_;
+    // the pages only carry the rows matching the filters, so a page may be empty before the partition is finished
+    const ::openmldb::codec::FilterList filters_;
+    std::shared_ptr<::openmldb::client::TabletClient> client_;
+    const uint32_t depth_;
+    const uint64_t max_bytes_;
+    std::shared_ptr<std::atomic<uint64_t>> used_bytes_;
+
+    bthread::Mutex mu_;
+    bthread::ConditionVariable cv_;
+    std::deque<std::shared_ptr<::openmldb::api::TraverseResponse>> pages_;
+    bool in_flight_ = false;
+    bool finished_ = false;
+    bool stopped_ = false;
+    // the position of the next request
+    bool first_request_ = true;
+    bool skip_first_pk_ = false;
+    std::string last_pk_;
+    uint64_t last_ts_ = 0;
+    uint32_t ts_pos_ = 0;
+};
+
+// Traverse the remote partitions of one table, the next `FLAGS_traverse_prefetch_partition_num - 1` partitions
+// (in pid order) are prefetched concurrently with the current one. All partitions share the memory budget
+// `FLAGS_traverse_prefetch_max_bytes`.
+class TraversePrefetchGroup {
+ public:
+    TraversePrefetchGroup(uint32_t tid, const std::string& index_name, bool skip_current_pk,
+                          const ::openmldb::codec::FilterList& filters,
+                          const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients);
+    ~TraversePrefetchGroup();
+
+    // the next page of `pid`, return nullptr if the partition has no more data.
+    // The partition is traversed from the first key unless it's positioned by `SeekPartition`.
+    std::shared_ptr<::openmldb::base::TraverseKvIterator> NextPage(uint32_t pid);
+
+    // drop the prefetched pages of `pid` and continue traversing it from the given position
+    void SeekPartition(uint32_t pid, const std::string& pk, uint64_t ts, uint32_t ts_pos, bool skip_pk);
+
+ private:
+    std::shared_ptr<TraversePrefetcher> NewPrefetcher(uint32_t pid);
+
+ private:
+    const uint32_t tid_;
+    const std::string index_name_;
+    const bool skip_current_pk_;
+    const ::openmldb::codec::FilterList filters_;
+    std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>> tablet_clients_;
+    std::shared_ptr<std::atomic<uint64_t>> used_bytes_;
+    std::map<uint32_t, std::shared_ptr<TraversePrefetcher>> prefetchers_;
+    // partitions that have been traversed to the end
+    std::set<uint32_t> finished_;
+};
+
+}  // namespace catalog
+}  // namespace openmldb
+#endif  // SRC_CATALOG_TRAVERSE_PREFETCHER_H_
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catalog/zk_catalog_cache.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "snappy.h"
+
+namespace openmldb {
+namespace catalog {
+
+static const char TABLE_CHANGE_PREFIX[] = "table_";
+static const char PROCEDURE_CHANGE_PREFIX[] = "procedure_";
+
+static std::string GetChangeLogPath(const std::string& zk_path) { return zk_path + "/table/change_log"; }
+
+// sequence -> entry, entries which are not written by `AppendChange` are ignored
+static std::map<int64_t, std::pair<CatalogChangeType, std::string>> ParseChangeLog(
+    const std::vector<std::string>& entries) {
+    std::map<int64_t, std::pair<CatalogChangeType, std::string>> log;
+    for (const auto& entry : entries) {
+        CatalogChangeType type;
+        std::string node;
+        int64_t seq = 0;
+        if (!ZkCatalogCache::ParseChange(entry, &type, &node, &seq)) {
+            LOG(WARNING) << "invalid catalog change log entry " << entry;
+            continue;
+        }
+        log.emplace(seq, std::make_pair(type, std::move(node)));
+    }
+    return log;
+}
+
+ZkCatalogCache::ZkCatalogCache(const std::string& zk_path)
+    : table_root_path_(zk_path + "/table/db_table_data"),
+      sp_root_path_(zk_path + "/store_procedure/db_sp_data"),
+      change_log_path_(GetChangeLogPath(zk_path)) {}
+
+bool ZkCatalogCache::ParseChange(const std::string& entry, CatalogChangeType* type, std::string* node,
+                                 int64_t* seq) {
+    size_t pos = entry.find_last_of('-');
+    if (pos == std::string::npos || pos + 1 == entry.size()) {
+        return false;
+    }
+    try {
+        size_t idx = 0;
+        *seq = std::stoll(entry.substr(pos + 1), &idx);
+        if (idx != entry.size() - pos - 1) {
+            return false;
+        }
+    } catch (const std::exception& e) {
+        return false;
+    }
+    size_t prefix_len = 0;
+    if (entry.compare(0, sizeof(TABLE_CHANGE_PREFIX) - 1, TABLE_CHANGE_PREFIX) == 0) {
+        *type = CatalogChangeType::kTable;
+        prefix_len = sizeof(TABLE_CHANGE_PREFIX) - 1;
+    } else if (entry.compare(0, sizeof(PROCEDURE_CHANGE_PREFIX) - 1, PROCEDURE_CHANGE_PREFIX) == 0) {
+        *type = CatalogChangeType::kProcedure;
+        prefix_len = sizeof(PROCEDURE_CHANGE_PREFIX) - 1;
+    } else {
+        return false;
+    }
+    if (pos <= prefix_len) {
+        return false;
+    }
+    node->assign(entry, prefix_len, pos - prefix_len);
+    return true;
+}
+
+bool ZkCatalogCache::AppendChange(::openmldb::zk::ZkClient* zk_client, const std::string& zk_path,
+                                  CatalogChangeType type, const std::string& node, uint32_t max_size) {
+    const std::string log_path = GetChangeLogPath(zk_path);
+    std::string entry = log_path + "/" +
+                        (type == CatalogChangeType::kTable ? TABLE_CHANGE_PREFIX : PROCEDURE_CHANGE_PREFIX) + node +
+                        "-";
+    std::string assigned_path;
+    bool ok = zk_client->CreateNode(entry, "", ZOO_SEQUENCE, assigned_path);
+    std::vector<std::string> entries;
+    if (!zk_client->GetChildren(log_path, entries)) {
+        LOG(WARNING) << "fail to get catalog change log " << log_path;
+        return false;
+    }
+    if (!ok) {
+        // readers can't see this change from the log, drop the log so that they reload everything
+        LOG(WARNING) << "fail to append catalog change " << entry << ", clear the change log";
+        for (const auto& name : entries) {
+            zk_client->DeleteNode(log_path + "/" + name);
+        }
+        return false;
+    }
+    max_size = std::max(max_size, 1u);
+    if (entries.size() > max_size) {
+        // delete the oldest ones, a reader that is behind the remaining entries will reload everything
+        std::vector<std::pair<int64_t, std::string>> seq_entries;
+        for (const auto& name : entries) {
+            CatalogChangeType cur_type;
+            std::string cur_node;
+            int64_t seq = 0;
+            if (ParseChange(name, &cur_type, &cur_node, &seq)) {
+                seq_entries.emplace_back(seq, name);
+            }
+        }
+        std::sort(seq_entries.begin(), seq_entries.end());
+        for (size_t i = 0; i + max_size < seq_entries.size(); i++) {
+            zk_client->DeleteNode(log_path + "/" + seq_entries[i].second);
+        }
+    }
+    return true;
+}
+
+bool ZkCatalogCache::Refresh(::openmldb::zk::ZkClient* zk_client) {
+    int exist = zk_client->IsExistNode(change_log_path_);
+    if (exist < 0) {
+        LOG(WARNING) << "fail to check the catalog change log " << change_log_path_;
+        return false;
+    }
+    std::vector<std::string> entries;
+    if (exist == 0 && !zk_client->GetChildren(change_log_path_, entries)) {
+        LOG(WARNING) << "fail to get the catalog change log " << change_log_path_;
+        return false;
+    }
+    auto log = ParseChangeLog(entries);
+    if (log.empty()) {
+        return FullReload(zk_client, -1);
+    }
+    int64_t max_seq = log.rbegin()->first;
+    if (!initialized_ || log.find(last_seq_) == log.end()) {
+        DLOG(INFO) << "catalog change log is not continuous with " << last_seq_ << ", reload all";
+        return FullReload(zk_client, max_seq);
+    }
+    std::set<std::string> tables;
+    std::set<std::string> procedures;
+    for (auto it = log.upper_bound(last_seq_); it != log.end(); ++it) {
+        if (it->second.first == CatalogChangeType::kTable) {
+            tables.insert(it->second.second);
+        } else {
+            procedures.insert(it->second.second);
+        }
+    }
+    for (const auto& node : tables) {
+        if (!LoadTable(zk_client, node)) {
+            return false;
+        }
+    }
+    for (const auto& node : procedures) {
+        if (!LoadProcedure(zk_client, node)) {
+            return false;
+        }
+    }
+    DLOG(INFO) << "apply catalog change log from " << last_seq_ << " to " << max_seq << ", " << tables.size()
+               << " tables and " << procedures.size() << " procedures changed";
+    last_seq_ = max_seq;
+    full_reload_ = false;
+    changed_tables_ = std::move(tables);
+    changed_procedures_ = std::move(procedures);
+    return true;
+}
+
+bool ZkCatalogCache::FullReload(::openmldb::zk::ZkClient* zk_client, int64_t seq) {
+    std::vector<std::string> table_nodes;
+    if (zk_client->IsExistNode(table_root_path_) == 0) {
+        if (!zk_client->GetChildren(table_root_path_, table_nodes)) {
+            LOG(WARNING) << "fail to get table list with path " << table_root_path_;
+            return false;
+        }
+    } else {
+        DLOG(INFO) << "no tables in db";
+    }
+    std::vector<std::string> sp_nodes;
+    if (zk_client->IsExistNode(sp_root_path_) == 0) {
+        if (!zk_client->GetChildren(sp_root_path_, sp_nodes)) {
+            LOG(WARNING) << "fail to get procedure list with path " << sp_root_path_;
+            return false;
+        }
+    } else {
+        DLOG(INFO) << "no procedures in db";
+    }
+    tables_.clear();
+    procedures_.clear();
+    // the cache is incomplete if the reload fails, so it must be reloaded next time
+    initialized_ = false;
+    for (const auto& node : table_nodes) {
+        if (!node.empty() && !LoadTable(zk_client, node)) {
+            return false;
+        }
+    }
+    for (const auto& node : sp_nodes) {
+        if (!node.empty() && !LoadProcedure(zk_client, node)) {
+            return false;
+        }
+    }
+    initialized_ = true;
+    last_seq_ = seq;
+    full_reload_ = true;
+    changed_tables_.clear();
+    changed_procedures_.clear();
+    return true;
+}
+
+bool ZkCatalogCache::LoadTable(::openmldb::zk::ZkClient* zk_client, const std::string& node) {
+    const std::string path = table_root_path_ + "/" + node;
+    std::string value;
+    if (!zk_client->GetNodeValue(path, value)) {
+        if (zk_client->IsExistNode(path) > 0) {
+            tables_.erase(node);
+            return true;
+        }
+        LOG(WARNING) << "fail to get table data " << path;
+        return false;
+    }
+    auto table_info = std::make_shared<::openmldb::nameserver::TableInfo>();
+    if (!table_info->ParseFromString(value)) {
+        // keep going, same as a broken node when reading all
+        LOG(WARNING) << "fail to parse table proto with " << value;
+        tables_.erase(node);
+        return true;
+    }
+    DLOG(INFO) << "load table info with name " << table_info->name() << " in db " << table_info->db();
+    tables_[node] = table_info;
+    return true;
+}
+
+bool ZkCatalogCache::LoadProcedure(::openmldb::zk::ZkClient* zk_client, const std::string& node) {
+    const std::string path = sp_root_path_ + "/" + node;
+    std::string value;
+    if (!zk_client->GetNodeValue(path, value)) {
+        if (zk_client->IsExistNode(path) > 0) {
+            procedures_.erase(node);
+            return true;
+        }
+        LOG(WARNING) << "fail to get procedure data. node: " << node;
+        return false;
+    }
+    std::string uncompressed;
+    ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
+    auto sp_info = std::make_shared<::openmldb::api::ProcedureInfo>();
+    if (!sp_info->ParseFromString(uncompressed)) {
+        LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
+        procedures_.erase(node);
+        return true;
+    }
+    DLOG(INFO) << "load procedure info with sp name " << sp_info->sp_name() << " in db " << sp_info->db_name();
+    procedures_[node] = sp_info;
+    return true;
+}
+
+}  // namespace catalog
+}  // namespace openmldb
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_CATALOG_ZK_CATALOG_CACHE_H_
+#define SRC_CATALOG_ZK_CATALOG_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "proto/name_server.pb.h"
+#include "proto/sql_procedure.pb.h"
+#include "zk/zk_client.h"
+
+namespace openmldb {
+namespace catalog {
+
+enum class CatalogChangeType { kTable, kProcedure };
+
+// A local copy of the table and procedure nodes in zk, kept up to date by the catalog change log.
+//
+// Every time the nameserver writes or deletes a node under `<zk_path>/table/db_table_data` or
+// `<zk_path>/store_procedure/db_sp_data`, it appends a sequential node named `table_<tid>-<seq>` or
+// `procedure_<db.sp>-<seq>` to `<zk_path>/table/change_log` *after* the write. So `Refresh` only lists the log and
+// reads the nodes appended since the last refresh. Sequences of the log are increasing but not contiguous, so the
+// log is only applied incrementally if the last applied entry is still there. Otherwise (no log, e.g. an older
+// nameserver, or the log has been trimmed) all nodes are read again.
+//
+// Not thread safe, the owner should serialize `Refresh` and the accessors.
+class ZkCatalogCache {
+ public:
+    explicit ZkCatalogCache(const std::string& zk_path);
+
+    // return false if zk is unreachable, the cache is left as it was
+    bool Refresh(::openmldb::zk::ZkClient* zk_client);
+
+    // keyed by the node name, i.e. tid for tables and `db.sp` for procedures.
+    // A changed node gets a new object, so the values can be shared with the readers.
+    const std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>& GetTables() const {
+        return tables_;
+    }
+    const std::map<std::string, std::shared_ptr<::openmldb::api::ProcedureInfo>>& GetProcedures() const {
+        return procedures_;
+    }
+
+    // whether the last `Refresh` re-read all nodes, then `GetChanged*` are meaningless
+    bool IsFullReload() const { return full_reload_; }
+    // nodes updated, created or deleted by the last `Refresh`
+    const std::set<std::string>& GetChangedTables() const { return changed_tables_; }
+    const std::set<std::string>& GetChangedProcedures() const { return changed_procedures_; }
+
+    // called by the nameserver after the node is written or deleted, the oldest entries beyond `max_size` are
+    // trimmed. If the entry can't be appended, the log is cleared so that all readers reload everything.
+    static bool AppendChange(::openmldb::zk::ZkClient* zk_client, const std::string& zk_path, CatalogChangeType type,
+                             const std::string& node, uint32_t max_size);
+
+    // parse a log entry `<type>_<node>-<seq>`
+    static bool ParseChange(const std::string& entry, CatalogChangeType* type, std::string* node, int64_t* seq);
+
+ private:
+    bool FullReload(::openmldb::zk::ZkClient* zk_client, int64_t seq);
+    // return false if zk is unreachable, a deleted node is removed from the cache
+    bool LoadTable(::openmldb::zk::ZkClient* zk_client, const std::string& node);
+    bool LoadProcedure(::openmldb::zk::ZkClient* zk_client, const std::string& node);
+
+ private:
+    const std::string table_root_path_;
+    const std::string sp_root_path_;
+    const std::string change_log_path_;
+    bool initialized_ = false;
+    // the sequence of the last applied log entry, -1 if none
+    int64_t last_seq_ = -1;
+    bool full_reload_ = false;
+    std::set<std::string> changed_tables_;
+    std::set<std::string> changed_procedures_;
+    std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>> tables_;
+    std::map<std::string, std::shared_ptr<::openmldb::api::ProcedureInfo>> procedures_;
+};
+
+}  // namespace catalog
+}  // namespace openmldb
+#endif  // SRC_CATALOG_ZK_CATALOG_CACHE_H_
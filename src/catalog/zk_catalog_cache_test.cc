@@ -0,0 +1,121 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catalog/zk_catalog_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace catalog {
+
+class ZkCatalogCacheTest : public ::testing::Test {};
+
+inline std::string GenRand() { return std::to_string(rand() % 10000000 + 1); }  // NOLINT
+
+static bool PutTable(::openmldb::zk::ZkClient* client, const std::string& root, uint32_t tid,
+                     const std::string& name) {
+    ::openmldb::nameserver::TableInfo table_info;
+    table_info.set_db("db1");
+    table_info.set_name(name);
+    table_info.set_tid(tid);
+    std::string value;
+    table_info.SerializeToString(&value);
+    std::string node = root + "/table/db_table_data/" + std::to_string(tid);
+    if (client->IsExistNode(node) == 0) {
+        return client->SetNodeValue(node, value);
+    }
+    return client->CreateNode(node, value);
+}
+
+TEST_F(ZkCatalogCacheTest, ParseChange) {
+    CatalogChangeType type;
+    std::string node;
+    int64_t seq = 0;
+    ASSERT_TRUE(ZkCatalogCache::ParseChange("table_12-0000000003", &type, &node, &seq));
+    ASSERT_EQ(CatalogChangeType::kTable, type);
+    ASSERT_EQ("12", node);
+    ASSERT_EQ(3, seq);
+    ASSERT_TRUE(ZkCatalogCache::ParseChange("procedure_db-1.sp_1-0000000010", &type, &node, &seq));
+    ASSERT_EQ(CatalogChangeType::kProcedure, type);
+    ASSERT_EQ("db-1.sp_1", node);
+    ASSERT_EQ(10, seq);
+    ASSERT_FALSE(ZkCatalogCache::ParseChange("table_-0000000003", &type, &node, &seq));
+    ASSERT_FALSE(ZkCatalogCache::ParseChange("table_12-", &type, &node, &seq));
+    ASSERT_FALSE(ZkCatalogCache::ParseChange("table_12-00a", &type, &node, &seq));
+    ASSERT_FALSE(ZkCatalogCache::ParseChange("index_12-0000000003", &type, &node, &seq));
+}
+
+TEST_F(ZkCatalogCacheTest, Refresh) {
+    ::openmldb::zk::ZkClient client("127.0.0.1:6181", "", 30000, "", "/openmldb", "", "");
+    ASSERT_TRUE(client.Init());
+    std::string root = "/zk_catalog_cache_test" + GenRand();
+    ASSERT_TRUE(PutTable(&client, root, 1, "t1"));
+    ASSERT_TRUE(PutTable(&client, root, 2, "t2"));
+
+    // no change log, read all
+    ZkCatalogCache cache(root);
+    ASSERT_TRUE(cache.Refresh(&client));
+    ASSERT_TRUE(cache.IsFullReload());
+    ASSERT_EQ(2u, cache.GetTables().size());
+
+    // the first entry of the log is not applied, read all
+    ASSERT_TRUE(PutTable(&client, root, 1, "t1_1"));
+    ASSERT_TRUE(ZkCatalogCache::AppendChange(&client, root, CatalogChangeType::kTable, "1", 3));
+    ASSERT_TRUE(cache.Refresh(&client));
+    ASSERT_TRUE(cache.IsFullReload());
+    ASSERT_EQ("t1_1", cache.GetTables().at("1")->name());
+
+    // apply the log
+    ASSERT_TRUE(PutTable(&client, root, 3, "t3"));
+    ASSERT_TRUE(ZkCatalogCache::AppendChange(&client, root, CatalogChangeType::kTable, "3", 3));
+    ASSERT_TRUE(client.DeleteNode(root + "/table/db_table_data/2"));
+    ASSERT_TRUE(ZkCatalogCache::AppendChange(&client, root, CatalogChangeType::kTable, "2", 3));
+    auto t1 = cache.GetTables().at("1");
+    ASSERT_TRUE(cache.Refresh(&client));
+    ASSERT_FALSE(cache.IsFullReload());
+    ASSERT_EQ(std::set<std::string>({"2", "3"}), cache.GetChangedTables());
+    ASSERT_EQ(2u, cache.GetTables().size());
+    ASSERT_EQ("t3", cache.GetTables().at("3")->name());
+    // unchanged tables are kept as they were
+    ASSERT_EQ(t1, cache.GetTables().at("1"));
+
+    // nothing changed
+    ASSERT_TRUE(cache.Refresh(&client));
+    ASSERT_FALSE(cache.IsFullReload());
+    ASSERT_TRUE(cache.GetChangedTables().empty());
+
+    // the applied entries are trimmed, read all
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(ZkCatalogCache::AppendChange(&client, root, CatalogChangeType::kTable, "3", 3));
+    }
+    std::vector<std::string> entries;
+    ASSERT_TRUE(client.GetChildren(root + "/table/change_log", entries));
+    ASSERT_EQ(3u, entries.size());
+    ASSERT_TRUE(cache.Refresh(&client));
+    ASSERT_TRUE(cache.IsFullReload());
+    ASSERT_EQ(2u, cache.GetTables().size());
+}
+
+}  // namespace catalog
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    srand(time(NULL));
+    return RUN_ALL_TESTS();
+}
@@ -46,7 +46,8 @@ TabletClient::~TabletClient() {}
 int TabletClient::Init() { return client_.Init(); }
 
 bool TabletClient::Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
-                         openmldb::api::QueryResponse* response, const bool is_debug) {
+                         openmldb::api::QueryResponse* response, const bool is_debug,
+                         const ::openmldb::api::FollowerRead* follower_read) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
@@ -55,6 +56,9 @@ bool TabletClient::Query(const std::string& db, const std::string& sql, const st
     request.set_is_debug(is_debug);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    if (follower_read != nullptr) {
+        request.mutable_follower_read()->CopyFrom(*follower_read);
+    }
     auto& io_buf = cntl->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
         LOG(WARNING) << "Encode row buffer failed";
@@ -71,13 +75,15 @@ bool TabletClient::Query(const std::string& db, const std::string& sql, const st
 bool TabletClient::Query(const std::string& db, const std::string& sql,
                          const std::vector<openmldb::type::DataType>& parameter_types,
                          const std::string& parameter_row,
-                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug) {
+                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug,
+                         const bool is_profile) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_batch(true);
     request.set_is_debug(is_debug);
+    request.set_profile(is_profile);
     request.set_parameter_row_size(parameter_row.size());
     request.set_parameter_row_slices(1);
     for (auto& type : parameter_types) {
@@ -239,6 +245,33 @@ base::Status TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const
     return {response.code(), response.msg()};
 }
 
+base::Status TabletClient::BatchPut(uint32_t tid, uint32_t pid,
+                                    ::google::protobuf::RepeatedPtrField<::openmldb::api::PutRequest>* rows,
+                                    int memory_usage_limit, bool put_if_absent, uint32_t* put_cnt) {
+    *put_cnt = 0;
+    ::openmldb::api::BatchPutRequest request;
+    if (memory_usage_limit < 0 || memory_usage_limit > 100) {
+        return {base::ReturnCode::kError, absl::StrCat("invalid memory_usage_limit ", memory_usage_limit)};
+    } else if (memory_usage_limit > 0) {
+        request.set_memory_limit(memory_usage_limit);
+    }
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.mutable_rows()->Swap(rows);
+    request.set_put_if_absent(put_if_absent);
+    ::openmldb::api::BatchPutResponse response;
+    // not retried, the rows put already would be put again
+    auto st = client_.SendRequestSt(&::openmldb::api::TabletServer_Stub::BatchPut, &request, &response,
+                                    FLAGS_request_timeout_ms, 1);
+    // give the rows back, so the caller can put them again
+    request.mutable_rows()->Swap(rows);
+    if (!st.OK()) {
+        return st;
+    }
+    *put_cnt = response.put_cnt();
+    return {response.code(), response.msg()};
+}
+
 base::Status TabletClient::Put(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time,
         const std::string& value) {
     ::openmldb::api::PutRequest request;
@@ -881,7 +914,7 @@ bool TabletClient::DeleteBinlog(uint32_t tid, uint32_t pid, openmldb::common::St
 
 std::shared_ptr<openmldb::base::TraverseKvIterator> TabletClient::Traverse(uint32_t tid, uint32_t pid,
         const std::string& idx_name, const std::string& pk, uint64_t ts, uint32_t limit, bool skip_current_pk,
-        uint32_t ts_pos, uint32_t& count) {
+        uint32_t ts_pos, uint32_t& count, const ::openmldb::codec::FilterList& filters) {
     ::openmldb::api::TraverseRequest request;
     auto response = std::make_shared<openmldb::api::TraverseResponse>();
     request.set_tid(tid);
@@ -896,6 +929,7 @@ std::shared_ptr<openmldb::base::TraverseKvIterator> TabletClient::Traverse(uint3
         request.set_ts_pos(ts_pos);
     }
     request.set_skip_current_pk(skip_current_pk);
+    request.mutable_filter()->CopyFrom(filters);
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Traverse, &request, response.get(),
                                   FLAGS_request_timeout_ms, FLAGS_request_max_retry);
     if (!ok || response->code() != 0) {
@@ -905,6 +939,24 @@ std::shared_ptr<openmldb::base::TraverseKvIterator> TabletClient::Traverse(uint3
     return std::make_shared<openmldb::base::TraverseKvIterator>(response);
 }
 
+bool TabletClient::AsyncTraverse(const ::openmldb::api::TraverseRequest& request,
+                                 openmldb::RpcCallback<openmldb::api::TraverseResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::Traverse, callback->GetController().get(),
+                               &request, callback->GetResponse().get(), callback);
+}
+
+bool TabletClient::AsyncMultiKeyTraverse(const ::openmldb::api::MultiKeyTraverseRequest& request,
+                                         openmldb::RpcCallback<openmldb::api::MultiKeyTraverseResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::MultiKeyTraverse,
+                               callback->GetController().get(), &request, callback->GetResponse().get(), callback);
+}
+
 bool TabletClient::SetMode(bool mode) {
     ::openmldb::api::SetModeRequest request;
     ::openmldb::api::GeneralResponse response;
@@ -1064,6 +1116,66 @@ bool TabletClient::ExtractIndexData(uint32_t tid, uint32_t pid, uint32_t partiti
     return true;
 }
 
+bool TabletClient::BuildIndexData(uint32_t tid, uint32_t pid, uint32_t partition_num,
+                                  const std::vector<::openmldb::common::ColumnKey>& column_key,
+                                  const std::map<uint32_t, std::string>& pid_endpoint_map,
+                                  std::shared_ptr<TaskInfo> task_info) {
+    if (column_key.empty()) {
+        if (task_info) {
+            task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+        }
+        return false;
+    }
+    ::openmldb::api::BuildIndexDataRequest request;
+    ::openmldb::api::GeneralResponse response;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.set_partition_num(partition_num);
+    for (const auto& cur_column_key : column_key) {
+        request.add_column_key()->CopyFrom(cur_column_key);
+    }
+    for (const auto& kv : pid_endpoint_map) {
+        auto pair = request.add_pairs();
+        pair->set_pid(kv.first);
+        pair->set_endpoint(kv.second);
+    }
+    if (task_info) {
+        request.mutable_task_info()->CopyFrom(*task_info);
+    }
+    bool ok = client_.SendRequest(&openmldb::api::TabletServer_Stub::BuildIndexData, &request, &response,
+                                  FLAGS_request_timeout_ms, 1);
+    if (!ok || response.code() != 0) {
+        return false;
+    }
+    return true;
+}
+
+base::Status TabletClient::PutIndexEntries(uint32_t tid, uint32_t pid,
+                                           ::google::protobuf::RepeatedPtrField<::openmldb::api::LogEntry>* entries) {
+    ::openmldb::api::PutIndexEntriesRequest request;
+    ::openmldb::api::GeneralResponse response;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.mutable_entries()->Swap(entries);
+    // the entries which exist already are skipped by the server, so it's safe to retry
+    auto st = client_.SendRequestSt(&::openmldb::api::TabletServer_Stub::PutIndexEntries, &request, &response,
+                                    FLAGS_request_timeout_ms, FLAGS_request_max_retry);
+    if (!st.OK()) {
+        return st;
+    }
+    return {response.code(), response.msg()};
+}
+
+base::Status TabletClient::SubscribeBinlog(const ::openmldb::api::SubscribeBinlogRequest& request,
+                                           ::openmldb::api::SubscribeBinlogResponse* response) {
+    auto st = client_.SendRequestSt(&::openmldb::api::TabletServer_Stub::SubscribeBinlog, &request, response,
+                                    FLAGS_request_timeout_ms + request.wait_ms(), 1);
+    if (!st.OK()) {
+        return st;
+    }
+    return {response->code(), response->msg()};
+}
+
 bool TabletClient::CancelOP(const uint64_t op_id) {
     ::openmldb::api::CancelOPRequest request;
     ::openmldb::api::GeneralResponse response;
@@ -1138,7 +1250,7 @@ bool TabletClient::Scan(const ::openmldb::api::ScanRequest& request, brpc::Contr
 
 bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_name, const base::Slice& row,
                                  brpc::Controller* cntl, openmldb::api::QueryResponse* response, bool is_debug,
-                                 uint64_t timeout_ms) {
+                                 uint64_t timeout_ms, const ::openmldb::api::FollowerRead* follower_read) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sp_name(sp_name);
@@ -1148,6 +1260,9 @@ bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_na
     request.set_is_procedure(true);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    if (follower_read != nullptr) {
+        request.mutable_follower_read()->CopyFrom(*follower_read);
+    }
     cntl->set_timeout_ms(timeout_ms);
     auto& io_buf = cntl->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
@@ -28,6 +28,7 @@
 #include "base/status.h"
 #include "brpc/channel.h"
 #include "client/client.h"
+#include "codec/codec.h"
 #include "codec/schema_codec.h"
 #include "proto/tablet.pb.h"
 #include "rpc/rpc_client.h"
@@ -63,10 +64,13 @@ class TabletClient : public Client {
 
     bool Query(const std::string& db, const std::string& sql,
                const std::vector<openmldb::type::DataType>& parameter_types, const std::string& parameter_row,
-               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               const bool is_profile = false);
 
+    // follower_read is set if the query is sent to a follower
     bool Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
-               ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               const ::openmldb::api::FollowerRead* follower_read = nullptr);
 
     bool SQLBatchRequestQuery(const std::string& db, const std::string& sql,
                               std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>, brpc::Controller* cntl,
@@ -82,6 +86,12 @@ class TabletClient : public Client {
             ::google::protobuf::RepeatedPtrField<::openmldb::api::Dimension>* dimensions,
             int memory_usage_limit = 0, bool put_if_absent = false);
 
+    // put the rows of one partition in one request, put_cnt is the number of rows put even if it fails.
+    // rows are left unchanged when it returns
+    base::Status BatchPut(uint32_t tid, uint32_t pid,
+                          ::google::protobuf::RepeatedPtrField<::openmldb::api::PutRequest>* rows,
+                          int memory_usage_limit, bool put_if_absent, uint32_t* put_cnt);
+
     bool Get(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, std::string& value,  // NOLINT
              uint64_t& ts,                                                                          // NOLINT
              std::string& msg);  // NOLINT
@@ -188,10 +198,18 @@ class TabletClient : public Client {
     bool ConnectZK();
     bool DisConnectZK();
 
+    // only the rows matching all `filters` are returned, a page may be empty before the traverse is finished
     std::shared_ptr<openmldb::base::TraverseKvIterator> Traverse(uint32_t tid, uint32_t pid,
                                                                  const std::string& idx_name, const std::string& pk,
                                                                  uint64_t ts, uint32_t limit, bool skip_current_pk,
-                                                                 uint32_t ts_pos, uint32_t& count);  // NOLINT
+                                                                 uint32_t ts_pos, uint32_t& count,  // NOLINT
+                                                                 const ::openmldb::codec::FilterList& filters = {});
+
+    bool AsyncTraverse(const ::openmldb::api::TraverseRequest& request,
+                       openmldb::RpcCallback<openmldb::api::TraverseResponse>* callback);
+
+    bool AsyncMultiKeyTraverse(const ::openmldb::api::MultiKeyTraverseRequest& request,
+                               openmldb::RpcCallback<openmldb::api::MultiKeyTraverseResponse>* callback);
 
     bool SetMode(bool mode);
 
@@ -214,6 +232,18 @@ class TabletClient : public Client {
                           const std::vector<::openmldb::common::ColumnKey>& column_key, uint64_t offset, bool dump_data,
                           std::shared_ptr<TaskInfo> task_info);
 
+    bool BuildIndexData(uint32_t tid, uint32_t pid, uint32_t partition_num,
+                        const std::vector<::openmldb::common::ColumnKey>& column_key,
+                        const std::map<uint32_t, std::string>& pid_endpoint_map, std::shared_ptr<TaskInfo> task_info);
+
+    // the entries are moved into the request
+    base::Status PutIndexEntries(uint32_t tid, uint32_t pid,
+                                 ::google::protobuf::RepeatedPtrField<::openmldb::api::LogEntry>* entries);
+
+    // the rpc timeout is extended by request.wait_ms(), the tablet may hold the request that long
+    base::Status SubscribeBinlog(const ::openmldb::api::SubscribeBinlogRequest& request,
+                                 ::openmldb::api::SubscribeBinlogResponse* response);
+
     bool CancelOP(const uint64_t op_id);
 
     bool UpdateRealEndpointMap(const std::map<std::string, std::string>& map);
@@ -222,7 +252,7 @@ class TabletClient : public Client {
 
     bool CallProcedure(const std::string& db, const std::string& sp_name, const base::Slice& row,
                        brpc::Controller* cntl, openmldb::api::QueryResponse* response, bool is_debug,
-                       uint64_t timeout_ms);
+                       uint64_t timeout_ms, const ::openmldb::api::FollowerRead* follower_read = nullptr);
 
     bool CallSQLBatchRequestProcedure(const std::string& db, const std::string& sp_name,
                                       std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>, brpc::Controller* cntl,
@@ -2751,7 +2751,11 @@ void HandleNSShowOPStatus(const std::vector<std::string>& parts, ::openmldb::cli
             row.push_back("-");
             row.push_back("-");
         }
-        row.push_back(response.op_status(idx).task_type());
+        if (response.op_status(idx).has_progress()) {
+            row.push_back(response.op_status(idx).task_type() + " " + response.op_status(idx).progress());
+        } else {
+            row.push_back(response.op_status(idx).task_type());
+        }
         if (response.op_status(idx).for_replica_cluster() == 1) {
             row.push_back("yes");
         } else {
@@ -634,6 +634,57 @@ TEST_P(DBSDKTest, LoadDataMultipleFiles) {
     HandleSQL("drop database test1;");
 }
 
+TEST_P(DBSDKTest, LoadDataPipeline) {
+    auto cli = GetParam();
+    cs = cli->cs;
+    sr = cli->sr;
+    HandleSQL("SET @@execute_mode='online';");
+    HandleSQL("create database test1;");
+    HandleSQL("use test1;");
+    HandleSQL("create table trans (c1 string, c2 int, index(key=c1, ts=c2));");
+    std::filesystem::path tmp_path = std::filesystem::temp_directory_path() / "load_pipeline_test";
+    ASSERT_TRUE(base::MkdirRecur(tmp_path.string()));
+    absl::Cleanup clean = [&tmp_path]() { std::filesystem::remove_all(tmp_path); };
+    // more lines than a chunk and a batch, so every file is split and put by several workers
+    int file_num = 3;
+    int line_num = 2500;
+    for (int j = 0; j < file_num; j++) {
+        std::ofstream ofile(tmp_path / absl::StrCat("myfile-", j, ".csv"));
+        ofile << "c1,c2" << std::endl;
+        for (int i = 0; i < line_num; i++) {
+            ofile << "key" << (i % 100) << "," << (j * line_num + i) << std::endl;
+        }
+    }
+    std::string load_sql = "LOAD DATA INFILE 'file://" + (tmp_path / "myfile*").string() +
+                           "' INTO TABLE trans options(load_mode='local', thread=4);";
+    hybridse::sdk::Status status;
+    sr->ExecuteSQL(load_sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.ToString();
+    ASSERT_EQ(status.msg, absl::StrCat("Load ", file_num * line_num, " rows"));
+    auto result = sr->ExecuteSQL("select * from trans;", &status);
+    ASSERT_TRUE(status.IsOK()) << status.ToString();
+    ASSERT_EQ(file_num * line_num, result->Size());
+    result = sr->ExecuteSQL("select * from trans where c1 = 'key7';", &status);
+    ASSERT_TRUE(status.IsOK()) << status.ToString();
+    ASSERT_EQ(file_num * line_num / 100, result->Size());
+
+    // a bad line in the middle of a file is reported by its line number
+    {
+        std::ofstream ofile(tmp_path / "bad.csv");
+        ofile << "c1,c2" << std::endl;
+        for (int i = 0; i < line_num; i++) {
+            ofile << "bad" << "," << (i == 1500 ? "x" : std::to_string(i)) << std::endl;
+        }
+    }
+    load_sql = "LOAD DATA INFILE '" + (tmp_path / "bad.csv").string() +
+               "' INTO TABLE trans options(load_mode='local', thread=2);";
+    sr->ExecuteSQL(load_sql, &status);
+    ASSERT_FALSE(status.IsOK());
+    ASSERT_TRUE(status.msg.find("lineno=1501") != std::string::npos) << status.msg;
+    HandleSQL("drop table trans;");
+    HandleSQL("drop database test1;");
+}
+
 TEST_P(DBSDKTest, LoadData) {
     auto cli = GetParam();
     cs = cli->cs;
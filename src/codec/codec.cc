@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <array>
+#include <string_view>
 #include <unordered_set>
 
 #include "base/glog_wrapper.h"
@@ -1152,5 +1153,216 @@ bool RowProject::Project(const int8_t* row_ptr, uint32_t size, int8_t** output_p
     return true;
 }
 
+RowFilter::RowFilter(const std::map<int32_t, std::shared_ptr<Schema>>& vers_schema, const FilterList& filters)
+    : filters_(filters),
+      conditions_(),
+      vers_views_(),
+      vers_schema_(vers_schema),
+      cur_rv_(nullptr),
+      cur_col_num_(0),
+      cur_ver_(0) {}
+
+bool RowFilter::Init() {
+    if (filters_.size() <= 0) {
+        LOG(WARNING) << "filter list is empty";
+        return false;
+    }
+    if (vers_schema_.empty()) {
+        LOG(WARNING) << "empty schema";
+        return false;
+    }
+    // the type of a column never changes, check the conditions with the latest schema
+    const auto& latest_schema = vers_schema_.rbegin()->second;
+    for (const auto& filter : filters_) {
+        Condition cond;
+        cond.col_idx = filter.col_idx();
+        cond.op = filter.op();
+        if (cond.col_idx >= static_cast<uint32_t>(latest_schema->size())) {
+            LOG(WARNING) << "invalid filter column idx " << cond.col_idx;
+            return false;
+        }
+        cond.type = latest_schema->Get(cond.col_idx).data_type();
+        cond.int_val = 0;
+        cond.double_val = 0;
+        if (cond.op != ::openmldb::common::kCmpIsNull && cond.op != ::openmldb::common::kCmpIsNotNull &&
+            !ParseLiteral(filter, &cond)) {
+            LOG(WARNING) << "invalid filter literal " << filter.value() << " of column "
+                         << latest_schema->Get(cond.col_idx).name();
+            return false;
+        }
+        conditions_.push_back(std::move(cond));
+    }
+    for (const auto& sch : vers_schema_) {
+        vers_views_.emplace(sch.first, std::make_shared<RowView>(*sch.second));
+    }
+    return true;
+}
+
+bool RowFilter::ParseLiteral(const ::openmldb::common::FilterCondition& filter, Condition* cond) {
+    const std::string& value = filter.value();
+    try {
+        switch (cond->type) {
+            case ::openmldb::type::kBool: {
+                if (value == "true" || value == "1") {
+                    cond->int_val = 1;
+                } else if (value == "false" || value == "0") {
+                    cond->int_val = 0;
+                } else {
+                    return false;
+                }
+                break;
+            }
+            case ::openmldb::type::kSmallInt:
+            case ::openmldb::type::kInt:
+            case ::openmldb::type::kBigInt:
+            case ::openmldb::type::kTimestamp:
+                cond->int_val = boost::lexical_cast<int64_t>(value);
+                break;
+            case ::openmldb::type::kDate: {
+                uint32_t year = 0, month = 0, day = 0, date = 0;
+                if (sscanf(value.c_str(), "%u-%u-%u", &year, &month, &day) != 3 ||  // NOLINT
+                    !RowBuilder::ConvertDate(year, month, day, &date)) {
+                    return false;
+                }
+                cond->int_val = static_cast<int32_t>(date);
+                break;
+            }
+            case ::openmldb::type::kFloat:
+                // compare in the precision of the column
+                cond->double_val = boost::lexical_cast<float>(value);
+                break;
+            case ::openmldb::type::kDouble:
+                cond->double_val = boost::lexical_cast<double>(value);
+                break;
+            case ::openmldb::type::kString:
+            case ::openmldb::type::kVarchar:
+                cond->str_val = value;
+                break;
+            default:
+                return false;
+        }
+    } catch (const boost::bad_lexical_cast&) {
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+static bool Compare(const T& lhs, const T& rhs, ::openmldb::common::CompareOp op) {
+    switch (op) {
+        case ::openmldb::common::kCmpEq:
+            return lhs == rhs;
+        case ::openmldb::common::kCmpNe:
+            return lhs != rhs;
+        case ::openmldb::common::kCmpLt:
+            return lhs < rhs;
+        case ::openmldb::common::kCmpLe:
+            return lhs <= rhs;
+        case ::openmldb::common::kCmpGt:
+            return lhs > rhs;
+        case ::openmldb::common::kCmpGe:
+            return lhs >= rhs;
+        default:
+            return false;
+    }
+}
+
+int32_t RowFilter::MatchCondition(const Condition& cond) {
+    // the column added later is null in the rows of the old schema
+    bool is_null = cond.col_idx >= cur_col_num_ || cur_rv_->IsNULL(cond.col_idx);
+    if (cond.op == ::openmldb::common::kCmpIsNull) {
+        return is_null ? 1 : 0;
+    } else if (cond.op == ::openmldb::common::kCmpIsNotNull) {
+        return is_null ? 0 : 1;
+    } else if (is_null) {
+        return 0;
+    }
+    int32_t ret = 0;
+    switch (cond.type) {
+        case ::openmldb::type::kBool: {
+            bool val = false;
+            ret = cur_rv_->GetBool(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val ? 1 : 0, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kSmallInt: {
+            int16_t val = 0;
+            ret = cur_rv_->GetInt16(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kInt: {
+            int32_t val = 0;
+            ret = cur_rv_->GetInt32(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kDate: {
+            int32_t val = 0;
+            ret = cur_rv_->GetDate(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kBigInt: {
+            int64_t val = 0;
+            ret = cur_rv_->GetInt64(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kTimestamp: {
+            int64_t val = 0;
+            ret = cur_rv_->GetTimestamp(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<int64_t>(val, cond.int_val, cond.op);
+        }
+        case ::openmldb::type::kFloat: {
+            float val = 0;
+            ret = cur_rv_->GetFloat(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<double>(val, cond.double_val, cond.op);
+        }
+        case ::openmldb::type::kDouble: {
+            double val = 0;
+            ret = cur_rv_->GetDouble(cond.col_idx, &val);
+            return ret != 0 ? -1 : Compare<double>(val, cond.double_val, cond.op);
+        }
+        case ::openmldb::type::kString:
+        case ::openmldb::type::kVarchar: {
+            char* val = nullptr;
+            uint32_t length = 0;
+            ret = cur_rv_->GetString(cond.col_idx, &val, &length);
+            if (ret != 0) {
+                return -1;
+            }
+            return Compare<std::string_view>(std::string_view(val, length), cond.str_val, cond.op);
+        }
+        default:
+            return -1;
+    }
+}
+
+bool RowFilter::Match(const int8_t* row_ptr, uint32_t row_size, bool* matched) {
+    if (row_ptr == nullptr || matched == nullptr) return false;
+    uint8_t version = openmldb::codec::RowView::GetSchemaVersion(row_ptr);
+    if (!cur_rv_ || version != cur_ver_) {
+        auto it = vers_views_.find(version);
+        if (it == vers_views_.end()) {
+            LOG(WARNING) << "not found valid row view for ver " << unsigned(version);
+            return false;
+        }
+        cur_rv_ = it->second;
+        cur_ver_ = version;
+        cur_col_num_ = vers_schema_.find(version)->second->size();
+    }
+    if (!cur_rv_->Reset(row_ptr, row_size)) {
+        return false;
+    }
+    for (const auto& cond : conditions_) {
+        int32_t ret = MatchCondition(cond);
+        if (ret < 0) {
+            PDLOG(WARNING, "fail to evaluate the filter on column idx %u", cond.col_idx);
+            return false;
+        } else if (ret == 0) {
+            *matched = false;
+            return true;
+        }
+    }
+    *matched = true;
+    return true;
+}
+
 }  // namespace codec
 }  // namespace openmldb
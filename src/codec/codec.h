@@ -31,6 +31,7 @@ namespace openmldb {
 namespace codec {
 
 using ProjectList = ::google::protobuf::RepeatedField<uint32_t>;
+using FilterList = ::google::protobuf::RepeatedPtrField<::openmldb::common::FilterCondition>;
 using Schema = ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc>;
 inline constexpr uint8_t VERSION_LENGTH = 2;
 inline constexpr uint8_t SIZE_LENGTH = 4;
@@ -65,6 +66,42 @@ class RowProject {
     uint32_t cur_ver_;
 };
 
+// Evaluate the conjunction of the filter conditions on encoded rows, the literals are parsed only once in Init
+class RowFilter {
+ public:
+    RowFilter(const std::map<int32_t, std::shared_ptr<Schema>>& vers_schema, const FilterList& filters);
+
+    bool Init();
+
+    // return false if the row can not be decoded, `matched` is valid only if it returns true
+    bool Match(const int8_t* row_ptr, uint32_t row_size, bool* matched);
+
+ private:
+    struct Condition {
+        uint32_t col_idx;
+        ::openmldb::common::CompareOp op;
+        ::openmldb::type::DataType type;
+        // bool, integer, date and timestamp literal
+        int64_t int_val;
+        // float and double literal
+        double double_val;
+        std::string str_val;
+    };
+
+    bool ParseLiteral(const ::openmldb::common::FilterCondition& filter, Condition* cond);
+    // return 1 if matched, 0 if not matched and -1 if failed
+    int32_t MatchCondition(const Condition& cond);
+
+ private:
+    const FilterList& filters_;
+    std::vector<Condition> conditions_;
+    std::map<int32_t, std::shared_ptr<RowView>> vers_views_;
+    std::map<int32_t, std::shared_ptr<Schema>> vers_schema_;
+    std::shared_ptr<RowView> cur_rv_;
+    uint32_t cur_col_num_;
+    uint32_t cur_ver_;
+};
+
 class RowBuilder {
  public:
     explicit RowBuilder(const Schema& schema);
@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "boost/container/deque.hpp"
@@ -542,6 +544,84 @@ TEST_F(CodecTest, RowBuilderSet) {
     ASSERT_EQ(ts, 1668149927000);
 }
 
+TEST_F(CodecTest, RowFilter) {
+    auto schema = std::make_shared<Schema>();
+    ::openmldb::common::ColumnDesc* col = schema->Add();
+    col->set_name("col1");
+    col->set_data_type(::openmldb::type::kInt);
+    col = schema->Add();
+    col->set_name("col2");
+    col->set_data_type(::openmldb::type::kFloat);
+    col = schema->Add();
+    col->set_name("col3");
+    col->set_data_type(::openmldb::type::kDate);
+    col = schema->Add();
+    col->set_name("col4");
+    col->set_data_type(::openmldb::type::kString);
+    col = schema->Add();
+    col->set_name("col5");
+    col->set_data_type(::openmldb::type::kBigInt);
+    RowBuilder builder(*schema);
+    std::string st("hello");
+    uint32_t size = builder.CalTotalLength(st.size());
+    std::string row;
+    row.resize(size);
+    builder.SetBuffer(reinterpret_cast<int8_t*>(&(row[0])), size);
+    ASSERT_TRUE(builder.AppendInt32(10));
+    ASSERT_TRUE(builder.AppendFloat(1.1));
+    ASSERT_TRUE(builder.AppendDate(2021, 5, 20));
+    ASSERT_TRUE(builder.AppendString(st.c_str(), st.size()));
+    ASSERT_TRUE(builder.AppendNULL());
+    std::map<int32_t, std::shared_ptr<Schema>> vers_schema = {{1, schema}};
+
+    auto check = [&](const std::vector<std::tuple<uint32_t, ::openmldb::common::CompareOp, std::string>>& conds,
+                     bool expect) {
+        FilterList filters;
+        for (const auto& cond : conds) {
+            auto filter = filters.Add();
+            filter->set_col_idx(std::get<0>(cond));
+            filter->set_op(std::get<1>(cond));
+            filter->set_value(std::get<2>(cond));
+        }
+        RowFilter row_filter(vers_schema, filters);
+        ASSERT_TRUE(row_filter.Init());
+        bool matched = !expect;
+        ASSERT_TRUE(row_filter.Match(reinterpret_cast<int8_t*>(&(row[0])), size, &matched));
+        ASSERT_EQ(expect, matched);
+    };
+    check({{0, ::openmldb::common::kCmpEq, "10"}}, true);
+    check({{0, ::openmldb::common::kCmpGt, "10"}}, false);
+    check({{0, ::openmldb::common::kCmpGe, "10"}, {1, ::openmldb::common::kCmpEq, "1.1"}}, true);
+    check({{2, ::openmldb::common::kCmpLt, "2021-05-21"}, {3, ::openmldb::common::kCmpEq, "hello"}}, true);
+    check({{2, ::openmldb::common::kCmpLt, "2021-05-20"}, {3, ::openmldb::common::kCmpEq, "hello"}}, false);
+    check({{3, ::openmldb::common::kCmpNe, "hell"}, {3, ::openmldb::common::kCmpGt, "hell"}}, true);
+    check({{4, ::openmldb::common::kCmpIsNull, ""}}, true);
+    check({{4, ::openmldb::common::kCmpIsNotNull, ""}}, false);
+    // comparing with null never matches
+    check({{4, ::openmldb::common::kCmpNe, "1"}}, false);
+
+    // the column doesn't exist in the old schema is null
+    auto new_schema = std::make_shared<Schema>(*schema);
+    col = new_schema->Add();
+    col->set_name("col6");
+    col->set_data_type(::openmldb::type::kInt);
+    vers_schema.emplace(2, new_schema);
+    check({{5, ::openmldb::common::kCmpIsNull, ""}, {0, ::openmldb::common::kCmpEq, "10"}}, true);
+
+    // invalid literal or column
+    FilterList filters;
+    auto filter = filters.Add();
+    filter->set_col_idx(0);
+    filter->set_op(::openmldb::common::kCmpEq);
+    filter->set_value("abc");
+    RowFilter invalid_literal(vers_schema, filters);
+    ASSERT_FALSE(invalid_literal.Init());
+    filter->set_col_idx(6);
+    filter->set_value("1");
+    RowFilter invalid_col(vers_schema, filters);
+    ASSERT_FALSE(invalid_col.Init());
+}
+
 TEST_F(CodecTest, Encrypt) {
     ASSERT_EQ(SHA256("root"), "4813494d137e1631bba301d5acab6e7bb7aa74ce1185d456565ef51d737677b2");
     ASSERT_EQ(SHA256(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
@@ -50,6 +50,11 @@ DEFINE_uint64(sync_task_long_interval_ms, 5000,
 DEFINE_uint64(sync_task_short_interval_ms, 1000,
               "interval of one sync task, if has next data to send, use this one, should be smaller than sync tool "
               "sync_task.check_period");
+DEFINE_bool(collector_subscribe_binlog, true,
+            "read the binlog by subscribing it from the tablet server, the hard linked binlog files are read only if "
+            "the subscription fails");
+DEFINE_uint32(collector_subscribe_wait_ms, 500,
+              "the time the tablet server holds a binlog subscription for the new entries if there is nothing to read");
 
 namespace fs = std::filesystem;
 namespace openmldb::datacollector {
@@ -448,7 +453,7 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
         LOG(WARNING) << "task not exist(deleted), tid: " << tid << ", pid: " << pid << ", reject task";
         return;
     }
-    LOG(INFO) << "sync once task: " << task.ShortDebugString();
+    VLOG(1) << "sync once task: " << task.ShortDebugString();
     auto name = EncodeId(tid, pid);
     auto start_point = task.sync_point();
     auto mode = task.mode();
@@ -489,8 +494,9 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
     uint64_t count = 0;
     decltype(start_point) next_point;
     bool meet_binlog_end = false;
+    bool subscribed = false;
     // we can do switch in it
-    if (!PackData(task, &io_buf, &count, &next_point, &meet_binlog_end)) {
+    if (!PackData(task, &io_buf, &count, &next_point, &meet_binlog_end, &subscribed)) {
         LOG(WARNING) << "fail to pack data, reject task: " << task.ShortDebugString();
         return;
     }
@@ -498,7 +504,8 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
     VLOG(1) << "pack cnt:" << count << "-size:" << io_buf.size() << ", start " << start_point.ShortDebugString()
               << ", next: " << next_point.ShortDebugString();
 
-    bool delay_longer = meet_binlog_end;
+    // the subscription has waited for the new entries already
+    bool delay_longer = meet_binlog_end && !subscribed;
     bool is_finished = false;
     // even count is 0(all data in snapshot, binlog is empty)
     if (meet_binlog_end && mode == datasync::SyncMode::kFull) {
@@ -524,15 +531,18 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
         }
 
         // validate meet_binlog_end if start_point is binlog(don't check by next_point, cuz it won't update
-        // meet_binlog_end when snapshot->binlog, just check start_point)
-        if (start_point.type() == datasync::SyncType::kBINLOG && !meet_binlog_end) {
+        // meet_binlog_end when snapshot->binlog, just check start_point). A subscribed batch may be all skipped
+        // entries, it's ok if the offset moves forward. It may be empty before the entries written are readable
+        // by the tablet, then sync them in the next round.
+        if (start_point.type() == datasync::SyncType::kBINLOG && !meet_binlog_end && !subscribed &&
+            next_point.offset() <= start_point.offset()) {
             LOG(ERROR) << "why binlog can't get any data and can't meet binlog end? reject task: "
                        << task.ShortDebugString();
             return;
         }
 
         if (google::protobuf::util::MessageDifferencer::Equals(start_point, next_point)) {
-            LOG(INFO) << "sync point not changed, skip update in file: " << task.ShortDebugString();
+            VLOG(1) << "sync point not changed, skip update in file: " << task.ShortDebugString();
             need_update = false;
         }
     }
@@ -540,7 +550,7 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
     decltype(task) updated_task;
     // DO NOT use io_buf after this line, because io_buf may be moved
     datasync::SendDataResponse response;
-    LOG(INFO) << "send data, task: " << task.ShortDebugString() << ", count: " << count
+    VLOG(1) << "send data, task: " << task.ShortDebugString() << ", count: " << count
               << ", is_finished: " << is_finished << ", next_point: " << next_point.ShortDebugString()
               << ", io_buf size: " << io_buf.size();
     auto ok = SendDataUnlock(&task, io_buf, count, next_point, is_finished, &response, &updated_task);
@@ -588,6 +598,9 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
     if (delay_longer) {
         // if meet binlog end, we can delay the next sync longer TODO(hw): param
         task_pool_.DelayTask(FLAGS_sync_task_long_interval_ms, std::bind(&DataCollectorImpl::SyncOnce, this, tid, pid));
+    } else if (subscribed && need_update) {
+        // keep up with the tablet, the next subscription waits if there is nothing new
+        task_pool_.AddTask(std::bind(&DataCollectorImpl::SyncOnce, this, tid, pid));
     } else {
         task_pool_.DelayTask(FLAGS_sync_task_short_interval_ms,
                              std::bind(&DataCollectorImpl::SyncOnce, this, tid, pid));
@@ -595,7 +608,7 @@ void DataCollectorImpl::SyncOnce(uint32_t tid, uint32_t pid) {
 }
 
 bool DataCollectorImpl::PackData(const datasync::AddSyncTaskRequest& task, butil::IOBuf* io_buf, uint64_t* count,
-                                 datasync::SyncPoint* next_point, bool* meet_binlog_end) {
+                                 datasync::SyncPoint* next_point, bool* meet_binlog_end, bool* subscribed) {
     auto name = EncodeId(task.tid(), task.pid());
     auto start_point = task.sync_point();
     auto mode = task.mode();
@@ -674,6 +687,18 @@ bool DataCollectorImpl::PackData(const datasync::AddSyncTaskRequest& task, butil
             next_point->set_offset(snapshot_offset + 1);
         }
     } else {
+        if (FLAGS_collector_subscribe_binlog) {
+            if (mode == datasync::SyncMode::kIncrementalByTimestamp) {
+                *subscribed = PackSubscribedBINLOG(task, pack_with_ts, next_point, meet_binlog_end);
+            } else {
+                *subscribed = PackSubscribedBINLOG(task, pack, next_point, meet_binlog_end);
+            }
+            if (*subscribed) {
+                return true;
+            }
+            // nothing is packed if the subscription fails
+            LOG(WARNING) << "fail to subscribe binlog, read the binlog files, task " << task.ShortDebugString();
+        }
         std::shared_ptr<openmldb::log::LogReader> reader;
         // we read the binlog path in db, it can be shared
         // DO NOT write in the binlog path
@@ -816,6 +841,51 @@ bool DataCollectorImpl::PackBINLOG(std::shared_ptr<log::LogReader> reader, uint6
     return true;
 }
 
+template <typename Func>
+bool DataCollectorImpl::PackSubscribedBINLOG(const datasync::AddSyncTaskRequest& task, Func pack_func,
+                                             datasync::SyncPoint* next_point, bool* meet_binlog_end) {
+    std::shared_ptr<client::TabletClient> tablet_client;
+    {
+        std::lock_guard<std::mutex> lock(process_map_mutex_);
+        auto it = tablet_client_map_.find(task.tablet_endpoint());
+        if (it == tablet_client_map_.end()) {
+            LOG(WARNING) << "tablet client not exist, task " << task.ShortDebugString();
+            return false;
+        }
+        tablet_client = it->second;
+    }
+    api::SubscribeBinlogRequest request;
+    request.set_tid(task.tid());
+    request.set_pid(task.pid());
+    // the token is unique for a task, a new task doesn't resume the reader of the old one
+    request.set_subscriber("datacollector-" + task.token());
+    request.set_offset(task.sync_point().offset());
+    request.set_max_bytes(FLAGS_max_pack_size);
+    request.set_wait_ms(FLAGS_collector_subscribe_wait_ms);
+    // the deletes are not synced, the same as reading the binlog files
+    request.set_skip_delete(true);
+    if (task.mode() == datasync::SyncMode::kIncrementalByTimestamp) {
+        request.set_start_ts(task.start_ts());
+    }
+    api::SubscribeBinlogResponse response;
+    if (auto st = tablet_client->SubscribeBinlog(request, &response); !st.OK()) {
+        LOG(WARNING) << "subscribe binlog failed, " << st.GetCode() << ", " << st.GetMsg();
+        return false;
+    }
+    uint64_t next_offset = response.next_offset();
+    for (const auto& entry : response.entries()) {
+        if (!pack_func(entry.ts(), base::Slice(entry.value()))) {
+            // the current entry is excluded, read it in next
+            next_offset = entry.log_index();
+            break;
+        }
+    }
+    *meet_binlog_end = next_offset > response.log_offset();
+    next_point->set_type(datasync::SyncType::kBINLOG);
+    next_point->set_offset(next_offset);
+    return true;
+}
+
 // use response and update_task iff status == true (the response may be not ok, and should delete the task)
 bool DataCollectorImpl::SendDataUnlock(const datasync::AddSyncTaskRequest* task, butil::IOBuf& data, uint64_t count,
                                        const datasync::SyncPoint& next_point, bool is_finished,
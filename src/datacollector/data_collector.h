@@ -137,14 +137,19 @@ class DataCollectorImpl : public datasync::DataCollector {
                                    const std::string& snapshot_path);
     bool FetchBinlogUnlocked(const std::string& name, const std::string& binlog_path, bool* updated);
 
+    // subscribed is set if the binlog is read by the subscription, not the hard linked files
     bool PackData(const datasync::AddSyncTaskRequest& task, butil::IOBuf* io_buf, uint64_t* count,
-                  datasync::SyncPoint* next_point, bool* meet_binlog_end);
+                  datasync::SyncPoint* next_point, bool* meet_binlog_end, bool* subscribed);
 
     template <typename Func>
     bool PackSNAPSHOT(std::shared_ptr<storage::TraverseIterator> it, Func pack_func, datasync::SyncPoint* next_point);
     template <typename Func>
     bool PackBINLOG(std::shared_ptr<log::LogReader> reader, uint64_t start_offset, Func pack_func,
                     datasync::SyncPoint* next_point, bool* meet_binlog_end);
+    // read the binlog from the tablet server, return false if the subscription fails
+    template <typename Func>
+    bool PackSubscribedBINLOG(const datasync::AddSyncTaskRequest& task, Func pack_func,
+                              datasync::SyncPoint* next_point, bool* meet_binlog_end);
 
     // data will be cleared, whether send success or not
     bool SendDataUnlock(const datasync::AddSyncTaskRequest* task, butil::IOBuf& data, uint64_t count,  // NOLINT
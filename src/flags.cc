@@ -48,6 +48,11 @@ DEFINE_int32(request_timeout, 600000, "rpc request timeout of CLI, unit is milli
 
 DEFINE_int32(get_task_status_interval, 2000, "config the interval of get task status. unit is milliseconds");
 DEFINE_uint32(get_table_status_interval, 2000, "config the interval of get table status. unit is milliseconds");
+DEFINE_uint32(hot_partition_min_qps, 1000,
+              "a partition can be hot only if its leader serves at least so many key reads and writes per second");
+DEFINE_double(hot_partition_factor, 3.0,
+              "a partition is hot if its key reads and writes per second are more than so many times of the average "
+              "of the table");
 DEFINE_uint32(get_table_diskused_interval, 600000, "config the interval of get table diskused. unit is milliseconds");
 DEFINE_uint32(get_memory_stat_interval, 10000, "config the interval of get memory stat. unit is milliseconds");
 DEFINE_int32(name_server_task_pool_size, 8, "config the size of name server task pool");
@@ -60,23 +65,55 @@ DEFINE_uint32(name_server_op_execute_timeout, 2 * 60 * 60 * 1000,
               "config the timeout of nameserver op. unit is milliseconds");
 DEFINE_bool(auto_failover, false, "enable or disable auto failover");
 DEFINE_int32(max_op_num, 10000, "config the max op num");
+DEFINE_uint32(catalog_change_log_size, 1000,
+              "config the max entries of the catalog change log, clients behind it reload all tables");
 DEFINE_uint32(partition_num, 8, "config the default partition_num");
 DEFINE_uint32(replica_num, 3, "config the default replica_num. if set 3, there is one leader and two followers");
 DEFINE_uint32(system_table_replica_num, 1, "config the default replica_num of system table.");
 DEFINE_int32(gc_interval, 120, "the gc interval of tablet every two hour");
 DEFINE_int32(disk_gc_interval, 120, "the rocksdb gc interval of tablet");
+DEFINE_uint32(disk_gc_thread_num, 4, "the threads to scan a disk table for the latest ttl gc");
 DEFINE_int32(gc_pool_size, 2, "the size of tablet gc thread pool");
 DEFINE_int32(gc_safe_offset, 1, "the safe offset of tablet gc in minute");
 DEFINE_uint64(gc_on_table_recover_count, 10000000, "make a gc on recover count");
 DEFINE_uint32(gc_deleted_pk_version_delta, 2, "config the gc version delta");
 DEFINE_double(mem_release_rate, 5, "specify memory release rate, which should be in 0 ~ 10");
+DEFINE_string(mem_cold_tier_root_path, "",
+              "the root path of the on-disk tier of the memory tables of the tablet, the keys not accessed recently "
+              "are spilled to it by the gc when a table partition is over mem_cold_tier_hot_bytes. Empty disables it");
+DEFINE_uint64(mem_cold_tier_hot_bytes, 1024 * 1024 * 1024,
+              "the bytes of the rows kept in memory for each memory table partition if the cold tier is enabled");
 DEFINE_int32(task_pool_size, 3, "the size of tablet task thread pool");
 DEFINE_int32(io_pool_size, 2, "the size of tablet io task thread pool");
 DEFINE_bool(use_name, false, "enable or disable use server name");
 DEFINE_string(data_dir, "./data", "the path of data dir");
 DEFINE_bool(enable_distsql, false, "enable or disable distribute sql");
 DEFINE_bool(enable_localtablet, true, "enable or disable local tablet opt when distribute sql circumstance");
+DEFINE_bool(enable_follower_read, false,
+            "serve sql queries with the follower partitions of the tablet. The followers within "
+            "--follower_read_max_lag are read as local partitions then, by the follower reads of clients and by the "
+            "other queries on the tablet");
+DEFINE_uint32(follower_read_max_lag, 1000,
+              "the max log entries a follower partition is behind the leader to be read as a local partition");
+DEFINE_uint32(follower_read_check_interval, 1000,
+              "the interval in milliseconds to check the lag of the follower partitions, if --enable_follower_read");
+DEFINE_uint32(follower_lag_expire_time, 5000,
+              "the lag of a follower is unknown if no log offset is received from the leader in this time, unit is "
+              "milliseconds");
 DEFINE_string(bucket_size, "1d", "the default bucket size in pre-aggr table");
+DEFINE_uint32(max_aggr_buffer_key_num, 0,
+              "the max keys whose buffers are kept in memory by one pre-aggregator, the least recently updated "
+              "ones are flushed and evicted beyond it and recovered from the pre-aggr table on demand. "
+              "0 means unlimited");
+DEFINE_uint32(aggr_update_thread_num, 0,
+              "apply the rows put to the tables with pre-aggregators by so many background threads instead of on put, "
+              "the rows of a partition are applied by one thread in order. 0 means on put");
+DEFINE_uint32(aggr_update_max_pending, 100000,
+              "the max rows waiting for a background thread to apply them to the pre-aggregators, the puts wait "
+              "beyond it");
+DEFINE_uint32(aggr_update_retry_interval_ms, 100,
+              "retry a failed update of a pre-aggregator in this interval, the later rows of the partition wait for "
+              "it");
 
 // scan configuration
 // max bytes size: write all even if scan result is too large, let it fail in client(receiver)
@@ -91,11 +128,16 @@ DEFINE_bool(binlog_notify_on_put, false, "config the sync log to follower strate
 DEFINE_bool(binlog_enable_crc, false, "enable crc");
 DEFINE_int32(binlog_coffee_time, 1000, "config the coffee time. unit is milliseconds");
 DEFINE_int32(binlog_sync_wait_time, 100, "config the sync log wait time. unit is milliseconds");
+DEFINE_uint32(binlog_heartbeat_interval, 1000,
+              "the interval the leader sends its log offset to the up to date followers, 0 disables it. unit is "
+              "milliseconds");
 DEFINE_int32(binlog_sync_to_disk_interval, 20000,
              "config the interval of sync binlog to disk time. unit is milliseconds");
 DEFINE_int32(binlog_delete_interval, 60000, "config the interval of delete binlog. unit is milliseconds");
 DEFINE_int32(binlog_match_logoffset_interval, 1000, "config the interval of match log offset. unit is milliseconds");
 DEFINE_int32(binlog_name_length, 8, "binlog name length");
+DEFINE_uint32(binlog_tail_cache_size, 10000,
+              "the number of the latest binlog entries kept in memory for the binlog subscribers of a partition");
 DEFINE_uint32(check_binlog_sync_progress_delta, 100000, "config the delta of check binlog sync progress");
 DEFINE_uint32(go_back_max_try_cnt, 10, "config max try time of go back");
 
@@ -109,6 +151,19 @@ DEFINE_string(db_root_path, "/tmp/", "the root path of db");
 DEFINE_int32(put_concurrency_limit, 0, "the limit of put concurrency");
 DEFINE_int32(thread_pool_size, 16, "the size of thread pool for other api");
 DEFINE_int32(get_concurrency_limit, 0, "the limit of get concurrency");
+DEFINE_uint32(tablet_max_concurrency, 0,
+              "the limit of the scheduled tasks of the tablet running at the same time, 0 is unlimited");
+DEFINE_uint32(online_request_max_concurrency, 0, "the limit of the running request mode queries, 0 is unlimited");
+DEFINE_uint32(online_write_max_concurrency, 0, "the limit of the running puts and deletes, 0 is unlimited");
+DEFINE_uint32(batch_query_max_concurrency, 0,
+              "the limit of the running batch queries, scans and traverses, 0 is unlimited");
+DEFINE_uint32(background_max_concurrency, 0, "the limit of the running snapshot and loading tasks, 0 is unlimited");
+DEFINE_uint32(online_request_max_queue_ms, 1000,
+              "the longest wait of a request mode query for a slot before it's rejected, 0 waits until a slot is free");
+DEFINE_uint32(online_write_max_queue_ms, 1000,
+              "the longest wait of a put or delete for a slot before it's rejected, 0 waits until a slot is free");
+DEFINE_uint32(batch_query_max_queue_ms, 10000,
+              "the longest wait of a batch query for a slot before it's rejected, 0 waits until a slot is free");
 DEFINE_int32(request_max_retry, 3, "max retry time when request error");
 DEFINE_int32(request_timeout_ms, 20000, "rpc request timeout of misc. unit is milliseconds");
 DEFINE_int32(request_sleep_time, 1000, "the sleep time when request error. unit is milliseconds");
@@ -118,6 +173,11 @@ DEFINE_uint32(max_memory_mb, 0, "max memory limit");
 DEFINE_uint32(max_traverse_key_cnt, 0, "max traverse iter key cnt");
 DEFINE_uint32(max_traverse_cnt, 0, "max traverse iter loop cnt");
 DEFINE_uint32(traverse_cnt_limit, 1000, "limit traverse cnt");
+DEFINE_uint32(traverse_prefetch_depth, 2,
+              "max traverse pages prefetched ahead per remote partition, 0 means fetching pages on demand");
+DEFINE_uint32(traverse_prefetch_partition_num, 4, "max remote partitions traversed concurrently by one iterator");
+DEFINE_uint64(traverse_prefetch_max_bytes, 64 * 1024 * 1024,
+              "memory budget of the prefetched traverse pages of one iterator");
 DEFINE_string(ssd_root_path, "", "the root ssd path of db");
 DEFINE_string(hdd_root_path, "", "the root hdd path of db");
 
@@ -143,6 +203,10 @@ DEFINE_int32(snapshot_pool_size, 1, "the size of tablet thread pool for making s
 
 DEFINE_uint32(load_index_max_wait_time, 120 * 60 * 1000,
               "config the max wait time of load index. unit is milliseconds");
+DEFINE_uint32(build_index_thread_num, 4, "the number of threads to scan a partition when building new indexes");
+DEFINE_uint32(build_index_batch_size, 500, "the max number of index entries sent to a partition in one request");
+DEFINE_uint64(build_index_max_rows_per_sec, 200000,
+              "the max number of rows scanned per second per partition when building new indexes, 0 means no limit");
 
 DEFINE_string(recycle_bin_root_path, "/tmp/recycle", "specify the root path of recycle bin");
 DEFINE_string(recycle_bin_ssd_root_path, "", "specify the root path of recycle bin in ssd");
@@ -162,6 +226,8 @@ DEFINE_uint32(max_col_display_length, 256, "config the max length of column disp
 DEFINE_uint32(load_table_batch, 30, "set laod table batch size");
 DEFINE_uint32(load_table_thread_num, 3, "set load tabale thread pool size");
 DEFINE_uint32(load_table_queue_size, 1000, "set load tabale queue size");
+DEFINE_bool(load_snapshot_in_parallel, true,
+            "parse the blocks of an uncompressed snapshot in all the load threads, the file is mapped into memory");
 
 // multiple data center
 DEFINE_uint32(get_replica_status_interval, 10000,
@@ -169,6 +235,15 @@ DEFINE_uint32(get_replica_status_interval, 10000,
 
 DEFINE_uint32(sync_deploy_stats_timeout, 10000,
               "time interval in milliseconds to sync deploy response time stats into table");
+DEFINE_uint32(deploy_profile_sample_interval, 0,
+              "profile one of every so many deployment requests and export the time of every runner by bvar, "
+              "0 means disabled");
+DEFINE_uint32(deploy_result_cache_max_mb, 64,
+              "the max size of the result cache of a deployment which enables it by the result_cache_ttl_ms option, "
+              "it's overridden by the result_cache_max_mb option");
+DEFINE_uint32(hot_key_sample_interval, 100,
+              "sample one of every so many key reads and writes of memory tables to find the hot keys, "
+              "0 means disabled");
 
 // config for rocksdb
 DEFINE_bool(disable_wal, true, "If true, do not write WAL for write.");
@@ -430,6 +430,111 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, uint64_t& offset) {
     return type;
 }
 
+MappedReader::MappedReader(const char* data, uint64_t size, uint64_t begin, uint64_t end)
+    : data_(data), size_(size), pos_((begin + kBlockSize - 1) / kBlockSize * kBlockSize), end_(end) {}
+
+Status MappedReader::ReadRecord(Slice* record, std::string* scratch) {
+    scratch->clear();
+    record->clear();
+    bool in_fragmented_record = false;
+    while (true) {
+        Slice fragment;
+        uint64_t offset = 0;
+        const unsigned int record_type = ReadPhysicalRecord(&fragment, &offset);
+        switch (record_type) {
+            case kFullType:
+                if (offset >= end_) {
+                    return Status::Eof();
+                }
+                scratch->clear();
+                *record = fragment;
+                return Status::OK();
+
+            case kFirstType:
+                if (offset >= end_) {
+                    return Status::Eof();
+                }
+                scratch->assign(fragment.data(), fragment.size());
+                in_fragmented_record = true;
+                break;
+
+            case kMiddleType:
+                // the fragments of the record started before the range are skipped
+                if (in_fragmented_record) {
+                    scratch->append(fragment.data(), fragment.size());
+                }
+                break;
+
+            case kLastType:
+                if (in_fragmented_record) {
+                    scratch->append(fragment.data(), fragment.size());
+                    *record = Slice(*scratch);
+                    return Status::OK();
+                }
+                break;
+
+            case kEof:
+                // the file is truncated in the middle of the record
+                scratch->clear();
+                return Status::Eof();
+
+            case kBadRecord:
+                if (!in_fragmented_record && offset >= end_) {
+                    return Status::Eof();
+                }
+                scratch->clear();
+                return Status::InvalidRecord(Slice("kBadRecord"));
+
+            default: {
+                if (!in_fragmented_record && offset >= end_) {
+                    return Status::Eof();
+                }
+                char buf[40];
+                snprintf(buf, sizeof(buf), "unknown record type %u", record_type);
+                scratch->clear();
+                return Status::InvalidRecord(Slice(buf, strlen(buf)));
+            }
+        }
+    }
+}
+
+unsigned int MappedReader::ReadPhysicalRecord(Slice* fragment, uint64_t* offset) {
+    while (true) {
+        if (pos_ + kHeaderSize > size_) {
+            pos_ = size_;
+            return kEof;
+        }
+        uint64_t block_left = kBlockSize - pos_ % kBlockSize;
+        // the trailer of the block
+        if (block_left < kHeaderSize) {
+            pos_ += block_left;
+            continue;
+        }
+        const char* header = data_ + pos_;
+        const uint32_t a = static_cast<uint32_t>(header[4]) & 0xff;
+        const uint32_t b = static_cast<uint32_t>(header[5]) & 0xff;
+        const unsigned int type = header[6];
+        const uint32_t length = a | (b << 8);
+        *offset = pos_;
+        if (kHeaderSize + length > block_left || pos_ + kHeaderSize + length > size_) {
+            // the length may be corrupted, drop the rest of the block as Reader does
+            pos_ += block_left;
+            return kBadRecord;
+        }
+        if (type == kEofType && length == 0) {
+            pos_ = size_;
+            return kEof;
+        }
+        if (type == kZeroType && length == 0) {
+            pos_ += block_left;
+            return kBadRecord;
+        }
+        pos_ += kHeaderSize + length;
+        *fragment = Slice(header + kHeaderSize, length);
+        return type;
+    }
+}
+
 LogReader::LogReader(LogParts* logs, const std::string& log_path, bool compressed) : log_path_(log_path) {
     sf_ = NULL;
     reader_ = NULL;
@@ -147,6 +147,36 @@ class Reader {
     void operator=(const Reader&);
 };
 
+// Read the records of an uncompressed log file which is mapped into memory. Only the records whose first fragment
+// starts in [begin, end) are returned, so the ranges of a file cut at the block boundaries are read by different
+// threads without a record being lost or read twice. A record of one fragment is returned without a copy
+class MappedReader {
+ public:
+    // `begin` is rounded up to a block boundary
+    MappedReader(const char* data, uint64_t size, uint64_t begin, uint64_t end);
+
+    // the same as Reader::ReadRecord, but Eof is returned after the last record of the range
+    Status ReadRecord(Slice* record, std::string* scratch);
+
+    MappedReader(const MappedReader&) = delete;
+    MappedReader& operator=(const MappedReader&) = delete;
+
+ private:
+    enum {
+        kEof = kMaxRecordType + 1,
+        kBadRecord = kMaxRecordType + 2
+    };
+
+    // return the type or one of the special values above, `offset` is where the physical record starts
+    unsigned int ReadPhysicalRecord(Slice* fragment, uint64_t* offset);
+
+ private:
+    const char* data_;
+    uint64_t size_;
+    uint64_t pos_;
+    uint64_t end_;
+};
+
 typedef ::openmldb::base::Skiplist<uint32_t, uint64_t, ::openmldb::base::DefaultComparator> LogParts;
 
 class LogReader {
@@ -21,7 +21,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 #include "base/file_util.h"
@@ -285,6 +288,46 @@ TEST_F(LogWRTest, TestLogEntry) {
     }
 }
 
+TEST_F(LogWRTest, TestMappedReader) {
+    if (compressed_) {
+        return;
+    }
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    std::string fname = "test.log";
+    std::string full_path = log_dir + "/" + fname;
+    FILE* fd_w = fopen(full_path.c_str(), "ab+");
+    ASSERT_TRUE(fd_w != NULL);
+    WritableFile* wf = NewWritableFile(fname, fd_w);
+    Writer writer(FLAGS_snapshot_compression, wf);
+    // the records in one fragment, across two blocks and across many blocks
+    std::vector<std::string> records;
+    for (int i = 0; i < 200; i++) {
+        size_t len = i % 10 == 0 ? kBlockSize * 3 + i : static_cast<size_t>(rand() % 3000 + 1);  // NOLINT
+        records.push_back(std::string(len, static_cast<char>('a' + i % 26)) + std::to_string(i));
+        ASSERT_TRUE(writer.AddRecord(records.back()).ok());
+    }
+    ASSERT_TRUE(writer.EndLog().ok());
+    delete wf;
+    std::ifstream ifs(full_path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ASSERT_GT(data.size(), kBlockSize * 10);
+    for (uint64_t range_size : {static_cast<uint64_t>(kBlockSize), kBlockSize * 7ul, data.size()}) {
+        std::vector<std::string> read_records;
+        for (uint64_t begin = 0; begin < data.size(); begin += range_size) {
+            MappedReader reader(data.data(), data.size(), begin, std::min(begin + range_size, data.size()));
+            std::string scratch;
+            Slice record;
+            Status status;
+            while ((status = reader.ReadRecord(&record, &scratch)).ok()) {
+                read_records.push_back(record.ToString());
+            }
+            ASSERT_TRUE(status.IsEof());
+        }
+        ASSERT_EQ(records, read_records);
+    }
+}
+
 TEST_F(LogWRTest, TestWait) {
     std::string log_dir = "/tmp/" + GenRand() + "/";
     ::openmldb::base::MkdirRecur(log_dir);
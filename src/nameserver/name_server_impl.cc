@@ -66,6 +66,8 @@ DECLARE_bool(auto_failover);
 DECLARE_uint32(tablet_heartbeat_timeout);
 DECLARE_uint32(tablet_offline_check_interval);
 DECLARE_uint32(get_table_status_interval);
+DECLARE_uint32(hot_partition_min_qps);
+DECLARE_double(hot_partition_factor);
 DECLARE_uint32(name_server_task_max_concurrency);
 DECLARE_uint32(check_binlog_sync_progress_delta);
 DECLARE_uint32(name_server_op_execute_timeout);
@@ -74,6 +76,7 @@ DECLARE_int32(make_snapshot_time);
 DECLARE_int32(make_snapshot_check_interval);
 DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
+DECLARE_uint32(catalog_change_log_size);
 
 namespace openmldb {
 namespace nameserver {
@@ -2775,6 +2778,11 @@ void NameServerImpl::ShowOPStatus(RpcController* controller, const ShowOPStatusR
         } else {
             std::shared_ptr<Task> task = kv.second->task_list_.front();
             op_status->set_task_type(::openmldb::api::TaskType_Name(task->task_info_->task_type()));
+            uint64_t processed_cnt = 0;
+            uint64_t total_cnt = 0;
+            if (task->GetProgress(&processed_cnt, &total_cnt)) {
+                op_status->set_progress(absl::StrCat(processed_cnt, "/", total_cnt));
+            }
         }
         op_status->set_start_time(kv.second->op_info_.start_time());
         op_status->set_end_time(kv.second->op_info_.end_time());
@@ -2995,6 +3003,7 @@ void NameServerImpl::DropTableInternel(const DropTableRequest& request, GeneralR
                 code = base::ReturnCode::kSetZkFailed;
             } else {
                 PDLOG(INFO, "delete table node[%s/%u]", zk_path_.db_table_data_path_.c_str(), tid);
+                AppendCatalogChange(catalog::CatalogChangeType::kTable, std::to_string(tid));
                 db_table_info_[db].erase(name);
             }
         } else {
@@ -3548,6 +3557,7 @@ bool NameServerImpl::SetTableInfo(std::shared_ptr<::openmldb::nameserver::TableI
         }
         PDLOG(INFO, "create db table node[%s/%u] success! value[%s] value_size[%u]",
               zk_path_.db_table_data_path_.c_str(), table_info->tid(), table_value.c_str(), table_value.length());
+        AppendCatalogChange(catalog::CatalogChangeType::kTable, std::to_string(table_info->tid()));
         {
             std::lock_guard<std::mutex> lock(mu_);
             db_table_info_[table_info->db()].insert(std::make_pair(table_info->name(), table_info));
@@ -3795,6 +3805,7 @@ bool NameServerImpl::SaveTableInfo(std::shared_ptr<TableInfo> table_info) {
         }
         PDLOG(INFO, "create db table node[%s/%s] success!", zk_path_.db_table_data_path_.c_str(),
               table_info->name().c_str());
+        AppendCatalogChange(catalog::CatalogChangeType::kTable, std::to_string(table_info->tid()));
     }
     return true;
 }
@@ -5085,9 +5096,19 @@ void NameServerImpl::UpdateTableStatus() {
     if (pos_response.empty()) {
         DEBUGLOG("pos_response is empty");
     } else {
-        UpdateTableStatusFun(table_info_, pos_response);
+        uint64_t now_ms = ::baidu::common::timer::get_micros() / 1000;
+        UpdateTableStatusFun(table_info_, pos_response, now_ms);
         for (const auto& kv : db_table_info_) {
-            UpdateTableStatusFun(kv.second, pos_response);
+            UpdateTableStatusFun(kv.second, pos_response, now_ms);
+        }
+        // the partitions of the dropped tables
+        std::lock_guard<std::mutex> lock(mu_);
+        for (auto it = partition_load_.begin(); it != partition_load_.end();) {
+            if (it->second.time_ms < now_ms) {
+                it = partition_load_.erase(it);
+            } else {
+                it++;
+            }
         }
     }
     if (running_.load(std::memory_order_acquire)) {
@@ -5098,7 +5119,7 @@ void NameServerImpl::UpdateTableStatus() {
 
 void NameServerImpl::UpdateTableStatusFun(
     const std::map<std::string, std::shared_ptr<TableInfo>>& table_info_map,
-    const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response) {
+    const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response, uint64_t now_ms) {
     std::lock_guard<std::mutex> lock(mu_);
     for (const auto& kv : table_info_map) {
         uint32_t tid = kv.second->tid();
@@ -5142,12 +5163,66 @@ void NameServerImpl::UpdateTableStatusFun(
                         table_partition->set_record_byte_size(table_status.record_byte_size() +
                                                               table_status.record_idx_byte_size());
                         table_partition->set_diskused(table_status.diskused());
+                        UpdatePartitionLoad(tid, table_partition->pid(), endpoint, table_status, now_ms);
                     }
                     tablet_has_partition = true;
                 }
                 partition_meta->set_tablet_has_partition(tablet_has_partition);
             }
         }
+        DetectHotPartition(*kv.second);
+    }
+}
+
+void NameServerImpl::UpdatePartitionLoad(uint32_t tid, uint32_t pid, const std::string& endpoint,
+                                         const ::openmldb::api::TableStatus& status, uint64_t now_ms) {
+    auto& load = partition_load_[std::make_pair(tid, pid)];
+    uint64_t access_cnt = status.read_cnt() + status.write_cnt();
+    // the counters restart if the leader is changed or the table is reloaded
+    if (load.endpoint == endpoint && access_cnt >= load.access_cnt && now_ms > load.time_ms) {
+        load.qps = (access_cnt - load.access_cnt) * 1000 / (now_ms - load.time_ms);
+    } else {
+        load.qps = 0;
+    }
+    load.endpoint = endpoint;
+    load.access_cnt = access_cnt;
+    load.time_ms = now_ms;
+    if (status.hot_keys_size() > 0) {
+        const auto& key = status.hot_keys(0);
+        load.hot_key = absl::StrCat(key.key(), " of index ", key.idx());
+    } else {
+        load.hot_key.clear();
+    }
+}
+
+void NameServerImpl::DetectHotPartition(const TableInfo& table_info) {
+    int partition_num = table_info.table_partition_size();
+    if (partition_num < 2) {
+        return;
+    }
+    std::vector<std::pair<uint32_t, PartitionLoad*>> loads;
+    uint64_t total_qps = 0;
+    for (const auto& table_partition : table_info.table_partition()) {
+        auto it = partition_load_.find(std::make_pair(table_info.tid(), table_partition.pid()));
+        if (it != partition_load_.end()) {
+            loads.emplace_back(table_partition.pid(), &it->second);
+            total_qps += it->second.qps;
+        }
+    }
+    for (const auto& [pid, load_ptr] : loads) {
+        auto& load = *load_ptr;
+        // compared with the other partitions, a partition can't be much hotter than an average including itself
+        double avg_qps = static_cast<double>(total_qps - load.qps) / (partition_num - 1);
+        bool is_hot = load.qps >= FLAGS_hot_partition_min_qps && load.qps > avg_qps * FLAGS_hot_partition_factor;
+        if (is_hot && !load.is_hot) {
+            PDLOG(WARNING, "partition is hot. table %s tid %u pid %u leader %s qps %lu others %.0f hottest key %s",
+                  table_info.name().c_str(), table_info.tid(), pid, load.endpoint.c_str(), load.qps, avg_qps,
+                  load.hot_key.c_str());
+        } else if (!is_hot && load.is_hot) {
+            PDLOG(INFO, "partition is not hot. table %s tid %u pid %u qps %lu others %.0f",
+                  table_info.name().c_str(), table_info.tid(), pid, load.qps, avg_qps);
+        }
+        load.is_hot = is_hot;
     }
 }
 
@@ -7413,6 +7488,16 @@ void NameServerImpl::NotifyTableChanged(::openmldb::type::NotifyType type) {
     }
 }
 
+void NameServerImpl::AppendCatalogChange(catalog::CatalogChangeType type, const std::string& node) {
+    if (!IsClusterMode()) {
+        return;
+    }
+    if (!catalog::ZkCatalogCache::AppendChange(zk_client_, zk_path_.root_path_, type, node,
+                                               FLAGS_catalog_change_log_size)) {
+        PDLOG(WARNING, "append catalog change failed. node is %s", node.c_str());
+    }
+}
+
 bool NameServerImpl::GetTableInfo(const std::string& table_name, const std::string& db_name,
                                   std::shared_ptr<TableInfo>* table_info) {
     std::lock_guard<std::mutex> lock(mu_);
@@ -8416,6 +8501,9 @@ bool NameServerImpl::UpdateZkTableNodeWithoutNotify(const TableInfo* table_info)
         return false;
     }
     LOG(INFO) << "update table node[" << temp_path << "] success";
+    if (!table_info->db().empty()) {
+        AppendCatalogChange(catalog::CatalogChangeType::kTable, std::to_string(table_info->tid()));
+    }
     return true;
 }
 
@@ -8752,7 +8840,6 @@ base::Status NameServerImpl::FillAddIndexTask(uint64_t op_index, api::OPType op_
     }
     uint32_t tid = table_info->tid();
     std::map<uint32_t, std::string> pid_endpoint_map;
-    std::map<uint32_t, uint64_t> pid_offset_map;
     std::vector<std::string> endpoints;
     for (const auto& part : table_info->table_partition()) {
         for (const auto& meta : part.partition_meta()) {
@@ -8766,7 +8853,6 @@ base::Status NameServerImpl::FillAddIndexTask(uint64_t op_index, api::OPType op_
             }
             if (meta.is_leader()) {
                 pid_endpoint_map.emplace(part.pid(), ep);
-                pid_offset_map.emplace(part.pid(), meta.offset());
             }
             endpoints.push_back(ep);
         }
@@ -8785,20 +8871,10 @@ base::Status NameServerImpl::FillAddIndexTask(uint64_t op_index, api::OPType op_
         return {-1, "create add index to table info task failed"};
     }
     task_list->push_back(task);
-    task = CreateTask<ExtractIndexDataTaskMeta>(op_index, op_type, tid, part_size,
-                column_key, pid_offset_map, pid_endpoint_map);
-    if (!task) {
-        return {-1, "create extract index task failed"};
-    }
-    task_list->push_back(task);
-    task = CreateTask<SendIndexDataTaskMeta>(op_index, op_type, tid, pid_endpoint_map);
+    // the leaders scan their rows and put the new index entries into the owner partitions and binlogs directly
+    task = CreateTask<BuildIndexDataTaskMeta>(op_index, op_type, tid, part_size, column_key, pid_endpoint_map);
     if (!task) {
-        return {-1, "create send index task failed"};
-    }
-    task_list->push_back(task);
-    task = CreateTask<LoadIndexDataTaskMeta>(op_index, op_type, tid, part_size, pid_endpoint_map);
-    if (!task) {
-        return {-1, "create load index task failed"};
+        return {-1, "create build index task failed"};
     }
     task_list->push_back(task);
     return {};
@@ -9331,6 +9407,7 @@ base::Status NameServerImpl::CreateProcedureInternal(const api::CreateProcedureR
                 status = {base::ReturnCode::kCreateZkFailed, "create zk node failed"};
                 break;
             }
+            AppendCatalogChange(catalog::CatalogChangeType::kProcedure, absl::StrCat(sp_db_name, ".", sp_name));
         }
         {
             std::lock_guard<std::mutex> lock(mu_);
@@ -9446,6 +9523,7 @@ void NameServerImpl::DropProcedure(RpcController* controller, const api::DropPro
                 response->set_msg("delete storage procedure zk node failed");
                 return;
             }
+            AppendCatalogChange(catalog::CatalogChangeType::kProcedure, db_name + "." + sp_name);
         }
         auto& sp_table_map = db_sp_table_map_[db_name];
         auto& db_table_pairs = sp_table_map[sp_name];
@@ -9733,6 +9811,7 @@ void NameServerImpl::UpdateOfflineTableInfo(::google::protobuf::RpcController* c
                 LOG(WARNING) << "set table info value failed. table " << table_name << ", node " << table_info_node;
                 return;
             }
+            AppendCatalogChange(catalog::CatalogChangeType::kTable, std::to_string(tid));
         }
         // update in this
         table_infos[table_name] = new_info;
@@ -10106,6 +10185,28 @@ std::shared_ptr<Task> NameServerImpl::CreateTaskInternal(const TaskMeta* task_me
             task->fun_ = boost::bind(&NameServerImpl::RunSubTask, this, task);
             break;
         }
+        case ::openmldb::api::TaskType::kBuildIndexRequest: {
+            auto meta = dynamic_cast<const BuildIndexRequestTaskMeta*>(task_meta);
+            boost::function<bool()> fun =
+                boost::bind(&TabletClient::BuildIndexData, client, meta->tid, meta->pid,
+                        meta->partition_num, meta->column_key, meta->pid_endpoint_map, task_info);
+            task->fun_ = boost::bind(&NameServerImpl::WrapTaskFun, this, fun, task_info);
+            break;
+        }
+        case ::openmldb::api::TaskType::kBuildIndexData: {
+            auto meta = dynamic_cast<const BuildIndexDataTaskMeta*>(task_meta);
+            for (const auto& kv : meta->pid_endpoint_map) {
+                auto sub_task = CreateTask<BuildIndexRequestTaskMeta>(
+                            meta->task_info->op_id(), meta->task_info->op_type(), kv.second,
+                            meta->tid, kv.first, meta->partition_num, meta->column_key,
+                            meta->pid_endpoint_map);
+                task->sub_task_.push_back(sub_task);
+                PDLOG(INFO, "add subtask kBuildIndexData. op_id[%lu] tid[%u] pid[%u] endpoint[%s]",
+                      meta->task_info->op_id(), meta->tid, kv.first, kv.second.c_str());
+            }
+            task->fun_ = boost::bind(&NameServerImpl::RunSubTask, this, task);
+            break;
+        }
         case ::openmldb::api::TaskType::kAddIndexToTabletRequest: {
             auto meta = dynamic_cast<const AddIndexToTabletRequestTaskMeta*>(task_meta);
             boost::function<bool()> fun =
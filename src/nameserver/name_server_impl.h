@@ -31,6 +31,7 @@
 
 #include "base/hash.h"
 #include "base/random.h"
+#include "catalog/zk_catalog_cache.h"
 #include "client/ns_client.h"
 #include "client/tablet_client.h"
 #include "codec/schema_codec.h"
@@ -572,6 +573,8 @@ class NameServerImpl : public NameServer {
                           uint32_t concurrency = FLAGS_name_server_task_concurrency_for_replica_cluster);
     // kTable for normal table and kGlobalVar for global var table
     void NotifyTableChanged(::openmldb::type::NotifyType type);
+    // record a written or deleted db table/procedure node in the catalog change log, call it after the node is written
+    void AppendCatalogChange(::openmldb::catalog::CatalogChangeType type, const std::string& node);
     void DeleteDoneOP();
     void UpdateTableStatus();
     int DropTableOnTablet(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info);
@@ -636,7 +639,16 @@ class NameServerImpl : public NameServer {
 
     void UpdateTableStatusFun(
         const std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>& table_info_map,
-        const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response);
+        const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response, uint64_t now_ms);
+
+    // update the qps of the partition from the status of its leader
+    void UpdatePartitionLoad(uint32_t tid, uint32_t pid, const std::string& endpoint,
+                             const ::openmldb::api::TableStatus& status, uint64_t now_ms);
+
+    // mark the partitions whose qps is FLAGS_hot_partition_factor times of the average of the table as hot. It only
+    // detects and logs them with the hottest key, they are relieved by the follower reads or by a manual migration.
+    // the partitions are not split, the pid is hash64(key) % partition_num everywhere
+    void DetectHotPartition(const TableInfo& table_info);
 
     void UpdateRealEpMapToTablet(bool check_running);
 
@@ -706,6 +718,17 @@ class NameServerImpl : public NameServer {
     std::atomic<bool> auto_failover_;
     std::atomic<uint32_t> mode_;
     std::map<std::string, uint64_t> offline_endpoint_map_;
+    struct PartitionLoad {
+        std::string endpoint;
+        uint64_t access_cnt = 0;
+        uint64_t time_ms = 0;
+        uint64_t qps = 0;
+        std::string hot_key;
+        bool is_hot = false;
+    };
+    // the load of the leader partitions keyed by tid and pid. It's kept in memory only, not in the table info
+    // persisted in zookeeper
+    std::map<std::pair<uint32_t, uint32_t>, PartitionLoad> partition_load_;
     ::openmldb::base::Random rand_;
     uint64_t session_term_;
     std::atomic<uint64_t> task_rpc_version_;
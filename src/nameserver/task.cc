@@ -73,6 +73,10 @@ bool Task::UpdateStatus(const ::openmldb::api::TaskInfo& task, const std::string
                 task_info_->set_status(task.status());
             }
         }
+        if (task.has_total_cnt()) {
+            task_info_->set_processed_cnt(task.processed_cnt());
+            task_info_->set_total_cnt(task.total_cnt());
+        }
         traversed_ = true;
         return true;
     }
@@ -153,6 +157,33 @@ void Task::UpdateStatusFromSubTask() {
     }
 }
 
+bool Task::GetProgress(uint64_t* processed_cnt, uint64_t* total_cnt) const {
+    if (!seq_task_.empty()) {
+        return seq_task_.front()->GetProgress(processed_cnt, total_cnt);
+    }
+    if (!sub_task_.empty()) {
+        bool has_progress = false;
+        *processed_cnt = 0;
+        *total_cnt = 0;
+        for (const auto& cur_task : sub_task_) {
+            uint64_t cur_processed_cnt = 0;
+            uint64_t cur_total_cnt = 0;
+            if (cur_task->GetProgress(&cur_processed_cnt, &cur_total_cnt)) {
+                has_progress = true;
+                *processed_cnt += cur_processed_cnt;
+                *total_cnt += cur_total_cnt;
+            }
+        }
+        return has_progress;
+    }
+    if (!task_info_->has_total_cnt()) {
+        return false;
+    }
+    *processed_cnt = task_info_->processed_cnt();
+    *total_cnt = task_info_->total_cnt();
+    return true;
+}
+
 std::string Task::GetAdditionalMsg(const ::openmldb::api::TaskInfo& task_info) {
     std::string additional_msg;
     if (task_info.has_tid()) {
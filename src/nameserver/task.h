@@ -54,6 +54,8 @@ class Task {
     uint64_t GetOpId() const { return task_info_->op_id(); }
     std::string GetReadableOpType() const { return ::openmldb::api::OPType_Name(task_info_->op_type()); }
     std::string GetAdditionalMsg();  // for log info
+    // sum of the progress reported by the running tasks, return false if none reports it
+    bool GetProgress(uint64_t* processed_cnt, uint64_t* total_cnt) const;
     static std::string GetAdditionalMsg(const ::openmldb::api::TaskInfo& task_info);
 
     std::string endpoint_;
@@ -290,6 +292,42 @@ class ExtractIndexDataTaskMeta : public TaskMeta {
     std::map<uint32_t, std::string> pid_endpoint_map;
 };
 
+class BuildIndexRequestTaskMeta : public TaskMeta {
+ public:
+    BuildIndexRequestTaskMeta(uint64_t op_id, ::openmldb::api::OPType op_type, const std::string& endpoint,
+            uint32_t tid_i, uint32_t pid_i, uint32_t partition_num_i,
+            const std::vector<::openmldb::common::ColumnKey>& column_key_i,
+            const std::map<uint32_t, std::string>& pid_endpoint_map_i) :
+        TaskMeta(op_id, op_type, ::openmldb::api::TaskType::kBuildIndexRequest, endpoint),
+        tid(tid_i), pid(pid_i), partition_num(partition_num_i), column_key(column_key_i),
+        pid_endpoint_map(pid_endpoint_map_i) {
+        task_info->set_tid(tid);
+        task_info->set_pid(pid);
+    }
+    uint32_t tid;
+    uint32_t pid;
+    uint32_t partition_num;
+    std::vector<::openmldb::common::ColumnKey> column_key;
+    std::map<uint32_t, std::string> pid_endpoint_map;
+};
+
+class BuildIndexDataTaskMeta : public TaskMeta {
+ public:
+    BuildIndexDataTaskMeta(uint64_t op_id, ::openmldb::api::OPType op_type,
+            uint32_t tid_i, uint32_t partition_num_i,
+            const std::vector<::openmldb::common::ColumnKey>& column_key_i,
+            const std::map<uint32_t, std::string>& pid_endpoint_map_i) :
+        TaskMeta(op_id, op_type, ::openmldb::api::TaskType::kBuildIndexData, ""),
+        tid(tid_i), partition_num(partition_num_i), column_key(column_key_i),
+        pid_endpoint_map(pid_endpoint_map_i) {
+        task_info->set_tid(tid);
+    }
+    uint32_t tid;
+    uint32_t partition_num;
+    std::vector<::openmldb::common::ColumnKey> column_key;
+    std::map<uint32_t, std::string> pid_endpoint_map;
+};
+
 class AddIndexToTabletTaskMeta : public TaskMeta {
  public:
     AddIndexToTabletTaskMeta(uint64_t op_id, ::openmldb::api::OPType op_type,
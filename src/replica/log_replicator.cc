@@ -35,12 +35,16 @@
 
 DECLARE_int32(binlog_single_file_max_size);
 DECLARE_int32(binlog_name_length);
+DECLARE_uint32(binlog_tail_cache_size);
 DECLARE_string(zk_cluster);
+DECLARE_uint32(follower_lag_expire_time);
 
 namespace openmldb {
 namespace replica {
 
 static const ::openmldb::base::DefaultComparator scmp;
+// the subscribers which don't read for so long are removed, and the tail is dropped with the last one
+static constexpr uint64_t kSubscriberIdleTimeoutMs = 10 * 60 * 1000;
 
 LogReplicator::LogReplicator(uint32_t tid, uint32_t pid, const std::string& path,
                              const std::map<std::string, std::string>& real_ep_map,
@@ -59,15 +63,23 @@ LogReplicator::LogReplicator(uint32_t tid, uint32_t pid, const std::string& path
       term_(0),
       mu_(),
       cv_(),
-      wmu_() {
+      wmu_(),
+      metrics_(::openmldb::storage::TableMetrics::Get(tid, pid)) {
     binlog_index_ = 0;
     snapshot_log_part_index_.store(-1, std::memory_order_relaxed);
     snapshot_last_offset_.store(0, std::memory_order_relaxed);
     follower_offset_.store(0);
+    leader_log_offset_.store(0);
+    leader_log_offset_time_.store(0);
 }
 
 LogReplicator::~LogReplicator() {
     DelAllReplicateNode();
+    {
+        // the readers refer to logs_
+        std::lock_guard<std::mutex> lock(sub_mu_);
+        subscribers_.clear();
+    }
     if (logs_ != NULL) {
         logs_->Clear();
     }
@@ -92,6 +104,7 @@ void LogReplicator::SyncToDisk() {
             PDLOG(WARNING, "fail to sync data for path %s", path_.c_str());
         }
         consumed = ::baidu::common::timer::get_micros() - consumed;
+        *metrics_->binlog_sync << consumed;
         if (consumed > 20000) {
             PDLOG(INFO, "sync to disk for path %s consumed %lld ms", path_.c_str(), consumed / 1000);
         }
@@ -289,6 +302,23 @@ uint64_t LogReplicator::GetLeaderTerm() { return term_.load(std::memory_order_re
 
 void LogReplicator::SetLeaderTerm(uint64_t term) { term_.store(term, std::memory_order_relaxed); }
 
+void LogReplicator::SetLeaderLogOffset(uint64_t offset) {
+    leader_log_offset_.store(offset, std::memory_order_relaxed);
+    leader_log_offset_time_.store(::baidu::common::timer::get_micros() / 1000, std::memory_order_relaxed);
+}
+
+bool LogReplicator::GetFollowerLag(uint64_t* lag) {
+    uint64_t update_time = leader_log_offset_time_.load(std::memory_order_relaxed);
+    if (update_time == 0 ||
+        ::baidu::common::timer::get_micros() / 1000 > update_time + FLAGS_follower_lag_expire_time) {
+        return false;
+    }
+    uint64_t leader_offset = leader_log_offset_.load(std::memory_order_relaxed);
+    uint64_t offset = GetOffset();
+    *lag = leader_offset > offset ? leader_offset - offset : 0;
+    return true;
+}
+
 bool LogReplicator::ApplyEntry(const LogEntry& entry) {
     std::lock_guard<std::mutex> lock(wmu_);
     uint64_t last_log_offset = GetOffset();
@@ -312,6 +342,7 @@ bool LogReplicator::ApplyEntry(const LogEntry& entry) {
         return false;
     }
     log_offset_.store(entry.log_index(), std::memory_order_relaxed);
+    AppendTail(entry.log_index(), &buffer);
     DEBUGLOG("sync log entry to offset %lu for %s", GetOffset(), path_.c_str());
     return true;
 }
@@ -446,12 +477,15 @@ bool LogReplicator::AppendEntry(LogEntry& entry, ::google::protobuf::Closure* do
     std::string buffer;
     entry.SerializeToString(&buffer);
     ::openmldb::base::Slice slice(buffer);
+    uint64_t start = ::baidu::common::timer::get_micros();
     ::openmldb::log::Status status = wh_->Write(slice);
+    *metrics_->binlog_write << ::baidu::common::timer::get_micros() - start;
     if (!status.ok()) {
         PDLOG(WARNING, "fail to write replication log in dir %s for %s", path_.c_str(), status.ToString().c_str());
         return false;
     }
     log_offset_.fetch_add(1, std::memory_order_relaxed);
+    AppendTail(cur_offset + 1, &buffer);
     if (local_endpoints_.empty()) {  // if local replica are dead, leader direct
                                      // sync to remote replica
         follower_offset_.store(cur_offset + 1, std::memory_order_relaxed);
@@ -487,5 +521,169 @@ bool LogReplicator::RollWLogFile() {
 
 void LogReplicator::Notify() { cv_.notify_all(); }
 
+void LogReplicator::AppendTail(uint64_t log_index, std::string* buffer) {
+    if (!tail_enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<bthread::Mutex> lock(tail_mu_);
+    // the follower may skip some offsets after it's reloaded, the tail must be continuous
+    if (!tail_.empty() && tail_.back().first + 1 != log_index) {
+        tail_.clear();
+    }
+    tail_.emplace_back(log_index, std::move(*buffer));
+    while (tail_.size() > FLAGS_binlog_tail_cache_size) {
+        tail_.pop_front();
+    }
+    tail_cv_.notify_all();
+}
+
+bool LogReplicator::WaitEntry(uint64_t offset, uint32_t timeout_ms) {
+    uint64_t deadline = ::baidu::common::timer::get_micros() + timeout_ms * 1000ul;
+    std::unique_lock<bthread::Mutex> lock(tail_mu_);
+    while (log_offset_.load(std::memory_order_relaxed) < offset) {
+        uint64_t now = ::baidu::common::timer::get_micros();
+        if (now >= deadline) {
+            return false;
+        }
+        tail_cv_.wait_for(lock, deadline - now);
+    }
+    return true;
+}
+
+bool LogReplicator::ReadEntries(const std::string& subscriber, uint64_t offset, uint32_t max_cnt,
+                                uint64_t max_bytes, std::vector<LogEntry>* entries) {
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    std::lock_guard<std::mutex> lock(sub_mu_);
+    RemoveIdleSubscribersUnlock(now, subscriber);
+    if (!tail_enabled_.exchange(true, std::memory_order_relaxed)) {
+        // the entries appended while it's disabled are missing, the tail starts from the next one
+        std::lock_guard<bthread::Mutex> tail_lock(tail_mu_);
+        tail_.clear();
+    }
+    auto& sub = subscribers_[subscriber];
+    sub.last_read_ms = now;
+    if (ReadTail(offset, max_cnt, max_bytes, entries)) {
+        sub.reader.reset();
+        return true;
+    }
+    return ReadFiles(&sub, offset, max_cnt, max_bytes, entries);
+}
+
+void LogReplicator::RemoveIdleSubscribers() {
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    std::lock_guard<std::mutex> lock(sub_mu_);
+    RemoveIdleSubscribersUnlock(now, "");
+}
+
+void LogReplicator::RemoveIdleSubscribersUnlock(uint64_t now, const std::string& keep) {
+    for (auto it = subscribers_.begin(); it != subscribers_.end();) {
+        if (it->first != keep && it->second.last_read_ms + kSubscriberIdleTimeoutMs < now) {
+            PDLOG(INFO, "remove idle binlog subscriber %s. tid %u pid %u", it->first.c_str(), tid_, pid_);
+            it = subscribers_.erase(it);
+        } else {
+            it++;
+        }
+    }
+    if (subscribers_.empty() && keep.empty() && tail_enabled_.exchange(false, std::memory_order_relaxed)) {
+        PDLOG(INFO, "no binlog subscriber, drop the tail. tid %u pid %u", tid_, pid_);
+        std::lock_guard<bthread::Mutex> tail_lock(tail_mu_);
+        tail_.clear();
+    }
+}
+
+bool LogReplicator::ReadTail(uint64_t offset, uint32_t max_cnt, uint64_t max_bytes, std::vector<LogEntry>* entries) {
+    std::vector<std::string> records;
+    {
+        std::lock_guard<bthread::Mutex> lock(tail_mu_);
+        if (tail_.empty()) {
+            // nothing to read if the offset has not been written
+            return offset > log_offset_.load(std::memory_order_relaxed);
+        }
+        uint64_t first = tail_.front().first;
+        if (offset < first) {
+            return false;
+        }
+        uint64_t bytes = 0;
+        for (uint64_t pos = offset - first; pos < tail_.size() && records.size() < max_cnt && bytes <= max_bytes;
+             pos++) {
+            records.push_back(tail_[pos].second);
+            bytes += records.back().size();
+        }
+    }
+    // parse out of the lock, the writes wait for it
+    for (const auto& record : records) {
+        entries->emplace_back();
+        if (!entries->back().ParseFromString(record)) {
+            PDLOG(WARNING, "bad protobuf format in tail. tid %u pid %u", tid_, pid_);
+            entries->pop_back();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogReplicator::ReadFiles(Subscriber* sub, uint64_t offset, uint32_t max_cnt, uint64_t max_bytes,
+                              std::vector<LogEntry>* entries) {
+    if (!sub->reader || sub->next_offset != offset) {
+        sub->reader = std::make_unique<::openmldb::log::LogReader>(logs_, log_path_, false);
+        if (!sub->reader->SetOffset(offset)) {
+            PDLOG(WARNING, "offset %lu is not in the binlog. tid %u pid %u", offset, tid_, pid_);
+            sub->reader.reset();
+            return false;
+        }
+        sub->next_offset = offset;
+    }
+    auto* reader = sub->reader.get();
+    uint64_t bytes = 0;
+    int cur_log_index = reader->GetLogIndex();
+    std::string buffer;
+    ::openmldb::base::Slice record;
+    while (entries->size() < max_cnt && bytes <= max_bytes) {
+        ::openmldb::log::Status status = reader->ReadNextRecord(&record, &buffer);
+        if (status.ok()) {
+            LogEntry entry;
+            if (!entry.ParseFromString(record.ToString())) {
+                PDLOG(WARNING, "bad protobuf format %s. tid %u pid %u",
+                      ::openmldb::base::DebugString(record.ToString()).c_str(), tid_, pid_);
+                sub->reader.reset();
+                return false;
+            }
+            if (entry.log_index() < sub->next_offset) {
+                continue;
+            }
+            if (entry.log_index() != sub->next_offset) {
+                PDLOG(WARNING, "log missing expect offset %lu but %lu. tid %u pid %u", sub->next_offset,
+                      entry.log_index(), tid_, pid_);
+                // read from the start of the file again in the next time
+                sub->reader.reset();
+                // the offset can't be read, otherwise return the entries before the gap
+                return !entries->empty();
+            }
+            bytes += record.size();
+            sub->next_offset++;
+            entries->push_back(std::move(entry));
+        } else if (status.IsWaitRecord()) {
+            // the last file is not flushed, or the file has been rolled
+            int end_log_index = reader->GetEndLogIndex();
+            if (end_log_index >= 0 && end_log_index > reader->GetLogIndex()) {
+                reader->RollRLogFile();
+                continue;
+            }
+            break;
+        } else if (status.IsEof()) {
+            if (reader->GetLogIndex() != cur_log_index) {
+                cur_log_index = reader->GetLogIndex();
+                continue;
+            }
+            break;
+        } else {
+            PDLOG(WARNING, "fail to read binlog: %s. tid %u pid %u", status.ToString().c_str(), tid_, pid_);
+            sub->reader.reset();
+            break;
+        }
+    }
+    return true;
+}
+
 }  // namespace replica
 }  // namespace openmldb
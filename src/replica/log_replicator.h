@@ -19,10 +19,12 @@
 
 #include <atomic>
 #include <condition_variable>  // NOLINT
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/skiplist.h"
@@ -35,6 +37,7 @@
 #include "proto/tablet.pb.h"
 #include "replica/replicate_node.h"
 #include "storage/table.h"
+#include "storage/table_metrics.h"
 
 namespace openmldb {
 namespace replica {
@@ -102,6 +105,12 @@ class LogReplicator {
     uint64_t GetLeaderTerm();
     void SetLeaderTerm(uint64_t term);
 
+    // the log offset of the leader carried by the last append entries request, followers only
+    void SetLeaderLogOffset(uint64_t offset);
+    // the log entries this follower is behind the leader. It fails if the leader offset is unknown, or is not
+    // refreshed in --follower_lag_expire_time
+    bool GetFollowerLag(uint64_t* lag);
+
     void SetSnapshotLogPartIndex(uint64_t offset);
 
     bool ParseBinlogIndex(const std::string& path, uint32_t& index);  // NOLINT
@@ -112,9 +121,38 @@ class LogReplicator {
 
     uint64_t GetSnapshotLastOffset() { return snapshot_last_offset_.load(std::memory_order_relaxed); }
 
+    // Read at most max_cnt entries from offset(inclusive) for the subscriber, stop once max_bytes is exceeded.
+    // The entries come from the in-memory tail if it covers the offset, or else from the binlog files by a reader
+    // kept for the subscriber, so the next read which starts where this one stops doesn't scan the files again.
+    // The tail holds the last FLAGS_binlog_tail_cache_size entries, it's kept only while there are subscribers.
+    // Return false if the offset can't be read, e.g. the binlog has been deleted.
+    bool ReadEntries(const std::string& subscriber, uint64_t offset, uint32_t max_cnt, uint64_t max_bytes,
+                     std::vector<LogEntry>* entries);
+
+    // wait until the entry of offset is written or timeout, return true if it is written
+    bool WaitEntry(uint64_t offset, uint32_t timeout_ms);
+
+    // remove the subscribers which don't read for a long time, the tail is dropped with the last one
+    void RemoveIdleSubscribers();
+
  private:
+    struct Subscriber {
+        std::unique_ptr<::openmldb::log::LogReader> reader;
+        // the offset the reader stops at
+        uint64_t next_offset = 0;
+        uint64_t last_read_ms = 0;
+    };
+
     bool OpenSeqFile(const std::string& path, SequentialFile** sf);
 
+    // call it after log_offset_ is updated
+    void AppendTail(uint64_t log_index, std::string* buffer);
+    bool ReadTail(uint64_t offset, uint32_t max_cnt, uint64_t max_bytes, std::vector<LogEntry>* entries);
+    bool ReadFiles(Subscriber* subscriber, uint64_t offset, uint32_t max_cnt, uint64_t max_bytes,
+                   std::vector<LogEntry>* entries);
+    // sub_mu_ should be held, the subscriber keep is not removed
+    void RemoveIdleSubscribersUnlock(uint64_t now, const std::string& keep);
+
  private:
     // the replicator root data path
     uint32_t tid_;
@@ -124,6 +162,9 @@ class LogReplicator {
     // the term for leader judgement
     std::atomic<uint64_t> log_offset_;
     std::atomic<uint64_t> follower_offset_;
+    std::atomic<uint64_t> leader_log_offset_;
+    // the time in milliseconds leader_log_offset_ is set, 0 if it's never set
+    std::atomic<uint64_t> leader_log_offset_time_;
     std::atomic<uint32_t> binlog_index_;
     LogParts* logs_;
     WriteHandle* wh_;
@@ -141,6 +182,16 @@ class LogReplicator {
     std::atomic<uint64_t> snapshot_last_offset_;
 
     std::mutex wmu_;
+    std::shared_ptr<::openmldb::storage::TableMetrics> metrics_;
+
+    // guards subscribers_, the reads of one subscriber are serial
+    std::mutex sub_mu_;
+    std::map<std::string, Subscriber> subscribers_;
+    std::atomic<bool> tail_enabled_{false};
+    bthread::Mutex tail_mu_;
+    bthread::ConditionVariable tail_cv_;
+    // log index and the serialized entry
+    std::deque<std::pair<uint64_t, std::string>> tail_;
 };
 
 }  // namespace replica
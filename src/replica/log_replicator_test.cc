@@ -49,6 +49,7 @@ using ::openmldb::storage::TableIterator;
 using ::openmldb::storage::Ticket;
 
 DECLARE_int32(binlog_single_file_max_size);
+DECLARE_uint32(follower_lag_expire_time);
 
 namespace openmldb {
 namespace replica {
@@ -136,6 +137,92 @@ TEST_F(LogReplicatorTest, Init) {
     ASSERT_TRUE(ok);
 }
 
+TEST_F(LogReplicatorTest, FollowerLag) {
+    std::map<std::string, std::string> map;
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator replicator(1, 1, folder, map, kFollowerNode);
+    ASSERT_TRUE(replicator.Init());
+    uint64_t lag = 0;
+    // the leader offset is unknown
+    ASSERT_FALSE(replicator.GetFollowerLag(&lag));
+    replicator.SetLeaderLogOffset(10);
+    ASSERT_TRUE(replicator.GetFollowerLag(&lag));
+    ASSERT_EQ(10u, lag);
+    ::openmldb::api::LogEntry entry;
+    ::openmldb::test::AddDimension(0, "test_pk", &entry);
+    entry.set_value(::openmldb::test::EncodeKV("test_pk", "value1"));
+    entry.set_ts(9527);
+    for (uint64_t i = 1; i <= 4; i++) {
+        entry.set_log_index(i);
+        ASSERT_TRUE(replicator.ApplyEntry(entry));
+    }
+    ASSERT_TRUE(replicator.GetFollowerLag(&lag));
+    ASSERT_EQ(6u, lag);
+    replicator.SetLeaderLogOffset(4);
+    ASSERT_TRUE(replicator.GetFollowerLag(&lag));
+    ASSERT_EQ(0u, lag);
+    // the leader offset is stale
+    uint32_t old_expire_time = FLAGS_follower_lag_expire_time;
+    FLAGS_follower_lag_expire_time = 100;
+    sleep(1);
+    ASSERT_FALSE(replicator.GetFollowerLag(&lag));
+    FLAGS_follower_lag_expire_time = old_expire_time;
+}
+
+TEST_F(LogReplicatorTest, ReadEntries) {
+    std::map<std::string, std::string> map;
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator replicator(1, 1, folder, map, kLeaderNode);
+    ASSERT_TRUE(replicator.Init());
+    auto append = [&replicator](uint32_t num) {
+        for (uint32_t i = 0; i < num; i++) {
+            ::openmldb::api::LogEntry entry;
+            ::openmldb::test::AddDimension(0, "test_pk", &entry);
+            entry.set_value(::openmldb::test::EncodeKV("test_pk", "value1"));
+            entry.set_ts(9527);
+            ASSERT_TRUE(replicator.AppendEntry(entry));
+        }
+    };
+    append(5);
+    replicator.SyncToDisk();
+    // the entries written before the first subscription are read from the files
+    std::vector<::openmldb::api::LogEntry> entries;
+    ASSERT_TRUE(replicator.ReadEntries("s1", 1, 3, 1024 * 1024, &entries));
+    ASSERT_EQ(3u, entries.size());
+    ASSERT_EQ(1u, entries[0].log_index());
+    entries.clear();
+    ASSERT_TRUE(replicator.ReadEntries("s1", 4, 10, 1024 * 1024, &entries));
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_EQ(5u, entries[1].log_index());
+    // from the tail
+    append(3);
+    entries.clear();
+    ASSERT_TRUE(replicator.ReadEntries("s1", 6, 10, 1024 * 1024, &entries));
+    ASSERT_EQ(3u, entries.size());
+    ASSERT_EQ(8u, entries[2].log_index());
+    ASSERT_EQ(9527u, entries[2].ts());
+    // at least one entry is read
+    entries.clear();
+    ASSERT_TRUE(replicator.ReadEntries("s2", 7, 10, 0, &entries));
+    ASSERT_EQ(1u, entries.size());
+    ASSERT_EQ(7u, entries[0].log_index());
+    // another subscriber resumes from an old offset by the files
+    replicator.SyncToDisk();
+    entries.clear();
+    ASSERT_TRUE(replicator.ReadEntries("s2", 2, 10, 1024 * 1024, &entries));
+    ASSERT_EQ(7u, entries.size());
+    ASSERT_EQ(2u, entries[0].log_index());
+    // nothing new
+    entries.clear();
+    ASSERT_TRUE(replicator.ReadEntries("s1", 9, 10, 1024 * 1024, &entries));
+    ASSERT_TRUE(entries.empty());
+    ASSERT_FALSE(replicator.WaitEntry(9, 10));
+    append(1);
+    ASSERT_TRUE(replicator.WaitEntry(9, 10));
+    ASSERT_TRUE(replicator.ReadEntries("s1", 9, 10, 1024 * 1024, &entries));
+    ASSERT_EQ(1u, entries.size());
+}
+
 TEST_F(LogReplicatorTest, BenchMark) {
     std::map<std::string, std::string> map;
     std::string folder = "/tmp/" + GenRand() + "/";
@@ -22,6 +22,7 @@
 
 #include "base/glog_wrapper.h"
 #include "base/strings.h"
+#include "common/timer.h"
 
 DECLARE_int32(binlog_sync_batch_size);
 DECLARE_int32(binlog_sync_wait_time);
@@ -31,6 +32,7 @@ DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
 DECLARE_string(zk_cluster);
 DECLARE_uint32(go_back_max_try_cnt);
+DECLARE_uint32(binlog_heartbeat_interval);
 
 namespace openmldb {
 namespace replica {
@@ -66,7 +68,8 @@ ReplicateNode::ReplicateNode(const std::string& point, LogParts* logs, const std
       cv_(cv),
       go_back_cnt_(0),
       rep_node_(rep_follower),
-      follower_offset_(follower_offset) {
+      follower_offset_(follower_offset),
+      last_send_time_(0) {
     if (!real_point.empty()) {
         rpc_client_ = openmldb::RpcClient<::openmldb::api::TabletServer_Stub>(real_point);
     }
@@ -114,6 +117,7 @@ void ReplicateNode::SyncData() {
             bthread_usleep(coffee_time * 1000);
             coffee_time = 0;
         }
+        bool need_heartbeat = false;
         {
             std::unique_lock<bthread::Mutex> lock(*mu_);
             // no new data append and wait
@@ -126,8 +130,17 @@ void ReplicateNode::SyncData() {
                           endpoint_.c_str(), tid_, pid_);
                     return;
                 }
+                if (FLAGS_binlog_heartbeat_interval > 0 && !rep_node_.load(std::memory_order_relaxed) &&
+                    ::baidu::common::timer::get_micros() / 1000 >= last_send_time_ + FLAGS_binlog_heartbeat_interval) {
+                    need_heartbeat = true;
+                    break;
+                }
             }
         }
+        if (need_heartbeat) {
+            SendHeartbeat();
+            continue;
+        }
         int ret;
         if (rep_node_.load(std::memory_order_relaxed)) {
             ret = SyncData(follower_offset_->load(std::memory_order_relaxed));
@@ -270,6 +283,8 @@ int ReplicateNode::SyncData(uint64_t log_offset) {
         }
     }
     if (request.entries_size() > 0) {
+        request.set_leader_log_offset(leader_log_offset_->load(std::memory_order_relaxed));
+        last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
         bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
                                            FLAGS_request_timeout_ms, FLAGS_request_max_retry);
         if (ret && response.code() == 0) {
@@ -296,6 +311,25 @@ int ReplicateNode::SyncData(uint64_t log_offset) {
     return 0;
 }
 
+void ReplicateNode::SendHeartbeat() {
+    ::openmldb::api::AppendEntriesRequest request;
+    ::openmldb::api::AppendEntriesResponse response;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_pre_log_index(last_sync_offset_);
+    if (!FLAGS_zk_cluster.empty()) {
+        request.set_term(term_->load(std::memory_order_relaxed));
+    }
+    request.set_leader_log_offset(leader_log_offset_->load(std::memory_order_relaxed));
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
+    // no retry, the next heartbeat is sent soon
+    bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
+                                       FLAGS_request_timeout_ms, 1);
+    if (!ret || response.code() != 0) {
+        DEBUGLOG("fail to send heartbeat to node %s. tid %u pid %u", endpoint_.c_str(), tid_, pid_);
+    }
+}
+
 void ReplicateNode::Stop() {
     is_running_.store(false, std::memory_order_relaxed);
     if (worker_ == 0) {
@@ -71,6 +71,8 @@ class ReplicateNode {
 
  private:
     int MatchLogOffsetFromNode();
+    // send the log offset to an up to date follower without entries, so it knows it's not behind
+    void SendHeartbeat();
 
  private:
     LogReader log_reader_;
@@ -90,6 +92,8 @@ class ReplicateNode {
     uint32_t go_back_cnt_;
     std::atomic<bool> rep_node_;
     std::atomic<uint64_t>* follower_offset_;  // max local cluster follower offset
+    // the time in milliseconds of the last append entries request
+    uint64_t last_send_time_;
 };
 
 }  // namespace replica
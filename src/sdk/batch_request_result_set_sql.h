@@ -77,6 +77,11 @@ class SQLBatchRequestResultSet : public ::hybridse::sdk::ResultSet {
         cntl_->response_attachment().copy_to(reinterpret_cast<void*>(buf));
     }
 
+    // raw access for callers forwarding the encoded rows without decoding, e.g. the binary http api.
+    // The rows buffer holds the common row(if any common column) followed by the non-common rows.
+    const ::openmldb::api::SQLBatchRequestQueryResponse& GetResponse() const { return *response_; }
+    const butil::IOBuf& GetRowsBuf() const { return cntl_->response_attachment(); }
+
  private:
     inline uint32_t GetRecordSize() { return response_->count(); }
 
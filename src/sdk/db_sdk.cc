@@ -19,7 +19,6 @@
 #ifdef DISALLOW_COPY_AND_ASSIGN
 #undef DISALLOW_COPY_AND_ASSIGN
 #endif
-#include <snappy.h>
 
 #include <algorithm>
 #include <functional>
@@ -176,13 +175,12 @@ bool DBSDK::RemoveExternalFun(const std::string& name) {
 ClusterSDK::ClusterSDK(const std::shared_ptr<SQLRouterOptions>& options)
     : options_(options),
       session_id_(0),
-      table_root_path_(options->zk_path + "/table/db_table_data"),
-      sp_root_path_(options->zk_path + "/store_procedure/db_sp_data"),
       notify_path_(options->zk_path + "/table/notify"),
       globalvar_changed_notify_path_(options->zk_path + "/notify/global_variable"),
       leader_path_(options->zk_path + "/leader"),
       taskmanager_leader_path_(options->zk_path + "/taskmanager/leader"),
       zk_client_(nullptr),
+      catalog_cache_(options->zk_path),
       pool_(1) {}
 
 ClusterSDK::~ClusterSDK() {
@@ -307,73 +305,35 @@ bool ClusterSDK::GetTaskManagerAddress(std::string* endpoint, std::string* real_
     return true;
 }
 
-// TODO(hw): refactor
-bool ClusterSDK::UpdateCatalog(const std::vector<std::string>& table_datas, const std::vector<std::string>& sp_datas) {
-    std::vector<::openmldb::nameserver::TableInfo> tables;
+bool ClusterSDK::UpdateCatalog(bool rebuild_all) {
+    auto old_catalog = GetCatalog();
+    bool reuse = !rebuild_all && !catalog_cache_.IsFullReload();
+    std::set<uint32_t> changed_tids;
+    std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>> tables;
     std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> mapping;
-    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
-    for (const auto& table_data : table_datas) {
-        if (table_data.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(table_root_path_ + "/" + table_data, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table data " << table_root_path_ << "/" << table_data;
-            continue;
-        }
-        std::shared_ptr<::openmldb::nameserver::TableInfo> table_info(new ::openmldb::nameserver::TableInfo());
-        ok = table_info->ParseFromString(value);
-        if (!ok) {
-            LOG(WARNING) << "fail to parse table proto with " << value;
-            continue;
-        }
-        DLOG(INFO) << "parse table " << table_info->name() << " ok";
-        tables.push_back(*(table_info));
-        auto it = mapping.find(table_info->db());
-        if (it == mapping.end()) {
-            std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>> table_in_db;
-            table_in_db.insert(std::make_pair(table_info->name(), table_info));
-            mapping.insert(std::make_pair(table_info->db(), table_in_db));
-        } else {
-            it->second.insert(std::make_pair(table_info->name(), table_info));
+    for (const auto& kv : catalog_cache_.GetTables()) {
+        const auto& table_info = kv.second;
+        if (catalog_cache_.GetChangedTables().count(kv.first) > 0) {
+            changed_tids.insert(table_info->tid());
         }
-        DLOG(INFO) << "load table info with name " << table_info->name() << " in db " << table_info->db();
+        tables.push_back(table_info);
+        mapping[table_info->db()].emplace(table_info->name(), table_info);
     }
 
     Procedures db_sp_map;
-    for (const auto& node : sp_datas) {
-        if (node.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(sp_root_path_ + "/" + node, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure data. node: " << node;
-            continue;
-        }
-        std::string uncompressed;
-        ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
-        ::openmldb::api::ProcedureInfo sp_info_pb;
-        ok = sp_info_pb.ParseFromString(uncompressed);
-        if (!ok) {
-            LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
-            continue;
+    for (const auto& kv : catalog_cache_.GetProcedures()) {
+        const auto& sp_info_pb = kv.second;
+        std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info;
+        if (reuse && catalog_cache_.GetChangedProcedures().count(kv.first) == 0) {
+            sp_info = old_catalog->GetProcedureInfo(sp_info_pb->db_name(), sp_info_pb->sp_name());
         }
-        DLOG(INFO) << "parse procedure " << sp_info_pb.sp_name() << " ok";
-        auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
         if (!sp_info) {
-            LOG(WARNING) << "convert procedure info failed, sp_name: " << sp_info_pb.sp_name()
-                         << " db: " << sp_info_pb.db_name();
-            continue;
-        }
-        auto it = db_sp_map.find(sp_info->GetDbName());
-        if (it == db_sp_map.end()) {
-            std::map<std::string, std::shared_ptr<hybridse::sdk::ProcedureInfo>> sp_in_db = {
-                {sp_info->GetSpName(), sp_info}};
-            db_sp_map.insert(std::make_pair(sp_info->GetDbName(), sp_in_db));
-        } else {
-            it->second.insert(std::make_pair(sp_info->GetSpName(), sp_info));
+            sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(*sp_info_pb);
         }
-        DLOG(INFO) << "load procedure info with sp name " << sp_info->GetSpName() << " in db " << sp_info->GetDbName();
+        db_sp_map[sp_info->GetDbName()].emplace(sp_info->GetSpName(), sp_info);
     }
-    if (!new_catalog->Init(tables, db_sp_map)) {
+    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
+    if (!new_catalog->Init(tables, db_sp_map, reuse ? old_catalog.get() : nullptr, changed_tids)) {
         LOG(WARNING) << "fail to init catalog";
         return false;
     }
@@ -386,7 +346,7 @@ bool ClusterSDK::UpdateCatalog(const std::vector<std::string>& table_datas, cons
     return true;
 }
 
-bool ClusterSDK::InitTabletClient() {
+bool ClusterSDK::InitTabletClient(bool* new_tablet) {
     std::vector<std::string> tablets;
     bool ok = zk_client_->GetNodes(tablets);
     if (!ok) {
@@ -404,37 +364,29 @@ bool ClusterSDK::InitTabletClient() {
     }
     // TODO(hw): update won't delete the old clients in mgr, should create a new mgr?
     client_manager_->UpdateClient(real_ep_map);
+    // the table handlers only hold the clients that existed when they were built
+    *new_tablet = false;
+    for (const auto& kv : real_ep_map) {
+        if (tablet_endpoints_.insert(kv.first).second) {
+            *new_tablet = true;
+        }
+    }
     return true;
 }
 
 bool ClusterSDK::BuildCatalog() {
-    if (!InitTabletClient()) {
+    std::lock_guard<std::mutex> lock(refresh_mu_);
+    bool new_tablet = false;
+    if (!InitTabletClient(&new_tablet)) {
         return false;
     }
-
-    std::vector<std::string> table_datas;
-    if (zk_client_->IsExistNode(table_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(table_root_path_, table_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table list with path " << table_root_path_;
-            return false;
-        }
-    } else {
-        LOG(INFO) << "no tables in db";
-    }
-    std::vector<std::string> sp_datas;
-    if (zk_client_->IsExistNode(sp_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(sp_root_path_, sp_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure list with path " << sp_root_path_;
-            return false;
-        }
-    } else {
-        LOG(INFO) << "no procedures in db";
+    // only the tables and procedures changed since the last build are read from zk
+    if (!catalog_cache_.Refresh(zk_client_)) {
+        return false;
     }
     // The empty database can't be find if we only get table datas, but database no notify, so we get alldbs from
     // nameserver in GetAllDbs()
-    return UpdateCatalog(table_datas, sp_datas);
+    return UpdateCatalog(new_tablet);
 }
 
 std::vector<std::string> DBSDK::GetAllDbs() {
@@ -19,12 +19,15 @@
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/spinlock.h"
 #include "catalog/sdk_catalog.h"
+#include "catalog/zk_catalog_cache.h"
 #include "client/ns_client.h"
 #include "client/tablet_client.h"
 #include "client/taskmanager_client.h"
@@ -162,8 +165,10 @@ class ClusterSDK : public DBSDK {
 
  private:
     bool GetRealEndpointFromZk(const std::string& endpoint, std::string* real_endpoint);
-    bool UpdateCatalog(const std::vector<std::string>& table_datas, const std::vector<std::string>& sp_datas);
-    bool InitTabletClient();
+    // build a new catalog from catalog_cache_, reuse the unchanged table handlers unless `rebuild_all`
+    bool UpdateCatalog(bool rebuild_all);
+    // `new_tablet` is set if there is a tablet that we haven't seen before
+    bool InitTabletClient(bool* new_tablet);
     void WatchNotify();
     void CheckZk();
     void RefreshNsClient(const std::vector<std::string>& leader_children);
@@ -172,8 +177,6 @@ class ClusterSDK : public DBSDK {
  private:
     std::shared_ptr<SQLRouterOptions> options_;
     uint64_t session_id_;
-    std::string table_root_path_;
-    std::string sp_root_path_;
     std::string notify_path_;
     std::string globalvar_changed_notify_path_;
     std::string leader_path_;
@@ -181,6 +184,10 @@ class ClusterSDK : public DBSDK {
     // CheckZk will be called periodically, so we don't need to check zk_client_ before using it
     // if failed, just retry
     ::openmldb::zk::ZkClient* zk_client_;
+    // serialize BuildCatalog, which may be called by the zk watcher and the users at the same time
+    std::mutex refresh_mu_;
+    ::openmldb::catalog::ZkCatalogCache catalog_cache_;
+    std::set<std::string> tablet_endpoints_;
     ::baidu::common::ThreadPool pool_;
 };
 
@@ -46,6 +46,11 @@ struct SQLRouterOptions : BasicRouterOptions {
     std::string zk_log_file;
     std::string zk_auth_schema = "digest";
     std::string zk_cert;
+    // send the request mode queries and the deployment calls to a follower of the partition, which serves them only
+    // if it is behind the leader by at most this number of log entries, otherwise they are sent to the leader.
+    // -1 means to read the leaders only. The tablets need --enable_follower_read.
+    // A follower read may miss the latest writes of this client, read the leaders for read-your-writes
+    int64_t follower_read_max_lag = -1;
 
     std::string to_string() {
         std::stringstream ss;
@@ -17,16 +17,23 @@
 #include "sdk/sql_cluster_router.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
@@ -981,7 +988,7 @@ std::shared_ptr<::openmldb::client::TabletClient> SQLClusterRouter::GetTabletCli
 std::shared_ptr<::openmldb::client::TabletClient> SQLClusterRouter::GetTabletClient(
     const std::string& db, const std::string& sql, const ::hybridse::vm::EngineMode engine_mode,
     const std::shared_ptr<SQLRequestRow>& row, const std::shared_ptr<openmldb::sdk::SQLRequestRow>& parameter,
-    hybridse::sdk::Status* status) {
+    hybridse::sdk::Status* status, ::openmldb::api::FollowerRead* follower_read) {
     RET_IF_NULL_AND_WARN(status, "output status is nullptr");
     auto cache = GetSQLCache(db, sql, engine_mode, parameter, status);
     WARN_NOT_OK_AND_RET(status, "sql plan failed(get/create cache failed)", nullptr);
@@ -997,6 +1004,11 @@ std::shared_ptr<::openmldb::client::TabletClient> SQLClusterRouter::GetTabletCli
                 DLOG(INFO) << "get main table" << main_table;
                 std::string val;
                 if (!col.empty() && row && row->GetRecordVal(col, &val)) {
+                    if (follower_read != nullptr) {
+                        if (auto client = GetFollowerClient(main_db, main_table, val, follower_read); client) {
+                            return client;
+                        }
+                    }
                     tablet = cluster_sdk_->GetTablet(main_db, main_table, val);
                 }
                 if (!tablet) {
@@ -1062,10 +1074,9 @@ std::shared_ptr<TableReader> SQLClusterRouter::GetTableReader() {
     return std::make_shared<TableReaderImpl>(cluster_sdk_);
 }
 
-std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(const std::string& db,
-                                                                            const std::string& sp_name,
-                                                                            const std::string& router_col,
-                                                                            hybridse::sdk::Status* status) {
+std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(
+    const std::string& db, const std::string& sp_name, const std::string& router_col, hybridse::sdk::Status* status,
+    ::openmldb::api::FollowerRead* follower_read) {
     RET_IF_NULL_AND_WARN(status, "output status is nullptr");
     auto sp_info = cluster_sdk_->GetProcedureInfo(db, sp_name, &status->msg);
     if (!sp_info) {
@@ -1078,6 +1089,11 @@ std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(cons
     if (router_col.empty()) {
         tablet = cluster_sdk_->GetTablet(db_name, table);
     } else {
+        if (follower_read != nullptr) {
+            if (auto client = GetFollowerClient(db_name, table, router_col, follower_read); client) {
+                return client;
+            }
+        }
         tablet = cluster_sdk_->GetTablet(db_name, table, router_col);
     }
     if (!tablet) {
@@ -1087,6 +1103,28 @@ std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(cons
     return tablet->GetClient();
 }
 
+std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetFollowerClient(
+    const std::string& db, const std::string& table, const std::string& pk,
+    ::openmldb::api::FollowerRead* follower_read) {
+    auto ops = std::dynamic_pointer_cast<SQLRouterOptions>(options_);
+    if (!ops || ops->follower_read_max_lag < 0) {
+        return {};
+    }
+    auto table_info = cluster_sdk_->GetTableInfo(db, table);
+    if (!table_info || table_info->table_partition_size() == 0) {
+        return {};
+    }
+    uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(pk) % table_info->table_partition_size());
+    auto followers = cluster_sdk_->GetTabletFollowers(db, table, pid);
+    if (followers.empty()) {
+        return {};
+    }
+    follower_read->set_tid(table_info->tid());
+    follower_read->set_pid(pid);
+    follower_read->set_max_lag(ops->follower_read_max_lag);
+    return followers[rand_.Uniform(followers.size())]->GetClient();
+}
+
 bool SQLClusterRouter::IsConstQuery(::hybridse::vm::PhysicalOpNode* node) {
     if (node->GetOpType() == ::hybridse::vm::kPhysicalOpConstProject) {
         return true;
@@ -1127,13 +1165,29 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLRequest(co
         SET_STATUS_AND_WARN(status, StatusCode::kCmdError, "make sure the request row is built before execute sql");
         return {};
     }
-    auto cntl = std::make_shared<::brpc::Controller>();
-    cntl->set_timeout_ms(options_->request_timeout);
-    auto response = std::make_shared<::openmldb::api::QueryResponse>();
-    auto client = GetTabletClient(db, sql, hybridse::vm::kRequestMode, row, status);
+    ::openmldb::api::FollowerRead follower_read;
+    auto client = GetTabletClient(db, sql, hybridse::vm::kRequestMode, row, {}, status, &follower_read);
     if (0 != status->code) {
         return {};
     }
+    if (client && follower_read.has_tid()) {
+        auto cntl = std::make_shared<::brpc::Controller>();
+        cntl->set_timeout_ms(options_->request_timeout);
+        auto response = std::make_shared<::openmldb::api::QueryResponse>();
+        if (client->Query(db, sql, row->GetRow(), cntl.get(), response.get(), options_->enable_debug,
+                          &follower_read)) {
+            return ResultSetSQL::MakeResultSet(response, cntl, status);
+        }
+        DLOG(INFO) << "follower read on " << client->GetEndpoint() << " failed, read the leader. "
+                   << (cntl->Failed() ? cntl->ErrorText() : response->msg());
+        client = GetTabletClient(db, sql, hybridse::vm::kRequestMode, row, status);
+        if (0 != status->code) {
+            return {};
+        }
+    }
+    auto cntl = std::make_shared<::brpc::Controller>();
+    cntl->set_timeout_ms(options_->request_timeout);
+    auto response = std::make_shared<::openmldb::api::QueryResponse>();
     if (!client) {
         SET_STATUS_AND_WARN(status, StatusCode::kCmdError, "tablet client not found");
         return {};
@@ -1175,6 +1229,33 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
     return ResultSetSQL::MakeResultSet(response, cntl, status);
 }
 
+std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExplainAnalyze(
+    const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRow> parameter,
+    ::hybridse::sdk::Status* status) {
+    RET_IF_NULL_AND_WARN(status, "output status is nullptr");
+    std::vector<openmldb::type::DataType> parameter_types;
+    if (parameter && !ExtractDBTypes(parameter->GetSchema(), &parameter_types)) {
+        SET_STATUS_AND_WARN(status, StatusCode::kCmdError, "convert parameter types error");
+        return {};
+    }
+    auto client = GetTabletClientForBatchQuery(db, sql, parameter, status);
+    if (!status->IsOK() || !client) {
+        status->Prepend("get tablet client failed");
+        return {};
+    }
+    auto cntl = std::make_shared<::brpc::Controller>();
+    cntl->set_timeout_ms(options_->request_timeout);
+    auto response = std::make_shared<::openmldb::api::QueryResponse>();
+    if (!client->Query(db, sql, parameter_types, parameter ? parameter->GetRow() : "", cntl.get(), response.get(),
+                       options_->enable_debug, true)) {
+        RPC_STATUS_AND_WARN(status, cntl, response, "Query rpc failed");
+        return {};
+    }
+    *status = {};
+    std::vector<std::string> value = {response->profile() + "\n"};
+    return ResultSetSQL::MakeResultSet({FORMAT_STRING_KEY}, {value}, status);
+}
+
 std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchRequest(
     const std::string& db, const std::string& sql, std::shared_ptr<SQLRequestRowBatch> row_batch,
     hybridse::sdk::Status* status) {
@@ -1497,7 +1578,19 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::CallProcedure(const
                                                                           const std::string& router_col,
                                                                           hybridse::sdk::Status* status) {
     RET_IF_NULL_AND_WARN(status, "output status is nullptr");
-    auto tablet = GetTablet(db, sp_name, router_col, status);
+    ::openmldb::api::FollowerRead follower_read;
+    auto tablet = GetTablet(db, sp_name, router_col, status, &follower_read);
+    if (tablet && follower_read.has_tid()) {
+        auto cntl = std::make_shared<::brpc::Controller>();
+        auto response = std::make_shared<::openmldb::api::QueryResponse>();
+        if (tablet->CallProcedure(db, sp_name, row, cntl.get(), response.get(), options_->enable_debug,
+                                  options_->request_timeout, &follower_read)) {
+            return ResultSetSQL::MakeResultSet(response, cntl, status);
+        }
+        DLOG(INFO) << "follower read on " << tablet->GetEndpoint() << " failed, read the leader. "
+                   << (cntl->Failed() ? cntl->ErrorText() : response->msg());
+        tablet = GetTablet(db, sp_name, router_col, status);
+    }
     if (!tablet) {
         SET_STATUS_AND_WARN(status, StatusCode::kCmdError, "cannot get tablet");
         return nullptr;
@@ -2579,6 +2672,20 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(const std
     return ExecuteSQL(db, sql, status);
 }
 
+// match `EXPLAIN ANALYZE <query>` case insensitively, output the query
+static bool ParseExplainAnalyze(const std::string& sql, std::string* query) {
+    absl::string_view view = absl::StripLeadingAsciiWhitespace(sql);
+    for (absl::string_view word : {"explain", "analyze"}) {
+        if (view.size() <= word.size() || !absl::StartsWithIgnoreCase(view, word) ||
+            !absl::ascii_isspace(view[word.size()])) {
+            return false;
+        }
+        view = absl::StripLeadingAsciiWhitespace(view.substr(word.size()));
+    }
+    query->assign(view.data(), view.size());
+    return true;
+}
+
 std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(const std::string& db, const std::string& sql,
                                                                        hybridse::sdk::Status* status) {
     // To avoid small sync job timeout, we set offline_job_timeout to the biggest value, user can set >
@@ -2605,6 +2712,15 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(
     // functions we called later may not change the status if it's succeed. So if we pass error status here, we'll get a
     // fake error
     status->SetOK();
+    // the parser does not know EXPLAIN ANALYZE, strip it like EXPLAIN below
+    std::string analyze_sql;
+    if (ParseExplainAnalyze(sql, &analyze_sql)) {
+        if (!is_online_mode) {
+            SET_STATUS_AND_WARN(status, StatusCode::kCmdError, "explain analyze is only supported in online mode");
+            return {};
+        }
+        return ExplainAnalyze(db, analyze_sql, parameter, status);
+    }
     hybridse::node::NodeManager node_manager;
     hybridse::node::PlanNodeList plan_trees;
     hybridse::base::Status sql_status;
@@ -3278,7 +3394,86 @@ void SQLClusterRouter::SetInteractive(bool value) { interactive_validator_.SetIn
     return {};
 }
 
+namespace {
+
+// lines read as a unit by the readers, and rows put in one request at most
+constexpr uint32_t kLoadChunkLines = 1000;
+constexpr int kLoadBatchRows = 500;
+constexpr int64_t kLoadProgressIntervalMs = 10000;
+// a batch rejected by the partition, e.g. the leader has changed, is put again to the refreshed leader
+constexpr int kLoadPutRetryTimes = 3;
+constexpr int64_t kLoadPutRetryIntervalMs = 1000;
+
+// the batch is rejected before any row is put, or not delivered. A timed out request might have been applied, then
+// its rows are put again
+bool IsLoadPutRetryable(const ::openmldb::base::Status& st) {
+    switch (st.GetCode()) {
+        case ::openmldb::base::ReturnCode::kRPCError:
+        case ::openmldb::base::ReturnCode::kServerConnError:
+        case ::openmldb::base::ReturnCode::kTableIsNotExist:
+        case ::openmldb::base::ReturnCode::kTableIsFollower:
+        case ::openmldb::base::ReturnCode::kTableIsLoading:
+        case ::openmldb::base::ReturnCode::kReplicatorIsNotExist:
+        case ::openmldb::base::ReturnCode::kServerOverloaded:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// A bounded queue of chunks between the readers and the workers, so the lines read but not put are limited
+class LoadChunkQueue {
+ public:
+    explicit LoadChunkQueue(size_t capacity) : capacity_(capacity) {}
+
+    // block if the queue is full, return false if it's closed
+    bool Push(LoadChunk&& chunk) {
+        std::unique_lock<std::mutex> lock(mu_);
+        not_full_.wait(lock, [this] { return closed_ || queue_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        queue_.push_back(std::move(chunk));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // block if the queue is empty, return false if it's closed and drained
+    bool Pop(LoadChunk* chunk) {
+        std::unique_lock<std::mutex> lock(mu_);
+        not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return false;
+        }
+        *chunk = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mu_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+ private:
+    const size_t capacity_;
+    std::mutex mu_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<LoadChunk> queue_;
+    bool closed_ = false;
+};
+
+}  // namespace
+
 // Only csv format
+//
+// The files are loaded by a pipeline. The readers read the files in parallel and split the lines into chunks, the
+// workers parse and encode the lines of a chunk, then put the rows of every partition by batches. Every worker waits
+// for its request, so there are at most `thread` requests in flight.
 hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     const std::string& database, const std::string& table, const std::string& file_path,
     const openmldb::sdk::LoadOptionsMapParser& options_parser) {
@@ -3297,60 +3492,127 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     if (!thread.ok()) {
         return {StatusCode::kCmdError, "thread option get failed " + options_parser.ToString()};
     }
-    auto thread_num = thread.value();
-    std::vector<uint64_t> counts(thread_num);
-    std::vector<std::future<hybridse::sdk::Status>> future_statuses;
-    for (int i = 0; i < thread_num; i++) {
-        future_statuses.emplace_back(std::async(&SQLClusterRouter::LoadDataMultipleFile, this, i, thread_num, database,
-                                                table, file_list, options_parser, &(counts[i])));
+    auto deli = options_parser.GetAs<std::string>("delimiter");
+    auto quote = options_parser.GetAs<std::string>("quote");
+    auto null_value = options_parser.GetAs<std::string>("null_value");
+    if (!deli.ok() || !quote.ok() || !null_value.ok()) {
+        return {StatusCode::kCmdError, "delimiter/quote/null_value option get failed " + options_parser.ToString()};
     }
-    uint64_t total_count = 0;
+    auto header = options_parser.GetAs<bool>("header");
+    if (!header.ok()) {
+        return {StatusCode::kCmdError, "header option get failed " + options_parser.ToString()};
+    }
+    auto schema = GetTableSchema(database, table);
+    auto table_info = cluster_sdk_->GetTableInfo(database, table);
+    if (!schema || !table_info) {
+        return {StatusCode::kTableNotFound, "table does not exist"};
+    }
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    if (!cluster_sdk_->GetTablet(database, table, &tablets) || tablets.empty()) {
+        return {StatusCode::kCmdError, "fail to get table " + table + " tablet"};
+    }
+
+    LoadDataContext ctx;
+    ctx.database = database;
+    ctx.table_info = table_info;
+    ctx.schema = schema;
+    ctx.tablets = std::move(tablets);
+    ctx.delimiter = deli.value();
+    ctx.quote = quote.value().empty() ? '\0' : quote.value()[0];
+    ctx.null_value = null_value.value();
+    ctx.header = header.value();
+    // build placeholder
+    std::string holders;
+    for (auto i = 0; i < schema->GetColumnCnt(); ++i) {
+        holders += ((i == 0) ? "?" : ",?");
+        if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
+            ctx.str_cols_idx.emplace_back(i);
+        }
+    }
+    ctx.insert_placeholder = "insert into " + table + " values(" + holders + ");";
+
+    auto thread_num = static_cast<size_t>(thread.value());
+    size_t reader_num = std::min(thread_num, file_list.size());
+    LoadChunkQueue queue(thread_num * 2);
+    std::atomic<size_t> next_file{0};
+    std::atomic<uint64_t> loaded_cnt{0};
+    std::atomic<bool> failed{false};
+    std::mutex status_mu;
     hybridse::sdk::Status status;
-    for (int i = 0; i < thread_num; i++) {
-        auto s = future_statuses[i].get();
-        if (s.IsOK()) {
-            total_count += counts[i];
-        } else {
-            // keep the last error code
-            status.code = s.code;
-            status.msg = s.msg;
+    auto set_error = [&](const hybridse::sdk::Status& s) {
+        {
+            std::lock_guard<std::mutex> lock(status_mu);
+            // keep the first error, the later ones may be caused by the stop
+            if (!failed.exchange(true)) {
+                status = s;
+            }
+        }
+        queue.Close();
+    };
+
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < thread_num; i++) {
+        workers.emplace_back(std::async(std::launch::async, [&]() {
+            LoadChunk chunk;
+            while (!failed.load(std::memory_order_relaxed) && queue.Pop(&chunk)) {
+                auto s = LoadDataChunk(ctx, chunk);
+                if (!s.IsOK()) {
+                    set_error(s);
+                    return;
+                }
+                loaded_cnt.fetch_add(chunk.lines.size(), std::memory_order_relaxed);
+            }
+        }));
+    }
+    std::vector<std::future<void>> readers;
+    for (size_t i = 0; i < reader_num; i++) {
+        readers.emplace_back(std::async(std::launch::async, [&]() {
+            for (size_t idx = next_file.fetch_add(1); idx < file_list.size() && !failed.load(std::memory_order_relaxed);
+                 idx = next_file.fetch_add(1)) {
+                auto s = ReadLoadDataFile(ctx, file_list[idx], [&queue](LoadChunk&& chunk) {
+                    return queue.Push(std::move(chunk));
+                });
+                if (!s.IsOK()) {
+                    set_error(s);
+                    return;
+                }
+            }
+        }));
+    }
+
+    uint64_t start_time = ::baidu::common::timer::get_micros() / 1000;
+    auto wait_with_progress = [&](std::future<void>* f) {
+        while (f->wait_for(std::chrono::milliseconds(kLoadProgressIntervalMs)) != std::future_status::ready) {
+            uint64_t cost = ::baidu::common::timer::get_micros() / 1000 - start_time;
+            LOG(INFO) << "loading " << file_path << " into " << database << "." << table << ", loaded "
+                      << loaded_cnt.load(std::memory_order_relaxed) << " rows in " << cost << " ms";
         }
+        f->get();
+    };
+    for (auto& reader : readers) {
+        wait_with_progress(&reader);
+    }
+    // the workers exit after the queue is drained
+    queue.Close();
+    for (auto& worker : workers) {
+        wait_with_progress(&worker);
     }
 
+    uint64_t total_count = loaded_cnt.load();
     // all ok TODO(hw): move load result to resultset
     if (status.IsOK()) {
         status.msg = absl::StrCat("Load ", total_count, " rows");
         DLOG(INFO) << status.msg;
     } else {
-        // the last error
+        // the first error
         absl::StrAppend(&status.msg, "\n", "Load ", total_count, " rows");
         LOG(WARNING) << status.ToString();
     }
     return status;
 }
 
-hybridse::sdk::Status SQLClusterRouter::LoadDataMultipleFile(int id, int step, const std::string& database,
-                                                             const std::string& table,
-                                                             const std::vector<std::string>& file_list,
-                                                             const openmldb::sdk::LoadOptionsMapParser& options_parser,
-                                                             uint64_t* count) {
-    for (const auto& file : file_list) {
-        uint64_t cur_count = 0;
-        auto status = LoadDataSingleFile(id, step, database, table, file, options_parser, &cur_count);
-        DLOG(INFO) << "[thread " << id << "] Loaded " << count << " rows in " << file;
-        if (!status.IsOK()) {
-            return status;
-        }
-        (*count) += cur_count;
-    }
-    return {0, absl::StrCat("Load ", std::to_string(*count), " rows")};
-}
-
-hybridse::sdk::Status SQLClusterRouter::LoadDataSingleFile(int id, int step, const std::string& database,
-                                                           const std::string& table, const std::string& file_path,
-                                                           const openmldb::sdk::LoadOptionsMapParser& options_parser,
-                                                           uint64_t* count) {
-    *count = 0;
+hybridse::sdk::Status SQLClusterRouter::ReadLoadDataFile(const LoadDataContext& ctx, const std::string& file_path,
+                                                         const std::function<bool(LoadChunk&&)>& output) {
     // read csv
     if (!base::IsExists(file_path)) {
         return {StatusCode::kCmdError, "file not exist"};
@@ -3364,28 +3626,15 @@ hybridse::sdk::Status SQLClusterRouter::LoadDataSingleFile(int id, int step, con
     if (!std::getline(file, line)) {
         return {StatusCode::kCmdError, "read from file failed"};
     }
-    std::vector<std::string> cols;
-    auto deli = options_parser.GetAs<std::string>("delimiter");
-    auto quote = options_parser.GetAs<std::string>("quote");
-    auto null_value = options_parser.GetAs<std::string>("null_value");
-    if (!deli.ok() || !quote.ok() || !null_value.ok()) {
-        return {StatusCode::kCmdError, "delimiter/quote/null_value option get failed " + options_parser.ToString()};
-    }
     // peek the first line, check the column size and if it's a header
-    ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, deli.value(), &cols,
-                                                      quote.value().empty() ? '\0' : quote.value()[0]);
-    auto schema = GetTableSchema(database, table);
-    if (!schema) {
-        return {StatusCode::kTableNotFound, "table does not exist"};
-    }
+    std::vector<std::string> cols;
+    ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, ctx.delimiter, &cols, ctx.quote);
+    const auto& schema = ctx.schema;
     if (static_cast<int>(cols.size()) != schema->GetColumnCnt()) {
         return {StatusCode::kCmdError, "mismatch column size"};
     }
-    auto header = options_parser.GetAs<bool>("header");
-    if (!header.ok()) {
-        return {StatusCode::kCmdError, "header option get failed " + options_parser.ToString()};
-    }
-    if (header.value()) {
+    int64_t lineno = 0;
+    if (ctx.header) {
         // the first line is the column names, check if equal with table schema
         for (int i = 0; i < schema->GetColumnCnt(); ++i) {
             if (cols[i] != schema->GetColumnName(i)) {
@@ -3394,67 +3643,147 @@ hybridse::sdk::Status SQLClusterRouter::LoadDataSingleFile(int id, int step, con
             }
         }
         // then read the first row of data
-        std::getline(file, line);
-    }
-
-    // build placeholder
-    std::string holders;
-    for (auto i = 0; i < schema->GetColumnCnt(); ++i) {
-        holders += ((i == 0) ? "?" : ",?");
-    }
-    hybridse::sdk::Status status;
-    std::string insert_placeholder = "insert into " + table + " values(" + holders + ");";
-    std::vector<int> str_cols_idx;
-    for (int i = 0; i < schema->GetColumnCnt(); ++i) {
-        if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
-            str_cols_idx.emplace_back(i);
+        if (!std::getline(file, line)) {
+            return {};
         }
+        lineno++;
     }
 
-    int64_t i = 0;
+    LoadChunk chunk;
     do {
-        // only process the line assigned to its own id
-        if (i % step == id) {
-            cols.clear();
-            ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, deli.value(), &cols,
-                                                              quote.value().empty() ? '\0' : quote.value()[0]);
-            auto ret = InsertOneRow(database, insert_placeholder, str_cols_idx, null_value.value(), cols);
-            if (!ret.IsOK()) {
-                return {StatusCode::kCmdError, absl::StrCat("file [", file_path, "] line [lineno=", i, ": ", line,
-                                                            "] insert failed, ", ret.msg)};
-            } else {
-                (*count)++;
+        if (chunk.lines.empty()) {
+            chunk.file_path = file_path;
+            chunk.start_lineno = lineno;
+            chunk.lines.reserve(kLoadChunkLines);
+        }
+        chunk.lines.emplace_back(std::move(line));
+        lineno++;
+        if (chunk.lines.size() >= kLoadChunkLines) {
+            if (!output(std::move(chunk))) {
+                // stopped by a failure somewhere else
+                return {};
             }
+            chunk = LoadChunk();
         }
-        ++i;
     } while (std::getline(file, line));
-    return {StatusCode::kOk, "Load " + std::to_string(i) + " rows"};
+    if (!chunk.lines.empty()) {
+        output(std::move(chunk));
+    }
+    return {};
 }
 
-hybridse::sdk::Status SQLClusterRouter::InsertOneRow(const std::string& database, const std::string& insert_placeholder,
-                                                     const std::vector<int>& str_col_idx, const std::string& null_value,
-                                                     const std::vector<std::string>& cols) {
-    if (cols.empty()) {
-        return {StatusCode::kCmdError, "cols is empty"};
-    }
-    if (database.empty()) {
-        return {StatusCode::kCmdError, "database is empty"};
+hybridse::sdk::Status SQLClusterRouter::LoadDataChunk(const LoadDataContext& ctx, const LoadChunk& chunk) {
+    uint32_t tid = ctx.table_info->tid();
+    int memory_limit = insert_memory_usage_limit_.load(std::memory_order_relaxed);
+    std::map<uint32_t, ::google::protobuf::RepeatedPtrField<::openmldb::api::PutRequest>> batches;
+    // the line range whose rows are in the batches
+    int64_t batch_start = chunk.start_lineno;
+    int64_t lineno = chunk.start_lineno;
+    bool put_if_absent = false;
+    auto flush = [&](uint32_t pid,
+                     ::google::protobuf::RepeatedPtrField<::openmldb::api::PutRequest>* rows) -> hybridse::sdk::Status {
+        if (rows->empty()) {
+            return {};
+        }
+        std::shared_ptr<::openmldb::client::TabletClient> client;
+        if (pid < ctx.tablets.size() && ctx.tablets[pid]) {
+            client = ctx.tablets[pid]->GetClient();
+        }
+        int rows_cnt = rows->size();
+        uint32_t put_cnt = 0;
+        ::openmldb::base::Status st(::openmldb::base::ReturnCode::kServerConnError, "fail to get tablet client");
+        for (int retry = 0; retry <= kLoadPutRetryTimes; retry++) {
+            if (retry > 0) {
+                LOG(WARNING) << "put to tid " << tid << " pid " << pid << " failed, " << st.GetMsg()
+                             << ", refresh the leader and retry " << retry;
+                std::this_thread::sleep_for(std::chrono::milliseconds(kLoadPutRetryIntervalMs));
+                cluster_sdk_->Refresh();
+                auto tablet = cluster_sdk_->GetTablet(ctx.database, ctx.table_info->name(), pid);
+                client = tablet ? tablet->GetClient() : nullptr;
+            }
+            if (!client) {
+                continue;
+            }
+            // the rows are kept in rows if it fails
+            st = client->BatchPut(tid, pid, rows, memory_limit, put_if_absent, &put_cnt);
+            if (st.OK() || put_cnt > 0 || !IsLoadPutRetryable(st)) {
+                break;
+            }
+        }
+        rows->Clear();
+        if (!st.OK()) {
+            return {StatusCode::kCmdError,
+                    absl::StrCat("file [", chunk.file_path, "] lines [", batch_start, ", ", lineno, ") put ", put_cnt,
+                                 "/", rows_cnt, " rows to pid ", pid, " failed, ", st.GetMsg(),
+                                 ". Note that data might have been partially inserted.")};
+        }
+        return {};
+    };
+    auto flush_all = [&]() -> hybridse::sdk::Status {
+        for (auto& kv : batches) {
+            auto status = flush(kv.first, &kv.second);
+            if (!status.IsOK()) {
+                return status;
+            }
+        }
+        batch_start = lineno;
+        return {};
+    };
+
+    std::vector<std::string> cols;
+    for (const auto& line : chunk.lines) {
+        cols.clear();
+        ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, ctx.delimiter, &cols, ctx.quote);
+        hybridse::sdk::Status status;
+        auto row = EncodeLoadDataRow(ctx, cols, &status);
+        if (!row) {
+            return {StatusCode::kCmdError, absl::StrCat("file [", chunk.file_path, "] line [lineno=", lineno, ": ",
+                                                        line, "] insert failed, ", status.msg)};
+        }
+        put_if_absent = row->IsPutIfAbsent();
+        uint64_t cur_ts = ::baidu::common::timer::get_micros() / 1000;
+        bool full = false;
+        for (const auto& kv : row->GetDimensions()) {
+            auto* put = batches[kv.first].Add();
+            put->set_time(cur_ts);
+            put->set_value(row->GetRow());
+            for (const auto& dim : kv.second) {
+                auto* dimension = put->add_dimensions();
+                dimension->set_key(dim.first);
+                dimension->set_idx(dim.second);
+            }
+            full = full || batches[kv.first].size() >= kLoadBatchRows;
+        }
+        lineno++;
+        // keep the rows of a line in the same round, so a failure is reported by lines
+        if (full) {
+            status = flush_all();
+            if (!status.IsOK()) {
+                return status;
+            }
+        }
     }
-    hybridse::sdk::Status status;
-    auto row = GetInsertRow(database, insert_placeholder, &status);
+    return flush_all();
+}
+
+std::shared_ptr<SQLInsertRow> SQLClusterRouter::EncodeLoadDataRow(const LoadDataContext& ctx,
+                                                                  const std::vector<std::string>& cols,
+                                                                  hybridse::sdk::Status* status) {
+    auto row = GetInsertRow(ctx.database, ctx.insert_placeholder, status);
     if (!row) {
-        return status;
+        return {};
     }
     // build row from cols
     auto& schema = row->GetSchema();
     auto cnt = schema->GetColumnCnt();
     if (cnt != static_cast<int>(cols.size())) {
-        return {StatusCode::kCmdError, "col size mismatch"};
+        *status = {StatusCode::kCmdError, "col size mismatch"};
+        return {};
     }
     // scan all strings , calc the sum, to init SQLInsertRow's string length
     std::string::size_type str_len_sum = 0;
-    for (auto idx : str_col_idx) {
-        if (cols[idx] != null_value) {
+    for (auto idx : ctx.str_cols_idx) {
+        if (cols[idx] != ctx.null_value) {
             str_len_sum += cols[idx].length();
         }
     }
@@ -3462,19 +3791,17 @@ hybridse::sdk::Status SQLClusterRouter::InsertOneRow(const std::string& database
 
     for (int i = 0; i < cnt; ++i) {
         if (!::openmldb::codec::AppendColumnValue(cols[i], schema->GetColumnType(i), schema->IsColumnNotNull(i),
-                                                  null_value, row)) {
-            return {StatusCode::kCmdError, absl::StrCat("translate failed on column ", schema->GetColumnName(i), "(", i,
-                                                        ") with value ", cols[i])};
+                                                  ctx.null_value, row)) {
+            *status = {StatusCode::kCmdError, absl::StrCat("translate failed on column ", schema->GetColumnName(i),
+                                                           "(", i, ") with value ", cols[i])};
+            return {};
         }
     }
     if (!row->IsComplete()) {
-        return {StatusCode::kCmdError, "row is not complete: " + absl::StrJoin(cols, ",")};
-    }
-
-    if (!ExecuteInsert(database, insert_placeholder, row, &status)) {
-        RETURN_NOT_OK_PREPEND(status, "insert row failed");
+        *status = {StatusCode::kCmdError, "row is not complete: " + absl::StrJoin(cols, ",")};
+        return {};
     }
-    return {};
+    return row;
 }
 
 hybridse::sdk::Status SQLClusterRouter::HandleDelete(const std::string& db, const std::string& table_name,
@@ -17,6 +17,7 @@
 #ifndef SRC_SDK_SQL_CLUSTER_ROUTER_H_
 #define SRC_SDK_SQL_CLUSTER_ROUTER_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -50,6 +51,8 @@ using TableInfoMap = std::map<std::string, std::map<std::string, ::openmldb::nam
 
 class Bias;
 struct UserInfo;
+struct LoadDataContext;
+struct LoadChunk;
 
 class SQLClusterRouter : public SQLRouter {
  public:
@@ -138,6 +141,11 @@ class SQLClusterRouter : public SQLRouter {
                                                                       std::shared_ptr<SQLRequestRow> parameter,
                                                                       ::hybridse::sdk::Status* status) override;
 
+    // run the query in online batch mode and return its runner tree annotated with the time and output of every runner
+    std::shared_ptr<hybridse::sdk::ResultSet> ExplainAnalyze(const std::string& db, const std::string& sql,
+                                                             std::shared_ptr<SQLRequestRow> parameter,
+                                                             ::hybridse::sdk::Status* status);
+
     std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLBatchRequest(const std::string& db, const std::string& sql,
                                                                      std::shared_ptr<SQLRequestRowBatch> row_batch,
                                                                      ::hybridse::sdk::Status* status) override;
@@ -203,10 +211,12 @@ class SQLClusterRouter : public SQLRouter {
                                                                       ::hybridse::vm::EngineMode engine_mode,
                                                                       const std::shared_ptr<SQLRequestRow>& row,
                                                                       hybridse::sdk::Status* status);
+    // if follower_read is not null and follower reads are enabled, a follower of the partition of the row is returned
+    // when there is one, and follower_read is filled for the query
     std::shared_ptr<::openmldb::client::TabletClient> GetTabletClient(
         const std::string& db, const std::string& sql, ::hybridse::vm::EngineMode engine_mode,
         const std::shared_ptr<SQLRequestRow>& row, const std::shared_ptr<SQLRequestRow>& parameter_row,
-        hybridse::sdk::Status* status);
+        hybridse::sdk::Status* status, ::openmldb::api::FollowerRead* follower_read = nullptr);
 
     std::shared_ptr<SQLCache> GetSQLCache(const std::string& db, const std::string& sql,
                                           ::hybridse::vm::EngineMode engine_mode,
@@ -334,7 +344,13 @@ class SQLClusterRouter : public SQLRouter {
     inline bool CheckSQLSyntax(const std::string& sql);
 
     std::shared_ptr<openmldb::client::TabletClient> GetTablet(const std::string& db, const std::string& sp_name,
-            const std::string& router_col, hybridse::sdk::Status* status);
+            const std::string& router_col, hybridse::sdk::Status* status,
+            ::openmldb::api::FollowerRead* follower_read = nullptr);
+
+    // a random follower of the partition of pk if follower reads are enabled by follower_read_max_lag, otherwise null
+    std::shared_ptr<openmldb::client::TabletClient> GetFollowerClient(const std::string& db, const std::string& table,
+                                                                      const std::string& pk,
+                                                                      ::openmldb::api::FollowerRead* follower_read);
 
     bool ExtractDBTypes(const std::shared_ptr<hybridse::sdk::Schema>& schema,
                         std::vector<openmldb::type::DataType>* parameter_types);
@@ -354,19 +370,15 @@ class SQLClusterRouter : public SQLRouter {
                                                const std::string& file_path,
                                                const openmldb::sdk::LoadOptionsMapParser& options_parser);
 
-    hybridse::sdk::Status LoadDataMultipleFile(int id, int step, const std::string& database, const std::string& table,
-                                               const std::vector<std::string>& file_list,
-                                               const openmldb::sdk::LoadOptionsMapParser& options_parser,
-                                               uint64_t* count);
+    // read the lines of the file, output them by chunks until it returns false
+    hybridse::sdk::Status ReadLoadDataFile(const LoadDataContext& ctx, const std::string& file_path,
+                                           const std::function<bool(LoadChunk&&)>& output);
 
-    hybridse::sdk::Status LoadDataSingleFile(int id, int step, const std::string& database, const std::string& table,
-                                             const std::string& file_path,
-                                             const openmldb::sdk::LoadOptionsMapParser& options_parser,
-                                             uint64_t* count);
+    // encode the lines of the chunk and put the rows by batches
+    hybridse::sdk::Status LoadDataChunk(const LoadDataContext& ctx, const LoadChunk& chunk);
 
-    hybridse::sdk::Status InsertOneRow(const std::string& database, const std::string& insert_placeholder,
-                                       const std::vector<int>& str_col_idx, const std::string& null_value,
-                                       const std::vector<std::string>& cols);
+    std::shared_ptr<SQLInsertRow> EncodeLoadDataRow(const LoadDataContext& ctx, const std::vector<std::string>& cols,
+                                                    hybridse::sdk::Status* status);
 
     hybridse::sdk::Status HandleDeploy(const std::string& db, const hybridse::node::DeployPlanNode* deploy_node,
                                        std::optional<uint64_t>* job_id);
@@ -460,6 +472,28 @@ struct UserInfo {
     uint64_t update_time = 0;
 };
 
+// the target table and the csv options of a local LOAD DATA
+struct LoadDataContext {
+    std::string database;
+    std::shared_ptr<::openmldb::nameserver::TableInfo> table_info;
+    std::shared_ptr<hybridse::sdk::Schema> schema;
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    std::string insert_placeholder;
+    std::vector<int> str_cols_idx;
+    std::string delimiter;
+    char quote = '\0';
+    std::string null_value;
+    bool header = true;
+};
+
+// the consecutive lines of a file
+struct LoadChunk {
+    std::string file_path;
+    // line number of the first line in the file
+    int64_t start_lineno = 0;
+    std::vector<std::string> lines;
+};
+
 class Bias {
  public:
     // If get failed, return false and won't change bias. Check negative bias value for your own logic
@@ -17,6 +17,7 @@
 #include "sdk/sql_request_row.h"
 
 #include <stdint.h>
+#include <string.h>
 #include <string>
 #include <unordered_map>
 
@@ -411,7 +412,13 @@ SQLRequestRowBatch::SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> sc
 
     std::vector<size_t> common_indices_vec;
     std::vector<size_t> non_common_indices_vec;
+    min_row_size_ = SDKGetStartOffset(schema->GetColumnCnt());
     for (int i = 0; i < schema->GetColumnCnt(); ++i) {
+        auto iter = SDK_TYPE_SIZE_MAP.find(schema->GetColumnType(i));
+        min_row_size_ += iter == SDK_TYPE_SIZE_MAP.end() ? 1 : iter->second;
+        if (schema->GetColumnType(i) == ::hybridse::sdk::kTypeString) {
+            str_field_cnt_++;
+        }
         auto col_ref = request_schema_.Add();
         col_ref->set_name(schema->GetColumnName(i));
         col_ref->set_is_not_null(schema->IsColumnNotNull(i));
@@ -422,6 +429,7 @@ SQLRequestRowBatch::SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> sc
             non_common_indices_vec.push_back(i);
         }
     }
+    row_view_ = std::make_unique<::hybridse::codec::RowView>(request_schema_);
 
     if (!common_column_indices_.empty()) {
         common_selector_ = std::unique_ptr<::hybridse::codec::RowSelector>(
@@ -431,14 +439,50 @@ SQLRequestRowBatch::SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> sc
     }
 }
 
+bool SQLRequestRowBatch::CheckEncodedRow(const int8_t* buf, uint32_t size) {
+    // the string offsets take more than one byte in a large row
+    uint32_t str_start = min_row_size_ + (SDKGetAddrLength(size) - 1) * str_field_cnt_;
+    if (row_view_ == nullptr || size < str_start || !row_view_->Reset(buf, size)) {
+        return false;
+    }
+    for (int i = 0; i < request_schema_.size(); i++) {
+        if (request_schema_.Get(i).type() != ::hybridse::type::kVarchar || row_view_->IsNULL(i)) {
+            continue;
+        }
+        const char* val = nullptr;
+        uint32_t length = 0;
+        if (row_view_->GetValue(buf, i, &val, &length) != 0) {
+            return false;
+        }
+        size_t offset = val - reinterpret_cast<const char*>(buf);
+        if (offset < str_start || offset > size || length > size - offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SQLRequestRowBatch::AddRow(std::shared_ptr<SQLRequestRow> row) {
     if (row == nullptr || !row->OK()) {
         LOG(WARNING) << "make sure the request row is built before execute sql";
         return false;
     }
     const std::string& row_str = row->GetRow();
-    int8_t* input_buf = reinterpret_cast<int8_t*>(const_cast<char*>(&row_str[0]));
-    size_t input_size = row_str.size();
+    return AddEncodedRow(reinterpret_cast<const int8_t*>(row_str.data()), row_str.size());
+}
+
+bool SQLRequestRowBatch::AddEncodedRow(const int8_t* buf, size_t size) {
+    uint32_t row_size = 0;
+    if (buf != nullptr && size >= min_row_size_ && size <= UINT32_MAX) {
+        // the buffer may be unaligned
+        memcpy(&row_size, buf + SDK_VERSION_LENGTH, SDK_SIZE_LENGTH);
+    }
+    if (row_size != size || !CheckEncodedRow(buf, row_size)) {
+        LOG(WARNING) << "invalid encoded request row, size " << size;
+        return false;
+    }
+    int8_t* input_buf = const_cast<int8_t*>(buf);
+    size_t input_size = size;
 
     // non-common
     if (common_column_indices_.empty() ||
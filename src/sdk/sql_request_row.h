@@ -88,6 +88,9 @@ class SQLRequestRowBatch {
  public:
     SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> schema, std::shared_ptr<ColumnIndicesSet> indices);
     bool AddRow(std::shared_ptr<SQLRequestRow> row);
+    // add a row which is already encoded by the row codec with the request schema, e.g. from the binary http api.
+    // The row size and the string offsets are validated here, the row buffer is copied without decoding.
+    bool AddEncodedRow(const int8_t* buf, size_t size);
     int Size() const { return non_common_slices_.size(); }
 
     const std::set<size_t>& common_column_indices() const { return common_column_indices_; }
@@ -107,8 +110,15 @@ class SQLRequestRowBatch {
     }
 
  private:
+    // check that the string fields of the encoded row are within the row
+    bool CheckEncodedRow(const int8_t* buf, uint32_t size);
+
     ::hybridse::codec::Schema request_schema_;
     std::set<size_t> common_column_indices_;
+    // header, bitmap, fixed-size fields and one byte offset per string field
+    uint32_t min_row_size_ = 0;
+    uint32_t str_field_cnt_ = 0;
+    std::unique_ptr<::hybridse::codec::RowView> row_view_;
 
     std::unique_ptr<::hybridse::codec::RowSelector> common_selector_;
     std::unique_ptr<::hybridse::codec::RowSelector> non_common_selector_;
@@ -272,6 +272,35 @@ TEST_F(SQLRequestRowBatchTest, batch_test_all_common) {
     ASSERT_EQ(non_common_view.GetStringUnsafe(1), "world");
 }
 
+TEST_F(SQLRequestRowBatchTest, add_encoded_row) {
+    ::hybridse::vm::Schema schema;
+    InitSimpleSchema(&schema);
+    auto schema_shared = std::make_shared<::hybridse::sdk::SchemaImpl>(schema);
+    SQLRequestRow row(schema_shared, std::set<std::string>());
+    row.Init(5);
+    row.AppendInt32(32);
+    row.AppendString("hello");
+    row.AppendInt64(64);
+    ASSERT_TRUE(row.Build());
+
+    SQLRequestRowBatch batch(schema_shared, std::make_shared<ColumnIndicesSet>(schema_shared));
+    // unaligned buffer
+    std::string buf = "x" + row.GetRow();
+    auto row_ptr = reinterpret_cast<const int8_t*>(buf.data() + 1);
+    ASSERT_TRUE(batch.AddEncodedRow(row_ptr, row.GetRow().size()));
+    ASSERT_FALSE(batch.AddEncodedRow(row_ptr, row.GetRow().size() - 1));
+    ASSERT_EQ(1, batch.Size());
+
+    // the string offset follows the header, the bitmap, the int32 and the int64 fields
+    size_t str_offset_pos = 1 + 6 + 1 + 4 + 8;
+    std::string bad_buf = buf;
+    bad_buf[str_offset_pos] = 0;
+    ASSERT_FALSE(batch.AddEncodedRow(reinterpret_cast<const int8_t*>(bad_buf.data() + 1), row.GetRow().size()));
+    bad_buf[str_offset_pos] = static_cast<char>(0xff);
+    ASSERT_FALSE(batch.AddEncodedRow(reinterpret_cast<const int8_t*>(bad_buf.data() + 1), row.GetRow().size()));
+    ASSERT_EQ(1, batch.Size());
+}
+
 }  // namespace sdk
 }  // namespace openmldb
 
@@ -695,6 +695,44 @@ TEST_F(SQLSDKTest, TableReaderScan) {
     ASSERT_FALSE(rs->Next());
 }
 
+TEST_F(SQLSDKTest, TableReaderScanWithFilter) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string db = GenRand("db");
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl = "create table test0 (col1 string, col2 bigint, col3 int, index(key=col1, ts=col2));";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status));
+    ASSERT_TRUE(router->RefreshCatalog());
+    for (int i = 0; i < 10; i++) {
+        std::string insert = "insert into test0 values('key1', " + std::to_string(1609212669000L + i) + "L, " +
+                             std::to_string(i) + ");";
+        ASSERT_TRUE(router->ExecuteInsert(db, insert, &status));
+    }
+    auto table_reader = router->GetTableReader();
+    ScanOption so;
+    so.filters.push_back({"col3", kScanFilterGe, "7"});
+    auto rs = table_reader->Scan(db, "test0", "key1", 1609212679000l, 0, so, &status);
+    ASSERT_TRUE(rs);
+    // only the matched rows are sent back by the tablet
+    ASSERT_EQ(3, rs->Size());
+    while (rs->Next()) {
+        ASSERT_GE(rs->GetInt32Unsafe(2), 7);
+    }
+    so.limit = 2;
+    rs = table_reader->Scan(db, "test0", "key1", 1609212679000l, 0, so, &status);
+    ASSERT_TRUE(rs);
+    ASSERT_EQ(2, rs->Size());
+
+    ScanOption bad_so;
+    bad_so.filters.push_back({"col_not_exist", kScanFilterEq, "1"});
+    ASSERT_FALSE(table_reader->Scan(db, "test0", "key1", 1609212679000l, 0, bad_so, &status));
+}
+
 TEST_F(SQLSDKTest, TableReaderAsyncScan) {
     SQLRouterOptions sql_opt;
     sql_opt.zk_cluster = mc_->GetZkCluster();
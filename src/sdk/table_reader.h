@@ -26,10 +26,30 @@
 namespace openmldb {
 namespace sdk {
 
+enum ScanFilterOp {
+    kScanFilterEq = 1,
+    kScanFilterNe,
+    kScanFilterLt,
+    kScanFilterLe,
+    kScanFilterGt,
+    kScanFilterGe,
+    kScanFilterIsNull,
+    kScanFilterIsNotNull,
+};
+
+// `column op value`, evaluated on the tablet so rows that fail it are not sent back
+struct ScanFilter {
+    std::string column;
+    ScanFilterOp op = kScanFilterEq;
+    // the literal in string format, it is ignored by kScanFilterIsNull and kScanFilterIsNotNull
+    std::string value;
+};
+
 struct ScanOption {
     std::string idx_name;
     uint32_t limit = 0;
     std::vector<std::string> projection;
+    std::vector<ScanFilter> filters;
 };
 
 class ScanFuture {
@@ -28,6 +28,23 @@
 namespace openmldb {
 namespace sdk {
 
+static bool SetScanFilters(const ScanOption& so, ::openmldb::catalog::SDKTableHandler* sdk_table_handler,
+                           ::openmldb::api::ScanRequest* request) {
+    for (const auto& filter : so.filters) {
+        int32_t col_idx = sdk_table_handler->GetColumnIndex(filter.column);
+        if (col_idx < 0) {
+            LOG(WARNING) << "fail to get filter col " << filter.column << " from table "
+                         << sdk_table_handler->GetName();
+            return false;
+        }
+        auto condition = request->add_filter();
+        condition->set_col_idx(static_cast<uint32_t>(col_idx));
+        condition->set_op(static_cast<::openmldb::common::CompareOp>(filter.op));
+        condition->set_value(filter.value);
+    }
+    return true;
+}
+
 class ScanFutureImpl : public ScanFuture {
  public:
     ScanFutureImpl(openmldb::RpcCallback<openmldb::api::ScanResponse>* callback,
@@ -137,6 +154,9 @@ std::shared_ptr<openmldb::sdk::ScanFuture> TableReaderImpl::AsyncScan(const std:
     if (!so.idx_name.empty()) {
         request.set_idx_name(so.idx_name);
     }
+    if (!SetScanFilters(so, sdk_table_handler, &request)) {
+        return std::shared_ptr<openmldb::sdk::ScanFuture>();
+    }
     auto scan_future = std::make_shared<ScanFutureImpl>(callback, request.projection(), table_handler);
     client->AsyncScan(request, callback);
     return scan_future;
@@ -185,6 +205,9 @@ std::shared_ptr<hybridse::sdk::ResultSet> TableReaderImpl::Scan(const std::strin
     if (!so.idx_name.empty()) {
         request.set_idx_name(so.idx_name);
     }
+    if (!SetScanFilters(so, sdk_table_handler, &request)) {
+        return std::shared_ptr<hybridse::sdk::ResultSet>();
+    }
     auto response = std::make_shared<::openmldb::api::ScanResponse>();
     auto cntl = std::make_shared<::brpc::Controller>();
     client->Scan(request, cntl.get(), response.get());
@@ -16,6 +16,9 @@
 
 #include "statistics/query_response_time/deployment_metric_collector.h"
 
+#include <iterator>
+#include <vector>
+
 namespace openmldb::statistics {
 
 absl::Status DeploymentMetricCollector::Collect(const std::string& db, const std::string& deploy_name,
@@ -40,4 +43,26 @@ void DeploymentMetricCollector::Reset() {
     absl::WriterMutexLock lock(&mutex_);
     md_recorder_ = make_shared(prefix_);
 }
+
+absl::Status DeploymentRunnerMetricCollector::Collect(const std::string& db, const std::string& deploy_name,
+                                                      const std::string& runner, absl::Duration time) {
+    auto it = md_recorder_->get_stats({db, deploy_name, runner});
+    if (it == nullptr) {
+        LOG(WARNING) << "reach limit size, collect failed";
+        return absl::OutOfRangeError("multi-dimensional recorder reaches limit size, please delete old deploy");
+    }
+    *it << absl::ToInt64Microseconds(time);
+    return absl::OkStatus();
+}
+
+absl::Status DeploymentRunnerMetricCollector::DeleteDeploy(const std::string& db, const std::string& deploy_name) {
+    std::vector<MDRecorder::key_type> keys;
+    md_recorder_->list_stats(&keys);
+    for (const auto& key : keys) {
+        if (key.size() == 3 && key.front() == db && *std::next(key.begin()) == deploy_name) {
+            md_recorder_->delete_stats(key);
+        }
+    }
+    return absl::OkStatus();
+}
 }  // namespace openmldb::statistics
@@ -77,5 +77,25 @@ class DeploymentMetricCollector {
     std::shared_ptr<MDRecorder> md_recorder_ GUARDED_BY(mutex_);
     mutable absl::Mutex mutex_;  // protects collectors_
 };
+
+// time of every runner in the sampled deployment requests, labeled by db, deployment and runner `<id>_<type>`
+class DeploymentRunnerMetricCollector {
+ public:
+    typedef typename bvar::MultiDimension<bvar::LatencyRecorder> MDRecorder;
+    explicit DeploymentRunnerMetricCollector(const std::string& prefix)
+        : md_recorder_(std::make_shared<MDRecorder>(prefix, "deployment_runner",
+                                                    MDRecorder::key_type{"db", "deployment", "runner"})) {}
+    DeploymentRunnerMetricCollector(const DeploymentRunnerMetricCollector& c) = delete;
+
+    absl::Status Collect(const std::string& db, const std::string& deploy_name, const std::string& runner,
+                         absl::Duration time);
+    // delete the stats of all runners of the deployment
+    absl::Status DeleteDeploy(const std::string& db, const std::string& deploy_name);
+
+    bool HasStats(const std::list<std::string>& key) { return md_recorder_->has_stats(key); }
+
+ private:
+    std::shared_ptr<MDRecorder> md_recorder_;
+};
 }  // namespace openmldb::statistics
 #endif  // SRC_STATISTICS_QUERY_RESPONSE_TIME_DEPLOYMENT_METRIC_COLLECTOR_H_
@@ -123,6 +123,18 @@ TEST_F(CollectorTest, MemoryTest) {
     test(1, 20002, 1, true);
 }
 
+TEST_F(CollectorTest, RunnerCollectorTest) {
+    DeploymentRunnerMetricCollector collector("runner_test");
+    ASSERT_TRUE(collector.Collect("db0", "d0", "1_PROJECT", absl::Microseconds(10)).ok());
+    ASSERT_TRUE(collector.Collect("db0", "d0", "2_REQUEST_UNION", absl::Microseconds(20)).ok());
+    ASSERT_TRUE(collector.Collect("db0", "d1", "1_PROJECT", absl::Microseconds(10)).ok());
+    ASSERT_TRUE(collector.HasStats({"db0", "d0", "1_PROJECT"}));
+    ASSERT_TRUE(collector.DeleteDeploy("db0", "d0").ok());
+    ASSERT_FALSE(collector.HasStats({"db0", "d0", "1_PROJECT"}));
+    ASSERT_FALSE(collector.HasStats({"db0", "d0", "2_REQUEST_UNION"}));
+    ASSERT_TRUE(collector.HasStats({"db0", "d1", "1_PROJECT"}));
+}
+
 }  // namespace statistics
 }  // namespace openmldb
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/aggr_watermark.h"
+
+#include "base/hash.h"
+
+namespace openmldb {
+namespace storage {
+
+// the column of the bucket end in the pre-aggr table
+constexpr uint32_t kAggrTsEndIdx = 2;
+
+AggrWatermark::Shard& AggrWatermark::GetShard(const std::string& key) {
+    return shards_[static_cast<uint64_t>(::openmldb::base::hash64(key)) % kShardNum];
+}
+
+void AggrWatermark::Add(const std::string& key, int64_t ts) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    shard.pending_map[key].insert(ts);
+}
+
+void AggrWatermark::Remove(const std::string& key, int64_t ts) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto it = shard.pending_map.find(key);
+    if (it == shard.pending_map.end()) {
+        return;
+    }
+    auto& pending = it->second;
+    if (auto ts_it = pending.find(ts); ts_it != pending.end()) {
+        pending.erase(ts_it);
+    }
+    if (pending.empty()) {
+        shard.pending_map.erase(it);
+    }
+}
+
+std::optional<int64_t> AggrWatermark::Get(const std::string& key) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto it = shard.pending_map.find(key);
+    if (it == shard.pending_map.end()) {
+        return std::nullopt;
+    }
+    return *it->second.begin();
+}
+
+bool AggrWatermark::IsComplete(const int8_t* bucket_row, int64_t watermark) const {
+    int64_t ts_end = 0;
+    if (aggr_row_view_.GetValue(bucket_row, kAggrTsEndIdx, ::openmldb::type::DataType::kTimestamp, &ts_end) != 0) {
+        return false;
+    }
+    return ts_end < watermark;
+}
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_AGGR_WATERMARK_H_
+#define SRC_STORAGE_AGGR_WATERMARK_H_
+
+#include <array>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <set>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "codec/codec.h"
+
+namespace openmldb {
+namespace storage {
+
+// The watermarks of the keys of a pre-aggr table partition, whose aggregator applies the rows put to the base table
+// asynchronously. The watermark of a key is not larger than the ts of any row of it which is put but not applied yet,
+// so the buckets ending before it are complete. A key without such rows has no watermark.
+class AggrWatermark {
+ public:
+    explicit AggrWatermark(const codec::Schema& aggr_schema)
+        : aggr_schema_(aggr_schema), aggr_row_view_(aggr_schema_) {}
+
+    AggrWatermark(const AggrWatermark&) = delete;
+    AggrWatermark& operator=(const AggrWatermark&) = delete;
+
+    // a row of the key is put to the base table, it is pending until removed
+    void Add(const std::string& key, int64_t ts);
+
+    // a pending row of the key with the ts is applied
+    void Remove(const std::string& key, int64_t ts);
+
+    std::optional<int64_t> Get(const std::string& key);
+
+    // the bucket, a row of the pre-aggr table, contains no pending rows if its key has the watermark
+    bool IsComplete(const int8_t* bucket_row, int64_t watermark) const;
+
+ private:
+    struct Shard {
+        std::mutex mu;
+        // key -> the ts of the pending rows, the smallest is the watermark
+        absl::flat_hash_map<std::string, std::multiset<int64_t>> pending_map;
+    };
+
+    static constexpr uint32_t kShardNum = 16;
+
+    Shard& GetShard(const std::string& key);
+
+ private:
+    std::array<Shard, kShardNum> shards_;
+    codec::Schema aggr_schema_;
+    codec::RowView aggr_row_view_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+#endif  // SRC_STORAGE_AGGR_WATERMARK_H_
@@ -24,12 +24,16 @@
 #include "absl/strings/str_cat.h"
 #include "base/file_util.h"
 #include "base/glog_wrapper.h"
+#include "base/hash.h"
 #include "base/slice.h"
 #include "base/strings.h"
 #include "common/timer.h"
 #include "storage/table.h"
 
 DECLARE_bool(binlog_notify_on_put);
+DECLARE_uint32(max_aggr_buffer_key_num);
+DECLARE_uint32(aggr_update_thread_num);
+
 namespace openmldb {
 namespace storage {
 
@@ -95,6 +99,10 @@ Aggregator::Aggregator(const ::openmldb::api::TableMeta& base_meta, std::shared_
     if (ts_col_idx_ == -1) {
         PDLOG(ERROR, "ts_col not found in base table");
     }
+    if (FLAGS_aggr_update_thread_num > 0 && aggr_table_) {
+        watermark_ = std::make_shared<AggrWatermark>(aggr_table_schema_);
+        aggr_table_->SetAggrWatermark(watermark_);
+    }
 }
 
 Aggregator::~Aggregator() {}
@@ -124,23 +132,15 @@ bool Aggregator::Update(const std::string& key, const std::string& row, uint64_t
         return false;
     }
 
-    AggrBufferLocked* aggr_buffer_lock;
+    std::shared_ptr<AggrBufferLocked> aggr_buffer_lock;
+    std::vector<IdleKey> idle_keys;
+    auto& shard = GetShard(key);
     {
-        std::lock_guard<std::mutex> lock(mu_);
-        auto it = aggr_buffer_map_.find(key);
-        if (it == aggr_buffer_map_.end()) {
-            auto insert_pair = aggr_buffer_map_[key].emplace(filter_key, AggrBufferLocked{});
-            aggr_buffer_lock = &insert_pair.first->second;
-        } else {
-            auto& filter_map = it->second;
-            auto filter_it = filter_map.find(filter_key);
-            if (filter_it == filter_map.end()) {
-                auto insert_pair = filter_map.emplace(filter_key, AggrBufferLocked{});
-                aggr_buffer_lock = &insert_pair.first->second;
-            } else {
-                aggr_buffer_lock = &filter_it->second;
-            }
-        }
+        std::lock_guard<std::mutex> lock(shard.mu);
+        aggr_buffer_lock = GetBufferUnlock(&shard, key, filter_key, &idle_keys);
+    }
+    if (!idle_keys.empty()) {
+        EvictIdleKeys(&shard, &idle_keys);
     }
 
     std::unique_lock<std::mutex> lock(*aggr_buffer_lock->mu_);
@@ -207,12 +207,32 @@ bool Aggregator::Update(const std::string& key, const std::string& row, uint64_t
     return true;
 }
 
+int64_t Aggregator::GetPendingTs(const std::string& row) {
+    int64_t cur_ts = 0;
+    if (ts_col_type_ == DataType::kBigInt || ts_col_type_ == DataType::kTimestamp) {
+        base_row_view_.GetValue(reinterpret_cast<const int8_t*>(row.c_str()), ts_col_idx_, ts_col_type_, &cur_ts);
+    }
+    return cur_ts;
+}
+
+void Aggregator::AddPending(const std::string& key, const std::string& row) {
+    if (watermark_) {
+        watermark_->Add(key, GetPendingTs(row));
+    }
+}
+
+void Aggregator::RemovePending(const std::string& key, const std::string& row) {
+    if (watermark_) {
+        watermark_->Remove(key, GetPendingTs(row));
+    }
+}
+
 bool Aggregator::DeleteData(const std::string& key, const std::optional<uint64_t>& start_ts,
         const std::optional<uint64_t>& end_ts) {
     if (!start_ts.has_value() && !end_ts.has_value()) {
-        std::lock_guard<std::mutex> lock(mu_);
-        // erase from the aggr_buffer_map_
-        aggr_buffer_map_.erase(key);
+        auto& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mu);
+        shard.key_map.erase(key);
     }
     ::openmldb::api::LogEntry entry;
     entry.set_term(aggr_replicator_->GetLeaderTerm());
@@ -248,15 +268,16 @@ bool Aggregator::Delete(const std::string& key, const std::optional<uint64_t>& s
         return DeleteData(key, start_ts, end_ts);
     }
     uint64_t real_start_ts = start_ts.has_value() ? start_ts.value() : UINT64_MAX;
-    std::vector<AggrBufferLocked*> aggr_buffer_lock_vec;
+    std::vector<std::shared_ptr<AggrBufferLocked>> aggr_buffer_lock_vec;
     {
-        std::lock_guard<std::mutex> lock(mu_);
-        if (auto it = aggr_buffer_map_.find(key); it != aggr_buffer_map_.end()) {
-            for (auto& kv : it->second) {
-                auto& buffer = kv.second.buffer_;
+        auto& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mu);
+        if (auto it = shard.key_map.find(key); it != shard.key_map.end()) {
+            for (auto& kv : it->second.filter_map) {
+                auto& buffer = kv.second->buffer_;
                 if (buffer.IsInited() && real_start_ts >= static_cast<uint64_t>(buffer.ts_begin_) &&
                         (!end_ts.has_value() || end_ts.value() < static_cast<uint64_t>(buffer.ts_end_))) {
-                    aggr_buffer_lock_vec.push_back(&kv.second);
+                    aggr_buffer_lock_vec.push_back(kv.second);
                 }
             }
         }
@@ -400,18 +421,19 @@ bool Aggregator::RebuildAggrBuffer(const std::string& key, AggrBuffer* aggr_buff
 
 bool Aggregator::FlushAll() {
     // TODO(nauta): optimize the flush process
-    std::unique_lock<std::mutex> lock(mu_);
     absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, AggrBuffer>> flushed_buffer_map;
-    for (auto& it : aggr_buffer_map_) {
-        for (auto& filter_it : it.second) {
-            auto& aggr_buffer = filter_it.second.buffer_;
-            if (aggr_buffer.aggr_cnt_ == 0) {
-                continue;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        for (auto& it : shard.key_map) {
+            for (auto& filter_it : it.second.filter_map) {
+                auto& aggr_buffer = filter_it.second->buffer_;
+                if (aggr_buffer.aggr_cnt_ == 0) {
+                    continue;
+                }
+                flushed_buffer_map[it.first].emplace(filter_it.first, aggr_buffer);
             }
-            flushed_buffer_map[it.first].emplace(filter_it.first, aggr_buffer);
         }
     }
-    lock.unlock();
     for (auto& it : flushed_buffer_map) {
         for (auto& filter_it : it.second) {
             if (!FlushAggrBuffer(it.first, filter_it.first, filter_it.second)) {
@@ -451,8 +473,13 @@ bool Aggregator::Init(std::shared_ptr<LogReplicator> base_replicator) {
         if (!aggr_row_view_.IsNULL(data_ptr, 6)) {
             aggr_row_view_.GetStrValue(data_ptr, 6, &filter_key);
         }
-        auto insert_pair = aggr_buffer_map_[pk].emplace(std::move(filter_key), AggrBufferLocked{});
-        auto& buffer = insert_pair.first->second.buffer_;
+        auto buffer_lock = std::make_shared<AggrBufferLocked>();
+        {
+            auto& shard = GetShard(pk);
+            std::lock_guard<std::mutex> lock(shard.mu);
+            shard.key_map[pk].filter_map.emplace(std::move(filter_key), buffer_lock);
+        }
+        auto& buffer = buffer_lock->buffer_;
         auto val = it->GetValue();
         auto aggr_row_ptr = reinterpret_cast<const int8_t*>(val.data());
         bool ok = GetAggrBufferFromRowView(aggr_row_view_, aggr_row_ptr, &buffer);
@@ -548,15 +575,150 @@ bool Aggregator::Init(std::shared_ptr<LogReplicator> base_replicator) {
 bool Aggregator::GetAggrBuffer(const std::string& key, AggrBuffer** buffer) { return GetAggrBuffer(key, "", buffer); }
 
 bool Aggregator::GetAggrBuffer(const std::string& key, const std::string& filter_key, AggrBuffer** buffer) {
-    std::lock_guard<std::mutex> lock(mu_);
-    auto it = aggr_buffer_map_.find(key);
-    if (it == aggr_buffer_map_.end()) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto it = shard.key_map.find(key);
+    if (it == shard.key_map.end()) {
         return false;
     }
-    *buffer = &aggr_buffer_map_[key][filter_key].buffer_;
+    auto& buffer_lock = it->second.filter_map[filter_key];
+    if (!buffer_lock) {
+        buffer_lock = std::make_shared<AggrBufferLocked>();
+    }
+    *buffer = &buffer_lock->buffer_;
     return true;
 }
 
+Aggregator::AggrShard& Aggregator::GetShard(const std::string& key) {
+    return shards_[static_cast<uint64_t>(::openmldb::base::hash64(key)) % kAggrShardNum];
+}
+
+std::shared_ptr<AggrBufferLocked> Aggregator::GetBufferUnlock(AggrShard* shard, const std::string& key,
+                                                              const std::string& filter_key,
+                                                              std::vector<IdleKey>* idle_keys) {
+    auto [it, key_inserted] = shard->key_map.try_emplace(key);
+    it->second.update_seq = ++shard->update_seq;
+    auto& buffer_lock = it->second.filter_map[filter_key];
+    if (!buffer_lock) {
+        buffer_lock = std::make_shared<AggrBufferLocked>();
+        // the buffer may have been evicted, it is empty if the key has nothing flushed
+        RecoverEvictedBuffer(key, filter_key, &buffer_lock->buffer_);
+    }
+    auto result = buffer_lock;
+    if (key_inserted) {
+        // the returned buffer is referenced, so it is not picked
+        PickIdleKeysUnlock(shard, idle_keys);
+    }
+    return result;
+}
+
+bool Aggregator::RecoverEvictedBuffer(const std::string& key, const std::string& filter_key,
+                                      AggrBuffer* aggr_buffer) {
+    Ticket ticket;
+    std::unique_ptr<TableIterator> it(aggr_table_->NewIterator(aggr_index_pos_, key, ticket));
+    if (it == nullptr) {
+        return false;
+    }
+    it->SeekToFirst();
+    while (it->Valid()) {
+        auto aggr_row_ptr = reinterpret_cast<const int8_t*>(it->GetValue().data());
+        std::string cur_filter_key;
+        if (!aggr_row_view_.IsNULL(aggr_row_ptr, 6)) {
+            aggr_row_view_.GetStrValue(aggr_row_ptr, 6, &cur_filter_key);
+        }
+        if (cur_filter_key != filter_key) {
+            it->Next();
+            continue;
+        }
+        AggrBuffer flushed_buffer;
+        if (!GetAggrBufferFromRowView(aggr_row_view_, aggr_row_ptr, &flushed_buffer)) {
+            PDLOG(WARNING, "GetAggrBufferFromRowView failed. key is %s", key.c_str());
+            return false;
+        }
+        // the same as the recovery in Init
+        aggr_buffer->data_type_ = aggr_col_type_;
+        aggr_buffer->ts_begin_ = flushed_buffer.ts_end_ + 1;
+        aggr_buffer->binlog_offset_ = flushed_buffer.binlog_offset_ + 1;
+        if (window_type_ == WindowType::kRowsRange) {
+            aggr_buffer->ts_end_ = aggr_buffer->ts_begin_ + window_size_ - 1;
+        }
+        return true;
+    }
+    return true;
+}
+
+void Aggregator::PickIdleKeysUnlock(AggrShard* shard, std::vector<IdleKey>* idle_keys) {
+    uint32_t max_key_num = FLAGS_max_aggr_buffer_key_num;
+    if (max_key_num == 0) {
+        return;
+    }
+    size_t limit = std::max<size_t>(1, max_key_num / kAggrShardNum);
+    if (shard->key_map.size() <= limit) {
+        return;
+    }
+    // evict a tenth more than needed at once, so that it does not run on every new key
+    size_t evict_num = shard->key_map.size() - limit + limit / 10;
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    candidates.reserve(shard->key_map.size());
+    for (const auto& kv : shard->key_map) {
+        candidates.emplace_back(kv.second.update_seq, kv.first);
+    }
+    std::nth_element(candidates.begin(), candidates.begin() + (evict_num - 1), candidates.end());
+    for (size_t i = 0; i < evict_num; i++) {
+        auto it = shard->key_map.find(candidates[i].second);
+        const auto& filter_map = it->second.filter_map;
+        // being updated, or picked by another put
+        bool in_use = std::any_of(filter_map.begin(), filter_map.end(),
+                                  [](const auto& kv) { return kv.second.use_count() > 1; });
+        if (!in_use) {
+            idle_keys->push_back({it->first, it->second.update_seq, filter_map});
+        }
+    }
+}
+
+void Aggregator::EvictIdleKeys(AggrShard* shard, std::vector<IdleKey>* idle_keys) {
+    size_t flushed_num = 0;
+    for (; flushed_num < idle_keys->size(); flushed_num++) {
+        const auto& idle_key = (*idle_keys)[flushed_num];
+        bool flushed = true;
+        for (const auto& kv : idle_key.filter_map) {
+            std::lock_guard<std::mutex> lock(*kv.second->mu_);
+            auto& buffer = kv.second->buffer_;
+            if (buffer.aggr_cnt_ == 0) {
+                continue;
+            }
+            if (!FlushAggrBuffer(idle_key.key, kv.first, buffer)) {
+                flushed = false;
+                break;
+            }
+            // continue after the flushed bucket, the same as the buffer recovered after the eviction
+            int64_t latest_ts = buffer.ts_end_ + 1;
+            uint64_t latest_binlog = buffer.binlog_offset_ + 1;
+            buffer.Clear();
+            buffer.ts_begin_ = latest_ts;
+            buffer.binlog_offset_ = latest_binlog;
+            if (window_type_ == WindowType::kRowsRange) {
+                buffer.ts_end_ = latest_ts + window_size_ - 1;
+            }
+        }
+        if (!flushed) {
+            PDLOG(WARNING, "flush the buffers of key %s failed, stop evicting", idle_key.key.c_str());
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(shard->mu);
+    for (size_t i = 0; i < flushed_num; i++) {
+        const auto& idle_key = (*idle_keys)[i];
+        auto it = shard->key_map.find(idle_key.key);
+        // updated after it was picked, the flushed buffers stay in memory
+        if (it == shard->key_map.end() || it->second.update_seq != idle_key.update_seq) {
+            continue;
+        }
+        shard->key_map.erase(it);
+    }
+    idle_keys->clear();
+}
+
 bool Aggregator::SetFilter(absl::string_view filter_col) {
     for (int i = 0; i < base_table_schema_.size(); i++) {
         if (base_table_schema_.Get(i).name() == filter_col) {
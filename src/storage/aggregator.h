@@ -17,6 +17,7 @@
 #ifndef SRC_STORAGE_AGGREGATOR_H_
 #define SRC_STORAGE_AGGREGATOR_H_
 
+#include <array>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -27,6 +28,7 @@
 #include "proto/tablet.pb.h"
 #include "proto/type.pb.h"
 #include "replica/log_replicator.h"
+#include "storage/aggr_watermark.h"
 #include "storage/table.h"
 
 namespace openmldb {
@@ -130,6 +132,14 @@ class Aggregator {
 
     bool Update(const std::string& key, const std::string& row, uint64_t offset, bool recover = false);
 
+    // the row of the key is put to the base table and will be applied later by Update, the buckets of the key
+    // in the aggr table after its ts are skipped by the queries until RemovePending. Only the aggregators updated
+    // asynchronously track the pending rows
+    void AddPending(const std::string& key, const std::string& row);
+
+    // the pending row of the key is applied
+    void RemovePending(const std::string& key, const std::string& row);
+
     bool Delete(const std::string& key, const std::optional<uint64_t>& start_ts, const std::optional<uint64_t>& end_ts);
 
     bool FlushAll();
@@ -162,9 +172,27 @@ class Aggregator {
  protected:
     codec::Schema base_table_schema_;
 
-    using FilterMap = absl::flat_hash_map<std::string, AggrBufferLocked>;  // filter_column -> aggregator buffer
-    absl::flat_hash_map<std::string, FilterMap> aggr_buffer_map_;          // key -> filter_map
-    std::mutex mu_;
+    // filter_column -> aggregator buffer, the buffer is shared so that it outlives its eviction while being updated
+    using FilterMap = absl::flat_hash_map<std::string, std::shared_ptr<AggrBufferLocked>>;
+    struct KeyBuffers {
+        FilterMap filter_map;
+        // the update sequence of the shard when the key is updated last, the idle keys are evicted first
+        uint64_t update_seq = 0;
+    };
+    // the keys are spread over the shards by hash, updates of keys in different shards do not contend
+    struct AggrShard {
+        std::mutex mu;
+        absl::flat_hash_map<std::string, KeyBuffers> key_map;  // key -> buffers
+        uint64_t update_seq = 0;
+    };
+    // a key picked to be evicted, the buffers are referenced so that no one else picks it
+    struct IdleKey {
+        std::string key;
+        uint64_t update_seq;
+        FilterMap filter_map;
+    };
+    static constexpr uint32_t kAggrShardNum = 16;
+    std::array<AggrShard, kAggrShardNum> shards_;
     DataType aggr_col_type_;
     DataType ts_col_type_;
     std::shared_ptr<Table> base_table_;
@@ -172,12 +200,17 @@ class Aggregator {
     std::shared_ptr<Table> aggr_table_;
     std::shared_ptr<LogReplicator> aggr_replicator_;
     std::atomic<AggrStat> status_;
+    std::shared_ptr<AggrWatermark> watermark_;
 
     bool GetAggrBufferFromRowView(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* buffer);
     bool FlushAggrBuffer(const std::string& key, const std::string& filter_key, const AggrBuffer& aggr_buffer);
     bool UpdateFlushedBuffer(const std::string& key, const std::string& filter_key, const int8_t* base_row_ptr,
                              int64_t cur_ts, uint64_t offset);
     bool CheckBufferFilled(int64_t cur_ts, int64_t buffer_end, int32_t buffer_cnt);
+    AggrShard& GetShard(const std::string& key);
+    // get or create the buffer, the keys to be evicted are picked into idle_keys. the shard lock should be held
+    std::shared_ptr<AggrBufferLocked> GetBufferUnlock(AggrShard* shard, const std::string& key,
+                                                      const std::string& filter_key, std::vector<IdleKey>* idle_keys);
 
  private:
     bool DeleteData(const std::string& key, const std::optional<uint64_t>& start_ts,
@@ -190,6 +223,16 @@ class Aggregator {
             const AggrBuffer& buffer, const std::string& aggr_val, std::string* encoded_row);
     bool RebuildAggrBuffer(const std::string& key, AggrBuffer* aggr_buffer);
     bool RebuildFlushedAggrBuffer(const std::string& key, const int8_t* row_ptr);
+    // continue the buffer after the latest flushed one of the key and filter key in the aggr table. the missing
+    // buffers are recovered by it, so that the evicted ones continue after their flushed buckets
+    bool RecoverEvictedBuffer(const std::string& key, const std::string& filter_key, AggrBuffer* aggr_buffer);
+    // pick the least recently updated keys that are not in use when the shard holds more than its share of
+    // FLAGS_max_aggr_buffer_key_num, the shard lock should be held
+    void PickIdleKeysUnlock(AggrShard* shard, std::vector<IdleKey>* idle_keys);
+    // flush the picked keys without the shard lock, then evict the ones not updated since they were picked
+    void EvictIdleKeys(AggrShard* shard, std::vector<IdleKey>* idle_keys);
+    // the ts of the base row tracked by the watermark
+    int64_t GetPendingTs(const std::string& row);
     int64_t AlignedStart(int64_t ts) {
         if (window_type_ == WindowType::kRowsRange) {
             return ts / window_size_ * window_size_;
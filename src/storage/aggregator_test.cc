@@ -16,6 +16,7 @@
 
 #include <map>
 #include <utility>
+#include "gflags/gflags.h"
 #include "gtest/gtest.h"
 
 #include "base/file_util.h"
@@ -24,6 +25,10 @@
 #include "storage/aggregator.h"
 #include "storage/mem_table.h"
 #include "test/util.h"
+
+DECLARE_uint32(max_aggr_buffer_key_num);
+DECLARE_uint32(aggr_update_thread_num);
+
 namespace openmldb {
 namespace storage {
 
@@ -1140,6 +1145,175 @@ TEST_F(AggregatorTest, FlushAll) {
     ASSERT_EQ(last_buffer->aggr_cnt_, 1);
 }
 
+TEST_F(AggregatorTest, EvictIdleKeys) {
+    FLAGS_max_aggr_buffer_key_num = 16;
+    ::openmldb::test::TempPath tmp_path;
+    std::string folder = tmp_path.GetTempPath();
+    std::map<std::string, std::string> map;
+    ::openmldb::api::TableMeta base_table_meta;
+    base_table_meta.set_tid(counter++);
+    AddDefaultAggregatorBaseSchema(&base_table_meta);
+    ::openmldb::api::TableMeta aggr_table_meta;
+    aggr_table_meta.set_tid(counter++);
+    AddDefaultAggregatorSchema(&aggr_table_meta);
+    std::shared_ptr<Table> aggr_table = std::make_shared<MemTable>(aggr_table_meta);
+    aggr_table->Init();
+    std::shared_ptr<LogReplicator> replicator = std::make_shared<LogReplicator>(
+        aggr_table->GetId(), aggr_table->GetPid(), folder, map, ::openmldb::replica::kLeaderNode);
+    replicator->Init();
+    auto aggr = CreateAggregator(base_table_meta, nullptr, aggr_table_meta, aggr_table, replicator, 0, "col3", "sum",
+                                 "ts_col", "1s");
+    std::shared_ptr<LogReplicator> base_replicator = std::make_shared<LogReplicator>(
+        base_table_meta.tid(), base_table_meta.pid(), folder, map, ::openmldb::replica::kLeaderNode);
+    base_replicator->Init();
+    aggr->Init(base_replicator);
+
+    codec::RowBuilder row_builder(base_table_meta.column_desc());
+    std::string encoded_row;
+    uint32_t row_size = row_builder.CalTotalLength(6);
+    encoded_row.resize(row_size);
+    auto encode = [&](int64_t ts, int32_t val) {
+        row_builder.SetBuffer(reinterpret_cast<int8_t*>(&(encoded_row[0])), row_size);
+        (void)row_builder.AppendString("id1", 3);
+        (void)row_builder.AppendString("id2", 3);
+        (void)row_builder.AppendTimestamp(ts);
+        (void)row_builder.AppendInt32(val);
+        (void)row_builder.AppendInt16(val);
+        (void)row_builder.AppendInt64(val);
+        (void)row_builder.AppendFloat(static_cast<float>(val));
+        (void)row_builder.AppendDouble(static_cast<double>(val));
+        (void)row_builder.AppendDate(val);
+        (void)row_builder.AppendString("", 0);
+        (void)row_builder.AppendNULL();
+        (void)row_builder.AppendInt32(0);
+    };
+    const int key_num = 64;
+    uint64_t offset = 0;
+    for (int i = 0; i < key_num; i++) {
+        encode(100, 1);
+        ASSERT_TRUE(aggr->Update("key" + std::to_string(i), encoded_row, offset++));
+    }
+    // the evicted keys are flushed with their partial buckets
+    int evicted = 0;
+    for (int i = 0; i < key_num; i++) {
+        AggrBuffer* buffer = nullptr;
+        if (!aggr->GetAggrBuffer("key" + std::to_string(i), &buffer)) {
+            evicted++;
+        }
+    }
+    ASSERT_GT(evicted, 0);
+    ASSERT_EQ(evicted, static_cast<int>(aggr_table->GetRecordCnt()));
+
+    // the evicted buffers continue after the flushed ones
+    for (int i = 0; i < key_num; i++) {
+        encode(1100, 2);
+        ASSERT_TRUE(aggr->Update("key" + std::to_string(i), encoded_row, offset++));
+    }
+    ASSERT_TRUE(aggr->FlushAll());
+    for (int i = 0; i < key_num; i++) {
+        Ticket ticket;
+        std::unique_ptr<TableIterator> it(aggr_table->NewIterator(0, "key" + std::to_string(i), ticket));
+        ASSERT_TRUE(it);
+        it->SeekToFirst();
+        for (int64_t ts_start : {1000, 0}) {
+            ASSERT_TRUE(it->Valid());
+            ASSERT_EQ(static_cast<uint64_t>(ts_start), it->GetKey());
+            std::string data = it->GetValue().ToString();
+            codec::RowView row_view(aggr_table_meta.column_desc(), reinterpret_cast<const int8_t*>(data.data()),
+                                    data.size());
+            int32_t num_rows = 0;
+            row_view.GetInt32(3, &num_rows);
+            ASSERT_EQ(1, num_rows);
+            char* ch = nullptr;
+            uint32_t ch_length = 0;
+            row_view.GetString(4, &ch, &ch_length);
+            ASSERT_EQ(ts_start == 0 ? 1 : 2, *reinterpret_cast<int64_t*>(ch));
+            it->Next();
+        }
+        ASSERT_FALSE(it->Valid());
+    }
+    FLAGS_max_aggr_buffer_key_num = 0;
+}
+
+TEST_F(AggregatorTest, PendingWatermark) {
+    FLAGS_aggr_update_thread_num = 1;
+    ::openmldb::test::TempPath tmp_path;
+    std::string folder = tmp_path.GetTempPath();
+    std::map<std::string, std::string> map;
+    ::openmldb::api::TableMeta base_table_meta;
+    base_table_meta.set_tid(counter++);
+    AddDefaultAggregatorBaseSchema(&base_table_meta);
+    ::openmldb::api::TableMeta aggr_table_meta;
+    aggr_table_meta.set_tid(counter++);
+    AddDefaultAggregatorSchema(&aggr_table_meta);
+    std::shared_ptr<Table> aggr_table = std::make_shared<MemTable>(aggr_table_meta);
+    aggr_table->Init();
+    std::shared_ptr<LogReplicator> replicator = std::make_shared<LogReplicator>(
+        aggr_table->GetId(), aggr_table->GetPid(), folder, map, ::openmldb::replica::kLeaderNode);
+    replicator->Init();
+    auto aggr = CreateAggregator(base_table_meta, nullptr, aggr_table_meta, aggr_table, replicator, 0, "col3", "sum",
+                                 "ts_col", "1s");
+    FLAGS_aggr_update_thread_num = 0;
+    std::shared_ptr<LogReplicator> base_replicator = std::make_shared<LogReplicator>(
+        base_table_meta.tid(), base_table_meta.pid(), folder, map, ::openmldb::replica::kLeaderNode);
+    base_replicator->Init();
+    aggr->Init(base_replicator);
+    auto watermark = aggr_table->GetAggrWatermark();
+    ASSERT_TRUE(watermark);
+
+    codec::RowBuilder row_builder(base_table_meta.column_desc());
+    uint32_t row_size = row_builder.CalTotalLength(6);
+    auto encode = [&](int64_t ts) {
+        std::string encoded_row(row_size, '\0');
+        row_builder.SetBuffer(reinterpret_cast<int8_t*>(&(encoded_row[0])), row_size);
+        (void)row_builder.AppendString("id1", 3);
+        (void)row_builder.AppendString("id2", 3);
+        (void)row_builder.AppendTimestamp(ts);
+        (void)row_builder.AppendInt32(1);
+        (void)row_builder.AppendInt16(1);
+        (void)row_builder.AppendInt64(1);
+        (void)row_builder.AppendFloat(1.0f);
+        (void)row_builder.AppendDouble(1.0);
+        (void)row_builder.AppendDate(1);
+        (void)row_builder.AppendString("", 0);
+        (void)row_builder.AppendNULL();
+        (void)row_builder.AppendInt32(0);
+        return encoded_row;
+    };
+    // flush the buckets [0, 999] and [1000, 1999]
+    ASSERT_TRUE(aggr->Update("key", encode(100), 1));
+    ASSERT_TRUE(aggr->Update("key", encode(1100), 2));
+    ASSERT_TRUE(aggr->Update("key", encode(2100), 3));
+    ASSERT_EQ(2u, aggr_table->GetRecordCnt());
+    ASSERT_FALSE(watermark->Get("key").has_value());
+
+    aggr->AddPending("key", encode(1500));
+    aggr->AddPending("key", encode(2500));
+    ASSERT_EQ(1500, watermark->Get("key").value());
+    ASSERT_FALSE(watermark->Get("other").has_value());
+    Ticket ticket;
+    std::unique_ptr<TableIterator> it(aggr_table->NewIterator(0, "key", ticket));
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(1000u, it->GetKey());
+    ASSERT_FALSE(watermark->IsComplete(reinterpret_cast<const int8_t*>(it->GetValue().data()), 1500));
+    it->Next();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(0u, it->GetKey());
+    ASSERT_TRUE(watermark->IsComplete(reinterpret_cast<const int8_t*>(it->GetValue().data()), 1500));
+
+    // the watermark advances as the pending rows are applied
+    aggr->AddPending("key", encode(3500));
+    aggr->RemovePending("key", encode(1500));
+    ASSERT_EQ(2500, watermark->Get("key").value());
+    aggr->AddPending("key", encode(3100));
+    aggr->RemovePending("key", encode(2500));
+    ASSERT_EQ(3100, watermark->Get("key").value());
+    aggr->RemovePending("key", encode(3100));
+    aggr->RemovePending("key", encode(3500));
+    ASSERT_FALSE(watermark->Get("key").has_value());
+}
+
 }  // namespace storage
 }  // namespace openmldb
 
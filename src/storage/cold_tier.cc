@@ -0,0 +1,570 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/cold_tier.h"
+
+#include <snappy.h>
+
+#include <algorithm>
+
+#include "base/file_util.h"
+#include "base/glog_wrapper.h"
+#include "base/hash.h"
+#include "gflags/gflags.h"
+#include "rocksdb/write_batch.h"
+
+DECLARE_uint32(max_traverse_cnt);
+DECLARE_uint32(max_log_file_size);
+DECLARE_uint32(keep_log_file_num);
+
+namespace openmldb {
+namespace storage {
+
+constexpr uint32_t SEED = 0xe17a1465;
+
+namespace {
+
+void PutFixed32BE(std::string* dst, uint32_t value) {
+    char buf[sizeof(uint32_t)];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = static_cast<char>((value >> (8 * (sizeof(buf) - 1 - i))) & 0xff);
+    }
+    dst->append(buf, sizeof(buf));
+}
+
+void PutFixed64BE(std::string* dst, uint64_t value) {
+    char buf[sizeof(uint64_t)];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = static_cast<char>((value >> (8 * (sizeof(buf) - 1 - i))) & 0xff);
+    }
+    dst->append(buf, sizeof(buf));
+}
+
+uint64_t GetFixedBE(const char* data, size_t len) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; i++) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return value;
+}
+
+// 0x00 is escaped to 0x00 0xff and the pk ends with 0x00 0x01, so the order of the encoded keys is the order of the
+// pks and no pk is a prefix of another one
+void AppendPK(std::string* dst, const Slice& pk) {
+    for (size_t i = 0; i < pk.size(); i++) {
+        dst->push_back(pk.data()[i]);
+        if (pk.data()[i] == '\0') {
+            dst->push_back('\xff');
+        }
+    }
+}
+
+}  // namespace
+
+std::string ColdTier::EncodeSegment(uint32_t inner_idx, uint32_t seg_idx) {
+    std::string key;
+    PutFixed32BE(&key, inner_idx);
+    PutFixed32BE(&key, seg_idx);
+    return key;
+}
+
+std::string ColdTier::EncodeKey(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk, uint32_t ts_col, uint64_t ts,
+                                uint32_t seq) {
+    std::string key = EncodeSegment(inner_idx, seg_idx);
+    AppendPK(&key, pk);
+    key.append("\x00\x01", 2);
+    PutFixed32BE(&key, ts_col);
+    // the newer rows go first as the time entries
+    PutFixed64BE(&key, ~ts);
+    PutFixed32BE(&key, seq);
+    return key;
+}
+
+std::string ColdTier::EncodePKEnd(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk) {
+    std::string key = EncodeSegment(inner_idx, seg_idx);
+    AppendPK(&key, pk);
+    key.append("\x00\x02", 2);
+    return key;
+}
+
+bool ColdTier::DecodeKey(const rocksdb::Slice& key, uint32_t* inner_idx, uint32_t* seg_idx, std::string* pk,
+                         uint32_t* ts_col, uint64_t* ts) {
+    constexpr size_t kSuffixLen = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+    if (key.size() < 2 * sizeof(uint32_t) + 2 + kSuffixLen) {
+        return false;
+    }
+    const char* data = key.data();
+    *inner_idx = GetFixedBE(data, sizeof(uint32_t));
+    *seg_idx = GetFixedBE(data + sizeof(uint32_t), sizeof(uint32_t));
+    pk->clear();
+    size_t pos = 2 * sizeof(uint32_t);
+    // the pk and its end mark are before the suffix
+    size_t pk_end = key.size() - kSuffixLen;
+    bool terminated = false;
+    while (pos < pk_end && !terminated) {
+        if (data[pos] != '\0') {
+            pk->push_back(data[pos++]);
+        } else if (pos + 1 < pk_end && data[pos + 1] == '\xff') {
+            pk->push_back('\0');
+            pos += 2;
+        } else if (pos + 2 == pk_end && data[pos + 1] == '\x01') {
+            terminated = true;
+        } else {
+            return false;
+        }
+    }
+    if (!terminated) {
+        return false;
+    }
+    *ts_col = GetFixedBE(data + pk_end, sizeof(uint32_t));
+    *ts = ~GetFixedBE(data + pk_end + sizeof(uint32_t), sizeof(uint64_t));
+    return true;
+}
+
+ColdTier::ColdTier(uint32_t tid, uint32_t pid, uint32_t seg_cnt)
+    : tid_(tid), pid_(pid), seg_cnt_(seg_cnt), path_(), db_(nullptr), stripes_(MAX_INDEX_NUM, nullptr) {
+    // the rows can be recovered from the binlog and the snapshot
+    write_opts_.disableWAL = true;
+}
+
+ColdTier::~ColdTier() {
+    delete db_;
+    db_ = nullptr;
+    for (auto stripe : stripes_) {
+        delete[] stripe;
+    }
+    if (!path_.empty() && !::openmldb::base::RemoveDirRecursive(path_)) {
+        PDLOG(WARNING, "fail to remove cold tier path %s. tid %u pid %u", path_.c_str(), tid_, pid_);
+    }
+}
+
+bool ColdTier::Open(const std::string& path) {
+    // the rows left by the last run are stale
+    if (::openmldb::base::IsExists(path) && !::openmldb::base::RemoveDirRecursive(path)) {
+        PDLOG(WARNING, "fail to remove the stale cold tier path %s. tid %u pid %u", path.c_str(), tid_, pid_);
+        return false;
+    }
+    if (!::openmldb::base::MkdirRecur(path)) {
+        PDLOG(WARNING, "fail to create path %s. tid %u pid %u", path.c_str(), tid_, pid_);
+        return false;
+    }
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    options.max_log_file_size = FLAGS_max_log_file_size;
+    options.keep_log_file_num = FLAGS_keep_log_file_num;
+    rocksdb::Status s = rocksdb::DB::Open(options, path, &db_);
+    if (!s.ok()) {
+        PDLOG(WARNING, "fail to open cold tier %s: %s. tid %u pid %u", path.c_str(), s.ToString().c_str(), tid_, pid_);
+        return false;
+    }
+    path_ = path;
+    PDLOG(INFO, "open cold tier with path %s. tid %u pid %u", path.c_str(), tid_, pid_);
+    return true;
+}
+
+void ColdTier::AddInnerIndex(uint32_t inner_idx) {
+    if (inner_idx < stripes_.size() && stripes_[inner_idx] == nullptr) {
+        stripes_[inner_idx] = new Stripe[seg_cnt_];
+    }
+}
+
+ColdTier::Stripe* ColdTier::GetStripe(uint32_t inner_idx, uint32_t seg_idx) const {
+    if (inner_idx >= stripes_.size() || seg_idx >= seg_cnt_ || stripes_[inner_idx] == nullptr) {
+        return nullptr;
+    }
+    return &stripes_[inner_idx][seg_idx];
+}
+
+bool ColdTier::MayBeCold(uint32_t inner_idx, uint32_t seg_idx) const {
+    Stripe* stripe = GetStripe(inner_idx, seg_idx);
+    return stripe != nullptr && stripe->cold_cnt.load() > 0;
+}
+
+bool ColdTier::HasColdKeys(uint32_t inner_idx) const {
+    for (uint32_t seg_idx = 0; seg_idx < seg_cnt_; seg_idx++) {
+        if (MayBeCold(inner_idx, seg_idx)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t ColdTier::Spill(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk,
+                         const std::function<uint64_t(const SpilledRowSink&)>& remove) {
+    Stripe* stripe = GetStripe(inner_idx, seg_idx);
+    if (stripe == nullptr || db_ == nullptr) {
+        return 0;
+    }
+    std::lock_guard<bthread::Mutex> lock(stripe->mu);
+    std::string key = pk.ToString();
+    // the rows put after the key was spilled are merged by the promote on access
+    if (stripe->keys.count(key) > 0) {
+        return 0;
+    }
+    // announce the spill before `remove` checks the access bit of the key. A reader sets the bit before it checks
+    // MayBeCold, so either the spill sees the bit and gives up or the reader sees the count and waits for the lock
+    stripe->cold_cnt.fetch_add(1);
+    bool written = false;
+    std::map<uint32_t, uint64_t> record_cnt;
+    uint64_t bytes = remove([&](const std::vector<SpilledRow>& rows) {
+        rocksdb::WriteBatch batch;
+        uint32_t seq = 0;
+        for (const auto& row : rows) {
+            batch.Put(EncodeKey(inner_idx, seg_idx, pk, row.ts_col, row.ts, seq++), row.value);
+            record_cnt[row.ts_col]++;
+        }
+        rocksdb::Status s = db_->Write(write_opts_, &batch);
+        if (!s.ok()) {
+            PDLOG(WARNING, "fail to spill key %s: %s. tid %u pid %u", key.c_str(), s.ToString().c_str(), tid_, pid_);
+            return false;
+        }
+        written = true;
+        return true;
+    });
+    if (!written) {
+        stripe->cold_cnt.fetch_sub(1);
+        return 0;
+    }
+    stripe->keys.insert(std::move(key));
+    for (const auto& kv : record_cnt) {
+        stripe->record_cnt[kv.first] += kv.second;
+    }
+    return bytes;
+}
+
+bool ColdTier::Promote(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk,
+                       const std::function<void(const std::vector<SpilledRow>&)>& put) {
+    Stripe* stripe = GetStripe(inner_idx, seg_idx);
+    if (stripe == nullptr || stripe->cold_cnt.load() == 0) {
+        return false;
+    }
+    std::lock_guard<bthread::Mutex> lock(stripe->mu);
+    auto key_iter = stripe->keys.find(pk.ToString());
+    if (key_iter == stripe->keys.end()) {
+        return false;
+    }
+    std::string end = EncodePKEnd(inner_idx, seg_idx, pk);
+    rocksdb::Slice upper_bound(end);
+    rocksdb::ReadOptions ro;
+    ro.iterate_upper_bound = &upper_bound;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(ro));
+    std::vector<SpilledRow> rows;
+    rocksdb::WriteBatch batch;
+    std::string row_pk;
+    for (it->Seek(EncodeKey(inner_idx, seg_idx, pk, 0, UINT64_MAX, 0)); it->Valid(); it->Next()) {
+        uint32_t cur_inner_idx = 0;
+        uint32_t cur_seg_idx = 0;
+        uint32_t ts_col = 0;
+        uint64_t ts = 0;
+        if (!DecodeKey(it->key(), &cur_inner_idx, &cur_seg_idx, &row_pk, &ts_col, &ts)) {
+            continue;
+        }
+        rows.push_back({ts_col, ts, it->value().ToString()});
+        batch.Delete(it->key());
+    }
+    if (!it->status().ok()) {
+        PDLOG(WARNING, "fail to read key %s: %s. tid %u pid %u", pk.ToString().c_str(),
+              it->status().ToString().c_str(), tid_, pid_);
+        return false;
+    }
+    put(rows);
+    rocksdb::Status s = db_->Write(write_opts_, &batch);
+    if (!s.ok()) {
+        PDLOG(WARNING, "fail to remove the promoted key %s: %s. tid %u pid %u", pk.ToString().c_str(),
+              s.ToString().c_str(), tid_, pid_);
+    }
+    for (const auto& row : rows) {
+        auto& cnt = stripe->record_cnt[row.ts_col];
+        cnt = cnt > 0 ? cnt - 1 : 0;
+    }
+    stripe->keys.erase(key_iter);
+    stripe->cold_cnt.fetch_sub(1);
+    return true;
+}
+
+bool ColdTier::Read(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk, uint32_t ts_col, ColdRows* rows) {
+    if (db_ == nullptr) {
+        return false;
+    }
+    std::string end = EncodePKEnd(inner_idx, seg_idx, pk);
+    rocksdb::Slice upper_bound(end);
+    rocksdb::ReadOptions ro;
+    ro.iterate_upper_bound = &upper_bound;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(ro));
+    std::string row_pk;
+    for (it->Seek(EncodeKey(inner_idx, seg_idx, pk, ts_col, UINT64_MAX, 0)); it->Valid(); it->Next()) {
+        uint32_t cur_inner_idx = 0;
+        uint32_t cur_seg_idx = 0;
+        uint32_t cur_ts_col = 0;
+        uint64_t ts = 0;
+        if (!DecodeKey(it->key(), &cur_inner_idx, &cur_seg_idx, &row_pk, &cur_ts_col, &ts)) {
+            continue;
+        }
+        if (cur_ts_col != ts_col) {
+            break;
+        }
+        rows->emplace_back(ts, it->value().ToString());
+    }
+    return it->status().ok();
+}
+
+uint64_t ColdTier::Gc(uint32_t inner_idx, const std::map<uint32_t, TTLSt>& ttl_st_map) {
+    if (db_ == nullptr || GetStripe(inner_idx, 0) == nullptr) {
+        return 0;
+    }
+    std::string end = EncodeSegment(inner_idx, seg_cnt_);
+    rocksdb::Slice upper_bound(end);
+    rocksdb::ReadOptions ro;
+    ro.iterate_upper_bound = &upper_bound;
+    ro.fill_cache = false;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(ro));
+    uint64_t gc_cnt = 0;
+    bool has_key = false;
+    uint32_t cur_seg_idx = 0;
+    std::string cur_pk;
+    uint32_t cur_ts_col = 0;
+    uint64_t record_idx = 0;
+    uint64_t row_cnt = 0;
+    std::vector<std::string> expired;
+    std::map<uint32_t, uint64_t> expired_cnt;
+    // remove the expired rows of the current key, the key may be promoted after it's read
+    auto remove_expired = [&]() {
+        if (!has_key || expired.empty()) {
+            return;
+        }
+        Stripe* stripe = GetStripe(inner_idx, cur_seg_idx);
+        if (stripe == nullptr) {
+            return;
+        }
+        std::lock_guard<bthread::Mutex> lock(stripe->mu);
+        auto key_iter = stripe->keys.find(cur_pk);
+        if (key_iter == stripe->keys.end()) {
+            return;
+        }
+        rocksdb::WriteBatch batch;
+        for (const auto& key : expired) {
+            batch.Delete(key);
+        }
+        rocksdb::Status s = db_->Write(write_opts_, &batch);
+        if (!s.ok()) {
+            PDLOG(WARNING, "fail to gc key %s: %s. tid %u pid %u", cur_pk.c_str(), s.ToString().c_str(), tid_, pid_);
+            return;
+        }
+        for (const auto& kv : expired_cnt) {
+            auto& cnt = stripe->record_cnt[kv.first];
+            cnt -= std::min(cnt, kv.second);
+        }
+        gc_cnt += expired.size();
+        if (expired.size() == row_cnt) {
+            stripe->keys.erase(key_iter);
+            stripe->cold_cnt.fetch_sub(1);
+        }
+    };
+    std::string pk;
+    for (it->Seek(EncodeSegment(inner_idx, 0)); it->Valid(); it->Next()) {
+        uint32_t row_inner_idx = 0;
+        uint32_t seg_idx = 0;
+        uint32_t ts_col = 0;
+        uint64_t ts = 0;
+        if (!DecodeKey(it->key(), &row_inner_idx, &seg_idx, &pk, &ts_col, &ts)) {
+            continue;
+        }
+        if (!has_key || seg_idx != cur_seg_idx || pk != cur_pk) {
+            remove_expired();
+            has_key = true;
+            cur_seg_idx = seg_idx;
+            cur_pk = pk;
+            cur_ts_col = ts_col;
+            record_idx = 0;
+            row_cnt = 0;
+            expired.clear();
+            expired_cnt.clear();
+        } else if (ts_col != cur_ts_col) {
+            cur_ts_col = ts_col;
+            record_idx = 0;
+        }
+        record_idx++;
+        row_cnt++;
+        auto ttl_iter = ttl_st_map.find(ts_col);
+        if (ttl_iter == ttl_st_map.end() || ttl_iter->second.IsExpired(ts, record_idx)) {
+            expired.push_back(it->key().ToString());
+            expired_cnt[ts_col]++;
+        }
+    }
+    remove_expired();
+    return gc_cnt;
+}
+
+uint64_t ColdTier::GetKeyCnt(uint32_t inner_idx, uint32_t seg_idx) {
+    Stripe* stripe = GetStripe(inner_idx, seg_idx);
+    if (stripe == nullptr || stripe->cold_cnt.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    std::lock_guard<bthread::Mutex> lock(stripe->mu);
+    return stripe->keys.size();
+}
+
+uint64_t ColdTier::GetRecordCnt(uint32_t inner_idx, uint32_t seg_idx, uint32_t ts_col) {
+    Stripe* stripe = GetStripe(inner_idx, seg_idx);
+    if (stripe == nullptr) {
+        return 0;
+    }
+    std::lock_guard<bthread::Mutex> lock(stripe->mu);
+    auto iter = stripe->record_cnt.find(ts_col);
+    return iter == stripe->record_cnt.end() ? 0 : iter->second;
+}
+
+TraverseIterator* ColdTier::NewTraverseIterator(uint32_t inner_idx, uint32_t ts_col, uint32_t seg_begin,
+                                                uint32_t seg_end, const TTLSt& expire_value,
+                                                type::CompressType compress_type) {
+    if (db_ == nullptr) {
+        return nullptr;
+    }
+    rocksdb::ReadOptions ro;
+    ro.fill_cache = false;
+    return new ColdTraverseIterator(db_->NewIterator(ro), inner_idx, ts_col, seg_begin, seg_end, seg_cnt_,
+                                    expire_value, compress_type);
+}
+
+ColdTraverseIterator::ColdTraverseIterator(rocksdb::Iterator* it, uint32_t inner_idx, uint32_t ts_col,
+                                           uint32_t seg_begin, uint32_t seg_end, uint32_t seg_cnt,
+                                           const TTLSt& expire_value, type::CompressType compress_type)
+    : it_(it),
+      inner_idx_(inner_idx),
+      ts_col_(ts_col),
+      seg_begin_(seg_begin),
+      seg_end_(seg_end),
+      seg_cnt_(seg_cnt),
+      end_(ColdTier::EncodeSegment(inner_idx, seg_end)),
+      expire_value_(expire_value),
+      compress_type_(compress_type),
+      valid_(false),
+      seg_idx_(0),
+      pk_(),
+      ts_(0),
+      record_idx_(0),
+      traverse_cnt_(0) {}
+
+ColdTraverseIterator::~ColdTraverseIterator() {}
+
+bool ColdTraverseIterator::Valid() { return valid_; }
+
+void ColdTraverseIterator::Settle() {
+    valid_ = false;
+    std::string pk;
+    while (it_->Valid() && it_->key().compare(rocksdb::Slice(end_)) < 0) {
+        if (FLAGS_max_traverse_cnt > 0 && traverse_cnt_ >= FLAGS_max_traverse_cnt) {
+            return;
+        }
+        uint32_t inner_idx = 0;
+        uint32_t seg_idx = 0;
+        uint32_t ts_col = 0;
+        uint64_t ts = 0;
+        if (!ColdTier::DecodeKey(it_->key(), &inner_idx, &seg_idx, &pk, &ts_col, &ts)) {
+            it_->Next();
+            continue;
+        }
+        if (ts_col < ts_col_) {
+            it_->Seek(ColdTier::EncodeKey(inner_idx_, seg_idx, pk, ts_col_, UINT64_MAX, 0));
+            continue;
+        } else if (ts_col > ts_col_) {
+            it_->Seek(ColdTier::EncodePKEnd(inner_idx_, seg_idx, pk));
+            continue;
+        }
+        if (record_idx_ == 0 || seg_idx != seg_idx_ || pk != pk_) {
+            seg_idx_ = seg_idx;
+            pk_ = pk;
+            record_idx_ = 1;
+            traverse_cnt_++;
+        }
+        if (expire_value_.IsExpired(ts, record_idx_)) {
+            // the older rows of the key are expired too
+            it_->Seek(ColdTier::EncodePKEnd(inner_idx_, seg_idx, pk));
+            continue;
+        }
+        ts_ = ts;
+        valid_ = true;
+        return;
+    }
+}
+
+void ColdTraverseIterator::SeekToFirst() {
+    record_idx_ = 0;
+    it_->Seek(ColdTier::EncodeSegment(inner_idx_, seg_begin_));
+    Settle();
+}
+
+void ColdTraverseIterator::Next() {
+    it_->Next();
+    record_idx_++;
+    traverse_cnt_++;
+    Settle();
+}
+
+void ColdTraverseIterator::NextPK() {
+    if (record_idx_ == 0) {
+        return;
+    }
+    it_->Seek(ColdTier::EncodePKEnd(inner_idx_, seg_idx_, pk_));
+    Settle();
+}
+
+void ColdTraverseIterator::Seek(const std::string& key, uint64_t ts) {
+    uint32_t seg_idx = 0;
+    if (seg_cnt_ > 1) {
+        seg_idx = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % seg_cnt_;
+    }
+    if (seg_idx < seg_begin_) {
+        SeekToFirst();
+        return;
+    } else if (seg_idx >= seg_end_) {
+        valid_ = false;
+        return;
+    }
+    record_idx_ = 0;
+    it_->Seek(ColdTier::EncodeKey(inner_idx_, seg_idx, key, ts_col_, UINT64_MAX, 0));
+    Settle();
+    if (!valid_ || seg_idx_ != seg_idx || pk_ != key) {
+        return;
+    }
+    if (expire_value_.ttl_type == TTLType::kLatestTime) {
+        while (valid_ && pk_ == key && ts_ > ts) {
+            Next();
+        }
+    } else {
+        it_->Seek(ColdTier::EncodeKey(inner_idx_, seg_idx, key, ts_col_, ts, 0));
+        Settle();
+    }
+}
+
+openmldb::base::Slice ColdTraverseIterator::GetValue() const {
+    rocksdb::Slice value = it_->value();
+    if (compress_type_ == type::CompressType::kSnappy) {
+        tmp_buf_.clear();
+        snappy::Uncompress(value.data(), value.size(), &tmp_buf_);
+        return openmldb::base::Slice(tmp_buf_);
+    }
+    return openmldb::base::Slice(value.data(), value.size());
+}
+
+std::string ColdTraverseIterator::GetPK() const { return valid_ ? pk_ : std::string(); }
+
+uint64_t ColdTraverseIterator::GetKey() const { return valid_ ? ts_ : UINT64_MAX; }
+
+uint64_t ColdTraverseIterator::GetCount() const { return traverse_cnt_; }
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_COLD_TIER_H_
+#define SRC_STORAGE_COLD_TIER_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "base/slice.h"
+#include "bthread/mutex.h"
+#include "proto/type.pb.h"
+#include "rocksdb/db.h"
+#include "storage/iterator.h"
+#include "storage/schema.h"
+#include "storage/segment.h"
+#include "vm/catalog.h"
+
+namespace openmldb {
+namespace storage {
+
+using ColdRows = std::vector<std::pair<uint64_t, std::string>>;
+
+// The on-disk tier of a memory table partition. The keys of the segments which are not accessed for a while are
+// spilled to it by the gc when the table is over its memory budget, and they are promoted back to the segments when
+// they are accessed again. The binlog and the snapshot still have all the rows, so the tier is not durable: the wal
+// is disabled and the data is dropped on open and on close.
+//
+// The rows are keyed by [inner index][segment][pk][ts column][ts desc][seq], so the rows of an index are in the order
+// which the segments are traversed and the rows of a key are in one range
+class ColdTier {
+ public:
+    ColdTier(uint32_t tid, uint32_t pid, uint32_t seg_cnt);
+    ~ColdTier();
+    ColdTier(const ColdTier&) = delete;
+    ColdTier& operator=(const ColdTier&) = delete;
+
+    bool Open(const std::string& path);
+
+    // the keys of an inner index are spilled after it's added
+    void AddInnerIndex(uint32_t inner_idx);
+
+    // the key may be in the tier. It's a sequentially consistent load, see Spill
+    bool MayBeCold(uint32_t inner_idx, uint32_t seg_idx) const;
+    // any key of the inner index may be in the tier, the scans read the tier only if so
+    bool HasColdKeys(uint32_t inner_idx) const;
+
+    // move the rows of the key to the tier. `remove` takes the rows out of the segment and passes them to the sink
+    // before it removes the key, it's called with the key locked so that the key is not promoted in the meantime.
+    // Return the size of the spilled rows
+    uint64_t Spill(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk,
+                   const std::function<uint64_t(const SpilledRowSink&)>& remove);
+
+    // move the rows of the key back by `put`, it's called with the key locked. Return false if the key is not cold
+    bool Promote(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk,
+                 const std::function<void(const std::vector<SpilledRow>&)>& put);
+
+    // read the rows of the ts column of the key without promoting it, they are in the order of ts desc
+    bool Read(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk, uint32_t ts_col, ColdRows* rows);
+
+    // remove the expired rows of the inner index. `ttl_st_map` is keyed by ts column id and abs_ttl is the expire
+    // time, the rows of the ts columns which are not in it are removed. Return the count of the removed rows
+    uint64_t Gc(uint32_t inner_idx, const std::map<uint32_t, TTLSt>& ttl_st_map);
+
+    uint64_t GetKeyCnt(uint32_t inner_idx, uint32_t seg_idx);
+    uint64_t GetRecordCnt(uint32_t inner_idx, uint32_t seg_idx, uint32_t ts_col);
+
+    // traverse the rows of the ts column of the segments [seg_begin, seg_end) in the order of the memory traverse
+    // iterator, i.e. (segment, pk, ts desc). The rows are read without promoting the keys
+    TraverseIterator* NewTraverseIterator(uint32_t inner_idx, uint32_t ts_col, uint32_t seg_begin, uint32_t seg_end,
+                                          const TTLSt& expire_value, type::CompressType compress_type);
+
+    uint32_t GetSegCnt() const { return seg_cnt_; }
+
+    static std::string EncodeKey(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk, uint32_t ts_col, uint64_t ts,
+                                 uint32_t seq);
+    // the start of the rows of the segment
+    static std::string EncodeSegment(uint32_t inner_idx, uint32_t seg_idx);
+    // the bound after all the rows of the key
+    static std::string EncodePKEnd(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk);
+    static bool DecodeKey(const rocksdb::Slice& key, uint32_t* inner_idx, uint32_t* seg_idx, std::string* pk,
+                          uint32_t* ts_col, uint64_t* ts);
+
+ private:
+    struct Stripe {
+        // guards the spill and the promote of the keys of a segment. The lock order is mu_, Segment::mu_ then
+        // KeyEntry::mu_. The promote reads rocksdb in it on the read path, so it's a bthread mutex which doesn't
+        // block the worker threads of the rpc
+        bthread::Mutex mu;
+        // the count of the cold keys and the spills in progress
+        std::atomic<uint64_t> cold_cnt{0};
+        std::unordered_set<std::string> keys;
+        // the count of the rows of each ts column
+        std::map<uint32_t, uint64_t> record_cnt;
+    };
+
+    Stripe* GetStripe(uint32_t inner_idx, uint32_t seg_idx) const;
+
+ private:
+    uint32_t tid_;
+    uint32_t pid_;
+    uint32_t seg_cnt_;
+    std::string path_;
+    rocksdb::DB* db_;
+    rocksdb::WriteOptions write_opts_;
+    std::vector<Stripe*> stripes_;
+};
+
+class ColdTraverseIterator : public TraverseIterator {
+ public:
+    ColdTraverseIterator(rocksdb::Iterator* it, uint32_t inner_idx, uint32_t ts_col, uint32_t seg_begin,
+                         uint32_t seg_end, uint32_t seg_cnt, const TTLSt& expire_value,
+                         type::CompressType compress_type);
+    ~ColdTraverseIterator() override;
+    bool Valid() override;
+    void Next() override;
+    void NextPK() override;
+    void Seek(const std::string& key, uint64_t time) override;
+    openmldb::base::Slice GetValue() const override;
+    std::string GetPK() const override;
+    uint64_t GetKey() const override;
+    void SeekToFirst() override;
+    uint64_t GetCount() const override;
+
+ private:
+    // move to the next row of the ts column which is not expired
+    void Settle();
+
+ private:
+    std::unique_ptr<rocksdb::Iterator> it_;
+    uint32_t inner_idx_;
+    uint32_t ts_col_;
+    uint32_t seg_begin_;
+    uint32_t seg_end_;
+    uint32_t seg_cnt_;
+    std::string end_;
+    TTLSt expire_value_;
+    type::CompressType compress_type_;
+    bool valid_;
+    uint32_t seg_idx_;
+    std::string pk_;
+    uint64_t ts_;
+    uint32_t record_idx_;
+    uint64_t traverse_cnt_;
+    mutable std::string tmp_buf_;
+};
+
+// the rows of a key read from the cold tier, they are uncompressed
+class ColdWindowIterator : public ::hybridse::vm::RowIterator {
+ public:
+    ColdWindowIterator(ColdRows&& rows, const TTLSt& expire_value)
+        : rows_(std::move(rows)), pos_(0), expire_value_(expire_value) {}
+
+    bool Valid() const override {
+        return pos_ < rows_.size() && !expire_value_.IsExpired(rows_[pos_].first, pos_ + 1);
+    }
+
+    void Next() override { pos_++; }
+
+    const uint64_t& GetKey() const override { return rows_[pos_].first; }
+
+    const ::hybridse::codec::Row& GetValue() override {
+        row_.Reset(reinterpret_cast<const int8_t*>(rows_[pos_].second.data()), rows_[pos_].second.size());
+        return row_;
+    }
+
+    void Seek(const uint64_t& key) override {
+        pos_ = 0;
+        while (Valid() && GetKey() > key) {
+            Next();
+        }
+    }
+
+    void SeekToFirst() override { pos_ = 0; }
+
+    bool IsSeekable() const override { return true; }
+
+ private:
+    ColdRows rows_;
+    uint32_t pos_;
+    TTLSt expire_value_;
+    ::hybridse::codec::Row row_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_COLD_TIER_H_
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/cold_tier.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "base/glog_wrapper.h"
+#include "base/slice.h"
+#include "gtest/gtest.h"
+#include "storage/mem_table_iterator.h"
+#include "storage/segment.h"
+#include "test/util.h"
+
+using ::openmldb::base::Slice;
+
+namespace openmldb {
+namespace storage {
+
+class ColdTierTest : public ::testing::Test {
+ public:
+    ColdTierTest() {}
+    ~ColdTierTest() {}
+};
+
+static uint64_t SpillKey(ColdTier* cold_tier, Segment* segment, const std::string& key) {
+    Slice pk(key);
+    return cold_tier->Spill(0, 0, pk, [segment, &pk](const SpilledRowSink& sink) {
+        return segment->SpillKey(pk, sink);
+    });
+}
+
+TEST_F(ColdTierTest, EncodeKey) {
+    std::string pk("a\0b", 3);
+    std::string key = ColdTier::EncodeKey(1, 2, Slice(pk), 3, 9527, 0);
+    uint32_t inner_idx = 0;
+    uint32_t seg_idx = 0;
+    std::string decoded_pk;
+    uint32_t ts_col = 0;
+    uint64_t ts = 0;
+    ASSERT_TRUE(ColdTier::DecodeKey(rocksdb::Slice(key), &inner_idx, &seg_idx, &decoded_pk, &ts_col, &ts));
+    ASSERT_EQ(1u, inner_idx);
+    ASSERT_EQ(2u, seg_idx);
+    ASSERT_EQ(pk, decoded_pk);
+    ASSERT_EQ(3u, ts_col);
+    ASSERT_EQ(9527u, ts);
+    // the keys are in the order of the segment traverse, the rows of a key are in the order of ts desc
+    ASSERT_LT(ColdTier::EncodeKey(0, 0, Slice("a"), 0, 1, 0), ColdTier::EncodeKey(0, 0, Slice(pk), 0, 1, 0));
+    ASSERT_LT(ColdTier::EncodeKey(0, 0, Slice(pk), 0, 1, 0), ColdTier::EncodeKey(0, 0, Slice("ab"), 0, 1, 0));
+    ASSERT_LT(ColdTier::EncodeKey(0, 0, Slice("a"), 0, 2, 0), ColdTier::EncodeKey(0, 0, Slice("a"), 0, 1, 0));
+    ASSERT_LT(ColdTier::EncodeKey(0, 0, Slice("b"), 0, 1, 0), ColdTier::EncodeKey(0, 1, Slice("a"), 0, 1, 0));
+    ASSERT_LT(ColdTier::EncodeKey(0, 0, Slice("a"), 5, 1, 0), ColdTier::EncodePKEnd(0, 0, Slice("a")));
+    ASSERT_LT(ColdTier::EncodePKEnd(0, 0, Slice("a")), ColdTier::EncodeKey(0, 0, Slice(pk), 0, 1, 0));
+    ASSERT_FALSE(ColdTier::DecodeKey(rocksdb::Slice(key.data(), 10), &inner_idx, &seg_idx, &decoded_pk, &ts_col,
+                                     &ts));
+}
+
+TEST_F(ColdTierTest, SpillAndPromote) {
+    ::openmldb::test::TempPath tmp_path;
+    ColdTier cold_tier(1, 1, 1);
+    ASSERT_TRUE(cold_tier.Open(tmp_path.GetTempPath()));
+    cold_tier.AddInnerIndex(0);
+    Segment segment(8);
+    for (uint64_t ts = 1; ts <= 5; ts++) {
+        std::string value = absl::StrCat("value", ts);
+        segment.Put(Slice("key1"), ts, value.c_str(), value.size());
+        segment.Put(Slice("key2"), ts, value.c_str(), value.size());
+    }
+    std::vector<std::string> keys;
+    // the keys are accessed by the puts, the first sweep only clears the bits
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    ASSERT_TRUE(keys.empty());
+    segment.Touch(Slice("key2"));
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    ASSERT_EQ(1u, keys.size());
+    ASSERT_EQ("key1", keys[0]);
+    ASSERT_FALSE(cold_tier.MayBeCold(0, 0));
+    ASSERT_GT(SpillKey(&cold_tier, &segment, "key1"), 0u);
+    ASSERT_TRUE(cold_tier.MayBeCold(0, 0));
+    ASSERT_TRUE(cold_tier.HasColdKeys(0));
+    ASSERT_EQ(1u, cold_tier.GetKeyCnt(0, 0));
+    ASSERT_EQ(5u, cold_tier.GetRecordCnt(0, 0, 0));
+    uint64_t count = 0;
+    ASSERT_LT(segment.GetCount(Slice("key1"), count), 0);
+    // a key accessed after the sweep is not spilled
+    segment.Touch(Slice("key2"));
+    ASSERT_EQ(0u, SpillKey(&cold_tier, &segment, "key2"));
+    ASSERT_EQ(0, segment.GetCount(Slice("key2"), count));
+    ASSERT_EQ(5u, count);
+
+    ColdRows rows;
+    ASSERT_TRUE(cold_tier.Read(0, 0, Slice("key1"), 0, &rows));
+    ASSERT_EQ(5u, rows.size());
+    for (uint64_t i = 0; i < rows.size(); i++) {
+        ASSERT_EQ(5 - i, rows[i].first);
+        ASSERT_EQ(absl::StrCat("value", 5 - i), rows[i].second);
+    }
+
+    std::vector<SpilledRow> promoted;
+    ASSERT_TRUE(cold_tier.Promote(0, 0, Slice("key1"), [&](const std::vector<SpilledRow>& spilled_rows) {
+        promoted = spilled_rows;
+        for (const auto& row : spilled_rows) {
+            segment.Put(Slice("key1"), row.ts, row.value.c_str(), row.value.size());
+        }
+    }));
+    ASSERT_EQ(5u, promoted.size());
+    ASSERT_FALSE(cold_tier.MayBeCold(0, 0));
+    ASSERT_EQ(0u, cold_tier.GetRecordCnt(0, 0, 0));
+    ASSERT_FALSE(cold_tier.Promote(0, 0, Slice("key1"), [](const std::vector<SpilledRow>&) {}));
+    ASSERT_EQ(0, segment.GetCount(Slice("key1"), count));
+    ASSERT_EQ(5u, count);
+}
+
+TEST_F(ColdTierTest, TraverseAndGc) {
+    ::openmldb::test::TempPath tmp_path;
+    ColdTier cold_tier(1, 1, 1);
+    ASSERT_TRUE(cold_tier.Open(tmp_path.GetTempPath()));
+    cold_tier.AddInnerIndex(0);
+    Segment segment(8);
+    for (uint32_t i = 0; i < 3; i++) {
+        std::string key = absl::StrCat("key", i);
+        for (uint64_t ts = 1; ts <= 5; ts++) {
+            std::string value = absl::StrCat("value", ts);
+            segment.Put(Slice(key), ts, value.c_str(), value.size());
+        }
+    }
+    std::vector<std::string> keys;
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    ASSERT_EQ(3u, keys.size());
+    for (const auto& key : keys) {
+        ASSERT_GT(SpillKey(&cold_tier, &segment, key), 0u);
+    }
+    std::unique_ptr<TraverseIterator> it(
+        cold_tier.NewTraverseIterator(0, 0, 0, 1, TTLSt(), type::CompressType::kNoCompress));
+    it->SeekToFirst();
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint64_t ts = 5; ts >= 1; ts--) {
+            ASSERT_TRUE(it->Valid());
+            ASSERT_EQ(absl::StrCat("key", i), it->GetPK());
+            ASSERT_EQ(ts, it->GetKey());
+            ASSERT_EQ(absl::StrCat("value", ts), it->GetValue().ToString());
+            it->Next();
+        }
+    }
+    ASSERT_FALSE(it->Valid());
+    it->Seek("key1", 3);
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key1", it->GetPK());
+    ASSERT_EQ(3u, it->GetKey());
+    it->NextPK();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key2", it->GetPK());
+
+    // the rows not after the expire time are removed, the keys without rows are not cold any more
+    std::map<uint32_t, TTLSt> ttl_st_map;
+    ttl_st_map.emplace(0, TTLSt(3, 0, TTLType::kAbsoluteTime));
+    ASSERT_EQ(9u, cold_tier.Gc(0, ttl_st_map));
+    ASSERT_EQ(6u, cold_tier.GetRecordCnt(0, 0, 0));
+    ttl_st_map.clear();
+    ttl_st_map.emplace(0, TTLSt(5, 0, TTLType::kAbsoluteTime));
+    ASSERT_EQ(6u, cold_tier.Gc(0, ttl_st_map));
+    ASSERT_EQ(0u, cold_tier.GetKeyCnt(0, 0));
+    ASSERT_FALSE(cold_tier.HasColdKeys(0));
+}
+
+TEST_F(ColdTierTest, HybridLatestTTL) {
+    ::openmldb::test::TempPath tmp_path;
+    ColdTier cold_tier(1, 1, 1);
+    ASSERT_TRUE(cold_tier.Open(tmp_path.GetTempPath()));
+    cold_tier.AddInnerIndex(0);
+    Segment segment(8);
+    for (uint64_t ts = 1; ts <= 3; ts++) {
+        std::string value = absl::StrCat("value", ts);
+        segment.Put(Slice("key1"), ts, value.c_str(), value.size());
+    }
+    std::vector<std::string> keys;
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    segment.CollectColdKeys(UINT64_MAX, &keys);
+    ASSERT_GT(SpillKey(&cold_tier, &segment, "key1"), 0u);
+    for (uint64_t ts = 4; ts <= 5; ts++) {
+        std::string value = absl::StrCat("value", ts);
+        segment.Put(Slice("key1"), ts, value.c_str(), value.size());
+        segment.Put(Slice("key2"), ts, value.c_str(), value.size());
+    }
+    // the latest 3 rows of key1 are 2 hot rows and 1 cold row
+    TTLSt expire_value(0, 3, TTLType::kLatestTime);
+    TTLSt tier_ttl = GetTierTTL(expire_value);
+    Segment* segments[] = {&segment};
+    auto new_iterator = [&]() {
+        return std::make_unique<HybridTraverseIterator>(
+            new MemTableTraverseIterator(segments, 1, tier_ttl.ttl_type, tier_ttl.abs_ttl, tier_ttl.lat_ttl, 0,
+                                         type::CompressType::kNoCompress),
+            cold_tier.NewTraverseIterator(0, 0, 0, 1, tier_ttl, type::CompressType::kNoCompress), 1, expire_value);
+    };
+    auto it = new_iterator();
+    it->SeekToFirst();
+    for (uint64_t ts = 5; ts >= 3; ts--) {
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ("key1", it->GetPK());
+        ASSERT_EQ(ts, it->GetKey());
+        it->Next();
+    }
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key2", it->GetPK());
+    it = new_iterator();
+    it->Seek("key1", 3);
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key1", it->GetPK());
+    ASSERT_EQ(3u, it->GetKey());
+    it->Next();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key2", it->GetPK());
+    // the row is over the latest count
+    it = new_iterator();
+    it->Seek("key1", 2);
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key2", it->GetPK());
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
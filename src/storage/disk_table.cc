@@ -16,10 +16,13 @@
 
 #include "storage/disk_table.h"
 #include <snappy.h>
+#include <algorithm>
 #include <utility>
 #include "absl/cleanup/cleanup.h"
 #include "base/file_util.h"
 #include "base/glog_wrapper.h"
+#include "base/taskpool.hpp"
+#include "boost/bind.hpp"
 #include "gflags/gflags.h"
 #include "storage/disk_table_iterator.h"
 
@@ -31,6 +34,7 @@ DECLARE_uint32(write_buffer_mb);
 DECLARE_uint32(block_cache_shardbits);
 DECLARE_bool(verify_compression);
 DECLARE_int32(disk_gc_interval);
+DECLARE_uint32(disk_gc_thread_num);
 DECLARE_uint32(max_log_file_size);
 DECLARE_uint32(keep_log_file_num);
 
@@ -41,6 +45,71 @@ static rocksdb::Options ssd_option_template;
 static rocksdb::Options hdd_option_template;
 static bool options_template_initialized = false;
 
+TTLCompactionFilter::TTLCompactionFilter(const std::shared_ptr<InnerIndexSt>& inner_index,
+                                         const std::shared_ptr<TableMetrics>& metrics, bool count_latest)
+    : count_latest_(count_latest), metrics_(metrics) {
+    const auto& indexs = inner_index->GetIndex();
+    has_ts_idx_ = indexs.size() > 1;
+    uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
+    for (const auto& index : indexs) {
+        uint32_t ts_idx = 0;
+        if (has_ts_idx_) {
+            auto ts_col = index->GetTsColumn();
+            if (!ts_col) {
+                continue;
+            }
+            ts_idx = ts_col->GetId();
+        }
+        auto ttl = index->GetTTL();
+        if (!ttl->NeedGc()) {
+            continue;
+        }
+        // abs_ttl of the entry is the expire time, 0 means the absolute ttl is not set or nothing is expired
+        uint64_t expire_time = ttl->abs_ttl > 0 && cur_time > ttl->abs_ttl ? cur_time - ttl->abs_ttl : 0;
+        ttl_map_.emplace(ts_idx, TTLSt(expire_time, ttl->lat_ttl, ttl->ttl_type));
+    }
+}
+
+TTLCompactionFilter::~TTLCompactionFilter() {
+    if (metrics_ && filtered_cnt_ > 0) {
+        *metrics_->compaction_filtered_records << filtered_cnt_;
+    }
+}
+
+bool TTLCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& /*existing_value*/,
+                                 std::string* /*new_value*/, bool* /*value_changed*/) const {
+    if (ttl_map_.empty() || key.size() < TS_LEN) {
+        return false;
+    }
+    rocksdb::Slice prefix(key.data(), key.size() - TS_LEN);
+    if (prefix.compare(rocksdb::Slice(last_prefix_)) != 0) {
+        last_prefix_.assign(prefix.data(), prefix.size());
+        record_idx_ = 0;
+    }
+    record_idx_++;
+    uint32_t ts_idx = 0;
+    if (has_ts_idx_) {
+        if (prefix.size() < TS_POS_LEN) {
+            return false;
+        }
+        memcpy(static_cast<void*>(&ts_idx), prefix.data() + prefix.size() - TS_POS_LEN, TS_POS_LEN);
+    }
+    auto it = ttl_map_.find(ts_idx);
+    if (it == ttl_map_.end()) {
+        return false;
+    }
+    uint64_t ts = 0;
+    memcpy(static_cast<void*>(&ts), key.data() + key.size() - TS_LEN, TS_LEN);
+    memrev64ifbe(static_cast<void*>(&ts));
+    // 0 is never beyond the latest ttl
+    uint32_t record_idx = count_latest_ ? std::min(record_idx_, static_cast<uint64_t>(UINT32_MAX)) : 0;
+    if (it->second.IsExpired(ts, record_idx)) {
+        filtered_cnt_++;
+        return true;
+    }
+    return false;
+}
+
 DiskTable::DiskTable(const std::string& name, uint32_t id, uint32_t pid, const std::map<std::string, uint32_t>& mapping,
                      uint64_t ttl, ::openmldb::type::TTLType ttl_type, ::openmldb::common::StorageMode storage_mode,
                      const std::string& table_path)
@@ -162,11 +231,13 @@ bool DiskTable::InitColumnFamilyDescriptor() {
     options_.max_log_file_size = FLAGS_max_log_file_size;
     options_.keep_log_file_num = FLAGS_keep_log_file_num;
     auto inner_indexs = table_index_.GetAllInnerIndex();
+    filter_factories_.assign(inner_indexs->size(), nullptr);
     for (const auto& inner_index : *inner_indexs) {
         rocksdb::Options cur_options = options_;
         bool use_compaction_filter = false;
         for (const auto& index_def : inner_index->GetIndex()) {
-            if (index_def->GetTTLType() == ::openmldb::storage::TTLType::kAbsoluteTime) {
+            if (index_def->GetTTL()->NeedGc()) {
+                // every sst file is compacted at least once in the interval, the expired records are dropped then
                 cur_options.periodic_compaction_seconds = FLAGS_disk_gc_interval * 60;
                 use_compaction_filter = true;
                 break;
@@ -176,7 +247,9 @@ bool DiskTable::InitColumnFamilyDescriptor() {
         cfo.comparator = &cmp_;
         cfo.prefix_extractor.reset(new KeyTsPrefixTransform());
         if (use_compaction_filter) {
-            cfo.compaction_filter_factory = std::make_shared<AbsoluteTTLFilterFactory>(inner_index);
+            auto factory = std::make_shared<TTLFilterFactory>(inner_index, metrics_);
+            filter_factories_[inner_index->GetId()] = factory;
+            cfo.compaction_filter_factory = factory;
         }
         const auto& indexs = inner_index->GetIndex();
         auto index_def = indexs.front();
@@ -190,6 +263,7 @@ bool DiskTable::Init() {
     if (!InitFromMeta()) {
         return false;
     }
+    metrics_ = TableMetrics::Get(id_, pid_);
     InitColumnFamilyDescriptor();
     std::string path = table_path_ + "/data";
     if (!openmldb::base::IsExists(path)) {
@@ -208,11 +282,36 @@ bool DiskTable::Init() {
         PDLOG(WARNING, "rocksdb open failed. tid %u pid %u error %s", id_, pid_, s.ToString().c_str());
         return false;
     }
+    // the deletes before the restart are marked in the default column family, the gc's tombstones are not
+    for (uint32_t inner_pos = 0; inner_pos < filter_factories_.size(); inner_pos++) {
+        if (!filter_factories_[inner_pos]) {
+            continue;
+        }
+        std::string value;
+        s = db_->Get(rocksdb::ReadOptions(), cf_hs_[0], GetDeletedMarkKey(inner_pos), &value);
+        if (s.ok()) {
+            filter_factories_[inner_pos]->MarkDeleted();
+        } else if (!s.IsNotFound()) {
+            PDLOG(WARNING, "get deleted mark failed. tid %u pid %u error %s", id_, pid_, s.ToString().c_str());
+            filter_factories_[inner_pos]->MarkDeleted();
+        }
+    }
     PDLOG(INFO, "Open DB. tid %u pid %u ColumnFamilyHandle size %u with data path %s", id_, pid_, GetIdxCnt(),
           path.c_str());
     return true;
 }
 
+std::string DiskTable::GetDeletedMarkKey(uint32_t inner_pos) {
+    return "deleted/" + cf_hs_[inner_pos + 1]->GetName();
+}
+
+void DiskTable::MarkDeleted(uint32_t inner_pos, rocksdb::WriteBatch* batch) {
+    batch->Put(cf_hs_[0], GetDeletedMarkKey(inner_pos), "");
+    if (inner_pos < filter_factories_.size() && filter_factories_[inner_pos]) {
+        filter_factories_[inner_pos]->MarkDeleted();
+    }
+}
+
 bool DiskTable::Put(const std::string& pk, uint64_t time, const char* data, uint32_t size) {
     rocksdb::Status s;
     std::string combine_key = CombineKeyTs(rocksdb::Slice(pk), time);
@@ -334,6 +433,7 @@ bool DiskTable::Delete(uint32_t idx, const std::string& pk,
         combine_key2 = CombineKeyTs(pk, real_end_ts);
     }
     rocksdb::WriteBatch batch;
+    MarkDeleted(inner_pos, &batch);
     batch.DeleteRange(cf_hs_[inner_pos + 1], rocksdb::Slice(combine_key1), rocksdb::Slice(combine_key2));
     rocksdb::Status s = db_->Write(write_opts_, &batch);
     if (!s.ok()) {
@@ -391,6 +491,7 @@ base::Status DiskTable::Truncate() {
                 PDLOG(INFO, "delete range. start key %s end key %s inner idx %u tid %u pid %u",
                         start_key.c_str(), end_key.c_str(), idx, id_, pid_);
                 batch.DeleteRange(cf_hs_[idx + 1], rocksdb::Slice(start_key), rocksdb::Slice(end_key));
+                MarkDeleted(idx, &batch);
             }
         }
     }
@@ -408,123 +509,202 @@ void DiskTable::SchedGc() {
 }
 
 void DiskTable::GcHead() {
-    uint64_t start_time = ::baidu::common::timer::get_micros() / 1000;
+    uint64_t start_time = ::baidu::common::timer::get_micros();
     auto inner_indexs = table_index_.GetAllInnerIndex();
     const rocksdb::Snapshot* snapshot = db_->GetSnapshot();
     absl::Cleanup release_snapshot = [this, snapshot] { this->db_->ReleaseSnapshot(snapshot); };
+    std::atomic<uint64_t> scanned_cnt = 0;
+    auto gc_range = [this, snapshot, &scanned_cnt](const std::shared_ptr<InnerIndexSt>& inner_index,
+                                                   const std::string& start, const std::string& end) {
+        scanned_cnt.fetch_add(GcHeadRange(inner_index, snapshot, start, end), std::memory_order_relaxed);
+    };
+    uint32_t thread_num = std::max(FLAGS_disk_gc_thread_num, 1u);
     for (const auto& inner_index : *inner_indexs) {
-        uint32_t idx = inner_index->GetId();
-        rocksdb::ReadOptions ro = rocksdb::ReadOptions();
-        ro.snapshot = snapshot;
-        // ro.prefix_same_as_start = true;
-        ro.pin_data = true;
-        std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(ro, cf_hs_[idx + 1]));
-        it->SeekToFirst();
-        const auto& indexs = inner_index->GetIndex();
-        if (indexs.size() > 1) {
-            bool need_ttl = false;
-            std::map<uint32_t, uint64_t> ttl_map;
-            for (const auto& index : indexs) {
-                if (index->GetTTLType() != ::openmldb::storage::TTLType::kLatestTime) {
-                    continue;
-                }
-                auto ts_col = index->GetTsColumn();
-                if (ts_col) {
-                    auto lat_ttl = index->GetTTL()->lat_ttl;
-                    if (lat_ttl > 0) {
-                        ttl_map.emplace(ts_col->GetId(), lat_ttl);
-                        need_ttl = true;
-                    }
-                }
+        bool need_gc = false;
+        for (const auto& index : inner_index->GetIndex()) {
+            if (index->GetTTLType() == ::openmldb::storage::TTLType::kLatestTime && index->GetTTL()->lat_ttl > 0) {
+                need_gc = true;
+                break;
+            }
+        }
+        if (!need_gc) {
+            continue;
+        }
+        auto ranges = SplitRange(inner_index, thread_num);
+        ::openmldb::base::TaskPool pool(std::min(thread_num, static_cast<uint32_t>(ranges.size())), ranges.size());
+        for (const auto& range : ranges) {
+            pool.AddTask(boost::bind<void>(gc_range, inner_index, range.first, range.second));
+        }
+        // wait for the ranges in queue
+        pool.Stop();
+    }
+    uint64_t time_used = ::baidu::common::timer::get_micros() - start_time;
+    if (metrics_) {
+        *metrics_->gc << time_used;
+        *metrics_->gc_scanned_records << scanned_cnt.load(std::memory_order_relaxed);
+    }
+    PDLOG(INFO, "Gc used %lu second, scanned %lu records. tid %u pid %u", time_used / 1000000,
+          scanned_cnt.load(std::memory_order_relaxed), id_, pid_);
+}
+
+std::vector<std::pair<std::string, std::string>> DiskTable::SplitRange(
+    const std::shared_ptr<InnerIndexSt>& inner_index, uint32_t num) {
+    uint32_t idx = inner_index->GetId();
+    bool has_ts_idx = inner_index->GetIndex().size() > 1;
+    std::vector<std::string> boundaries;
+    if (num > 1) {
+        std::vector<rocksdb::LiveFileMetaData> metas;
+        db_->GetLiveFilesMetaData(&metas);
+        const std::string& cf_name = cf_ds_[idx + 1].name;
+        for (const auto& meta : metas) {
+            if (meta.column_family_name != cf_name) {
+                continue;
             }
-            if (!need_ttl) {
+            rocksdb::Slice pk;
+            uint64_t ts = 0;
+            uint32_t ts_idx = 0;
+            if (ParseKeyAndTs(has_ts_idx, rocksdb::Slice(meta.smallestkey), &pk, &ts, &ts_idx) < 0) {
                 continue;
             }
-            std::map<uint32_t, uint32_t> key_cnt;
-            std::map<uint32_t, uint64_t> delete_key_map;
-            std::string last_pk;
-            while (it->Valid()) {
-                rocksdb::Slice cur_pk;
-                uint64_t ts = 0;
-                uint32_t ts_idx = 0;
-                ParseKeyAndTs(true, it->key(), &cur_pk, &ts, &ts_idx);
-                if (!last_pk.empty() && cur_pk.compare(rocksdb::Slice(last_pk)) == 0) {
-                    auto ttl_iter = ttl_map.find(ts_idx);
-                    if (ttl_iter != ttl_map.end() && ttl_iter->second > 0) {
-                        auto key_cnt_iter = key_cnt.find(ts_idx);
-                        if (key_cnt_iter == key_cnt.end()) {
-                            key_cnt.insert(std::make_pair(ts_idx, 1));
-                        } else {
-                            key_cnt_iter->second++;
-                        }
-                        if (key_cnt_iter->second > ttl_iter->second &&
-                            delete_key_map.find(ts_idx) == delete_key_map.end()) {
-                            delete_key_map.insert(std::make_pair(ts_idx, ts));
-                        }
-                    }
-                } else {
-                    for (const auto& kv : delete_key_map) {
-                        std::string combine_key1 = CombineKeyTs(rocksdb::Slice(last_pk), kv.second, kv.first);
-                        std::string combine_key2 = CombineKeyTs(rocksdb::Slice(last_pk), 0, kv.first);
-                        rocksdb::Status s = db_->DeleteRange(write_opts_, cf_hs_[idx + 1], rocksdb::Slice(combine_key1),
-                                                             rocksdb::Slice(combine_key2));
-                        if (!s.ok()) {
-                            PDLOG(WARNING, "Delete failed. tid %u pid %u msg %s", id_, pid_, s.ToString().c_str());
-                        }
-                    }
-                    delete_key_map.clear();
-                    key_cnt.clear();
-                    key_cnt.insert(std::make_pair(ts_idx, 1));
-                    last_pk.assign(cur_pk.data(), cur_pk.size());
+            // a range starts at the first record of a key, the records of one key are scanned by one thread
+            boundaries.push_back(has_ts_idx ? CombineKeyTs(pk, UINT64_MAX, 0) : CombineKeyTs(pk, UINT64_MAX));
+        }
+        std::sort(boundaries.begin(), boundaries.end(), [this](const std::string& a, const std::string& b) {
+            return cmp_.Compare(rocksdb::Slice(a), rocksdb::Slice(b)) < 0;
+        });
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                                     [this](const std::string& a, const std::string& b) {
+                                         return cmp_.Compare(rocksdb::Slice(a), rocksdb::Slice(b)) == 0;
+                                     }),
+                         boundaries.end());
+    }
+    std::vector<std::pair<std::string, std::string>> ranges;
+    std::string start;
+    for (uint32_t i = 1; i < num; i++) {
+        size_t pos = i * boundaries.size() / num;
+        // the first boundary is about the start of the column family
+        if (pos == 0 || boundaries[pos] == start) {
+            continue;
+        }
+        const std::string& end = boundaries[pos];
+        ranges.emplace_back(start, end);
+        start = end;
+    }
+    ranges.emplace_back(start, "");
+    return ranges;
+}
+
+uint64_t DiskTable::GcHeadRange(const std::shared_ptr<InnerIndexSt>& inner_index, const rocksdb::Snapshot* snapshot,
+                                const std::string& start, const std::string& end) {
+    uint32_t idx = inner_index->GetId();
+    rocksdb::ReadOptions ro = rocksdb::ReadOptions();
+    ro.snapshot = snapshot;
+    // ro.prefix_same_as_start = true;
+    ro.pin_data = true;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(ro, cf_hs_[idx + 1]));
+    if (start.empty()) {
+        it->SeekToFirst();
+    } else {
+        it->Seek(rocksdb::Slice(start));
+    }
+    uint64_t scanned_cnt = 0;
+    auto valid = [this, &it, &end, &scanned_cnt]() {
+        if (!it->Valid() || (!end.empty() && cmp_.Compare(it->key(), rocksdb::Slice(end)) >= 0)) {
+            return false;
+        }
+        scanned_cnt++;
+        return true;
+    };
+    const auto& indexs = inner_index->GetIndex();
+    if (indexs.size() > 1) {
+        std::map<uint32_t, uint64_t> ttl_map;
+        for (const auto& index : indexs) {
+            if (index->GetTTLType() != ::openmldb::storage::TTLType::kLatestTime) {
+                continue;
+            }
+            auto ts_col = index->GetTsColumn();
+            if (ts_col) {
+                auto lat_ttl = index->GetTTL()->lat_ttl;
+                if (lat_ttl > 0) {
+                    ttl_map.emplace(ts_col->GetId(), lat_ttl);
                 }
-                it->Next();
             }
+        }
+        if (ttl_map.empty()) {
+            return 0;
+        }
+        std::map<uint32_t, uint32_t> key_cnt;
+        std::map<uint32_t, uint64_t> delete_key_map;
+        std::string last_pk;
+        auto delete_last_pk = [&]() {
             for (const auto& kv : delete_key_map) {
-                std::string combine_key1 = CombineKeyTs(last_pk, kv.second, kv.first);
-                std::string combine_key2 = CombineKeyTs(last_pk, 0, kv.first);
+                std::string combine_key1 = CombineKeyTs(rocksdb::Slice(last_pk), kv.second, kv.first);
+                std::string combine_key2 = CombineKeyTs(rocksdb::Slice(last_pk), 0, kv.first);
                 rocksdb::Status s = db_->DeleteRange(write_opts_, cf_hs_[idx + 1], rocksdb::Slice(combine_key1),
                                                      rocksdb::Slice(combine_key2));
                 if (!s.ok()) {
                     PDLOG(WARNING, "Delete failed. tid %u pid %u msg %s", id_, pid_, s.ToString().c_str());
                 }
             }
-        } else {
-            auto index = indexs.front();
-            auto ttl_num = index->GetTTL()->lat_ttl;
-            if (ttl_num < 1 || index->GetTTLType() != ::openmldb::storage::TTLType::kLatestTime) {
-                continue;
-            }
-            std::string last_pk;
-            uint64_t count = 0;
-            while (it->Valid()) {
-                rocksdb::Slice cur_pk;
-                uint64_t ts = 0;
-                ParseKeyAndTs(it->key(), &cur_pk, &ts);
-                if (!last_pk.empty() && cur_pk.compare(rocksdb::Slice(last_pk)) == 0) {
-                    if (ts == 0 || count < ttl_num) {
-                        it->Next();
-                        count++;
-                        continue;
-                    } else {
-                        std::string combine_key1 = CombineKeyTs(cur_pk, ts);
-                        std::string combine_key2 = CombineKeyTs(cur_pk, 0);
-                        rocksdb::Status s = db_->DeleteRange(write_opts_, cf_hs_[idx + 1], rocksdb::Slice(combine_key1),
-                                                             rocksdb::Slice(combine_key2));
-                        if (!s.ok()) {
-                            PDLOG(WARNING, "Delete failed. tid %u pid %u msg %s", id_, pid_, s.ToString().c_str());
-                        }
-                        it->Seek(rocksdb::Slice(combine_key2));
+        };
+        while (valid()) {
+            rocksdb::Slice cur_pk;
+            uint64_t ts = 0;
+            uint32_t ts_idx = 0;
+            ParseKeyAndTs(true, it->key(), &cur_pk, &ts, &ts_idx);
+            if (!last_pk.empty() && cur_pk.compare(rocksdb::Slice(last_pk)) == 0) {
+                auto ttl_iter = ttl_map.find(ts_idx);
+                if (ttl_iter != ttl_map.end()) {
+                    uint32_t cnt = ++key_cnt[ts_idx];
+                    if (cnt > ttl_iter->second && delete_key_map.find(ts_idx) == delete_key_map.end()) {
+                        delete_key_map.emplace(ts_idx, ts);
                     }
-                } else {
-                    count = 1;
-                    last_pk.assign(cur_pk.data(), cur_pk.size());
+                }
+            } else {
+                delete_last_pk();
+                delete_key_map.clear();
+                key_cnt.clear();
+                key_cnt.emplace(ts_idx, 1);
+                last_pk.assign(cur_pk.data(), cur_pk.size());
+            }
+            it->Next();
+        }
+        delete_last_pk();
+    } else {
+        auto index = indexs.front();
+        auto ttl_num = index->GetTTL()->lat_ttl;
+        if (ttl_num < 1 || index->GetTTLType() != ::openmldb::storage::TTLType::kLatestTime) {
+            return 0;
+        }
+        std::string last_pk;
+        uint64_t count = 0;
+        while (valid()) {
+            rocksdb::Slice cur_pk;
+            uint64_t ts = 0;
+            ParseKeyAndTs(it->key(), &cur_pk, &ts);
+            if (!last_pk.empty() && cur_pk.compare(rocksdb::Slice(last_pk)) == 0) {
+                if (ts == 0 || count < ttl_num) {
                     it->Next();
+                    count++;
+                    continue;
+                } else {
+                    std::string combine_key1 = CombineKeyTs(cur_pk, ts);
+                    std::string combine_key2 = CombineKeyTs(cur_pk, 0);
+                    rocksdb::Status s = db_->DeleteRange(write_opts_, cf_hs_[idx + 1], rocksdb::Slice(combine_key1),
+                                                         rocksdb::Slice(combine_key2));
+                    if (!s.ok()) {
+                        PDLOG(WARNING, "Delete failed. tid %u pid %u msg %s", id_, pid_, s.ToString().c_str());
+                    }
+                    it->Seek(rocksdb::Slice(combine_key2));
                 }
+            } else {
+                count = 1;
+                last_pk.assign(cur_pk.data(), cur_pk.size());
+                it->Next();
             }
         }
     }
-    uint64_t time_used = ::baidu::common::timer::get_micros() / 1000 - start_time;
-    PDLOG(INFO, "Gc used %lu second. tid %u pid %u", time_used / 1000, id_, pid_);
+    return scanned_cnt;
 }
 
 void DiskTable::GcTTLOrHead() {}
@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/slice.h"
@@ -39,6 +40,7 @@
 #include "storage/iterator.h"
 #include "storage/key_transform.h"
 #include "storage/table.h"
+#include "storage/table_metrics.h"
 
 namespace openmldb {
 namespace storage {
@@ -84,73 +86,54 @@ class KeyTsPrefixTransform : public rocksdb::SliceTransform {
     bool SameResultWhenAppended(const rocksdb::Slice& prefix) const override { return InDomain(prefix); }
 };
 
-class AbsoluteTTLCompactionFilter : public rocksdb::CompactionFilter {
+// Drop the records beyond the ttl of their index while compacting.
+//
+// The records of a key and ts column are adjacent and in the descending order of ts, so the filter counts the
+// position of every record for the latest ttl. Only the records in the compaction are counted, a record may be
+// newer than it is in the whole column family, the position is never overestimated.
+// The deleted records are still seen by the filter if their tombstones are not in the compaction, so the position is
+// overestimated once records are deleted. `count_latest` is false then, and only the absolute ttl is checked.
+// A filter is used by one compaction at a time.
+class TTLCompactionFilter : public rocksdb::CompactionFilter {
  public:
-    explicit AbsoluteTTLCompactionFilter(std::shared_ptr<InnerIndexSt> inner_index) : inner_index_(inner_index) {}
-    virtual ~AbsoluteTTLCompactionFilter() {}
+    TTLCompactionFilter(const std::shared_ptr<InnerIndexSt>& inner_index, const std::shared_ptr<TableMetrics>& metrics,
+                        bool count_latest);
+    ~TTLCompactionFilter() override;
 
-    const char* Name() const override { return "AbsoluteTTLCompactionFilter"; }
+    const char* Name() const override { return "TTLCompactionFilter"; }
 
-    bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& /*existing_value*/,
-                std::string* /*new_value*/, bool* /*value_changed*/) const override {
-        if (key.size() < TS_LEN) {
-            return false;
-        }
-        uint64_t real_ttl = 0;
-        const auto& indexs = inner_index_->GetIndex();
-        if (indexs.size() > 1) {
-            if (key.size() < TS_LEN + TS_POS_LEN) {
-                return false;
-            }
-            uint32_t ts_idx = *((uint32_t*)(key.data() + key.size() - TS_LEN -  // NOLINT
-                                            TS_POS_LEN));
-            bool has_found = false;
-            for (const auto& index : indexs) {
-                auto ts_col = index->GetTsColumn();
-                if (!ts_col) {
-                    return false;
-                }
-                if (ts_col->GetId() == ts_idx &&
-                    index->GetTTL()->ttl_type == openmldb::storage::TTLType::kAbsoluteTime) {
-                    real_ttl = index->GetTTL()->abs_ttl;
-                    has_found = true;
-                    break;
-                }
-            }
-            if (!has_found) {
-                return false;
-            }
-        } else {
-            real_ttl = indexs.front()->GetTTL()->abs_ttl;
-        }
-        if (real_ttl < 1) {
-            return false;
-        }
-        uint64_t ts = 0;
-        memcpy(static_cast<void*>(&ts), key.data() + key.size() - TS_LEN, TS_LEN);
-        memrev64ifbe(static_cast<void*>(&ts));
-        uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
-        if (ts < cur_time - real_ttl) {
-            return true;
-        }
-        return false;
-    }
+    bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+                bool* value_changed) const override;
 
  private:
-    std::shared_ptr<InnerIndexSt> inner_index_;
+    bool has_ts_idx_ = false;
+    bool count_latest_ = true;
+    // the expire time and latest count of every ts column
+    std::map<uint32_t, TTLSt> ttl_map_;
+    std::shared_ptr<TableMetrics> metrics_;
+    mutable std::string last_prefix_;
+    mutable uint64_t record_idx_ = 0;
+    mutable uint64_t filtered_cnt_ = 0;
 };
 
-class AbsoluteTTLFilterFactory : public rocksdb::CompactionFilterFactory {
+class TTLFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-    explicit AbsoluteTTLFilterFactory(const std::shared_ptr<InnerIndexSt>& inner_index) : inner_index_(inner_index) {}
+    TTLFilterFactory(const std::shared_ptr<InnerIndexSt>& inner_index, const std::shared_ptr<TableMetrics>& metrics)
+        : inner_index_(inner_index), metrics_(metrics) {}
     std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
         const rocksdb::CompactionFilter::Context& context) override {
-        return std::unique_ptr<rocksdb::CompactionFilter>(new AbsoluteTTLCompactionFilter(inner_index_));
+        return std::unique_ptr<rocksdb::CompactionFilter>(
+            new TTLCompactionFilter(inner_index_, metrics_, !deleted_.load(std::memory_order_relaxed)));
     }
-    const char* Name() const override { return "AbsoluteTTLFilterFactory"; }
+    const char* Name() const override { return "TTLFilterFactory"; }
+
+    // the column family has deleted records, the latest ttl is left to the gc
+    void MarkDeleted() { deleted_.store(true, std::memory_order_relaxed); }
 
  private:
     std::shared_ptr<InnerIndexSt> inner_index_;
+    std::shared_ptr<TableMetrics> metrics_;
+    std::atomic<bool> deleted_ = false;
 };
 
 class DiskTable : public Table {
@@ -214,6 +197,8 @@ class DiskTable : public Table {
 
     void SchedGc() override;
 
+    // delete the records beyond the latest ttl. The key space of every column family is split into ranges by the
+    // boundaries of its sst files, and the ranges are scanned by FLAGS_disk_gc_thread_num threads
     void GcHead();
     void GcTTLAndHead();
     void GcTTLOrHead();
@@ -240,6 +225,17 @@ class DiskTable : public Table {
  private:
     base::Status Delete(uint32_t idx, const std::string& pk, uint64_t start_ts, const std::optional<uint64_t>& end_ts);
 
+    // split the column family into at most `num` ranges, an empty boundary means the start or end of the column family
+    std::vector<std::pair<std::string, std::string>> SplitRange(const std::shared_ptr<InnerIndexSt>& inner_index,
+                                                                uint32_t num);
+    // the records of the inner index are deleted by the user, the mark is written by the batch of the deletes
+    void MarkDeleted(uint32_t inner_pos, rocksdb::WriteBatch* batch);
+    std::string GetDeletedMarkKey(uint32_t inner_pos);
+
+    // scan the keys in [start, end) and delete the records beyond the latest ttl, return the scanned count
+    uint64_t GcHeadRange(const std::shared_ptr<InnerIndexSt>& inner_index, const rocksdb::Snapshot* snapshot,
+                         const std::string& start, const std::string& end);
+
  private:
     rocksdb::DB* db_;
     rocksdb::WriteOptions write_opts_;
@@ -249,6 +245,9 @@ class DiskTable : public Table {
     KeyTSComparator cmp_;
     std::atomic<uint64_t> offset_;
     std::string table_path_;
+    std::shared_ptr<TableMetrics> metrics_;
+    // the compaction filter factory of every inner index, null if the index has no ttl
+    std::vector<std::shared_ptr<TTLFilterFactory>> filter_factories_;
 };
 
 }  // namespace storage
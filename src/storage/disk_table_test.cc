@@ -33,6 +33,7 @@ DECLARE_string(ssd_root_path);
 DECLARE_string(hdd_root_path);
 DECLARE_uint32(max_traverse_cnt);
 DECLARE_int32(gc_safe_offset);
+DECLARE_uint32(disk_gc_thread_num);
 
 namespace openmldb {
 namespace storage {
@@ -1120,6 +1121,126 @@ TEST_F(DiskTableTest, GcHead) {
     RemoveData(table_path);
 }
 
+TEST_F(DiskTableTest, CompactFilterLatest) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::string table_path = FLAGS_hdd_root_path + "/16_1";
+    DiskTable* table = new DiskTable("t1", 16, 1, mapping, 3, ::openmldb::type::TTLType::kLatestTime,
+                                     ::openmldb::common::StorageMode::kHDD, table_path);
+    ASSERT_TRUE(table->Init());
+    uint64_t ts = 9537;
+    for (int idx = 0; idx < 100; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 5; k++) {
+            ASSERT_TRUE(table->Put(key, ts + k, "value", 5));
+        }
+    }
+    table->CompactDB();
+    for (int idx = 0; idx < 100; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 5; k++) {
+            std::string value;
+            ASSERT_EQ(k >= 2, table->Get(key, ts + k, value));
+        }
+    }
+    auto metrics = TableMetrics::Get(16, 1);
+    ASSERT_EQ(200, metrics->compaction_filtered_records->get_value());
+
+    // nothing is left for the gc
+    uint32_t old_thread_num = FLAGS_disk_gc_thread_num;
+    FLAGS_disk_gc_thread_num = 3;
+    table->GcHead();
+    FLAGS_disk_gc_thread_num = old_thread_num;
+    ASSERT_EQ(1, metrics->gc->count());
+    ASSERT_EQ(300, metrics->gc_scanned_records->get_value());
+    delete table;
+    RemoveData(table_path);
+}
+
+TEST_F(DiskTableTest, CompactFilterLatestWithDelete) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::string table_path = FLAGS_hdd_root_path + "/17_1";
+    auto table = std::make_unique<DiskTable>("t1", 17, 1, mapping, 3, ::openmldb::type::TTLType::kLatestTime,
+                                             ::openmldb::common::StorageMode::kHDD, table_path);
+    ASSERT_TRUE(table->Init());
+    uint64_t ts = 9537;
+    for (int idx = 0; idx < 10; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 3; k++) {
+            ASSERT_TRUE(table->Put(key, ts + k, "value", 5));
+        }
+        // delete the two newer records, and put two newer ones
+        ASSERT_TRUE(table->Delete(0, key, ts + 2, ts));
+        for (int k = 3; k < 5; k++) {
+            ASSERT_TRUE(table->Put(key, ts + k, "value", 5));
+        }
+    }
+    // the deleted records are not counted, the latest 3 records are kept
+    table->CompactDB();
+    for (int idx = 0; idx < 10; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 5; k++) {
+            std::string value;
+            ASSERT_EQ(k == 0 || k >= 3, table->Get(key, ts + k, value));
+        }
+    }
+    ASSERT_EQ(0, TableMetrics::Get(17, 1)->compaction_filtered_records->get_value());
+    table.reset();
+    // the deletes are still known after the restart
+    table = std::make_unique<DiskTable>("t1", 17, 1, mapping, 3, ::openmldb::type::TTLType::kLatestTime,
+                                        ::openmldb::common::StorageMode::kHDD, table_path);
+    ASSERT_TRUE(table->Init());
+    for (int idx = 0; idx < 10; idx++) {
+        ASSERT_TRUE(table->Put("test" + std::to_string(idx), ts + 5, "value", 5));
+    }
+    table->CompactDB();
+    for (int idx = 0; idx < 10; idx++) {
+        std::string value;
+        ASSERT_TRUE(table->Get("test" + std::to_string(idx), ts, value));
+    }
+    table.reset();
+    RemoveData(table_path);
+}
+
+TEST_F(DiskTableTest, CompactFilterLatestAfterGc) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::string table_path = FLAGS_hdd_root_path + "/18_1";
+    auto table = std::make_unique<DiskTable>("t1", 18, 1, mapping, 3, ::openmldb::type::TTLType::kLatestTime,
+                                             ::openmldb::common::StorageMode::kHDD, table_path);
+    ASSERT_TRUE(table->Init());
+    uint64_t ts = 9537;
+    for (int idx = 0; idx < 10; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 5; k++) {
+            ASSERT_TRUE(table->Put(key, ts + k, "value", 5));
+        }
+    }
+    // the tombstones of the gc are not taken as deletes after the restart
+    table->GcHead();
+    table.reset();
+    table = std::make_unique<DiskTable>("t1", 18, 1, mapping, 3, ::openmldb::type::TTLType::kLatestTime,
+                                        ::openmldb::common::StorageMode::kHDD, table_path);
+    ASSERT_TRUE(table->Init());
+    for (int idx = 0; idx < 10; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 5; k < 7; k++) {
+            ASSERT_TRUE(table->Put(key, ts + k, "value", 5));
+        }
+    }
+    table->CompactDB();
+    for (int idx = 0; idx < 10; idx++) {
+        std::string key = "test" + std::to_string(idx);
+        for (int k = 0; k < 7; k++) {
+            std::string value;
+            ASSERT_EQ(k >= 4, table->Get(key, ts + k, value));
+        }
+    }
+    table.reset();
+    RemoveData(table_path);
+}
+
 TEST_F(DiskTableTest, CheckPoint) {
     std::map<std::string, uint32_t> mapping;
     mapping.insert(std::make_pair("idx0", 0));
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/index_builder.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "base/glog_wrapper.h"
+#include "base/hash.h"
+#include "base/taskpool.hpp"
+#include "boost/bind.hpp"
+#include "common/timer.h"
+#include "storage/mem_table_snapshot.h"
+
+namespace openmldb {
+namespace storage {
+
+// check the speed limit every so many rows
+static constexpr uint64_t THROTTLE_STEP = 256;
+
+IndexBuilder::IndexBuilder(const std::shared_ptr<MemTable>& table,
+                           const std::vector<::openmldb::common::ColumnKey>& add_indexs, uint32_t partition_num)
+    : table_(table), add_indexs_(add_indexs), partition_num_(partition_num) {}
+
+base::Status IndexBuilder::Init() {
+    if (!table_ || partition_num_ == 0) {
+        return {-1, "invalid args"};
+    }
+    TableIndexInfo table_index_info(*(table_->GetTableMeta()), add_indexs_);
+    if (!table_index_info.Init()) {
+        return {-1, "parse TableIndexInfo failed"};
+    }
+    for (auto idx : table_index_info.GetAddIndexIdx()) {
+        auto index_def = table_->GetIndex(idx);
+        if (!index_def || !index_def->IsReady()) {
+            return {-1, absl::StrCat("index ", idx, " is not added to table")};
+        }
+        index_key_cols_.emplace(idx, table_index_info.GetRealIndexCols(idx));
+    }
+    decode_cols_ = table_index_info.GetAllIndexCols();
+    uint64_t* stat = nullptr;
+    uint32_t size = 0;
+    if (table_->GetRecordIdxCnt(0, &stat, &size)) {
+        for (uint32_t i = 0; i < size; i++) {
+            total_cnt_ += stat[i];
+        }
+        delete[] stat;
+    }
+    return {};
+}
+
+base::Status IndexBuilder::Build(uint32_t thread_num, uint32_t batch_size, uint64_t max_rows_per_sec,
+                                 const EntryHandler& handler) {
+    uint32_t tid = table_->GetId();
+    uint32_t pid = table_->GetPid();
+    uint32_t seg_cnt = table_->GetSegCnt();
+    max_rows_per_sec_ = max_rows_per_sec;
+    start_time_ = ::baidu::common::timer::get_micros();
+    {
+        ::openmldb::base::TaskPool pool(std::max(std::min(thread_num, seg_cnt), 1u), seg_cnt);
+        for (uint32_t i = 0; i < seg_cnt; i++) {
+            pool.AddTask(boost::bind(&IndexBuilder::BuildSegment, this, i, std::max(batch_size, 1u), handler));
+        }
+        // wait for the segments in queue
+        pool.Stop();
+    }
+    uint64_t consumed = (::baidu::common::timer::get_micros() - start_time_) / 1000;
+    PDLOG(INFO, "build index finished. scanned %lu rows in %lu ms, tid %u pid %u", GetScannedCnt(), consumed, tid,
+          pid);
+    std::lock_guard<std::mutex> lock(mu_);
+    return status_;
+}
+
+void IndexBuilder::BuildSegment(uint32_t seg_idx, uint32_t batch_size, const EntryHandler& handler) {
+    if (failed_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::unique_ptr<TraverseIterator> it(table_->NewSegmentTraverseIterator(0, seg_idx));
+    if (!it) {
+        SetError({-1, absl::StrCat("fail to traverse segment ", seg_idx)});
+        return;
+    }
+    std::shared_ptr<Table> table = table_;
+    std::map<uint32_t, IndexEntries> batches;
+    std::map<uint32_t, std::vector<std::pair<uint32_t, std::string>>> pid_dims;
+    std::vector<std::string> row;
+    ::openmldb::api::LogEntry entry;
+    it->SeekToFirst();
+    while (it->Valid()) {
+        if (failed_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        auto value = it->GetValue();
+        entry.set_ts(it->GetKey());
+        entry.set_value(value.data(), value.size());
+        auto status = MemTableSnapshot::DecodeData(table, entry, decode_cols_, &row);
+        if (!status.OK()) {
+            PDLOG(WARNING, "fail to decode row of pk %s. tid %u pid %u msg %s", it->GetPK().c_str(),
+                  table_->GetId(), table_->GetPid(), status.GetMsg().c_str());
+        } else {
+            pid_dims.clear();
+            for (const auto& kv : index_key_cols_) {
+                std::string key;
+                for (auto pos : kv.second) {
+                    if (key.empty()) {
+                        key = row.at(pos);
+                    } else {
+                        absl::StrAppend(&key, "|", row.at(pos));
+                    }
+                }
+                uint32_t index_pid = ::openmldb::base::hash64(key) % partition_num_;
+                pid_dims[index_pid].emplace_back(kv.first, std::move(key));
+            }
+            for (auto& kv : pid_dims) {
+                auto& batch = batches[kv.first];
+                auto* new_entry = batch.Add();
+                new_entry->set_ts(entry.ts());
+                new_entry->set_value(entry.value());
+                for (auto& dim : kv.second) {
+                    auto* new_dim = new_entry->add_dimensions();
+                    new_dim->set_idx(dim.first);
+                    new_dim->set_key(std::move(dim.second));
+                }
+                if (static_cast<uint32_t>(batch.size()) >= batch_size && !FlushBatch(kv.first, &batch, handler)) {
+                    return;
+                }
+            }
+        }
+        uint64_t scanned_cnt = scanned_cnt_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (scanned_cnt % THROTTLE_STEP == 0) {
+            Throttle(scanned_cnt);
+        }
+        it->Next();
+    }
+    for (auto& kv : batches) {
+        if (kv.second.size() > 0 && !FlushBatch(kv.first, &kv.second, handler)) {
+            return;
+        }
+    }
+}
+
+bool IndexBuilder::FlushBatch(uint32_t pid, IndexEntries* entries, const EntryHandler& handler) {
+    auto status = handler(pid, entries);
+    entries->Clear();
+    if (!status.OK()) {
+        SetError(status);
+        return false;
+    }
+    return true;
+}
+
+void IndexBuilder::Throttle(uint64_t scanned_cnt) {
+    if (max_rows_per_sec_ == 0) {
+        return;
+    }
+    uint64_t expect_time = scanned_cnt * 1000000 / max_rows_per_sec_;
+    uint64_t cur_time = ::baidu::common::timer::get_micros() - start_time_;
+    if (expect_time > cur_time) {
+        std::this_thread::sleep_for(std::chrono::microseconds(expect_time - cur_time));
+    }
+}
+
+void IndexBuilder::SetError(const base::Status& status) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!failed_.exchange(true, std::memory_order_relaxed)) {
+        PDLOG(WARNING, "build index failed. tid %u pid %u msg %s", table_->GetId(), table_->GetPid(),
+              status.GetMsg().c_str());
+        status_ = status;
+    }
+}
+
+}  // namespace storage
+}  // namespace openmldb
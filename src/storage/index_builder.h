@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_INDEX_BUILDER_H_
+#define SRC_STORAGE_INDEX_BUILDER_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "base/status.h"
+#include "proto/common.pb.h"
+#include "proto/tablet.pb.h"
+#include "storage/mem_table.h"
+
+namespace openmldb {
+namespace storage {
+
+using IndexEntries = ::google::protobuf::RepeatedPtrField<::openmldb::api::LogEntry>;
+
+// Build the data of new indexes from the rows in a memory table, instead of reading the snapshot and binlog.
+//
+// The segments of the first index are scanned by several threads, each row is scanned once. For every partition that
+// owns a key of the new indexes (hash of the key modulo the partition num), the row becomes one entry which carries
+// the dimensions of that partition only. The entries are handed to the handler in batches, the caller puts the local
+// ones into the table and sends the others to their leaders.
+class IndexBuilder {
+ public:
+    // called by the scanning threads concurrently, the build stops if it returns an error
+    using EntryHandler = std::function<base::Status(uint32_t pid, IndexEntries* entries)>;
+
+    // the new indexes must have been added to the table
+    IndexBuilder(const std::shared_ptr<MemTable>& table, const std::vector<::openmldb::common::ColumnKey>& add_indexs,
+                 uint32_t partition_num);
+
+    base::Status Init();
+
+    // block until all segments are scanned. `max_rows_per_sec` limits the scan speed of all threads, 0 means no limit
+    base::Status Build(uint32_t thread_num, uint32_t batch_size, uint64_t max_rows_per_sec,
+                       const EntryHandler& handler);
+
+    uint64_t GetScannedCnt() const { return scanned_cnt_.load(std::memory_order_relaxed); }
+    // the record count of the first index when the build starts, rows put after that are not counted
+    uint64_t GetTotalCnt() const { return total_cnt_; }
+
+ private:
+    void BuildSegment(uint32_t seg_idx, uint32_t batch_size, const EntryHandler& handler);
+    bool FlushBatch(uint32_t pid, IndexEntries* entries, const EntryHandler& handler);
+    void Throttle(uint64_t scanned_cnt);
+    void SetError(const base::Status& status);
+
+ private:
+    std::shared_ptr<MemTable> table_;
+    std::vector<::openmldb::common::ColumnKey> add_indexs_;
+    uint32_t partition_num_;
+    // the columns to decode and the position of key columns in them for every new index
+    std::vector<uint32_t> decode_cols_;
+    std::map<uint32_t, std::vector<uint32_t>> index_key_cols_;
+    uint64_t total_cnt_ = 0;
+    uint64_t max_rows_per_sec_ = 0;
+    uint64_t start_time_ = 0;
+    std::atomic<uint64_t> scanned_cnt_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex mu_;
+    base::Status status_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+#endif  // SRC_STORAGE_INDEX_BUILDER_H_
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/index_builder.h"
+
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/glog_wrapper.h"
+#include "base/hash.h"
+#include "codec/schema_codec.h"
+#include "codec/sdk_codec.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace storage {
+
+using ::openmldb::codec::SchemaCodec;
+
+class IndexBuilderTest : public ::testing::Test {};
+
+static std::shared_ptr<MemTable> CreateTable(uint32_t pid, ::openmldb::common::ColumnKey* new_index) {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(1);
+    table_meta.set_pid(pid);
+    table_meta.set_seg_cnt(8);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    auto table = std::make_shared<MemTable>(table_meta);
+    table->Init();
+    codec::SDKCodec codec(table_meta);
+    for (int i = 0; i < 1000; i++) {
+        std::vector<std::string> row = {"card" + std::to_string(i % 100), "mcc" + std::to_string(i % 37),
+                                        std::to_string(1000 + i)};
+        Dimensions dims;
+        auto* dim = dims.Add();
+        dim->set_idx(0);
+        dim->set_key(row[0]);
+        std::string value;
+        EXPECT_EQ(0, codec.EncodeRow(row, &value));
+        EXPECT_TRUE(table->Put(1000 + i, value, dims).ok());
+    }
+    SchemaCodec::SetIndex(new_index, "mcc", "mcc", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    EXPECT_TRUE(table->AddIndex(*new_index));
+    return table;
+}
+
+static uint64_t CountRecords(const std::shared_ptr<MemTable>& table, uint32_t idx) {
+    std::unique_ptr<TableIterator> it(table->NewTraverseIterator(idx));
+    uint64_t cnt = 0;
+    it->SeekToFirst();
+    while (it->Valid()) {
+        cnt++;
+        it->Next();
+    }
+    return cnt;
+}
+
+TEST_F(IndexBuilderTest, Build) {
+    const uint32_t local_pid = 1;
+    const uint32_t partition_num = 4;
+    ::openmldb::common::ColumnKey new_index;
+    auto table = CreateTable(local_pid, &new_index);
+
+    std::mutex mu;
+    std::map<uint32_t, uint64_t> pid_cnt;
+    auto handler = [&](uint32_t pid, IndexEntries* entries) -> base::Status {
+        for (const auto& entry : *entries) {
+            EXPECT_EQ(1, entry.dimensions_size());
+            EXPECT_EQ(1u, entry.dimensions(0).idx());
+            EXPECT_EQ(pid, ::openmldb::base::hash64(entry.dimensions(0).key()) % partition_num);
+            if (pid == local_pid) {
+                auto status = table->Put(entry.ts(), entry.value(), entry.dimensions(), true);
+                if (!status.ok() && !absl::IsAlreadyExists(status)) {
+                    return {-1, status.ToString()};
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(mu);
+        pid_cnt[pid] += entries->size();
+        return {};
+    };
+
+    IndexBuilder builder(table, {new_index}, partition_num);
+    ASSERT_TRUE(builder.Init().OK());
+    ASSERT_EQ(1000u, builder.GetTotalCnt());
+    ASSERT_TRUE(builder.Build(4, 16, 0, handler).OK());
+    ASSERT_EQ(1000u, builder.GetScannedCnt());
+    uint64_t total = 0;
+    for (const auto& kv : pid_cnt) {
+        total += kv.second;
+    }
+    ASSERT_EQ(1000u, total);
+    ASSERT_EQ(pid_cnt[local_pid], CountRecords(table, 1));
+
+    // build again, the local entries exist already
+    pid_cnt.clear();
+    IndexBuilder builder2(table, {new_index}, partition_num);
+    ASSERT_TRUE(builder2.Init().OK());
+    ASSERT_TRUE(builder2.Build(2, 100, 0, handler).OK());
+    ASSERT_EQ(pid_cnt[local_pid], CountRecords(table, 1));
+}
+
+TEST_F(IndexBuilderTest, HandlerFailed) {
+    ::openmldb::common::ColumnKey new_index;
+    auto table = CreateTable(0, &new_index);
+    IndexBuilder builder(table, {new_index}, 2);
+    ASSERT_TRUE(builder.Init().OK());
+    auto status = builder.Build(4, 10, 0, [](uint32_t pid, IndexEntries* entries) -> base::Status {
+        return {-1, "send failed"};
+    });
+    ASSERT_FALSE(status.OK());
+    ASSERT_EQ("send failed", status.GetMsg());
+    ASSERT_LT(builder.GetScannedCnt(), 1000u);
+}
+
+TEST_F(IndexBuilderTest, IndexNotAdded) {
+    ::openmldb::common::ColumnKey new_index;
+    auto table = CreateTable(0, &new_index);
+    ::openmldb::common::ColumnKey other_index;
+    SchemaCodec::SetIndex(&other_index, "mcc_card", "mcc|card", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    IndexBuilder builder(table, {other_index}, 2);
+    ASSERT_FALSE(builder.Init().OK());
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
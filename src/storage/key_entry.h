@@ -17,9 +17,11 @@
 #ifndef SRC_STORAGE_KEY_ENTRY_H_
 #define SRC_STORAGE_KEY_ENTRY_H_
 
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include "base/skiplist.h"
+#include "base/spinlock.h"
 
 namespace openmldb {
 namespace storage {
@@ -90,7 +92,15 @@ class KeyEntry {
 
  public:
     TimeEntries entries;
-    std::atomic<uint64_t> refs_;
+    // refs_ is 32 bits so that mu_, removed_ and accessed_ fit in,
+    // the size of KeyEntry is counted in the memory statistics
+    std::atomic<uint32_t> refs_;
+    // writers of entries (put, delete and gc) are serialized by mu_, readers are lock free
+    ::openmldb::base::SpinMutex mu_;
+    // the key is removed from the segment, it's guarded by mu_
+    bool removed_ = false;
+    // the CLOCK bit of the spill to the cold tier, set on access and cleared by the sweep
+    std::atomic<bool> accessed_ = false;
     std::atomic<uint64_t> count_;
 };
 
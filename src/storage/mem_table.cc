@@ -34,6 +34,8 @@ DECLARE_uint32(skiplist_max_height);
 DECLARE_uint32(key_entry_max_height);
 DECLARE_uint32(absolute_default_skiplist_height);
 DECLARE_uint32(latest_default_skiplist_height);
+DECLARE_string(mem_cold_tier_root_path);
+DECLARE_uint64(mem_cold_tier_hot_bytes);
 
 namespace openmldb {
 namespace storage {
@@ -93,6 +95,14 @@ bool MemTable::Init() {
         table_meta_->key_entry_max_height() > 0) {
         global_key_entry_max_height = table_meta_->key_entry_max_height();
     }
+    metrics_ = TableMetrics::Get(id_, pid_);
+    if (!FLAGS_mem_cold_tier_root_path.empty()) {
+        cold_tier_ = std::make_unique<ColdTier>(id_, pid_, seg_cnt_);
+        if (!cold_tier_->Open(absl::StrCat(FLAGS_mem_cold_tier_root_path, "/", id_, "_", pid_))) {
+            PDLOG(WARNING, "fail to open the cold tier, keep all the rows in memory. tid %u pid %u", id_, pid_);
+            cold_tier_.reset();
+        }
+    }
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (uint32_t i = 0; i < inner_indexs->size(); i++) {
         const std::vector<uint32_t>& ts_vec = inner_indexs->at(i)->GetTsIdx();
@@ -107,24 +117,57 @@ bool MemTable::Init() {
         if (!ts_vec.empty()) {
             for (uint32_t j = 0; j < seg_cnt_; j++) {
                 seg_arr[j] = new Segment(cur_key_entry_max_height, ts_vec);
+                seg_arr[j]->SetMetrics(metrics_.get());
                 PDLOG(INFO, "init %u, %u segment. height %u, ts col num %u. tid %u pid %u", i, j,
                       cur_key_entry_max_height, ts_vec.size(), id_, pid_);
             }
         } else {
             for (uint32_t j = 0; j < seg_cnt_; j++) {
                 seg_arr[j] = new Segment(cur_key_entry_max_height);
+                seg_arr[j]->SetMetrics(metrics_.get());
                 PDLOG(INFO, "init %u, %u segment. height %u tid %u pid %u", i, j, cur_key_entry_max_height, id_, pid_);
             }
         }
         segments_[i] = seg_arr;
+        if (cold_tier_) {
+            cold_tier_->AddInnerIndex(i);
+        }
         key_entry_max_height_ = cur_key_entry_max_height;
     }
+    UpdateLatestTTL();
     PDLOG(INFO, "init table name %s, id %d, pid %d, seg_cnt %d", name_.c_str(), id_, pid_, seg_cnt_);
     return true;
 }
 
 void MemTable::SetCompressType(::openmldb::type::CompressType compress_type) { compress_type_ = compress_type; }
 
+void MemTable::SetExpire(bool is_expire) {
+    enable_gc_.store(is_expire, std::memory_order_relaxed);
+    UpdateLatestTTL();
+}
+
+void MemTable::UpdateLatestTTL() {
+    bool enable_gc = enable_gc_.load(std::memory_order_relaxed);
+    auto inner_indexs = table_index_.GetAllInnerIndex();
+    for (uint32_t i = 0; i < inner_indexs->size() && i < segments_.size(); i++) {
+        if (segments_[i] == nullptr) {
+            continue;
+        }
+        std::map<uint32_t, TTLSt> ttl_st_map;
+        if (enable_gc) {
+            for (const auto& index_def : inner_indexs->at(i)->GetIndex()) {
+                auto ts_col = index_def->GetTsColumn();
+                if (ts_col && index_def->IsReady()) {
+                    ttl_st_map.emplace(ts_col->GetId(), *(index_def->GetTTL()));
+                }
+            }
+        }
+        for (uint32_t j = 0; j < seg_cnt_; j++) {
+            segments_[i][j]->SetLatestTTL(ttl_st_map);
+        }
+    }
+}
+
 ::openmldb::type::CompressType MemTable::GetCompressType() { return compress_type_; }
 
 bool MemTable::Put(const std::string& pk, uint64_t time, const char* data, uint32_t size) {
@@ -215,11 +258,18 @@ absl::Status MemTable::Put(uint64_t time, const std::string& value, const Dimens
             seg_idx = ::openmldb::base::hash(kv.second.data(), kv.second.size(), SEED) % seg_cnt_;
         }
         Segment* segment = segments_[kv.first][seg_idx];
+        if (put_if_absent) {
+            // the rows of a cold key are checked too
+            Access(kv.first, seg_idx, kv.second);
+        }
         if (!segment->Put(kv.second, iter->second, block, put_if_absent)) {
             return absl::AlreadyExistsError("data exists");  // let caller know exists
         }
     }
     record_byte_size_.fetch_add(GetRecordSize(value.length()));
+    if (metrics_) {
+        metrics_->RecordWrite(dimensions.begin()->idx(), dimensions.begin()->key());
+    }
     return absl::OkStatus();
 }
 
@@ -271,6 +321,7 @@ bool MemTable::Delete(uint32_t idx, const std::string& key,
     if (seg_cnt_ > 1) {
         seg_idx = base::hash(spk.data(), spk.size(), SEED) % seg_cnt_;
     }
+    Access(real_idx, seg_idx, spk);
     if (!start_ts.has_value() && !end_ts.has_value()) {
         return segments_[real_idx][seg_idx]->Delete(ts_idx, spk);
     } else {
@@ -308,6 +359,7 @@ void MemTable::SchedGc() {
     auto inner_indexs = table_index_.GetAllInnerIndex();
     uint64_t gc_idx_cnt = 0;
     uint64_t gc_record_byte_size = 0;
+    uint64_t node_cache_size = 0;
     for (uint32_t i = 0; i < inner_indexs->size(); i++) {
         const std::vector<std::shared_ptr<IndexDef>>& real_index = inner_indexs->at(i)->GetIndex();
         std::map<uint32_t, TTLSt> ttl_st_map;
@@ -349,6 +401,9 @@ void MemTable::SchedGc() {
             }
             deleted_num += deleting_pos.size();
         }
+        if (cold_tier_) {
+            gc_idx_cnt += cold_tier_->Gc(i, GetColdTTL(i));
+        }
         if (!enable_gc_.load(std::memory_order_relaxed) || !need_gc) {
             continue;
         }
@@ -368,16 +423,120 @@ void MemTable::SchedGc() {
             }
             gc_idx_cnt += statistics_info.GetTotalCnt();
             gc_record_byte_size += statistics_info.record_byte_size;
+            node_cache_size += segment->GetNodeCacheSize();
             seg_gc_time = ::baidu::common::timer::get_micros() / 1000 - seg_gc_time;
             PDLOG(INFO, "gc segment[%u][%u] done consumed %lu for table %s tid %u pid %u", i, j, seg_gc_time,
                   name_.c_str(), id_, pid_);
         }
     }
-    consumed = ::baidu::common::timer::get_micros() - consumed;
     record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
+    if (cold_tier_) {
+        SpillColdKeys();
+    }
+    consumed = ::baidu::common::timer::get_micros() - consumed;
+    if (metrics_) {
+        *metrics_->gc << consumed;
+        *metrics_->gc_freed_records << gc_idx_cnt;
+        *metrics_->gc_freed_bytes << gc_record_byte_size;
+        *metrics_->node_cache_size << node_cache_size;
+    }
     PDLOG(INFO, "gc finished, gc_idx_cnt %lu, consumed %lu ms for table %s tid %u pid %u",
           gc_idx_cnt, consumed / 1000, name_.c_str(), id_, pid_);
     UpdateTTL();
+    UpdateLatestTTL();
+}
+
+std::map<uint32_t, TTLSt> MemTable::GetColdTTL(uint32_t inner_idx) {
+    std::map<uint32_t, TTLSt> ttl_st_map;
+    auto inner_index = table_index_.GetInnerIndex(inner_idx);
+    if (!inner_index) {
+        return ttl_st_map;
+    }
+    bool enable_gc = enable_gc_.load(std::memory_order_relaxed);
+    // the rows of the indexes which are not ready are removed
+    for (const auto& index_def : inner_index->GetIndex()) {
+        auto ts_col = index_def->GetTsColumn();
+        if (!index_def->IsReady()) {
+            continue;
+        }
+        auto ttl = index_def->GetTTL();
+        ttl_st_map.emplace(GetColdTsCol(inner_idx, ts_col),
+                           TTLSt(GetExpireTime(*ttl), enable_gc ? ttl->lat_ttl : 0, ttl->ttl_type));
+    }
+    return ttl_st_map;
+}
+
+uint32_t MemTable::GetColdTsCol(uint32_t inner_idx, const std::shared_ptr<ColumnDef>& ts_col) {
+    if (!ts_col || segments_[inner_idx][0]->GetTsIdxMap().empty()) {
+        return 0;
+    }
+    return ts_col->GetId();
+}
+
+void MemTable::Access(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk) {
+    if (!cold_tier_) {
+        return;
+    }
+    Segment* segment = segments_[inner_idx][seg_idx];
+    // the bit is set before the cold tier is checked, so the key is not spilled after it's found not cold
+    segment->Touch(pk);
+    bool has_ts_idx = !segment->GetTsIdxMap().empty();
+    cold_tier_->Promote(inner_idx, seg_idx, pk, [&](const std::vector<SpilledRow>& rows) {
+        uint64_t byte_size = 0;
+        for (const auto& row : rows) {
+            auto* block = new DataBlock(1, row.value.c_str(), row.value.size());
+            bool ok = has_ts_idx ? segment->Put(pk, {{static_cast<int32_t>(row.ts_col), row.ts}}, block)
+                                 : segment->Put(pk, row.ts, block);
+            if (!ok) {
+                delete block;
+                continue;
+            }
+            byte_size += GetRecordSize(row.value.size());
+        }
+        record_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+        if (metrics_) {
+            *metrics_->cold_promoted_keys << 1;
+        }
+    });
+}
+
+void MemTable::SpillColdKeys() {
+    uint64_t record_byte_size = record_byte_size_.load(std::memory_order_relaxed);
+    if (record_byte_size <= FLAGS_mem_cold_tier_hot_bytes) {
+        return;
+    }
+    // the rows shared by the indexes are freed after the keys of all the indexes are spilled, so every index spills
+    // the same bytes. The memory is freed by the node cache in the later gc
+    uint64_t max_bytes = (record_byte_size - FLAGS_mem_cold_tier_hot_bytes) / seg_cnt_ + 1;
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t spilled_cnt = 0;
+    uint64_t spilled_bytes = 0;
+    auto inner_indexs = table_index_.GetAllInnerIndex();
+    for (uint32_t i = 0; i < inner_indexs->size(); i++) {
+        if (segments_[i] == nullptr) {
+            continue;
+        }
+        for (uint32_t j = 0; j < seg_cnt_; j++) {
+            Segment* segment = segments_[i][j];
+            std::vector<std::string> keys;
+            segment->CollectColdKeys(max_bytes, &keys);
+            for (const auto& key : keys) {
+                Slice spk(key);
+                uint64_t bytes = cold_tier_->Spill(
+                    i, j, spk, [segment, &spk](const SpilledRowSink& sink) { return segment->SpillKey(spk, sink); });
+                if (bytes > 0) {
+                    spilled_cnt++;
+                    spilled_bytes += bytes;
+                }
+            }
+        }
+    }
+    consumed = ::baidu::common::timer::get_micros() - consumed;
+    if (metrics_) {
+        *metrics_->cold_spilled_keys << spilled_cnt;
+    }
+    PDLOG(INFO, "spill %lu keys with %lu bytes to the cold tier, consumed %lu ms for table %s tid %u pid %u",
+          spilled_cnt, spilled_bytes, consumed / 1000, name_.c_str(), id_, pid_);
 }
 
 // tll as ms
@@ -493,6 +652,7 @@ int MemTable::GetCount(uint32_t index, const std::string& pk, uint64_t& count) {
     }
     Slice spk(pk);
     uint32_t real_idx = index_def->GetInnerPos();
+    Access(real_idx, seg_idx, spk);
     Segment* segment = segments_[real_idx][seg_idx];
     auto ts_col = index_def->GetTsColumn();
     if (ts_col) {
@@ -515,7 +675,11 @@ TableIterator* MemTable::NewIterator(uint32_t index, const std::string& pk, Tick
     }
     Slice spk(pk);
     uint32_t real_idx = index_def->GetInnerPos();
+    Access(real_idx, seg_idx, spk);
     Segment* segment = segments_[real_idx][seg_idx];
+    if (metrics_) {
+        metrics_->RecordRead(index, pk);
+    }
     auto ts_col = index_def->GetTsColumn();
     if (ts_col) {
         return segment->NewIterator(spk, ts_col->GetId(), ticket, GetCompressType());
@@ -565,6 +729,9 @@ uint64_t MemTable::GetRecordIdxCnt() {
         } else {
             record_idx_cnt += segments_[inner_idx][i]->GetIdxCnt();
         }
+        if (cold_tier_) {
+            record_idx_cnt += cold_tier_->GetRecordCnt(inner_idx, i, GetColdTsCol(inner_idx, ts_col));
+        }
     }
     return record_idx_cnt;
 }
@@ -611,12 +778,39 @@ bool MemTable::GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) {
         } else {
             data_array[i] += segments_[inner_idx][i]->GetIdxCnt();
         }
+        if (cold_tier_) {
+            data_array[i] += cold_tier_->GetRecordCnt(inner_idx, i, GetColdTsCol(inner_idx, ts_col));
+        }
     }
     *stat = data_array;
     *size = seg_cnt_;
     return true;
 }
 
+bool MemTable::GetIndexStat(uint32_t idx, uint64_t* pk_cnt, uint64_t* record_cnt) {
+    if (pk_cnt == nullptr || record_cnt == nullptr) {
+        return false;
+    }
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    uint64_t* stat = nullptr;
+    uint32_t size = 0;
+    if (!index_def || !GetRecordIdxCnt(idx, &stat, &size)) {
+        return false;
+    }
+    *record_cnt = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        *record_cnt += stat[i];
+    }
+    delete[] stat;
+    // the indexes on the same key columns share the segments
+    uint32_t inner_idx = index_def->GetInnerPos();
+    *pk_cnt = 0;
+    for (uint32_t i = 0; i < seg_cnt_; i++) {
+        *pk_cnt += segments_[inner_idx][i]->GetPkCnt();
+    }
+    return true;
+}
+
 bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
     // TODO(denglong): support ttl type and merge index
     auto table_meta = GetTableMeta();
@@ -671,6 +865,7 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
         Segment** seg_arr = new Segment*[seg_cnt_];
         for (uint32_t j = 0; j < seg_cnt_; j++) {
             seg_arr[j] = new Segment(FLAGS_absolute_default_skiplist_height, ts_vec);
+            seg_arr[j]->SetMetrics(metrics_.get());
             PDLOG(INFO, "init %u, %u segment. height %u, ts col num %u. tid %u pid %u", inner_id, j,
                   FLAGS_absolute_default_skiplist_height, ts_vec.size(), id_, pid_);
         }
@@ -680,6 +875,9 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
             PDLOG(WARNING, "add index failed. tid %u pid %u", id_, pid_);
             return false;
         }
+        if (cold_tier_) {
+            cold_tier_->AddInnerIndex(inner_id);
+        }
         segments_[inner_id] = seg_arr;
         if (!column_key.ts_name().empty()) {
             auto ts_iter = schema.find(column_key.ts_name());
@@ -747,8 +945,24 @@ bool MemTable::DeleteIndex(const std::string& idx_name) {
     if (ts_col) {
         ts_idx = ts_col->GetId();
     }
-    return new MemTableKeyIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type,
+    auto it = new MemTableKeyIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type,
             expire_time, expire_cnt, ts_idx, GetCompressType());
+    it->SetMetrics(metrics_.get(), index);
+    if (cold_tier_) {
+        it->SetPromoter([this, real_idx](uint32_t seg_idx, const std::string& key) {
+            Access(real_idx, seg_idx, Slice(key));
+        });
+        if (cold_tier_->HasColdKeys(real_idx)) {
+            TTLSt expire_value(expire_time, expire_cnt, ttl->ttl_type);
+            uint32_t cold_ts_col = GetColdTsCol(real_idx, ts_col);
+            // the cold keys are listed by it, the rows of a key are merged and counted by HybridKeyIterator
+            auto cold_it = cold_tier_->NewTraverseIterator(real_idx, cold_ts_col, 0, seg_cnt_,
+                    GetTierTTL(expire_value), GetCompressType());
+            return new HybridKeyIterator(it, cold_it, cold_tier_.get(), real_idx, cold_ts_col, expire_value,
+                    GetCompressType());
+        }
+    }
+    return it;
 }
 
 TraverseIterator* MemTable::NewTraverseIterator(uint32_t index) {
@@ -766,12 +980,47 @@ TraverseIterator* MemTable::NewTraverseIterator(uint32_t index) {
     }
     uint32_t real_idx = index_def->GetInnerPos();
     auto ts_col = index_def->GetTsColumn();
-    if (ts_col) {
-        return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type,
-                expire_time, expire_cnt, ts_col->GetId(), GetCompressType());
+    uint32_t ts_idx = ts_col ? ts_col->GetId() : 0;
+    if (cold_tier_ && cold_tier_->HasColdKeys(real_idx)) {
+        TTLSt expire_value(expire_time, expire_cnt, ttl->ttl_type);
+        TTLSt tier_ttl = GetTierTTL(expire_value);
+        auto it = new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, tier_ttl.ttl_type, tier_ttl.abs_ttl,
+                tier_ttl.lat_ttl, ts_idx, GetCompressType());
+        auto cold_it = cold_tier_->NewTraverseIterator(real_idx, GetColdTsCol(real_idx, ts_col), 0, seg_cnt_,
+                tier_ttl, GetCompressType());
+        return new HybridTraverseIterator(it, cold_it, seg_cnt_, expire_value);
     }
     return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type,
-            expire_time, expire_cnt, 0, GetCompressType());
+            expire_time, expire_cnt, ts_idx, GetCompressType());
+}
+
+TraverseIterator* MemTable::NewSegmentTraverseIterator(uint32_t index, uint32_t seg_idx) {
+    std::shared_ptr<IndexDef> index_def = GetIndex(index);
+    if (!index_def || !index_def->IsReady() || seg_idx >= seg_cnt_) {
+        PDLOG(WARNING, "index %u segment %u not found. tid %u pid %u", index, seg_idx, id_, pid_);
+        return nullptr;
+    }
+    uint64_t expire_time = 0;
+    uint64_t expire_cnt = 0;
+    auto ttl = index_def->GetTTL();
+    if (enable_gc_.load(std::memory_order_relaxed)) {
+        expire_time = GetExpireTime(*ttl);
+        expire_cnt = ttl->lat_ttl;
+    }
+    uint32_t real_idx = index_def->GetInnerPos();
+    auto ts_col = index_def->GetTsColumn();
+    uint32_t ts_idx = ts_col ? ts_col->GetId() : 0;
+    if (cold_tier_ && cold_tier_->MayBeCold(real_idx, seg_idx)) {
+        TTLSt expire_value(expire_time, expire_cnt, ttl->ttl_type);
+        TTLSt tier_ttl = GetTierTTL(expire_value);
+        auto it = new MemTableTraverseIterator(segments_[real_idx] + seg_idx, 1, tier_ttl.ttl_type, tier_ttl.abs_ttl,
+                tier_ttl.lat_ttl, ts_idx, ::openmldb::type::CompressType::kNoCompress);
+        auto cold_it = cold_tier_->NewTraverseIterator(real_idx, GetColdTsCol(real_idx, ts_col), seg_idx,
+                seg_idx + 1, tier_ttl, ::openmldb::type::CompressType::kNoCompress);
+        return new HybridTraverseIterator(it, cold_it, seg_cnt_, expire_value);
+    }
+    return new MemTableTraverseIterator(segments_[real_idx] + seg_idx, 1, ttl->ttl_type,
+            expire_time, expire_cnt, ts_idx, ::openmldb::type::CompressType::kNoCompress);
 }
 
 bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response) {
@@ -24,9 +24,11 @@
 #include <vector>
 
 #include "proto/tablet.pb.h"
+#include "storage/cold_tier.h"
 #include "storage/iterator.h"
 #include "storage/segment.h"
 #include "storage/table.h"
+#include "storage/table_metrics.h"
 #include "storage/ticket.h"
 #include "vm/catalog.h"
 
@@ -70,6 +72,10 @@ class MemTable : public Table {
 
     TraverseIterator* NewTraverseIterator(uint32_t index) override;
 
+    // traverse the segment `seg_idx` only, so that the segments can be traversed in parallel.
+    // The values are returned as they are stored, i.e. compressed if the table is compressed
+    TraverseIterator* NewSegmentTraverseIterator(uint32_t index, uint32_t seg_idx);
+
     ::hybridse::vm::WindowIterator* NewWindowIterator(uint32_t index);
 
     // release all memory allocated
@@ -83,6 +89,8 @@ class MemTable : public Table {
     bool GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) override;
     uint64_t GetRecordIdxByteSize() override;
     uint64_t GetRecordPkCnt() override;
+    // the key count and record count of the index `idx`
+    bool GetIndexStat(uint32_t idx, uint64_t* pk_cnt, uint64_t* record_cnt);
 
     void SetCompressType(::openmldb::type::CompressType compress_type);
     ::openmldb::type::CompressType GetCompressType();
@@ -93,7 +101,7 @@ class MemTable : public Table {
 
     inline uint32_t GetSegCnt() const { return seg_cnt_; }
 
-    inline void SetExpire(bool is_expire) { enable_gc_.store(is_expire, std::memory_order_relaxed); }
+    void SetExpire(bool is_expire);
 
     uint64_t GetExpireTime(const TTLSt& ttl_st) override;
 
@@ -103,6 +111,8 @@ class MemTable : public Table {
 
     inline uint32_t GetKeyEntryHeight() const { return key_entry_max_height_; }
 
+    TableMetrics* GetMetrics() const { return metrics_.get(); }
+
     bool DeleteIndex(const std::string& idx_name) override;
 
     bool AddIndex(const ::openmldb::common::ColumnKey& column_key);
@@ -112,6 +122,23 @@ class MemTable : public Table {
 
     bool CheckLatest(uint32_t index_id, const std::string& key, uint64_t ts);
 
+    // pass the latest ttl of the indexes to the segments which remove the rows over it on put, not if gc is disabled
+    void UpdateLatestTTL();
+
+    // mark the key as accessed and promote it if it's in the cold tier, it's called before the key is read.
+    // Each index spills and promotes its own copy of a row shared by the indexes, so a promoted row takes one
+    // block per index. The copies are counted in the row bytes, the gc spills them again if it's over the budget
+    void Access(uint32_t inner_idx, uint32_t seg_idx, const Slice& pk);
+
+    // spill the keys not accessed recently to the cold tier if the rows are over mem_cold_tier_hot_bytes
+    void SpillColdKeys();
+
+    // the expire time is taken as abs_ttl as the iterators do
+    std::map<uint32_t, TTLSt> GetColdTTL(uint32_t inner_idx);
+
+    // the ts column the rows are spilled with, it's 0 if the segments of the inner index have one ts column
+    uint32_t GetColdTsCol(uint32_t inner_idx, const std::shared_ptr<ColumnDef>& ts_col);
+
  private:
     uint32_t seg_cnt_;
     std::vector<Segment**> segments_;
@@ -120,6 +147,9 @@ class MemTable : public Table {
     bool segment_released_;
     std::atomic<uint64_t> record_byte_size_;
     uint32_t key_entry_max_height_;
+    std::shared_ptr<TableMetrics> metrics_;
+    // the on-disk tier of the keys spilled from the segments, null if it's disabled
+    std::unique_ptr<ColdTier> cold_tier_;
 };
 
 }  // namespace storage
@@ -16,7 +16,10 @@
 
 #include "storage/mem_table_iterator.h"
 #include <snappy.h>
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <utility>
 #include "base/hash.h"
 #include "gflags/gflags.h"
 
@@ -27,6 +30,20 @@ namespace storage {
 
 constexpr uint32_t SEED = 0xe17a1465;
 
+static uint32_t GetSegIdx(const Slice& pk, uint32_t seg_cnt) {
+    return seg_cnt > 1 ? ::openmldb::base::hash(pk.data(), pk.size(), SEED) % seg_cnt : 0;
+}
+
+// the order of the keys in the traverse of the segments
+static int ComparePK(const Slice& a, const Slice& b, uint32_t seg_cnt) {
+    uint32_t seg_a = GetSegIdx(a, seg_cnt);
+    uint32_t seg_b = GetSegIdx(b, seg_cnt);
+    if (seg_a != seg_b) {
+        return seg_a < seg_b ? -1 : 1;
+    }
+    return a.compare(b);
+}
+
 MemTableWindowIterator::~MemTableWindowIterator() {
     delete it_;
 }
@@ -121,6 +138,14 @@ void MemTableKeyIterator::Seek(const std::string& key) {
     ticket_.Pop();
     if (seg_cnt_ > 1) {
         seg_idx_ = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % seg_cnt_;
+    } else {
+        seg_idx_ = 0;
+    }
+    if (metrics_ != nullptr) {
+        metrics_->RecordRead(idx_, key);
+    }
+    if (promoter_) {
+        promoter_(seg_idx_, key);
     }
     Slice spk(key);
     pk_it_ = segments_[seg_idx_]->GetKeyEntries()->NewIterator();
@@ -395,5 +420,178 @@ void MemTableTraverseIterator::SeekToFirst() {
     }
 }
 
+void HybridTraverseIterator::Pick() {
+    bool hot_valid = hot_->Valid();
+    bool cold_valid = cold_->Valid();
+    if (hot_valid && cold_valid) {
+        std::string hot_pk = hot_->GetPK();
+        std::string cold_pk = cold_->GetPK();
+        int cmp = ComparePK(Slice(hot_pk), Slice(cold_pk), seg_cnt_);
+        if (cmp == 0) {
+            cur_ = hot_->GetKey() >= cold_->GetKey() ? hot_.get() : cold_.get();
+        } else {
+            cur_ = cmp < 0 ? hot_.get() : cold_.get();
+        }
+    } else if (hot_valid) {
+        cur_ = hot_.get();
+    } else if (cold_valid) {
+        cur_ = cold_.get();
+    } else {
+        cur_ = nullptr;
+    }
+}
+
+void HybridTraverseIterator::Settle() {
+    while (true) {
+        Pick();
+        if (cur_ == nullptr) {
+            return;
+        }
+        std::string pk = cur_->GetPK();
+        if (pk != pk_) {
+            pk_ = std::move(pk);
+            record_idx_ = 1;
+        }
+        if (!expire_value_.IsExpired(cur_->GetKey(), record_idx_)) {
+            return;
+        }
+        // the rest rows of the key are expired too
+        SkipPK(pk_);
+    }
+}
+
+void HybridTraverseIterator::SkipPK(const std::string& pk) {
+    if (hot_->Valid() && hot_->GetPK() == pk) {
+        hot_->NextPK();
+    }
+    if (cold_->Valid() && cold_->GetPK() == pk) {
+        cold_->NextPK();
+    }
+}
+
+void HybridTraverseIterator::Next() {
+    cur_->Next();
+    record_idx_++;
+    Settle();
+}
+
+void HybridTraverseIterator::NextPK() {
+    SkipPK(pk_);
+    Settle();
+}
+
+void HybridTraverseIterator::Seek(const std::string& key, uint64_t time) {
+    pk_.clear();
+    record_idx_ = 0;
+    if (expire_value_.ttl_type == TTLType::kAbsoluteTime || expire_value_.lat_ttl == 0) {
+        hot_->Seek(key, time);
+        cold_->Seek(key, time);
+        Settle();
+        return;
+    }
+    // count the rows of the key before time in both tiers
+    hot_->Seek(key, UINT64_MAX);
+    cold_->Seek(key, UINT64_MAX);
+    Settle();
+    while (cur_ != nullptr && pk_ == key && cur_->GetKey() > time) {
+        Next();
+    }
+}
+
+void HybridTraverseIterator::SeekToFirst() {
+    pk_.clear();
+    record_idx_ = 0;
+    hot_->SeekToFirst();
+    cold_->SeekToFirst();
+    Settle();
+}
+
+HybridKeyIterator::HybridKeyIterator(MemTableKeyIterator* hot, TraverseIterator* cold, ColdTier* cold_tier,
+                                     uint32_t inner_idx, uint32_t ts_col, const TTLSt& expire_value,
+                                     type::CompressType compress_type)
+    : hot_(hot),
+      cold_(cold),
+      cold_tier_(cold_tier),
+      inner_idx_(inner_idx),
+      ts_col_(ts_col),
+      expire_value_(expire_value),
+      compress_type_(compress_type) {}
+
+void HybridKeyIterator::Pick() {
+    in_hot_ = hot_->Valid();
+    in_cold_ = cold_->Valid();
+    std::string cold_pk = in_cold_ ? cold_->GetPK() : std::string();
+    if (in_hot_ && in_cold_) {
+        int cmp = ComparePK(hot_->GetPK(), Slice(cold_pk), cold_tier_->GetSegCnt());
+        if (cmp < 0) {
+            in_cold_ = false;
+        } else if (cmp > 0) {
+            in_hot_ = false;
+        }
+    }
+    if (in_hot_) {
+        pk_ = hot_->GetPK().ToString();
+    } else {
+        pk_ = std::move(cold_pk);
+    }
+}
+
+void HybridKeyIterator::Seek(const std::string& key) {
+    hot_->Seek(key);
+    cold_->Seek(key, UINT64_MAX);
+    Pick();
+}
+
+void HybridKeyIterator::SeekToFirst() {
+    hot_->SeekToFirst();
+    cold_->SeekToFirst();
+    Pick();
+}
+
+void HybridKeyIterator::Next() {
+    if (in_hot_) {
+        hot_->Next();
+    }
+    if (in_cold_) {
+        cold_->NextPK();
+    }
+    Pick();
+}
+
+::hybridse::vm::RowIterator* HybridKeyIterator::GetRawValue() {
+    if (!in_cold_) {
+        return hot_->GetRawValue();
+    }
+    ColdRows rows;
+    Slice pk(pk_);
+    cold_tier_->Read(inner_idx_, GetSegIdx(pk, cold_tier_->GetSegCnt()), pk, ts_col_, &rows);
+    if (compress_type_ == type::CompressType::kSnappy) {
+        std::string buf;
+        for (auto& row : rows) {
+            buf.clear();
+            snappy::Uncompress(row.second.data(), row.second.size(), &buf);
+            row.second.swap(buf);
+        }
+    }
+    if (in_hot_) {
+        ColdRows hot_rows;
+        std::unique_ptr<::hybridse::vm::RowIterator> it(hot_->GetRawValue());
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            const auto& row = it->GetValue();
+            hot_rows.emplace_back(it->GetKey(), std::string(reinterpret_cast<const char*>(row.buf()), row.size()));
+        }
+        ColdRows merged;
+        merged.reserve(hot_rows.size() + rows.size());
+        std::merge(hot_rows.begin(), hot_rows.end(), rows.begin(), rows.end(), std::back_inserter(merged),
+                   [](const auto& a, const auto& b) { return a.first > b.first; });
+        rows.swap(merged);
+    }
+    return new ColdWindowIterator(std::move(rows), expire_value_);
+}
+
+const hybridse::codec::Row HybridKeyIterator::GetKey() {
+    return hybridse::codec::Row(::hybridse::base::RefCountedSlice::Create(pk_.data(), pk_.size()));
+}
+
 }  // namespace storage
 }  // namespace openmldb
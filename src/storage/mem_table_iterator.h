@@ -16,8 +16,10 @@
 #ifndef SRC_STORAGE_MEM_TABLE_ITERATOR_H_
 #define SRC_STORAGE_MEM_TABLE_ITERATOR_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include "storage/cold_tier.h"
 #include "storage/segment.h"
 #include "vm/catalog.h"
 
@@ -77,6 +79,18 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
 
     const hybridse::codec::Row GetKey() override;
 
+    // record the sought keys as reads of the index
+    void SetMetrics(TableMetrics* metrics, uint32_t idx) {
+        metrics_ = metrics;
+        idx_ = idx;
+    }
+
+    // called with the segment and the key before the key is sought, so that a cold key is promoted
+    void SetPromoter(std::function<void(uint32_t, const std::string&)> promoter) { promoter_ = std::move(promoter); }
+
+    // the key of the current position, it's valid until the iterator moves
+    Slice GetPK() { return pk_it_->GetKey(); }
+
  private:
     void NextPK();
 
@@ -92,6 +106,9 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
     Ticket ticket_;
     uint32_t ts_idx_;
     type::CompressType compress_type_;
+    TableMetrics* metrics_ = nullptr;
+    uint32_t idx_ = 0;
+    std::function<void(uint32_t, const std::string&)> promoter_;
 };
 
 class MemTableTraverseIterator : public TraverseIterator {
@@ -125,6 +142,80 @@ class MemTableTraverseIterator : public TraverseIterator {
     mutable std::string tmp_buf_;
 };
 
+// merge the rows of the segments and the cold tier in the order of (segment, pk, ts desc). A key is in both of them
+// if it's put after it was spilled, its rows are merged by ts then
+// the ttl applied by each tier of the hybrid iterators. The latest count of a key is over the rows of both tiers, so
+// the tiers only remove the rows expired by time and the merged rows are counted
+inline TTLSt GetTierTTL(const TTLSt& expire_value) {
+    bool abs_expired = expire_value.ttl_type == TTLType::kAbsoluteTime || expire_value.ttl_type == TTLType::kAbsOrLat;
+    return TTLSt(abs_expired ? expire_value.abs_ttl : 0, 0, TTLType::kAbsoluteTime);
+}
+
+class HybridTraverseIterator : public TraverseIterator {
+ public:
+    // hot and cold apply the ttl of GetTierTTL, expire_value is applied to the merged rows
+    HybridTraverseIterator(TraverseIterator* hot, TraverseIterator* cold, uint32_t seg_cnt, const TTLSt& expire_value)
+        : hot_(hot), cold_(cold), seg_cnt_(seg_cnt), expire_value_(expire_value), cur_(nullptr) {}
+    ~HybridTraverseIterator() override {}
+    bool Valid() override { return cur_ != nullptr; }
+    void Next() override;
+    void NextPK() override;
+    void Seek(const std::string& key, uint64_t time) override;
+    openmldb::base::Slice GetValue() const override { return cur_->GetValue(); }
+    std::string GetPK() const override { return cur_ == nullptr ? std::string() : cur_->GetPK(); }
+    uint64_t GetKey() const override { return cur_ == nullptr ? UINT64_MAX : cur_->GetKey(); }
+    void SeekToFirst() override;
+    uint64_t GetCount() const override { return hot_->GetCount() + cold_->GetCount(); }
+
+ private:
+    void Pick();
+    // pick the next row which is not expired
+    void Settle();
+    void SkipPK(const std::string& pk);
+
+ private:
+    std::unique_ptr<TraverseIterator> hot_;
+    std::unique_ptr<TraverseIterator> cold_;
+    uint32_t seg_cnt_;
+    TTLSt expire_value_;
+    TraverseIterator* cur_;
+    // the key of cur_ and the position of its row in the merged rows of the key
+    std::string pk_;
+    uint32_t record_idx_ = 0;
+};
+
+// the window iterator over the keys of the segments and the cold tier. The cold keys are read without being promoted
+// by the full scans, but Seek promotes the key as the point reads do
+class HybridKeyIterator : public ::hybridse::vm::WindowIterator {
+ public:
+    HybridKeyIterator(MemTableKeyIterator* hot, TraverseIterator* cold, ColdTier* cold_tier, uint32_t inner_idx,
+                      uint32_t ts_col, const TTLSt& expire_value, type::CompressType compress_type);
+    ~HybridKeyIterator() override {}
+
+    void Seek(const std::string& key) override;
+    void SeekToFirst() override;
+    void Next() override;
+    bool Valid() override { return in_hot_ || in_cold_; }
+    ::hybridse::vm::RowIterator* GetRawValue() override;
+    const hybridse::codec::Row GetKey() override;
+
+ private:
+    void Pick();
+
+ private:
+    std::unique_ptr<MemTableKeyIterator> hot_;
+    std::unique_ptr<TraverseIterator> cold_;
+    ColdTier* cold_tier_;
+    uint32_t inner_idx_;
+    uint32_t ts_col_;
+    TTLSt expire_value_;
+    type::CompressType compress_type_;
+    // the current key is in the segments or the cold tier or both
+    bool in_hot_ = false;
+    bool in_cold_ = false;
+    std::string pk_;
+};
+
 }  // namespace storage
 }  // namespace openmldb
 
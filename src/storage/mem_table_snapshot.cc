@@ -19,7 +19,10 @@
 #ifdef DISALLOW_COPY_AND_ASSIGN
 #undef DISALLOW_COPY_AND_ASSIGN
 #endif
+#include <fcntl.h>
 #include <snappy.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <set>
@@ -42,6 +45,7 @@
 #include "log/log_reader.h"
 #include "log/sequential_file.h"
 #include "proto/tablet.pb.h"
+#include "storage/table_metrics.h"
 
 DECLARE_uint64(gc_on_table_recover_count);
 DECLARE_int32(binlog_name_length);
@@ -49,6 +53,7 @@ DECLARE_uint32(make_snapshot_max_deleted_keys);
 DECLARE_uint32(load_table_batch);
 DECLARE_uint32(load_table_thread_num);
 DECLARE_uint32(load_table_queue_size);
+DECLARE_bool(load_snapshot_in_parallel);
 DECLARE_string(snapshot_compression);
 
 namespace openmldb {
@@ -415,6 +420,10 @@ void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uin
 
 void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table,
                                              std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt) {
+    if (table && FLAGS_load_snapshot_in_parallel && !IsCompressed(path) &&
+        RecoverSnapshotInParallel(path, table, g_succ_cnt, g_failed_cnt)) {
+        return;
+    }
     ::openmldb::base::TaskPool load_pool_(FLAGS_load_table_thread_num, FLAGS_load_table_batch);
     std::atomic<uint64_t> succ_cnt, failed_cnt;
     succ_cnt = failed_cnt = 0;
@@ -479,26 +488,105 @@ void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::share
     load_pool_.Stop();
 }
 
+bool MemTableSnapshot::RecoverSnapshotInParallel(const std::string& path, const std::shared_ptr<Table>& table,
+                                             std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PDLOG(WARNING, "fail to open path %s for error %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        PDLOG(WARNING, "fail to stat path %s for error %s", path.c_str(), strerror(errno));
+        close(fd);
+        return false;
+    }
+    uint64_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        PDLOG(WARNING, "fail to map path %s for error %s, read it instead", path.c_str(), strerror(errno));
+        return false;
+    }
+    absl::Cleanup unmap = [addr, size] { munmap(addr, size); };
+    // every range is read once from the start to the end
+    madvise(addr, size, MADV_SEQUENTIAL);
+    const char* data = reinterpret_cast<const char*>(addr);
+    uint32_t thread_num = std::max(FLAGS_load_table_thread_num, 1u);
+    // several ranges per thread so that the threads finish at about the same time
+    uint64_t block_cnt = (size + ::openmldb::log::kBlockSize - 1) / ::openmldb::log::kBlockSize;
+    uint64_t range_size = std::max<uint64_t>(block_cnt / (thread_num * 4), 1) * ::openmldb::log::kBlockSize;
+    std::atomic<uint64_t> succ_cnt(0);
+    std::atomic<uint64_t> failed_cnt(0);
+    uint64_t consumed = ::baidu::common::timer::now_time();
+    {
+        ::openmldb::base::TaskPool load_pool(thread_num, FLAGS_load_table_queue_size);
+        for (uint64_t begin = 0; begin < size; begin += range_size) {
+            uint64_t end = std::min(begin + range_size, size);
+            load_pool.AddTask([this, &path, &table, data, size, begin, end, &succ_cnt, &failed_cnt] {
+                ::openmldb::log::MappedReader reader(data, size, begin, end);
+                ::openmldb::api::LogEntry entry;
+                std::string scratch;
+                ::openmldb::base::Slice record;
+                while (true) {
+                    ::openmldb::log::Status status = reader.ReadRecord(&record, &scratch);
+                    if (status.IsEof()) {
+                        break;
+                    }
+                    if (!status.ok()) {
+                        PDLOG(WARNING, "fail to read record for tid %u, pid %u with error %s", tid_, pid_,
+                              status.ToString().c_str());
+                        failed_cnt.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    PutRecord(path, table.get(), record, &entry, &succ_cnt, &failed_cnt);
+                }
+            });
+        }
+        load_pool.Stop();
+    }
+    consumed = ::baidu::common::timer::now_time() - consumed;
+    PDLOG(INFO, "parallel load path %s for table tid %u pid %u completed, succ_cnt %lu, failed_cnt %lu, consumed %us",
+          path.c_str(), tid_, pid_, succ_cnt.load(std::memory_order_relaxed),
+          failed_cnt.load(std::memory_order_relaxed), consumed);
+    if (g_succ_cnt) {
+        g_succ_cnt->fetch_add(succ_cnt, std::memory_order_relaxed);
+    }
+    if (g_failed_cnt) {
+        g_failed_cnt->fetch_add(failed_cnt, std::memory_order_relaxed);
+    }
+    return true;
+}
+
 void MemTableSnapshot::Put(std::string& path, std::shared_ptr<Table>& table, std::vector<std::string*> recordPtr,
                            std::atomic<uint64_t>* succ_cnt, std::atomic<uint64_t>* failed_cnt) {
     ::openmldb::api::LogEntry entry;
     for (const auto ptr : recordPtr) {
-        bool ok = entry.ParseFromString(*ptr);
+        PutRecord(path, table.get(), ::openmldb::base::Slice(*ptr), &entry, succ_cnt, failed_cnt);
         delete ptr;
-        if (!ok) {
-            failed_cnt->fetch_add(1, std::memory_order_relaxed);
-            continue;
-        }
-        auto scount = succ_cnt->fetch_add(1, std::memory_order_relaxed);
-        if (scount % 100000 == 0) {
-            PDLOG(INFO, "load snapshot %s with succ_cnt %lu, failed_cnt %lu", path.c_str(), scount,
-                  failed_cnt->load(std::memory_order_relaxed));
-        }
-        if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
-            table->Delete(entry);
-        } else {
-            table->Put(entry);
-        }
+    }
+}
+
+void MemTableSnapshot::PutRecord(const std::string& path, Table* table, const ::openmldb::base::Slice& record,
+                                 ::openmldb::api::LogEntry* entry, std::atomic<uint64_t>* succ_cnt,
+                                 std::atomic<uint64_t>* failed_cnt) {
+    if (!entry->ParseFromArray(record.data(), record.size())) {
+        failed_cnt->fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto scount = succ_cnt->fetch_add(1, std::memory_order_relaxed);
+    if (scount % 100000 == 0) {
+        PDLOG(INFO, "load snapshot %s with succ_cnt %lu, failed_cnt %lu", path.c_str(), scount,
+              failed_cnt->load(std::memory_order_relaxed));
+    }
+    if (entry->has_method_type() && entry->method_type() == ::openmldb::api::MethodType::kDelete) {
+        table->Delete(*entry);
+    } else {
+        table->Put(*entry);
     }
 }
 
@@ -612,6 +700,7 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
     }
     uint64_t collected_offset = CollectDeletedKey(end_offset);
     uint64_t start_time = ::baidu::common::timer::now_time();
+    uint64_t start_ms = ::baidu::common::timer::get_micros() / 1000;
     ::openmldb::api::Manifest manifest;
     bool has_error = false;
     snapshot_meta.term = term;
@@ -709,6 +798,7 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         }
     }
     wh->EndLog();
+    uint64_t snapshot_bytes = wh->GetSize();
     wh.reset();
     if (has_error) {
         unlink(snapshot_meta.tmp_file_path.c_str());
@@ -722,6 +812,10 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
             return -1;
         }
         uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
+        auto metrics = TableMetrics::Get(tid_, pid_);
+        *metrics->snapshot << ::baidu::common::timer::get_micros() / 1000 - start_ms;
+        *metrics->snapshot_records << snapshot_meta.count;
+        *metrics->snapshot_bytes << snapshot_bytes;
         PDLOG(INFO, "make snapshot[%s] success. update offset from %lu to %lu."
               "use %lu second. write key %lu expired key %lu deleted key %lu",
               snapshot_meta.snapshot_name.c_str(), old_offset, snapshot_meta.offset, consumed,
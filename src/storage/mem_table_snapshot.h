@@ -194,15 +194,26 @@ class MemTableSnapshot : public Snapshot {
 
     int Truncate(uint64_t offset, uint64_t term);
 
+    // decode the columns `cols` of the row in `entry`
+    static ::openmldb::base::Status DecodeData(const std::shared_ptr<Table>& table,
+            const openmldb::api::LogEntry& entry, const std::vector<uint32_t>& cols, std::vector<std::string>* row);
+
  private:
     // load single snapshot to table
     void RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table, std::atomic<uint64_t>* g_succ_cnt,
                                std::atomic<uint64_t>* g_failed_cnt);
 
-    uint64_t CollectDeletedKey(uint64_t end_offset);
+    // load the ranges of the uncompressed snapshot in all the load threads. The file is mapped to be shared by the
+    // threads, every record is still parsed and put into the table. Return false if the file can't be mapped,
+    // nothing is loaded then
+    bool RecoverSnapshotInParallel(const std::string& path, const std::shared_ptr<Table>& table,
+                               std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt);
 
-    ::openmldb::base::Status DecodeData(const std::shared_ptr<Table>& table, const openmldb::api::LogEntry& entry,
-            const std::vector<uint32_t>& cols, std::vector<std::string>* row);
+    void PutRecord(const std::string& path, Table* table, const ::openmldb::base::Slice& record,
+                   ::openmldb::api::LogEntry* entry, std::atomic<uint64_t>* succ_cnt,
+                   std::atomic<uint64_t>* failed_cnt);
+
+    uint64_t CollectDeletedKey(uint64_t end_offset);
 
     std::string GenSnapshotName();
 
@@ -55,6 +55,7 @@ void NodeCache::Clear() {
         node_it->Next();
     }
     value_node_list_.Clear();
+    size_.store(0, std::memory_order_relaxed);
 }
 
 
@@ -79,10 +80,12 @@ void NodeCache::Free(uint64_t version, StatisticsInfo* gc_info) {
         node1 = key_entry_node_list_.Split(version);
         node2 = value_node_list_.Split(version);
     }
+    uint64_t freed_cnt = 0;
     while (node1) {
         auto entry_node_list = node1->GetValue();
         for (auto& entry_node : *entry_node_list) {
             FreeKeyEntryNode(entry_node, gc_info);
+            freed_cnt++;
         }
         delete entry_node_list;
         auto tmp = node1;
@@ -97,12 +100,14 @@ void NodeCache::Free(uint64_t version, StatisticsInfo* gc_info) {
             } else {
                 FreeNodeList(node.idx, node.node, gc_info);
             }
+            freed_cnt++;
         }
         delete node_list;
         auto tmp = node2;
         node2 = node2->GetNextNoBarrier(0);
         delete tmp;
     }
+    size_.fetch_sub(freed_cnt, std::memory_order_relaxed);
     DLOG(INFO) << "free idx_byte_size " << gc_info->idx_byte_size - old.idx_byte_size;
     DLOG(INFO) << "free record_byte_size " << gc_info->record_byte_size - old.record_byte_size;
 }
@@ -17,6 +17,7 @@
 #ifndef SRC_STORAGE_NODE_CACHE_H_
 #define SRC_STORAGE_NODE_CACHE_H_
 
+#include <atomic>
 #include <forward_list>
 #include <memory>
 #include <mutex>
@@ -52,6 +53,9 @@ class NodeCache {
     void Free(uint64_t version, StatisticsInfo* gc_info);
     void Clear();
 
+    // the count of nodes waiting to be freed
+    uint64_t GetSize() const { return size_.load(std::memory_order_relaxed); }
+
     using KeyEntryNodeList =
       base::Skiplist<uint64_t, std::forward_list<base::Node<base::Slice, void*>*>*, TimeComparator>;
     using ValueNodeList =
@@ -67,6 +71,7 @@ class NodeCache {
             list->Insert(version, value_list);
          }
          value_list->push_front(node);
+         size_.fetch_add(1, std::memory_order_relaxed);
     }
 
     void FreeKeyEntryNode(base::Node<base::Slice, void*>* entry_node, StatisticsInfo* gc_info);
@@ -80,6 +85,7 @@ class NodeCache {
     std::mutex mutex_;
     KeyEntryNodeList key_entry_node_list_;
     ValueNodeList value_node_list_;
+    std::atomic<uint64_t> size_ = 0;
 };
 
 }  // namespace storage
@@ -19,6 +19,7 @@
 #include <snappy.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/glog_wrapper.h"
 #include "base/strings.h"
@@ -35,6 +36,14 @@ namespace storage {
 
 static const SliceComparator scmp;
 
+static uint64_t GetListSize(::openmldb::base::Node<uint64_t, DataBlock*>* node) {
+    uint64_t cnt = 0;
+    for (; node != nullptr; node = node->GetNextNoBarrier(0)) {
+        cnt++;
+    }
+    return cnt;
+}
+
 Segment::Segment(uint8_t height)
     : entries_(nullptr),
       mu_(),
@@ -47,6 +56,7 @@ Segment::Segment(uint8_t height)
       node_cache_(1, height) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     idx_cnt_vec_.push_back(std::make_shared<std::atomic<uint64_t>>(0));
+    keep_cnt_vec_.push_back(std::make_shared<std::atomic<uint64_t>>(0));
 }
 
 Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
@@ -63,6 +73,7 @@ Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
     for (uint32_t i = 0; i < ts_idx_vec.size(); i++) {
         ts_idx_map_[ts_idx_vec[i]] = i;
         idx_cnt_vec_.push_back(std::make_shared<std::atomic<uint64_t>>(0));
+        keep_cnt_vec_.push_back(std::make_shared<std::atomic<uint64_t>>(0));
     }
 }
 
@@ -120,13 +131,16 @@ void Segment::ReleaseAndCount(const std::vector<size_t>& id_vec, StatisticsInfo*
             KeyEntry** entry_arr = reinterpret_cast<KeyEntry**>(it->GetValue());
             for (auto pos : real_idx_vec) {
                 KeyEntry* entry = entry_arr[pos];
-                std::unique_ptr<TimeEntries::Iterator> ts_it(entry->entries.NewIterator());
-                ts_it->SeekToFirst();
-                if (ts_it->Valid()) {
-                    uint64_t ts = ts_it->GetKey();
-                    auto data_node = entry->entries.Split(ts);
-                    FreeList(pos, data_node, statistics_info);
+                ::openmldb::base::Node<uint64_t, DataBlock*>* data_node = nullptr;
+                {
+                    std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
+                    std::unique_ptr<TimeEntries::Iterator> ts_it(entry->entries.NewIterator());
+                    ts_it->SeekToFirst();
+                    if (ts_it->Valid()) {
+                        data_node = entry->entries.Split(ts_it->GetKey());
+                    }
                 }
+                FreeList(pos, data_node, statistics_info);
             }
         }
         it->Next();
@@ -147,64 +161,164 @@ bool Segment::Put(const Slice& key, uint64_t time, DataBlock* row, bool put_if_a
         LOG(ERROR) << "wrong call";
         return false;
     }
-    std::lock_guard<std::mutex> lock(mu_);
-    return PutUnlock(key, time, row, put_if_absent, check_all_time);
-}
-
-bool Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row, bool put_if_absent, bool check_all_time) {
-    void* entry = nullptr;
+    void* value = nullptr;
+    KeyEntry* entry = nullptr;
     uint32_t byte_size = 0;
-    // one key just one entry
-    int ret = entries_->Get(key, entry);
-    if (ret < 0 || entry == nullptr) {
-        char* pk = new char[key.size()];
-        memcpy(pk, key.data(), key.size());
-        // need to delete memory when free node
-        Slice skey(pk, key.size());
-        entry = reinterpret_cast<void*>(new KeyEntry(key_entry_max_height_));
-        uint8_t height = entries_->Insert(skey, entry);
-        byte_size += GetRecordPkIdxSize(height, key.size(), key_entry_max_height_);
-        pk_cnt_.fetch_add(1, std::memory_order_relaxed);
-        // no need to check if absent when first put
-    } else if (put_if_absent && ListContains(reinterpret_cast<KeyEntry*>(entry), time, row, check_all_time)) {
+    auto lock = LockKeyEntry(key, 0, &value, &entry, &byte_size);
+    if (put_if_absent && ListContains(entry, time, row, check_all_time)) {
+        idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         return false;
     }
-
+    uint8_t height = entry->entries.Insert(time, row);
+    entry->count_.fetch_add(1, std::memory_order_relaxed);
+    entry->accessed_.store(true, std::memory_order_relaxed);
+    uint8_t entry_height = entry->entries.GetMaxHeight();
+    auto evicted = EvictLatestUnlock(entry, 0);
+    lock.unlock();
+    AddEvicted(0, evicted);
+    if (metrics_ != nullptr) {
+        *metrics_->key_entry_height << entry_height;
+    }
     idx_cnt_vec_[0]->fetch_add(1, std::memory_order_relaxed);
-    uint8_t height = reinterpret_cast<KeyEntry*>(entry)->entries.Insert(time, row);
-    reinterpret_cast<KeyEntry*>(entry)->count_.fetch_add(1, std::memory_order_relaxed);
     byte_size += GetRecordTsIdxSize(height);
     idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
     return true;
 }
 
-void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
-    void* key_entry_or_list = nullptr;
-    uint32_t byte_size = 0;
-    std::lock_guard<std::mutex> lock(mu_);  // TODO(hw): need lock?
-    int ret = entries_->Get(key, key_entry_or_list);
-    if (ts_cnt_ == 1) {
-        PutUnlock(key, time, row);
+std::unique_lock<::openmldb::base::SpinMutex> Segment::LockKeyEntry(const Slice& key, uint32_t pos, void** value,
+                                                                    KeyEntry** entry, uint32_t* byte_size) {
+    while (true) {
+        // most puts go to existing keys, which are found without the segment lock
+        if (*value == nullptr && (entries_->Get(key, *value) < 0 || *value == nullptr)) {
+            auto lock = LockSegment();
+            *value = InsertKeyUnlock(key, byte_size);
+        }
+        *entry = ts_cnt_ > 1 ? reinterpret_cast<KeyEntry**>(*value)[pos] : reinterpret_cast<KeyEntry*>(*value);
+        std::unique_lock<::openmldb::base::SpinMutex> lock((*entry)->mu_);
+        if (!(*entry)->removed_) {
+            return lock;
+        }
+        // the key is removed by delete or gc after it was found, look it up again
+        *value = nullptr;
+    }
+}
+
+std::unique_lock<std::mutex> Segment::LockSegment() {
+    std::unique_lock<std::mutex> lock(mu_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        uint64_t start = ::baidu::common::timer::get_micros();
+        lock.lock();
+        if (metrics_ != nullptr) {
+            *metrics_->segment_lock_wait << ::baidu::common::timer::get_micros() - start;
+        }
+    }
+    return lock;
+}
+
+void* Segment::InsertKeyUnlock(const Slice& key, uint32_t* byte_size) {
+    void* value = nullptr;
+    // one key just one entry, it may be inserted by others after the lock free lookup
+    if (entries_->Get(key, value) == 0 && value != nullptr) {
+        return value;
+    }
+    char* pk = new char[key.size()];
+    memcpy(pk, key.data(), key.size());
+    // need to delete memory when free node
+    Slice skey(pk, key.size());
+    if (ts_cnt_ > 1) {
+        auto** entry_arr = new KeyEntry*[ts_cnt_];
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            entry_arr[i] = new KeyEntry(key_entry_max_height_);
+        }
+        value = reinterpret_cast<void*>(entry_arr);
+        uint8_t height = entries_->Insert(skey, value);
+        *byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
     } else {
-        if (ret < 0 || key_entry_or_list == nullptr) {
-            char* pk = new char[key.size()];
-            memcpy(pk, key.data(), key.size());
-            Slice skey(pk, key.size());
-            auto** entry_arr_tmp = new KeyEntry*[ts_cnt_];
-            for (uint32_t i = 0; i < ts_cnt_; i++) {
-                entry_arr_tmp[i] = new KeyEntry(key_entry_max_height_);
-            }
-            auto entry_arr = reinterpret_cast<void*>(entry_arr_tmp);
-            uint8_t height = entries_->Insert(skey, entry_arr);
-            byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
-            pk_cnt_.fetch_add(1, std::memory_order_relaxed);
+        value = reinterpret_cast<void*>(new KeyEntry(key_entry_max_height_));
+        uint8_t height = entries_->Insert(skey, value);
+        *byte_size += GetRecordPkIdxSize(height, key.size(), key_entry_max_height_);
+    }
+    pk_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return value;
+}
+
+::openmldb::base::Node<Slice, void*>* Segment::RemoveKeyIfEmpty(const Slice& key) {
+    auto lock = LockSegment();
+    void* value = nullptr;
+    if (entries_->Get(key, value) < 0 || value == nullptr) {
+        return nullptr;
+    }
+    auto entry_at = [this, value](uint32_t i) {
+        return ts_cnt_ > 1 ? reinterpret_cast<KeyEntry**>(value)[i] : reinterpret_cast<KeyEntry*>(value);
+    };
+    // the writers may append to the entries before they are locked
+    std::vector<std::unique_lock<::openmldb::base::SpinMutex>> entry_locks;
+    entry_locks.reserve(ts_cnt_);
+    for (uint32_t i = 0; i < ts_cnt_; i++) {
+        entry_locks.emplace_back(entry_at(i)->mu_);
+        if (!entry_at(i)->entries.IsEmpty()) {
+            return nullptr;
         }
-        uint8_t height = reinterpret_cast<KeyEntry**>(key_entry_or_list)[key_entry_id]->entries.Insert(time, row);
-        reinterpret_cast<KeyEntry**>(key_entry_or_list)[key_entry_id]->count_.fetch_add(1, std::memory_order_relaxed);
-        byte_size += GetRecordTsIdxSize(height);
-        idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
-        idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
     }
+    for (uint32_t i = 0; i < ts_cnt_; i++) {
+        entry_at(i)->removed_ = true;
+    }
+    return entries_->Remove(key);
+}
+
+::openmldb::base::Node<uint64_t, DataBlock*>* Segment::EvictLatestUnlock(KeyEntry* entry, uint32_t pos) {
+    uint64_t keep_cnt = keep_cnt_vec_[pos]->load(std::memory_order_relaxed);
+    if (keep_cnt == 0) {
+        return nullptr;
+    }
+    if (entry->count_.load(std::memory_order_relaxed) <= keep_cnt) {
+        return nullptr;
+    }
+    // split by position as gc does, the rows of the same ts are not told apart by key
+    auto evicted = entry->entries.SplitByPos(keep_cnt);
+    entry->count_.fetch_sub(GetListSize(evicted), std::memory_order_relaxed);
+    return evicted;
+}
+
+void Segment::AddEvicted(uint32_t pos, ::openmldb::base::Node<uint64_t, DataBlock*>* node) {
+    if (node != nullptr) {
+        node_cache_.AddValueNodeList(pos, gc_version_.load(std::memory_order_relaxed), node);
+    }
+}
+
+void Segment::SetLatestTTL(const std::map<uint32_t, TTLSt>& ttl_st_map) {
+    auto get_keep_cnt = [](const TTLSt& ttl_st) -> uint64_t {
+        return ttl_st.ttl_type == ::openmldb::storage::TTLType::kLatestTime ? ttl_st.lat_ttl : 0;
+    };
+    if (ts_idx_map_.empty()) {
+        uint64_t keep_cnt = ttl_st_map.size() == 1 ? get_keep_cnt(ttl_st_map.begin()->second) : 0;
+        keep_cnt_vec_[0]->store(keep_cnt, std::memory_order_relaxed);
+        return;
+    }
+    for (const auto& kv : ts_idx_map_) {
+        auto iter = ttl_st_map.find(kv.first);
+        uint64_t keep_cnt = iter == ttl_st_map.end() ? 0 : get_keep_cnt(iter->second);
+        keep_cnt_vec_[kv.second]->store(keep_cnt, std::memory_order_relaxed);
+    }
+}
+
+void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
+    if (ts_cnt_ == 1) {
+        Put(key, time, row);
+        return;
+    }
+    void* value = nullptr;
+    KeyEntry* entry = nullptr;
+    uint32_t byte_size = 0;
+    auto lock = LockKeyEntry(key, key_entry_id, &value, &entry, &byte_size);
+    uint8_t height = entry->entries.Insert(time, row);
+    entry->count_.fetch_add(1, std::memory_order_relaxed);
+    auto evicted = EvictLatestUnlock(entry, key_entry_id);
+    lock.unlock();
+    AddEvicted(key_entry_id, evicted);
+    byte_size += GetRecordTsIdxSize(height);
+    idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
 }
 
 bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row, bool put_if_absent) {
@@ -220,35 +334,28 @@ bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
         return ret;
     }
     void* entry_arr = nullptr;
-    std::lock_guard<std::mutex> lock(mu_);
     for (const auto& kv : ts_map) {
         uint32_t byte_size = 0;
         auto pos = ts_idx_map_.find(kv.first);
         if (pos == ts_idx_map_.end()) {
             continue;
         }
-        if (entry_arr == nullptr) {
-            int ret = entries_->Get(key, entry_arr);
-            if (ret < 0 || entry_arr == nullptr) {
-                char* pk = new char[key.size()];
-                memcpy(pk, key.data(), key.size());
-                Slice skey(pk, key.size());
-                KeyEntry** entry_arr_tmp = new KeyEntry*[ts_cnt_];
-                for (uint32_t i = 0; i < ts_cnt_; i++) {
-                    entry_arr_tmp[i] = new KeyEntry(key_entry_max_height_);
-                }
-                entry_arr = reinterpret_cast<void*>(entry_arr_tmp);
-                uint8_t height = entries_->Insert(skey, entry_arr);
-                byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
-                pk_cnt_.fetch_add(1, std::memory_order_relaxed);
-            }
-        }
-        auto entry = reinterpret_cast<KeyEntry**>(entry_arr)[pos->second];
+        KeyEntry* entry = nullptr;
+        auto lock = LockKeyEntry(key, pos->second, &entry_arr, &entry, &byte_size);
         if (put_if_absent && ListContains(entry, kv.second, row, pos->first == DEFAULT_TS_COL_ID)) {
+            idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
             return false;
         }
         uint8_t height = entry->entries.Insert(kv.second, row);
         entry->count_.fetch_add(1, std::memory_order_relaxed);
+        entry->accessed_.store(true, std::memory_order_relaxed);
+        uint8_t entry_height = entry->entries.GetMaxHeight();
+        auto evicted = EvictLatestUnlock(entry, pos->second);
+        lock.unlock();
+        AddEvicted(pos->second, evicted);
+        if (metrics_ != nullptr) {
+            *metrics_->key_entry_height << entry_height;
+        }
         byte_size += GetRecordTsIdxSize(height);
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[pos->second]->fetch_add(1, std::memory_order_relaxed);
@@ -263,8 +370,14 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key) {
         }
         ::openmldb::base::Node<Slice, void*>* entry_node = nullptr;
         {
-            std::lock_guard<std::mutex> lock(mu_);
-            entry_node = entries_->Remove(key);
+            auto lock = LockSegment();
+            void* entry = nullptr;
+            if (entries_->Get(key, entry) == 0 && entry != nullptr) {
+                auto key_entry = reinterpret_cast<KeyEntry*>(entry);
+                std::lock_guard<::openmldb::base::SpinMutex> entry_lock(key_entry->mu_);
+                key_entry->removed_ = true;
+                entry_node = entries_->Remove(key);
+            }
         }
         if (entry_node != nullptr) {
             node_cache_.AddKeyEntryNode(gc_version_.load(std::memory_order_relaxed), entry_node);
@@ -279,18 +392,19 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key) {
             return false;
         }
         base::Node<uint64_t, DataBlock*>* data_node = nullptr;
+        void* entry_arr = nullptr;
+        if (entries_->Get(key, entry_arr) < 0 || entry_arr == nullptr) {
+            return true;
+        }
+        KeyEntry* key_entry = reinterpret_cast<KeyEntry**>(entry_arr)[iter->second];
         {
-            std::lock_guard<std::mutex> lock(mu_);
-            void* entry_arr = nullptr;
-            if (entries_->Get(key, entry_arr) < 0 || entry_arr == nullptr) {
-                return true;
-            }
-            KeyEntry* key_entry = reinterpret_cast<KeyEntry**>(entry_arr)[iter->second];
+            std::lock_guard<::openmldb::base::SpinMutex> lock(key_entry->mu_);
             std::unique_ptr<TimeEntries::Iterator> it(key_entry->entries.NewIterator());
             it->SeekToFirst();
             if (it->Valid()) {
                 uint64_t ts = it->GetKey();
                 data_node = key_entry->entries.Split(ts);
+                key_entry->count_.fetch_sub(GetListSize(data_node), std::memory_order_relaxed);
             }
         }
         if (data_node != nullptr) {
@@ -335,20 +449,26 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key, uint6
                 it->Next();
                 base::Node<uint64_t, DataBlock*>* data_node = nullptr;
                 if (cur_ts <= ts && cur_ts > end_ts.value()) {
-                    std::lock_guard<std::mutex> lock(mu_);
+                    std::lock_guard<::openmldb::base::SpinMutex> lock(key_entry->mu_);
                     data_node = key_entry->entries.Remove(cur_ts);
+                    if (data_node != nullptr) {
+                        key_entry->count_.fetch_sub(1, std::memory_order_relaxed);
+                    }
                 } else {
                     return true;
                 }
-                node_cache_.AddSingleValueNode(ts_idx, gc_version_.load(std::memory_order_relaxed), data_node);
+                if (data_node != nullptr) {
+                    node_cache_.AddSingleValueNode(ts_idx, gc_version_.load(std::memory_order_relaxed), data_node);
+                }
             }
             return true;
         }
     }
     base::Node<uint64_t, DataBlock*>* data_node = nullptr;
     {
-        std::lock_guard<std::mutex> lock(mu_);
+        std::lock_guard<::openmldb::base::SpinMutex> lock(key_entry->mu_);
         data_node = key_entry->entries.Split(ts);
+        key_entry->count_.fetch_sub(GetListSize(data_node), std::memory_order_relaxed);
         DLOG(INFO) << "entry " << key.ToString() << " split by " << ts;
     }
     if (data_node != nullptr) {
@@ -463,16 +583,21 @@ void Segment::Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info) {
     it->SeekToFirst();
     while (it->Valid()) {
         auto entry = reinterpret_cast<KeyEntry*>(it->GetValue());
+        // the keys are mostly trimmed by put already
+        if (entry->count_.load(std::memory_order_relaxed) <= keep_cnt) {
+            it->Next();
+            continue;
+        }
         ::openmldb::base::Node<uint64_t, DataBlock*>* node = nullptr;
         {
-            std::lock_guard<std::mutex> lock(mu_);
+            std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
             if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                 node = entry->entries.SplitByPos(keep_cnt);
+                // count in the lock, the put evicts rows by the count
+                entry->count_.fetch_sub(GetListSize(node), std::memory_order_relaxed);
             }
         }
-        uint64_t cur_idx_cnt = statistics_info->GetIdxCnt(0);
         FreeList(0, node, statistics_info);
-        entry->count_.fetch_sub(statistics_info->GetIdxCnt(0) - cur_idx_cnt, std::memory_order_relaxed);
         it->Next();
     }
     DEBUGLOG("[Gc4Head] segment gc keep cnt %lu consumed %lu, count %lu", keep_cnt,
@@ -501,6 +626,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
             KeyEntry* entry = entry_arr[pos->second];
             ::openmldb::base::Node<uint64_t, DataBlock*>* node = nullptr;
             bool continue_flag = false;
+            bool counted = false;
             switch (kv.second.ttl_type) {
                 case ::openmldb::storage::TTLType::kAbsoluteTime: {
                     node = entry->entries.GetLast();
@@ -508,7 +634,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
                         continue_flag = true;
                     } else {
                         node = nullptr;
-                        std::lock_guard<std::mutex> lock(mu_);
+                        std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
                         SplitList(entry, kv.second.abs_ttl, &node);
                         if (entry->entries.IsEmpty()) {
                             DLOG(INFO) << "gc key " << key.ToString() << " is empty";
@@ -518,9 +644,16 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
                     break;
                 }
                 case ::openmldb::storage::TTLType::kLatestTime: {
-                    std::lock_guard<std::mutex> lock(mu_);
+                    if (entry->count_.load(std::memory_order_relaxed) <= kv.second.lat_ttl) {
+                        continue_flag = true;
+                        break;
+                    }
+                    std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
                     if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                         node = entry->entries.SplitByPos(kv.second.lat_ttl);
+                        // count in the lock, the put evicts rows by the count
+                        entry->count_.fetch_sub(GetListSize(node), std::memory_order_relaxed);
+                        counted = true;
                     }
                     break;
                 }
@@ -530,7 +663,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
                         continue_flag = true;
                     } else {
                         node = nullptr;
-                        std::lock_guard<std::mutex> lock(mu_);
+                        std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
                         if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                             node = entry->entries.SplitByKeyAndPos(kv.second.abs_ttl, kv.second.lat_ttl);
                         }
@@ -543,7 +676,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
                         continue_flag = true;
                     } else {
                         node = nullptr;
-                        std::lock_guard<std::mutex> lock(mu_);
+                        std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
                         if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                             if (kv.second.abs_ttl == 0) {
                                 node = entry->entries.SplitByPos(kv.second.lat_ttl);
@@ -568,24 +701,13 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
             uint64_t cur_idx_cnt = statistics_info->GetIdxCnt(pos->second);
             FreeList(pos->second, node, statistics_info);
             uint64_t free_idx_cnt = statistics_info->GetIdxCnt(pos->second) - cur_idx_cnt;
-            entry->count_.fetch_sub(free_idx_cnt, std::memory_order_relaxed);
+            if (!counted) {
+                entry->count_.fetch_sub(free_idx_cnt, std::memory_order_relaxed);
+            }
             idx_cnt_vec_[pos->second]->fetch_sub(free_idx_cnt, std::memory_order_relaxed);
         }
         if (empty_cnt == ts_cnt_) {
-            bool is_empty = true;
-            ::openmldb::base::Node<Slice, void*>* entry_node = nullptr;
-            {
-                std::lock_guard<std::mutex> lock(mu_);
-                for (uint32_t i = 0; i < ts_cnt_; i++) {
-                    if (!entry_arr[i]->entries.IsEmpty()) {
-                        is_empty = false;
-                        break;
-                    }
-                }
-                if (is_empty) {
-                    entry_node = entries_->Remove(key);
-                }
-            }
+            auto entry_node = RemoveKeyIfEmpty(key);
             if (entry_node != nullptr) {
                 node_cache_.AddKeyEntryNode(gc_version_.load(std::memory_order_relaxed), entry_node);
             }
@@ -650,12 +772,14 @@ void Segment::Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info) {
         }
         node = nullptr;
         ::openmldb::base::Node<Slice, void*>* entry_node = nullptr;
+        bool is_empty = false;
         {
-            std::lock_guard<std::mutex> lock(mu_);
+            std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
             SplitList(entry, time, &node);
-            if (entry->entries.IsEmpty()) {
-                entry_node = entries_->Remove(key);
-            }
+            is_empty = entry->entries.IsEmpty();
+        }
+        if (is_empty) {
+            entry_node = RemoveKeyIfEmpty(key);
         }
         if (entry_node != nullptr) {
             DLOG(INFO) << "add key " << key.ToString() << " to node cache. version " << gc_version_;
@@ -691,7 +815,7 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, Statis
         }
         node = nullptr;
         {
-            std::lock_guard<std::mutex> lock(mu_);
+            std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
             if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                 node = entry->entries.SplitByKeyAndPos(time, keep_cnt);
             }
@@ -730,14 +854,16 @@ void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, Statist
         }
         node = nullptr;
         ::openmldb::base::Node<Slice, void*>* entry_node = nullptr;
+        bool is_empty = false;
         {
-            std::lock_guard<std::mutex> lock(mu_);
+            std::lock_guard<::openmldb::base::SpinMutex> lock(entry->mu_);
             if (entry->refs_.load(std::memory_order_acquire) <= 0) {
                 node = entry->entries.SplitByKeyOrPos(time, keep_cnt);
             }
-            if (entry->entries.IsEmpty()) {
-                entry_node = entries_->Remove(key);
-            }
+            is_empty = entry->entries.IsEmpty();
+        }
+        if (is_empty) {
+            entry_node = RemoveKeyIfEmpty(key);
         }
         if (entry_node != nullptr) {
             node_cache_.AddKeyEntryNode(gc_version_.load(std::memory_order_relaxed), entry_node);
@@ -779,6 +905,113 @@ int Segment::GetCount(const Slice& key, uint32_t idx, uint64_t& count) {
     return 0;
 }
 
+void Segment::Touch(const Slice& key) {
+    void* value = nullptr;
+    if (entries_->Get(key, value) < 0 || value == nullptr) {
+        return;
+    }
+    KeyEntry* entry = ts_cnt_ > 1 ? reinterpret_cast<KeyEntry**>(value)[0] : reinterpret_cast<KeyEntry*>(value);
+    entry->accessed_.store(true);
+}
+
+void Segment::CollectColdKeys(uint64_t max_bytes, std::vector<std::string>* keys) {
+    std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
+    std::string start = clock_hand_;
+    if (start.empty()) {
+        it->SeekToFirst();
+    } else {
+        it->Seek(Slice(start));
+    }
+    uint64_t bytes = 0;
+    bool wrapped = false;
+    while (bytes < max_bytes) {
+        if (!it->Valid()) {
+            if (wrapped || start.empty()) {
+                break;
+            }
+            wrapped = true;
+            it->SeekToFirst();
+            continue;
+        }
+        Slice key = it->GetKey();
+        // a whole round is walked
+        if (wrapped && key.compare(Slice(start)) >= 0) {
+            break;
+        }
+        void* value = it->GetValue();
+        bool accessed = false;
+        uint64_t size = 0;
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            KeyEntry* entry = ts_cnt_ > 1 ? reinterpret_cast<KeyEntry**>(value)[i] : reinterpret_cast<KeyEntry*>(value);
+            if (entry->accessed_.exchange(false, std::memory_order_relaxed)) {
+                accessed = true;
+            }
+            if (i == 0) {
+                std::unique_ptr<TimeEntries::Iterator> ts_it(entry->entries.NewIterator());
+                for (ts_it->SeekToFirst(); ts_it->Valid(); ts_it->Next()) {
+                    size += ts_it->GetValue()->size;
+                }
+            }
+        }
+        if (!accessed && size > 0) {
+            keys->push_back(key.ToString());
+            bytes += size;
+        }
+        it->Next();
+    }
+    clock_hand_ = it->Valid() ? it->GetKey().ToString() : std::string();
+}
+
+uint64_t Segment::SpillKey(const Slice& key, const SpilledRowSink& sink) {
+    std::vector<uint32_t> ts_cols(ts_cnt_, 0);
+    for (const auto& kv : ts_idx_map_) {
+        ts_cols[kv.second] = kv.first;
+    }
+    ::openmldb::base::Node<Slice, void*>* entry_node = nullptr;
+    uint64_t bytes = 0;
+    {
+        auto lock = LockSegment();
+        void* value = nullptr;
+        if (entries_->Get(key, value) < 0 || value == nullptr) {
+            return 0;
+        }
+        auto entry_at = [this, value](uint32_t i) {
+            return ts_cnt_ > 1 ? reinterpret_cast<KeyEntry**>(value)[i] : reinterpret_cast<KeyEntry*>(value);
+        };
+        std::vector<std::unique_lock<::openmldb::base::SpinMutex>> entry_locks;
+        entry_locks.reserve(ts_cnt_);
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            entry_locks.emplace_back(entry_at(i)->mu_);
+        }
+        // pairs with the store of Touch, the reader sees the key in the cold tier if it's not seen accessed here
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            if (entry_at(i)->accessed_.load()) {
+                return 0;
+            }
+        }
+        std::vector<SpilledRow> rows;
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            std::unique_ptr<TimeEntries::Iterator> it(entry_at(i)->entries.NewIterator());
+            for (it->SeekToFirst(); it->Valid(); it->Next()) {
+                const DataBlock* block = it->GetValue();
+                rows.push_back({ts_cols[i], it->GetKey(), std::string(block->data, block->size)});
+                bytes += block->size;
+            }
+        }
+        if (rows.empty() || !sink(rows)) {
+            return 0;
+        }
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            entry_at(i)->removed_ = true;
+        }
+        entry_node = entries_->Remove(key);
+    }
+    if (entry_node != nullptr) {
+        node_cache_.AddKeyEntryNode(gc_version_.load(std::memory_order_relaxed), entry_node);
+    }
+    return bytes;
+}
+
 MemTableIterator* Segment::NewIterator(const Slice& key, Ticket& ticket, type::CompressType compress_type) {
     if (entries_ == nullptr || ts_cnt_ > 1) {
         return new MemTableIterator(nullptr, compress_type);
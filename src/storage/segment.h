@@ -18,6 +18,7 @@
 #define SRC_STORAGE_SEGMENT_H_
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -32,6 +33,7 @@
 #include "storage/key_entry.h"
 #include "storage/node_cache.h"
 #include "storage/schema.h"
+#include "storage/table_metrics.h"
 #include "storage/ticket.h"
 
 namespace openmldb {
@@ -64,6 +66,14 @@ struct SliceComparator {
 using KeyEntries = base::Skiplist<base::Slice, void*, SliceComparator>;
 using KeyEntryNodeList = base::Skiplist<uint64_t, base::Node<Slice, void*>*, TimeComparator>;
 
+// a row moved out of the segment by the spill to the cold tier, `ts_col` is the ts column id of its entry
+struct SpilledRow {
+    uint32_t ts_col;
+    uint64_t ts;
+    std::string value;
+};
+using SpilledRowSink = std::function<bool(const std::vector<SpilledRow>&)>;
+
 class Segment {
  public:
     explicit Segment(uint8_t height);
@@ -141,17 +151,53 @@ class Segment {
 
     void ReleaseAndCount(const std::vector<size_t>& id_vec, StatisticsInfo* statistics_info);
 
+    // the nodes removed by gc or delete which are not freed yet
+    uint64_t GetNodeCacheSize() const { return node_cache_.GetSize(); }
+
+    // the metrics are owned by the table and must outlive the segment
+    void SetMetrics(TableMetrics* metrics) { metrics_ = metrics; }
+
+    // the ttl of the indexes keyed by ts column id. The rows of a key over the count of a kLatestTime ttl are removed
+    // on put, so the gc needs not to walk the keys which are not over it
+    void SetLatestTTL(const std::map<uint32_t, TTLSt>& ttl_st_map);
+
+    // set the CLOCK bit of the key if it's in the segment. The store is sequentially consistent, it's ordered before
+    // the cold tier lookup of the reader, see ColdTier::Spill
+    void Touch(const Slice& key);
+
+    // the CLOCK sweep of the spill, it's run by the gc thread only. Walk the keys from where the last sweep stopped,
+    // clear the bits of the accessed keys and collect the others until the size of their rows reaches `max_bytes`
+    void CollectColdKeys(uint64_t max_bytes, std::vector<std::string>* keys);
+
+    // remove the key if it's not accessed since the sweep, `sink` persists the rows of the key before it's removed
+    // and the key is kept if it fails. Return the size of the spilled rows, 0 if the key is not spilled
+    uint64_t SpillKey(const Slice& key, const SpilledRowSink& sink);
+
  private:
     void FreeList(uint32_t ts_idx, ::openmldb::base::Node<uint64_t, DataBlock*>* node, StatisticsInfo* statistics_info);
     void SplitList(KeyEntry* entry, uint64_t ts, ::openmldb::base::Node<uint64_t, DataBlock*>** node);
 
     bool ListContains(KeyEntry* entry, uint64_t time, DataBlock* row, bool check_all_time);
 
-    bool PutUnlock(const Slice& key, uint64_t time, DataBlock* row, bool put_if_absent = false,
-                   bool check_all_time = false);
+    // return the entry of the key at ts position `pos` with the entry locked, the key is inserted if absent.
+    // `value` caches the value of the key node between the calls for the same key
+    std::unique_lock<::openmldb::base::SpinMutex> LockKeyEntry(const Slice& key, uint32_t pos, void** value,
+                                                               KeyEntry** entry, uint32_t* byte_size);
+    // lock mu_ and record the wait time if it's contended
+    std::unique_lock<std::mutex> LockSegment();
+    // mu_ must be held
+    void* InsertKeyUnlock(const Slice& key, uint32_t* byte_size);
+    // remove the key if the entries of all ts are empty, return the removed node
+    ::openmldb::base::Node<Slice, void*>* RemoveKeyIfEmpty(const Slice& key);
+    // remove the oldest rows of the entry at ts position `pos` over the latest ttl, the entry must be locked.
+    // Return the removed nodes linked by level 0, they are freed by the node cache as readers may be on them
+    ::openmldb::base::Node<uint64_t, DataBlock*>* EvictLatestUnlock(KeyEntry* entry, uint32_t pos);
+    void AddEvicted(uint32_t pos, ::openmldb::base::Node<uint64_t, DataBlock*>* node);
 
  private:
     KeyEntries* entries_;
+    // guards the insert and remove of keys, the time entries of a key are guarded by KeyEntry::mu_.
+    // The lock order is mu_ then KeyEntry::mu_
     std::mutex mu_;
     std::atomic<uint64_t> idx_byte_size_;
     std::atomic<uint64_t> pk_cnt_;
@@ -160,8 +206,13 @@ class Segment {
     std::atomic<uint64_t> gc_version_;
     std::map<uint32_t, uint32_t> ts_idx_map_;
     std::vector<std::shared_ptr<std::atomic<uint64_t>>> idx_cnt_vec_;
+    // the row count kept for each key by the latest ttl of each ts position, 0 means unlimited
+    std::vector<std::shared_ptr<std::atomic<uint64_t>>> keep_cnt_vec_;
     uint64_t ttl_offset_;
     NodeCache node_cache_;
+    TableMetrics* metrics_ = nullptr;
+    // the key where the last CLOCK sweep stopped
+    std::string clock_hand_;
 };
 
 }  // namespace storage
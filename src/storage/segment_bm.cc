@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/hash.h"
+#include "benchmark/benchmark.h"
+#include "storage/record.h"
+#include "storage/segment.h"
+
+namespace openmldb {
+namespace storage {
+
+// the same seed as MemTable, so keys are sharded to segments the same way
+static const uint32_t SEED = 0xe17a1465;
+static const uint32_t KEY_NUM = 100000;
+
+static std::vector<std::unique_ptr<Segment>> segments;
+static std::vector<std::string> keys;
+
+// run by thread 0 only, the other threads wait for it at the start and the end of the benchmark loop
+static void SetupSegments(const benchmark::State& state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+        segments.emplace_back(std::make_unique<Segment>(8));
+    }
+    if (keys.empty()) {
+        for (uint32_t i = 0; i < KEY_NUM; i++) {
+            keys.push_back("key" + std::to_string(i));
+        }
+    }
+}
+
+static void TeardownSegments() {
+    StatisticsInfo statistics_info(1);
+    for (auto& segment : segments) {
+        segment->Release(&statistics_info);
+    }
+    segments.clear();
+}
+
+// all threads put to the segments of one index, `seg_cnt` is the number of segments the keys are sharded to
+static void BM_SegmentPut(benchmark::State& state) {  // NOLINT
+    const std::string value(128, 'v');
+    uint64_t ts = 1;
+    // threads start from different keys, and meet on the same keys later
+    uint64_t pos = state.thread_index * (KEY_NUM / state.threads);
+    if (state.thread_index == 0) {
+        SetupSegments(state);
+    }
+    for (auto _ : state) {
+        const std::string& key = keys[pos++ % KEY_NUM];
+        uint32_t idx = segments.size() > 1 ? base::hash(key.data(), key.size(), SEED) % segments.size() : 0;
+        segments[idx]->Put(Slice(key), ts++, value.data(), value.size());
+    }
+    if (state.thread_index == 0) {
+        TeardownSegments();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SegmentPut)
+    ->ArgName("seg_cnt")
+    ->Arg(1)
+    ->Arg(8)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+// a few hot keys, the writers of the same key are serialized
+static void BM_SegmentPutHotKey(benchmark::State& state) {  // NOLINT
+    const std::string value(128, 'v');
+    uint64_t ts = 1;
+    uint64_t pos = state.thread_index;
+    if (state.thread_index == 0) {
+        SetupSegments(state);
+    }
+    for (auto _ : state) {
+        const std::string& key = keys[pos++ % 16];
+        segments[0]->Put(Slice(key), ts++, value.data(), value.size());
+    }
+    if (state.thread_index == 0) {
+        TeardownSegments();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SegmentPutHotKey)->Arg(1)->ThreadRange(1, 32)->UseRealTime();
+
+}  // namespace storage
+}  // namespace openmldb
+
+BENCHMARK_MAIN();
@@ -16,8 +16,11 @@
 
 #include "storage/segment.h"
 
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "base/glog_wrapper.h"
@@ -500,6 +503,189 @@ TEST_F(SegmentTest, PutIfAbsent) {
     }
 }
 
+TEST_F(SegmentTest, ConcurrentPutAndGc) {
+    Segment segment(8);
+    const int key_num = 50;
+    const int thread_num = 8;
+    const int put_per_key = 100;
+    // the old records are expired by gc while the writers put new ones, so the keys are removed and inserted again
+    for (int i = 0; i < key_num; i++) {
+        std::string key = "key" + std::to_string(i);
+        for (int ts = 1; ts <= 10; ts++) {
+            segment.Put(Slice(key), ts, "old", 3);
+        }
+    }
+    std::atomic<bool> done{false};
+    StatisticsInfo gc_info(1);
+    std::thread gc_thread([&] {
+        while (!done.load()) {
+            segment.Gc4TTL(100, &gc_info);
+        }
+        segment.Gc4TTL(100, &gc_info);
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < thread_num; t++) {
+        writers.emplace_back([&segment, t] {
+            for (int n = 0; n < put_per_key; n++) {
+                for (int i = 0; i < key_num; i++) {
+                    std::string key = "key" + std::to_string(i);
+                    segment.Put(Slice(key), 1000 + t * put_per_key + n, "new", 3);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    gc_thread.join();
+
+    ASSERT_EQ(key_num * 10, static_cast<int>(gc_info.GetIdxCnt(0)));
+    ASSERT_EQ(key_num * thread_num * put_per_key, static_cast<int>(segment.GetIdxCnt()));
+    for (int i = 0; i < key_num; i++) {
+        std::string key = "key" + std::to_string(i);
+        uint64_t count = 0;
+        ASSERT_EQ(0, segment.GetCount(Slice(key), count));
+        ASSERT_EQ(thread_num * put_per_key, static_cast<int>(count));
+        Ticket ticket;
+        std::unique_ptr<MemTableIterator> it(segment.NewIterator(Slice(key), ticket, type::CompressType::kNoCompress));
+        it->SeekToFirst();
+        int scanned = 0;
+        while (it->Valid()) {
+            ASSERT_GE(it->GetKey(), 1000u);
+            scanned++;
+            it->Next();
+        }
+        ASSERT_EQ(thread_num * put_per_key, scanned);
+    }
+}
+
+TEST_F(SegmentTest, ConcurrentPutMultiTs) {
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    Segment segment(8, ts_idx_vec);
+    const int key_num = 20;
+    const int thread_num = 8;
+    const int put_per_key = 50;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < thread_num; t++) {
+        writers.emplace_back([&segment, t] {
+            for (int n = 0; n < put_per_key; n++) {
+                for (int i = 0; i < key_num; i++) {
+                    std::string key = "key" + std::to_string(i);
+                    uint64_t ts = 1000 + t * put_per_key + n;
+                    std::map<int32_t, uint64_t> ts_map = {{1, ts}, {3, ts + 1}};
+                    segment.Put(Slice(key), ts_map, new DataBlock(2, "value", 5));
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    ASSERT_EQ(key_num, static_cast<int>(segment.GetPkCnt()));
+    ASSERT_EQ(key_num * thread_num * put_per_key, GetCount(&segment, 1));
+    ASSERT_EQ(key_num * thread_num * put_per_key, GetCount(&segment, 3));
+    StatisticsInfo gc_info(2);
+    segment.Release(&gc_info);
+}
+
+TEST_F(SegmentTest, EvictLatest) {
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    Segment segment(8, ts_idx_vec);
+    std::map<uint32_t, TTLSt> ttl_st_map = {{1, TTLSt(0, 2, TTLType::kLatestTime)},
+                                            {3, TTLSt(0, 0, TTLType::kAbsoluteTime)}};
+    segment.SetLatestTTL(ttl_st_map);
+    Slice pk("pk");
+    for (int i = 0; i < 5; i++) {
+        std::map<int32_t, uint64_t> ts_map = {{1, 1000 + i}, {3, 1000 + i}};
+        ASSERT_TRUE(segment.Put(pk, ts_map, new DataBlock(2, "value", 5)));
+    }
+    uint64_t count = 0;
+    ASSERT_EQ(0, segment.GetCount(pk, 1, count));
+    ASSERT_EQ(2u, count);
+    ASSERT_EQ(2, GetCount(&segment, 1));
+    ASSERT_EQ(0, segment.GetCount(pk, 3, count));
+    ASSERT_EQ(5u, count);
+    ASSERT_EQ(5, GetCount(&segment, 3));
+    Ticket ticket;
+    std::unique_ptr<MemTableIterator> it(segment.NewIterator(pk, 1, ticket, type::CompressType::kNoCompress));
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(1004u, it->GetKey());
+    it->Next();
+    ASSERT_EQ(1003u, it->GetKey());
+    it->Next();
+    ASSERT_FALSE(it->Valid());
+
+    // the gc has nothing to cut, the removed rows are freed a version later
+    StatisticsInfo gc_info(2);
+    segment.ExecuteGc(ttl_st_map, &gc_info);
+    ASSERT_EQ(0u, gc_info.GetTotalCnt());
+    segment.IncrGcVersion();
+    segment.IncrGcVersion();
+    segment.GcFreeList(&gc_info);
+    ASSERT_EQ(3u, gc_info.GetIdxCnt(0));
+    ASSERT_EQ(0u, gc_info.GetIdxCnt(1));
+    // the rows are still referred by ts 3
+    ASSERT_EQ(0u, gc_info.record_byte_size);
+
+    // deleted rows are not counted, no row is removed by mistake
+    ASSERT_TRUE(segment.Delete(1, pk, 1003, std::nullopt));
+    ASSERT_EQ(0, segment.GetCount(pk, 1, count));
+    ASSERT_EQ(1u, count);
+    std::map<int32_t, uint64_t> ts_map = {{1, 1005}, {3, 1005}};
+    ASSERT_TRUE(segment.Put(pk, ts_map, new DataBlock(2, "value", 5)));
+    ASSERT_EQ(2, GetCount(&segment, 1));
+
+    // the ttl is lowered
+    ttl_st_map[1].lat_ttl = 1;
+    segment.SetLatestTTL(ttl_st_map);
+    ts_map = {{1, 1006}, {3, 1006}};
+    ASSERT_TRUE(segment.Put(pk, ts_map, new DataBlock(2, "value", 5)));
+    ASSERT_EQ(0, segment.GetCount(pk, 1, count));
+    ASSERT_EQ(1u, count);
+    ASSERT_EQ(1, GetCount(&segment, 1));
+    ASSERT_EQ(7, GetCount(&segment, 3));
+    segment.Release(&gc_info);
+}
+
+TEST_F(SegmentTest, EvictLatestSameTs) {
+    Segment segment(8);
+    std::map<uint32_t, TTLSt> ttl_st_map = {{0, TTLSt(0, 2, TTLType::kLatestTime)}};
+    segment.SetLatestTTL(ttl_st_map);
+    Slice pk("pk");
+    segment.Put(pk, 1000, "test1", 5);
+    segment.Put(pk, 1000, "test2", 5);
+    // the rows of the tail ts are evicted from the oldest one, the newest put is kept
+    segment.Put(pk, 1000, "test3", 5);
+    segment.Put(pk, 999, "test4", 5);
+    uint64_t count = 0;
+    ASSERT_EQ(0, segment.GetCount(pk, count));
+    ASSERT_EQ(2u, count);
+    Ticket ticket;
+    std::unique_ptr<MemTableIterator> it(segment.NewIterator(pk, ticket, type::CompressType::kNoCompress));
+    it->SeekToFirst();
+    std::vector<std::string> values;
+    while (it->Valid()) {
+        ASSERT_EQ(1000u, it->GetKey());
+        values.emplace_back(it->GetValue().data(), it->GetValue().size());
+        it->Next();
+    }
+    ASSERT_EQ(std::vector<std::string>({"test3", "test2"}), values);
+
+    ttl_st_map[0].lat_ttl = 1;
+    segment.SetLatestTTL(ttl_st_map);
+    segment.Put(pk, 1000, "test5", 5);
+    it.reset(segment.NewIterator(pk, ticket, type::CompressType::kNoCompress));
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("test5", std::string(it->GetValue().data(), it->GetValue().size()));
+    it->Next();
+    ASSERT_FALSE(it->Valid());
+    StatisticsInfo gc_info(1);
+    segment.Release(&gc_info);
+}
+
 }  // namespace storage
 }  // namespace openmldb
 
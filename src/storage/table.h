@@ -39,6 +39,8 @@ using Schema = google::protobuf::RepeatedPtrField<openmldb::common::ColumnDesc>;
 
 enum TableStat { kUndefined = 0, kNormal, kLoading, kMakingSnapshot, kSnapshotPaused };
 
+class AggrWatermark;
+
 class Table {
  public:
     Table();
@@ -173,6 +175,16 @@ class Table {
 
     virtual int GetCount(uint32_t index, const std::string& pk, uint64_t& count) = 0;  // NOLINT
 
+    // set on a pre-aggr table whose aggregator applies the rows asynchronously, the queries skip the buckets after
+    // the watermark of a key
+    void SetAggrWatermark(const std::shared_ptr<AggrWatermark>& watermark) {
+        std::atomic_store_explicit(&aggr_watermark_, watermark, std::memory_order_release);
+    }
+
+    std::shared_ptr<AggrWatermark> GetAggrWatermark() {
+        return std::atomic_load_explicit(&aggr_watermark_, std::memory_order_acquire);
+    }
+
  protected:
     void UpdateTTL();
     bool InitFromMeta();
@@ -192,6 +204,7 @@ class Table {
     std::shared_ptr<std::map<int32_t, std::shared_ptr<Schema>>> version_schema_;
     std::shared_ptr<std::map<int32_t, std::shared_ptr<codec::RowView>>> version_decoder_;
     std::shared_ptr<std::vector<::openmldb::storage::UpdateTTLMeta>> update_ttl_;
+    std::shared_ptr<AggrWatermark> aggr_watermark_;
 };
 
 }  // namespace storage
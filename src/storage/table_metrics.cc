@@ -0,0 +1,249 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/table_metrics.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "common/timer.h"
+#include "gflags/gflags.h"
+
+DECLARE_uint32(hot_key_sample_interval);
+
+namespace openmldb {
+namespace storage {
+
+namespace {
+
+constexpr uint32_t kHotKeyCapacity = 64;
+constexpr uint64_t kHotKeyDecayIntervalMs = 60 * 1000;
+
+using LatencyDimension = bvar::MultiDimension<bvar::LatencyRecorder>;
+using IntDimension = bvar::MultiDimension<bvar::IntRecorder>;
+using AdderDimension = bvar::MultiDimension<bvar::Adder<int64_t>>;
+
+struct TableDimensions {
+    TableDimensions()
+        : segment_lock_wait("table_segment_lock_wait", {"tid", "pid"}),
+          key_entry_height("table_key_entry_height", {"tid", "pid"}),
+          node_cache_size("table_node_cache_size", {"tid", "pid"}),
+          gc("table_gc", {"tid", "pid"}),
+          gc_freed_records("table_gc_freed_records", {"tid", "pid"}),
+          gc_freed_bytes("table_gc_freed_bytes", {"tid", "pid"}),
+          gc_scanned_records("table_gc_scanned_records", {"tid", "pid"}),
+          compaction_filtered_records("table_compaction_filtered_records", {"tid", "pid"}),
+          snapshot("table_snapshot", {"tid", "pid"}),
+          snapshot_records("table_snapshot_records", {"tid", "pid"}),
+          snapshot_bytes("table_snapshot_bytes", {"tid", "pid"}),
+          binlog_write("table_binlog_write", {"tid", "pid"}),
+          binlog_sync("table_binlog_sync", {"tid", "pid"}),
+          reads("table_reads", {"tid", "pid"}),
+          writes("table_writes", {"tid", "pid"}),
+          cold_spilled_keys("table_cold_spilled_keys", {"tid", "pid"}),
+          cold_promoted_keys("table_cold_promoted_keys", {"tid", "pid"}) {}
+
+    void DeleteStats(const std::list<std::string>& labels) {
+        segment_lock_wait.delete_stats(labels);
+        key_entry_height.delete_stats(labels);
+        node_cache_size.delete_stats(labels);
+        gc.delete_stats(labels);
+        gc_freed_records.delete_stats(labels);
+        gc_freed_bytes.delete_stats(labels);
+        gc_scanned_records.delete_stats(labels);
+        compaction_filtered_records.delete_stats(labels);
+        snapshot.delete_stats(labels);
+        snapshot_records.delete_stats(labels);
+        snapshot_bytes.delete_stats(labels);
+        binlog_write.delete_stats(labels);
+        binlog_sync.delete_stats(labels);
+        reads.delete_stats(labels);
+        writes.delete_stats(labels);
+        cold_spilled_keys.delete_stats(labels);
+        cold_promoted_keys.delete_stats(labels);
+    }
+
+    LatencyDimension segment_lock_wait;
+    IntDimension key_entry_height;
+    IntDimension node_cache_size;
+    LatencyDimension gc;
+    AdderDimension gc_freed_records;
+    AdderDimension gc_freed_bytes;
+    AdderDimension gc_scanned_records;
+    AdderDimension compaction_filtered_records;
+    LatencyDimension snapshot;
+    AdderDimension snapshot_records;
+    AdderDimension snapshot_bytes;
+    LatencyDimension binlog_write;
+    LatencyDimension binlog_sync;
+    AdderDimension reads;
+    AdderDimension writes;
+    AdderDimension cold_spilled_keys;
+    AdderDimension cold_promoted_keys;
+};
+
+TableDimensions* GetDimensions() {
+    // never deleted, the tables may be released after the static variables are destroyed
+    static auto* dimensions = new TableDimensions();
+    return dimensions;
+}
+
+// guards the registry, and the creation and deletion of the stats in the dimensions
+std::mutex registry_mu;
+std::map<std::pair<uint32_t, uint32_t>, std::weak_ptr<TableMetrics>> registry;
+
+}  // namespace
+
+std::shared_ptr<TableMetrics> TableMetrics::Get(uint32_t tid, uint32_t pid) {
+    std::lock_guard<std::mutex> lock(registry_mu);
+    auto& entry = registry[{tid, pid}];
+    auto metrics = entry.lock();
+    if (!metrics) {
+        metrics.reset(new TableMetrics(tid, pid));
+        entry = metrics;
+    }
+    return metrics;
+}
+
+TableMetrics::TableMetrics(uint32_t tid, uint32_t pid)
+    : tid_(tid), pid_(pid), labels_({std::to_string(tid), std::to_string(pid)}), hot_keys_(kHotKeyCapacity) {
+    auto* dimensions = GetDimensions();
+    segment_lock_wait = GetStats(&dimensions->segment_lock_wait);
+    key_entry_height = GetStats(&dimensions->key_entry_height);
+    node_cache_size = GetStats(&dimensions->node_cache_size);
+    gc = GetStats(&dimensions->gc);
+    gc_freed_records = GetStats(&dimensions->gc_freed_records);
+    gc_freed_bytes = GetStats(&dimensions->gc_freed_bytes);
+    gc_scanned_records = GetStats(&dimensions->gc_scanned_records);
+    compaction_filtered_records = GetStats(&dimensions->compaction_filtered_records);
+    snapshot = GetStats(&dimensions->snapshot);
+    snapshot_records = GetStats(&dimensions->snapshot_records);
+    snapshot_bytes = GetStats(&dimensions->snapshot_bytes);
+    binlog_write = GetStats(&dimensions->binlog_write);
+    binlog_sync = GetStats(&dimensions->binlog_sync);
+    reads = GetStats(&dimensions->reads);
+    writes = GetStats(&dimensions->writes);
+    cold_spilled_keys = GetStats(&dimensions->cold_spilled_keys);
+    cold_promoted_keys = GetStats(&dimensions->cold_promoted_keys);
+}
+
+TableMetrics::~TableMetrics() {
+    std::lock_guard<std::mutex> lock(registry_mu);
+    auto it = registry.find({tid_, pid_});
+    // a new instance may be created for the partition before this one takes the lock, it owns the stats then
+    if (it != registry.end() && it->second.expired()) {
+        registry.erase(it);
+        GetDimensions()->DeleteStats(labels_);
+    }
+}
+
+template <typename T>
+T* TableMetrics::GetStats(bvar::MultiDimension<T>* dimension) {
+    T* stats = dimension->get_stats(labels_);
+    if (stats == nullptr) {
+        auto var = std::make_shared<T>();
+        unexported_.push_back(var);
+        stats = var.get();
+    }
+    return stats;
+}
+
+void TableMetrics::RecordRead(uint32_t idx, const std::string& key) {
+    *reads << 1;
+    SampleKey(idx, key);
+}
+
+void TableMetrics::RecordWrite(uint32_t idx, const std::string& key) {
+    *writes << 1;
+    SampleKey(idx, key);
+}
+
+void TableMetrics::SampleKey(uint32_t idx, const std::string& key) {
+    uint32_t interval = FLAGS_hot_key_sample_interval;
+    if (interval == 0) {
+        return;
+    }
+    thread_local uint32_t access_cnt = 0;
+    if (++access_cnt % interval != 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(hot_keys_mu_);
+    hot_keys_.Add(idx, key, interval, ::baidu::common::timer::get_micros() / 1000);
+}
+
+std::vector<HotKey> TableMetrics::GetHotKeys(uint32_t num) {
+    std::lock_guard<std::mutex> lock(hot_keys_mu_);
+    return hot_keys_.GetTop(num);
+}
+
+void HotKeySketch::Add(uint32_t idx, const std::string& key, uint64_t cnt, uint64_t now_ms) {
+    Decay(now_ms);
+    auto it = counts_.find({idx, key});
+    if (it != counts_.end()) {
+        it->second += cnt;
+        return;
+    }
+    if (counts_.size() < capacity_) {
+        counts_.emplace(std::make_pair(idx, key), cnt);
+        return;
+    }
+    // replace the coldest key, the new key may have been counted by it
+    auto min_it = std::min_element(counts_.begin(), counts_.end(),
+                                   [](const auto& a, const auto& b) { return a.second < b.second; });
+    uint64_t min_cnt = min_it->second;
+    counts_.erase(min_it);
+    counts_.emplace(std::make_pair(idx, key), min_cnt + cnt);
+}
+
+void HotKeySketch::Decay(uint64_t now_ms) {
+    if (last_decay_ms_ == 0) {
+        last_decay_ms_ = now_ms;
+        return;
+    }
+    while (now_ms >= last_decay_ms_ + kHotKeyDecayIntervalMs) {
+        if (counts_.empty()) {
+            last_decay_ms_ = now_ms;
+            break;
+        }
+        for (auto it = counts_.begin(); it != counts_.end();) {
+            it->second /= 2;
+            if (it->second == 0) {
+                it = counts_.erase(it);
+            } else {
+                it++;
+            }
+        }
+        last_decay_ms_ += kHotKeyDecayIntervalMs;
+    }
+}
+
+std::vector<HotKey> HotKeySketch::GetTop(uint32_t num) const {
+    std::vector<HotKey> keys;
+    keys.reserve(counts_.size());
+    for (const auto& kv : counts_) {
+        keys.push_back({kv.first.first, kv.first.second, kv.second});
+    }
+    std::sort(keys.begin(), keys.end(), [](const HotKey& a, const HotKey& b) { return a.cnt > b.cnt; });
+    if (keys.size() > num) {
+        keys.resize(num);
+    }
+    return keys;
+}
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_TABLE_METRICS_H_
+#define SRC_STORAGE_TABLE_METRICS_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bvar/bvar.h"
+#include "bvar/multi_dimension.h"
+
+namespace openmldb {
+namespace storage {
+
+struct HotKey {
+    uint32_t idx;
+    std::string key;
+    uint64_t cnt;
+};
+
+// The most accessed keys found by the space saving algorithm. A key out of the sketch is accessed at most as many
+// times as the coldest key in it. The counts are halved every minute to follow the recent load. Not thread safe.
+class HotKeySketch {
+ public:
+    explicit HotKeySketch(uint32_t capacity) : capacity_(capacity) {}
+
+    void Add(uint32_t idx, const std::string& key, uint64_t cnt, uint64_t now_ms);
+
+    // at most num keys, the hottest first
+    std::vector<HotKey> GetTop(uint32_t num) const;
+
+ private:
+    void Decay(uint64_t now_ms);
+
+ private:
+    uint32_t capacity_;
+    uint64_t last_decay_ms_ = 0;
+    std::map<std::pair<uint32_t, std::string>, uint64_t> counts_;
+};
+
+// Internal metrics of one table partition, exported by bvar with the labels tid and pid, so they show up on the
+// brpc /vars and /brpc_metrics pages. The variables are combined per thread, recording one costs no lock.
+//
+// The table, its snapshot and its replicator share one instance, the labels are removed when the last one is gone.
+class TableMetrics {
+ public:
+    static std::shared_ptr<TableMetrics> Get(uint32_t tid, uint32_t pid);
+
+    TableMetrics(const TableMetrics&) = delete;
+    TableMetrics& operator=(const TableMetrics&) = delete;
+    ~TableMetrics();
+
+    uint32_t GetTid() const { return tid_; }
+    uint32_t GetPid() const { return pid_; }
+
+    // time to wait for the segment lock in us, only the contended acquires are recorded
+    bvar::LatencyRecorder* segment_lock_wait = nullptr;
+    // the skiplist height of the key entry which is put to
+    bvar::IntRecorder* key_entry_height = nullptr;
+    // nodes waiting in the node caches of all segments to be freed, recorded every gc round
+    bvar::IntRecorder* node_cache_size = nullptr;
+    // time of a gc round in us
+    bvar::LatencyRecorder* gc = nullptr;
+    bvar::Adder<int64_t>* gc_freed_records = nullptr;
+    bvar::Adder<int64_t>* gc_freed_bytes = nullptr;
+    // records scanned by the gc of disk tables
+    bvar::Adder<int64_t>* gc_scanned_records = nullptr;
+    // records dropped by the ttl compaction filter of disk tables
+    bvar::Adder<int64_t>* compaction_filtered_records = nullptr;
+    // time of making a snapshot in ms
+    bvar::LatencyRecorder* snapshot = nullptr;
+    bvar::Adder<int64_t>* snapshot_records = nullptr;
+    bvar::Adder<int64_t>* snapshot_bytes = nullptr;
+    // time to write and sync the binlog in us
+    bvar::LatencyRecorder* binlog_write = nullptr;
+    bvar::LatencyRecorder* binlog_sync = nullptr;
+    // key reads and writes, the nameserver finds the hot partitions by them
+    bvar::Adder<int64_t>* reads = nullptr;
+    bvar::Adder<int64_t>* writes = nullptr;
+    // keys moved between the memory and the cold tier of memory tables
+    bvar::Adder<int64_t>* cold_spilled_keys = nullptr;
+    bvar::Adder<int64_t>* cold_promoted_keys = nullptr;
+
+    // count an access of the key in the index, one of every FLAGS_hot_key_sample_interval accesses is added to the
+    // hot keys
+    void RecordRead(uint32_t idx, const std::string& key);
+    void RecordWrite(uint32_t idx, const std::string& key);
+
+    std::vector<HotKey> GetHotKeys(uint32_t num);
+
+ private:
+    TableMetrics(uint32_t tid, uint32_t pid);
+
+    template <typename T>
+    T* GetStats(bvar::MultiDimension<T>* dimension);
+
+    void SampleKey(uint32_t idx, const std::string& key);
+
+ private:
+    uint32_t tid_;
+    uint32_t pid_;
+    std::list<std::string> labels_;
+    // the variables used when the label count of a metric reaches the bvar limit, they are not exported
+    std::vector<std::shared_ptr<void>> unexported_;
+    std::mutex hot_keys_mu_;
+    HotKeySketch hot_keys_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+#endif  // SRC_STORAGE_TABLE_METRICS_H_
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/table_metrics.h"
+
+#include <string>
+#include <vector>
+
+#include "base/glog_wrapper.h"
+#include "codec/schema_codec.h"
+#include "codec/sdk_codec.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "storage/mem_table.h"
+
+DECLARE_uint32(hot_key_sample_interval);
+
+namespace openmldb {
+namespace storage {
+
+using ::openmldb::codec::SchemaCodec;
+
+class TableMetricsTest : public ::testing::Test {};
+
+TEST_F(TableMetricsTest, Share) {
+    auto m1 = TableMetrics::Get(100, 1);
+    auto m2 = TableMetrics::Get(100, 1);
+    auto m3 = TableMetrics::Get(100, 2);
+    ASSERT_EQ(m1, m2);
+    ASSERT_NE(m1, m3);
+    *m1->gc_freed_records << 10;
+    ASSERT_EQ(10, m2->gc_freed_records->get_value());
+    ASSERT_EQ(0, m3->gc_freed_records->get_value());
+    m1.reset();
+    m2.reset();
+    // the stats are deleted with the last reference
+    auto m4 = TableMetrics::Get(100, 1);
+    ASSERT_EQ(0, m4->gc_freed_records->get_value());
+}
+
+TEST_F(TableMetricsTest, MemTable) {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(101);
+    table_meta.set_pid(0);
+    table_meta.set_seg_cnt(8);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kLatestTime, 0, 1);
+    auto table = std::make_shared<MemTable>(table_meta);
+    ASSERT_TRUE(table->Init());
+    codec::SDKCodec codec(table_meta);
+    for (int i = 0; i < 100; i++) {
+        std::vector<std::string> row = {"card" + std::to_string(i % 10), std::to_string(1000 + i)};
+        Dimensions dims;
+        auto* dim = dims.Add();
+        dim->set_idx(0);
+        dim->set_key(row[0]);
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        ASSERT_TRUE(table->Put(1000 + i, value, dims).ok());
+    }
+    auto metrics = TableMetrics::Get(101, 0);
+    ASSERT_EQ(100, metrics->key_entry_height->get_value().num);
+    // keep the latest one of every key, the others are removed on put and freed by the second gc
+    table->SchedGc();
+    table->SchedGc();
+    ASSERT_EQ(2, metrics->gc->count());
+    ASSERT_EQ(90, metrics->gc_freed_records->get_value());
+}
+
+TEST_F(TableMetricsTest, HotKeySketch) {
+    HotKeySketch sketch(2);
+    sketch.Add(0, "k1", 10, 1000);
+    sketch.Add(0, "k2", 5, 1000);
+    sketch.Add(0, "k1", 10, 1000);
+    // replace k2, the coldest one
+    sketch.Add(1, "k3", 1, 1000);
+    auto keys = sketch.GetTop(10);
+    ASSERT_EQ(2u, keys.size());
+    ASSERT_EQ("k1", keys[0].key);
+    ASSERT_EQ(20u, keys[0].cnt);
+    ASSERT_EQ("k3", keys[1].key);
+    ASSERT_EQ(1u, keys[1].idx);
+    ASSERT_EQ(6u, keys[1].cnt);
+    ASSERT_EQ(1u, sketch.GetTop(1).size());
+    // halved after a minute
+    sketch.Add(0, "k1", 0, 61000);
+    keys = sketch.GetTop(10);
+    ASSERT_EQ(10u, keys[0].cnt);
+    ASSERT_EQ(3u, keys[1].cnt);
+}
+
+TEST_F(TableMetricsTest, HotKeys) {
+    FLAGS_hot_key_sample_interval = 1;
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(102);
+    table_meta.set_pid(0);
+    table_meta.set_seg_cnt(8);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    auto table = std::make_shared<MemTable>(table_meta);
+    ASSERT_TRUE(table->Init());
+    codec::SDKCodec codec(table_meta);
+    for (int i = 0; i < 100; i++) {
+        std::vector<std::string> row = {"card" + std::to_string(i % 10), std::to_string(1000 + i)};
+        Dimensions dims;
+        auto* dim = dims.Add();
+        dim->set_idx(0);
+        dim->set_key(row[0]);
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        ASSERT_TRUE(table->Put(1000 + i, value, dims).ok());
+    }
+    for (int i = 0; i < 5; i++) {
+        Ticket ticket;
+        std::unique_ptr<TableIterator> it(table->NewIterator(0, "card3", ticket));
+    }
+    std::unique_ptr<::hybridse::vm::WindowIterator> window_it(table->NewWindowIterator(0));
+    window_it->Seek("card3");
+    auto metrics = TableMetrics::Get(102, 0);
+    ASSERT_EQ(100, metrics->writes->get_value());
+    ASSERT_EQ(6, metrics->reads->get_value());
+    auto keys = metrics->GetHotKeys(3);
+    ASSERT_EQ(3u, keys.size());
+    ASSERT_EQ("card3", keys[0].key);
+    ASSERT_EQ(16u, keys[0].cnt);
+    ASSERT_EQ(10u, keys[1].cnt);
+    FLAGS_hot_key_sample_interval = 100;
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
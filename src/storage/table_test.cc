@@ -379,6 +379,8 @@ TEST_P(TableTest, SchedGcHead) {
             ASSERT_FALSE(table->IsExpire(entry));
         }
     }
+    // the row over the latest ttl is removed on put, and freed by the gc a version later
+    table->SchedGc();
     ASSERT_EQ(1, (int64_t)table->GetRecordIdxCnt());
     ASSERT_EQ(bytes, table->GetRecordByteSize());
     ASSERT_EQ(record_idx_bytes, table->GetRecordIdxByteSize());
@@ -461,6 +463,8 @@ TEST_P(TableTest, SchedGc) {
         ASSERT_EQ(2, (int64_t)table->GetRecordIdxCnt());
         ASSERT_EQ(1, (int64_t)table->GetRecordPkCnt());
     }
+    // the row over the latest ttl is removed on put, and freed by the gc a version later
+    table->SchedGc();
     table->SchedGc();
     if (storageMode == ::openmldb::common::StorageMode::kMemory) {
         ASSERT_EQ(1, (int64_t)table->GetRecordIdxCnt());
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/result_cache.h"
+
+#include <iterator>
+
+#include "absl/strings/numbers.h"
+#include "base/glog_wrapper.h"
+#include "common/timer.h"
+#include "gflags/gflags.h"
+
+DECLARE_uint32(deploy_result_cache_max_mb);
+
+namespace openmldb {
+namespace tablet {
+
+// the size of the list node, the hash node and the members of an entry besides the strings
+static constexpr uint64_t ENTRY_OVERHEAD = 128;
+
+ResultCache::ResultCache(uint64_t ttl_ms, uint64_t max_bytes)
+    : ttl_ms_(ttl_ms), max_bytes_(max_bytes), mu_(), lru_(), entries_(), byte_size_(0), hit_cnt_(0), miss_cnt_(0) {}
+
+std::shared_ptr<ResultCache> ResultCache::Create(const hybridse::sdk::ProcedureInfo& sp_info) {
+    const std::string* ttl_option = sp_info.GetOption(RESULT_CACHE_TTL_OPTION);
+    if (ttl_option == nullptr) {
+        return {};
+    }
+    uint64_t ttl_ms = 0;
+    if (!absl::SimpleAtoi(*ttl_option, &ttl_ms)) {
+        PDLOG(WARNING, "invalid %s %s of deployment %s.%s, the result cache is disabled", RESULT_CACHE_TTL_OPTION,
+              ttl_option->c_str(), sp_info.GetDbName().c_str(), sp_info.GetSpName().c_str());
+        return {};
+    }
+    if (ttl_ms == 0) {
+        return {};
+    }
+    uint64_t max_mb = FLAGS_deploy_result_cache_max_mb;
+    const std::string* max_mb_option = sp_info.GetOption(RESULT_CACHE_MAX_MB_OPTION);
+    if (max_mb_option != nullptr && !absl::SimpleAtoi(*max_mb_option, &max_mb)) {
+        PDLOG(WARNING, "invalid %s %s of deployment %s.%s, use %u", RESULT_CACHE_MAX_MB_OPTION,
+              max_mb_option->c_str(), sp_info.GetDbName().c_str(), sp_info.GetSpName().c_str(),
+              FLAGS_deploy_result_cache_max_mb);
+        max_mb = FLAGS_deploy_result_cache_max_mb;
+    }
+    if (max_mb == 0) {
+        return {};
+    }
+    PDLOG(INFO, "enable the result cache of deployment %s.%s, ttl %lu ms, max size %lu MB",
+          sp_info.GetDbName().c_str(), sp_info.GetSpName().c_str(), ttl_ms, max_mb);
+    return std::make_shared<ResultCache>(ttl_ms, max_mb * 1024 * 1024);
+}
+
+uint64_t ResultCache::GetEntrySize(const Entry& entry) {
+    // the key is kept by both the entry and the hash map
+    return entry.key.size() * 2 + entry.value.size() + entry.offsets.size() * sizeof(uint64_t) + ENTRY_OVERHEAD;
+}
+
+void ResultCache::Erase(EntryList::iterator it) {
+    byte_size_ -= GetEntrySize(*it);
+    entries_.erase(it->key);
+    lru_.erase(it);
+}
+
+bool ResultCache::Get(const std::string& key, const std::vector<uint64_t>& offsets, std::string* value) {
+    uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        miss_cnt_++;
+        return false;
+    }
+    if (it->second->expire_time <= cur_time || it->second->offsets != offsets) {
+        Erase(it->second);
+        miss_cnt_++;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    *value = it->second->value;
+    hit_cnt_++;
+    return true;
+}
+
+void ResultCache::Put(const std::string& key, const std::vector<uint64_t>& offsets, const std::string& value) {
+    uint64_t expire_time = ::baidu::common::timer::get_micros() / 1000 + ttl_ms_;
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        Erase(it->second);
+    }
+    lru_.push_front(Entry{key, offsets, value, expire_time});
+    uint64_t size = GetEntrySize(lru_.front());
+    if (size > max_bytes_) {
+        lru_.pop_front();
+        return;
+    }
+    entries_.emplace(key, lru_.begin());
+    byte_size_ += size;
+    while (byte_size_ > max_bytes_) {
+        Erase(std::prev(lru_.end()));
+    }
+}
+
+uint64_t ResultCache::GetEntryCnt() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return entries_.size();
+}
+
+uint64_t ResultCache::GetByteSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return byte_size_;
+}
+
+uint64_t ResultCache::GetHitCnt() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return hit_cnt_;
+}
+
+uint64_t ResultCache::GetMissCnt() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return miss_cnt_;
+}
+
+}  // namespace tablet
+}  // namespace openmldb
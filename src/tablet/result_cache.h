@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_RESULT_CACHE_H_
+#define SRC_TABLET_RESULT_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdk/base.h"
+
+namespace openmldb {
+namespace tablet {
+
+// the deploy options which enable the result cache of a deployment
+constexpr const char* RESULT_CACHE_TTL_OPTION = "result_cache_ttl_ms";
+constexpr const char* RESULT_CACHE_MAX_MB_OPTION = "result_cache_max_mb";
+
+// The results of the request rows of a deployment, keyed by the encoded request row. An entry is put with the
+// offsets of the input partitions read by the request, and it's valid until its ttl passes or the offsets advance,
+// i.e. until a row is put to or deleted from any of the partitions. The least recently used entries are evicted when
+// the cache is over its size
+class ResultCache {
+ public:
+    ResultCache(uint64_t ttl_ms, uint64_t max_bytes);
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // return null if the cache is not enabled by the options of the deployment
+    static std::shared_ptr<ResultCache> Create(const hybridse::sdk::ProcedureInfo& sp_info);
+
+    bool Get(const std::string& key, const std::vector<uint64_t>& offsets, std::string* value);
+    void Put(const std::string& key, const std::vector<uint64_t>& offsets, const std::string& value);
+
+    uint64_t GetEntryCnt();
+    uint64_t GetByteSize();
+    uint64_t GetHitCnt();
+    uint64_t GetMissCnt();
+
+ private:
+    struct Entry {
+        std::string key;
+        std::vector<uint64_t> offsets;
+        std::string value;
+        uint64_t expire_time;
+    };
+    using EntryList = std::list<Entry>;
+
+    static uint64_t GetEntrySize(const Entry& entry);
+    // mu_ is held
+    void Erase(EntryList::iterator it);
+
+ private:
+    uint64_t ttl_ms_;
+    uint64_t max_bytes_;
+    std::mutex mu_;
+    // in the order of the last access, the most recent one is at the front
+    EntryList lru_;
+    std::unordered_map<std::string, EntryList::iterator> entries_;
+    uint64_t byte_size_;
+    uint64_t hit_cnt_;
+    uint64_t miss_cnt_;
+};
+
+}  // namespace tablet
+}  // namespace openmldb
+
+#endif  // SRC_TABLET_RESULT_CACHE_H_
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/result_cache.h"
+
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "base/glog_wrapper.h"
+#include "catalog/base.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class ResultCacheTest : public ::testing::Test {
+ public:
+    ResultCacheTest() {}
+    ~ResultCacheTest() {}
+};
+
+static void AddOption(::openmldb::api::ProcedureInfo* sp_info, const std::string& name, const std::string& value) {
+    auto option = sp_info->add_options();
+    option->set_name(name);
+    option->mutable_value()->set_value(value);
+}
+
+TEST_F(ResultCacheTest, Create) {
+    ::openmldb::api::ProcedureInfo sp_info;
+    sp_info.set_db_name("db1");
+    sp_info.set_sp_name("sp1");
+    ASSERT_FALSE(ResultCache::Create(catalog::ProcedureInfoImpl(sp_info)));
+    AddOption(&sp_info, RESULT_CACHE_TTL_OPTION, "abc");
+    ASSERT_FALSE(ResultCache::Create(catalog::ProcedureInfoImpl(sp_info)));
+    sp_info.mutable_options(0)->mutable_value()->set_value("0");
+    ASSERT_FALSE(ResultCache::Create(catalog::ProcedureInfoImpl(sp_info)));
+    sp_info.mutable_options(0)->mutable_value()->set_value("1000");
+    ASSERT_TRUE(ResultCache::Create(catalog::ProcedureInfoImpl(sp_info)));
+    AddOption(&sp_info, RESULT_CACHE_MAX_MB_OPTION, "0");
+    ASSERT_FALSE(ResultCache::Create(catalog::ProcedureInfoImpl(sp_info)));
+}
+
+TEST_F(ResultCacheTest, GetAndPut) {
+    ResultCache cache(60000, 1024 * 1024);
+    std::vector<uint64_t> offsets = {1, 0, 10, 1, 20};
+    std::string value;
+    ASSERT_FALSE(cache.Get("row1", offsets, &value));
+    cache.Put("row1", offsets, "result1");
+    ASSERT_TRUE(cache.Get("row1", offsets, &value));
+    ASSERT_EQ("result1", value);
+    ASSERT_FALSE(cache.Get("row2", offsets, &value));
+    ASSERT_EQ(1u, cache.GetHitCnt());
+    ASSERT_EQ(2u, cache.GetMissCnt());
+    // a row is put to one of the input partitions
+    std::vector<uint64_t> new_offsets = {1, 0, 11, 1, 20};
+    ASSERT_FALSE(cache.Get("row1", new_offsets, &value));
+    ASSERT_EQ(0u, cache.GetEntryCnt());
+    ASSERT_EQ(0u, cache.GetByteSize());
+    cache.Put("row1", new_offsets, "result2");
+    ASSERT_TRUE(cache.Get("row1", new_offsets, &value));
+    ASSERT_EQ("result2", value);
+}
+
+TEST_F(ResultCacheTest, Expire) {
+    ResultCache cache(10, 1024 * 1024);
+    std::vector<uint64_t> offsets = {1, 0, 10};
+    std::string value;
+    cache.Put("row1", offsets, "result1");
+    ASSERT_TRUE(cache.Get("row1", offsets, &value));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(cache.Get("row1", offsets, &value));
+    ASSERT_EQ(0u, cache.GetEntryCnt());
+}
+
+TEST_F(ResultCacheTest, Evict) {
+    ResultCache cache(60000, 4096);
+    std::vector<uint64_t> offsets = {1, 0, 10};
+    std::string value;
+    std::string result(500, 'a');
+    for (int i = 0; i < 100; i++) {
+        cache.Put(absl::StrCat("row", i), offsets, result);
+        // the first row is the most recently used one
+        ASSERT_TRUE(cache.Get("row0", offsets, &value));
+        ASSERT_LE(cache.GetByteSize(), 4096u);
+    }
+    ASSERT_LT(cache.GetEntryCnt(), 100u);
+    ASSERT_TRUE(cache.Get("row99", offsets, &value));
+    ASSERT_FALSE(cache.Get("row1", offsets, &value));
+    // the result larger than the cache is not cached
+    cache.Put("row100", offsets, std::string(8192, 'a'));
+    ASSERT_FALSE(cache.Get("row100", offsets, &value));
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
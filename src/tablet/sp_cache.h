@@ -23,6 +23,7 @@
 #include <utility>
 
 #include "absl/status/statusor.h"
+#include "tablet/result_cache.h"
 #include "vm/engine.h"
 
 namespace openmldb {
@@ -35,11 +36,14 @@ struct SQLProcedureCacheEntry {
     std::shared_ptr<hybridse::sdk::ProcedureInfo> procedure_info;
     std::shared_ptr<hybridse::vm::CompileInfo> request_info;
     std::shared_ptr<hybridse::vm::CompileInfo> batch_request_info;
+    // null if the deployment does not enable it
+    std::shared_ptr<ResultCache> result_cache;
 
     SQLProcedureCacheEntry(const std::shared_ptr<hybridse::sdk::ProcedureInfo> pinfo,
                            std::shared_ptr<hybridse::vm::CompileInfo> rinfo,
-                           std::shared_ptr<hybridse::vm::CompileInfo> brinfo)
-        : procedure_info(pinfo), request_info(rinfo), batch_request_info(brinfo) {}
+                           std::shared_ptr<hybridse::vm::CompileInfo> brinfo,
+                           std::shared_ptr<ResultCache> rcache = nullptr)
+        : procedure_info(pinfo), request_info(rinfo), batch_request_info(brinfo), result_cache(rcache) {}
 };
 
 class SpCache : public hybridse::vm::CompileInfoCache {
@@ -67,10 +71,27 @@ class SpCache : public hybridse::vm::CompileInfoCache {
                                       std::shared_ptr<hybridse::sdk::ProcedureInfo> procedure_info,
                                       std::shared_ptr<hybridse::vm::CompileInfo> request_info,
                                       std::shared_ptr<hybridse::vm::CompileInfo> batch_request_info) {
+        auto result_cache = procedure_info ? ResultCache::Create(*procedure_info) : nullptr;
         std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
         auto& sp_map_of_db = db_sp_map_[db];
-        sp_map_of_db.insert(
-            std::make_pair(sp_name, SQLProcedureCacheEntry(procedure_info, request_info, batch_request_info)));
+        sp_map_of_db.insert(std::make_pair(
+            sp_name, SQLProcedureCacheEntry(procedure_info, request_info, batch_request_info, result_cache)));
+    }
+
+    // the procedure info and the result cache of the deployment, the cache is null if it's not enabled
+    std::shared_ptr<ResultCache> GetResultCache(const std::string& db, const std::string& sp_name,
+                                                std::shared_ptr<hybridse::sdk::ProcedureInfo>* procedure_info) const {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        auto db_it = db_sp_map_.find(db);
+        if (db_it == db_sp_map_.end()) {
+            return {};
+        }
+        auto sp_it = db_it->second.find(sp_name);
+        if (sp_it == db_it->second.end()) {
+            return {};
+        }
+        *procedure_info = sp_it->second.procedure_info;
+        return sp_it->second.result_cache;
     }
 
     void DropSQLProcedureCacheEntry(const std::string& db, const std::string& sp_name) {
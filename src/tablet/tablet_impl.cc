@@ -26,6 +26,10 @@
 #include <snappy.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <optional>
 #include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
@@ -46,6 +50,7 @@
 #include "base/sys_info.h"
 #include "brpc/controller.h"
 #include "butil/iobuf.h"
+#include "client/tablet_client.h"
 #include "codec/codec.h"
 #include "codec/row_codec.h"
 #include "codec/sql_rpc_row_codec.h"
@@ -62,6 +67,7 @@
 #include "schema/schema_adapter.h"
 #include "storage/binlog.h"
 #include "storage/disk_table_snapshot.h"
+#include "storage/index_builder.h"
 #include "storage/segment.h"
 #include "storage/table.h"
 #include "tablet/file_sender.h"
@@ -98,8 +104,14 @@ DECLARE_uint32(get_table_diskused_interval);
 DECLARE_uint32(get_memory_stat_interval);
 DECLARE_uint32(task_check_interval);
 DECLARE_uint32(load_index_max_wait_time);
+DECLARE_uint32(build_index_thread_num);
+DECLARE_uint32(build_index_batch_size);
+DECLARE_uint64(build_index_max_rows_per_sec);
 DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
+DECLARE_bool(enable_follower_read);
+DECLARE_uint32(follower_read_max_lag);
+DECLARE_uint32(follower_read_check_interval);
 DECLARE_string(snapshot_compression);
 DECLARE_string(file_compression);
 
@@ -121,7 +133,19 @@ DECLARE_uint32(snapshot_ttl_time);
 DECLARE_uint32(snapshot_ttl_check_interval);
 DECLARE_uint32(put_slow_log_threshold);
 DECLARE_uint32(query_slow_log_threshold);
+DECLARE_uint32(deploy_profile_sample_interval);
 DECLARE_int32(snapshot_pool_size);
+DECLARE_uint32(aggr_update_thread_num);
+DECLARE_uint32(aggr_update_max_pending);
+DECLARE_uint32(aggr_update_retry_interval_ms);
+DECLARE_uint32(tablet_max_concurrency);
+DECLARE_uint32(online_request_max_concurrency);
+DECLARE_uint32(online_write_max_concurrency);
+DECLARE_uint32(batch_query_max_concurrency);
+DECLARE_uint32(background_max_concurrency);
+DECLARE_uint32(online_request_max_queue_ms);
+DECLARE_uint32(online_write_max_queue_ms);
+DECLARE_uint32(batch_query_max_queue_ms);
 
 namespace openmldb {
 namespace tablet {
@@ -129,6 +153,8 @@ namespace tablet {
 static const uint32_t SEED = 0xe17a1465;
 
 static constexpr const char DEPLOY_STATS[] = "deploy_stats";
+// the hot keys of a partition in its table status
+static constexpr uint32_t HOT_KEY_REPORT_NUM = 8;
 
 TabletImpl::TabletImpl()
     : tables_(),
@@ -152,9 +178,32 @@ TabletImpl::TabletImpl()
       sp_cache_(std::shared_ptr<SpCache>(new SpCache())),
       notify_path_(),
       globalvar_changed_notify_path_(),
-      startup_mode_(::openmldb::type::StartupMode::kStandalone) {}
+      startup_mode_(::openmldb::type::StartupMode::kStandalone) {
+    for (uint32_t i = 0; i < FLAGS_aggr_update_thread_num; i++) {
+        aggr_update_pools_.emplace_back(std::make_unique<ThreadPool>(1));
+    }
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> workload_options;
+    auto& online_request = workload_options[static_cast<uint32_t>(WorkloadClass::kOnlineRequest)];
+    online_request.max_concurrency = FLAGS_online_request_max_concurrency;
+    online_request.max_queue_us = FLAGS_online_request_max_queue_ms * 1000ull;
+    auto& online_write = workload_options[static_cast<uint32_t>(WorkloadClass::kOnlineWrite)];
+    online_write.max_concurrency = FLAGS_online_write_max_concurrency;
+    online_write.max_queue_us = FLAGS_online_write_max_queue_ms * 1000ull;
+    auto& batch_query = workload_options[static_cast<uint32_t>(WorkloadClass::kBatchQuery)];
+    batch_query.max_concurrency = FLAGS_batch_query_max_concurrency;
+    batch_query.max_queue_us = FLAGS_batch_query_max_queue_ms * 1000ull;
+    // the background tasks are not shed, they wait until a slot is free
+    workload_options[static_cast<uint32_t>(WorkloadClass::kBackground)].max_concurrency =
+        FLAGS_background_max_concurrency;
+    workload_scheduler_ =
+        std::make_unique<WorkloadScheduler>(FLAGS_tablet_max_concurrency, workload_options, "tablet_workload");
+}
 
 TabletImpl::~TabletImpl() {
+    aggr_update_stopped_.store(true, std::memory_order_relaxed);
+    for (auto& pool : aggr_update_pools_) {
+        pool->Stop(true);
+    }
     task_pool_.Stop(true);
     trivial_task_pool_.Stop(true);
     gc_pool_.Stop(true);
@@ -175,7 +224,7 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     zk_path_ = zk_path;
     endpoint_ = endpoint;
     notify_path_ = zk_path + "/table/notify";
-    sp_root_path_ = zk_path + "/store_procedure/db_sp_data";
+    catalog_cache_ = std::make_unique<::openmldb::catalog::ZkCatalogCache>(zk_path);
     globalvar_changed_notify_path_ = zk_path + "/notify/global_variable";
     global_variables_ = std::make_shared<std::map<std::string, std::string>>();
     global_variables_->emplace("execute_mode", "offline");
@@ -195,6 +244,8 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     // rpc_server_<port> if standalone, diy
     deploy_collector_ = std::make_unique<::openmldb::statistics::DeploymentMetricCollector>(
         "rpc_server_" + endpoint.substr(endpoint.find(":") + 1));
+    deploy_runner_collector_ = std::make_unique<::openmldb::statistics::DeploymentRunnerMetricCollector>(
+        "rpc_server_" + endpoint.substr(endpoint.find(":") + 1));
 
     if (!zk_cluster.empty()) {
         zk_client_ = new ZkClient(zk_cluster, real_endpoint, FLAGS_zk_session_timeout, endpoint, zk_path,
@@ -314,6 +365,10 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     if (FLAGS_recycle_ttl != 0) {
         task_pool_.DelayTask(FLAGS_recycle_ttl * 60 * 1000, boost::bind(&TabletImpl::SchedDelRecycle, this));
     }
+    if (FLAGS_enable_follower_read) {
+        task_pool_.DelayTask(FLAGS_follower_read_check_interval,
+                             boost::bind(&TabletImpl::SchedSyncFollowerCatalog, this));
+    }
 #ifdef TCMALLOC_ENABLE
     MallocExtension* tcmalloc = MallocExtension::instance();
     tcmalloc->SetMemoryReleaseRate(FLAGS_mem_release_rate);
@@ -610,6 +665,12 @@ void TabletImpl::RecoverExternalFunction() {
 void TabletImpl::Get(RpcController* controller, const ::openmldb::api::GetRequest* request,
                      ::openmldb::api::GetResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kOnlineRequest);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     uint64_t start_time = ::baidu::common::timer::get_micros();
     uint32_t tid = request->tid();
     uint32_t pid_num = 1;
@@ -707,6 +768,12 @@ void TabletImpl::Get(RpcController* controller, const ::openmldb::api::GetReques
 void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutRequest* request,
                      ::openmldb::api::PutResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kOnlineWrite);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     if (follower_.load(std::memory_order_relaxed)) {
         response->set_code(::openmldb::base::ReturnCode::kIsFollowerCluster);
         response->set_msg("is follower cluster");
@@ -723,34 +790,12 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
         return;
     }
     DLOG(INFO) << "request dimension size " << request->dimensions_size() << " request time " << request->time();
-    if (!table->IsLeader()) {
-        response->set_code(::openmldb::base::ReturnCode::kTableIsFollower);
-        response->set_msg("table is follower");
-        return;
-    }
-    if (table->GetTableStat() == ::openmldb::storage::kLoading) {
-        PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
-        response->set_code(::openmldb::base::ReturnCode::kTableIsLoading);
-        response->set_msg("table is loading");
+    auto status = CheckPutTable(table, request->memory_limit());
+    if (!status.OK()) {
+        response->set_code(status.GetCode());
+        response->set_msg(status.GetMsg());
         return;
     }
-    if (table->GetStorageMode() == ::openmldb::common::StorageMode::kMemory) {
-        if (memory_used_.load(std::memory_order_relaxed) > FLAGS_max_memory_mb) {
-            PDLOG(WARNING, "current memory %lu MB exceed max memory limit %lu MB. tid %u, pid %u",
-                  memory_used_.load(std::memory_order_relaxed), FLAGS_max_memory_mb, tid, pid);
-            response->set_code(base::ReturnCode::kExceedMaxMemory);
-            response->set_msg("exceed max memory");
-            return;
-        }
-        if (request->has_memory_limit() && request->memory_limit() > 0
-                && system_memory_usage_rate_.load(std::memory_order_relaxed) > request->memory_limit()) {
-            PDLOG(WARNING, "current system_memory_usage_rate %u exceed request memory limit %u. tid %u, pid %u",
-                  system_memory_usage_rate_.load(std::memory_order_relaxed), request->memory_limit(), tid, pid);
-            response->set_code(base::ReturnCode::kExceedPutMemoryLimit);
-            response->set_msg("exceed memory limit");
-            return;
-        }
-    }
     ::openmldb::api::LogEntry entry;
     entry.set_pk(request->pk());
     entry.set_ts(request->time());
@@ -814,6 +859,7 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
                 UpdateAggrs(request->tid(), request->pid(), request->value(), request->dimensions(), entry.log_index());
         };
         UpdateAggrClosure closure(update_aggr);
+        WaitAggrPending(tid, pid);
         replicator->AppendEntry(entry, &closure);
         if (!ok) {
             response->set_code(::openmldb::base::ReturnCode::kError);
@@ -852,6 +898,124 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
     }
 }
 
+base::Status TabletImpl::CheckPutTable(const std::shared_ptr<Table>& table, uint32_t memory_limit) {
+    uint32_t tid = table->GetId();
+    uint32_t pid = table->GetPid();
+    if (!table->IsLeader()) {
+        return {base::ReturnCode::kTableIsFollower, "table is follower"};
+    }
+    if (table->GetTableStat() == ::openmldb::storage::kLoading) {
+        PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
+        return {base::ReturnCode::kTableIsLoading, "table is loading"};
+    }
+    if (table->GetStorageMode() == ::openmldb::common::StorageMode::kMemory) {
+        if (memory_used_.load(std::memory_order_relaxed) > FLAGS_max_memory_mb) {
+            PDLOG(WARNING, "current memory %lu MB exceed max memory limit %lu MB. tid %u, pid %u",
+                  memory_used_.load(std::memory_order_relaxed), FLAGS_max_memory_mb, tid, pid);
+            return {base::ReturnCode::kExceedMaxMemory, "exceed max memory"};
+        }
+        if (memory_limit > 0 && system_memory_usage_rate_.load(std::memory_order_relaxed) > memory_limit) {
+            PDLOG(WARNING, "current system_memory_usage_rate %u exceed request memory limit %u. tid %u, pid %u",
+                  system_memory_usage_rate_.load(std::memory_order_relaxed), memory_limit, tid, pid);
+            return {base::ReturnCode::kExceedPutMemoryLimit, "exceed memory limit"};
+        }
+    }
+    return {};
+}
+
+void TabletImpl::BatchPut(RpcController* controller, const ::openmldb::api::BatchPutRequest* request,
+                          ::openmldb::api::BatchPutResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kOnlineWrite);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
+    response->set_put_cnt(0);
+    if (follower_.load(std::memory_order_relaxed)) {
+        response->set_code(::openmldb::base::ReturnCode::kIsFollowerCluster);
+        response->set_msg("is follower cluster");
+        return;
+    }
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table does not exist. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+        response->set_msg("table does not exist");
+        return;
+    }
+    auto status = CheckPutTable(table, request->memory_limit());
+    if (!status.OK()) {
+        response->set_code(status.GetCode());
+        response->set_msg(status.GetMsg());
+        return;
+    }
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(tid, pid);
+    if (!replicator) {
+        PDLOG(WARNING, "fail to find table tid %u pid %u leader's log replicator", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kReplicatorIsNotExist);
+        response->set_msg("replicator does not exist");
+        return;
+    }
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    response->set_msg("ok");
+    bool compress = table->GetCompressType() == openmldb::type::CompressType::kSnappy;
+    uint32_t put_cnt = 0;
+    ::openmldb::api::LogEntry entry;
+    for (const auto& row : request->rows()) {
+        if (row.dimensions_size() == 0 || CheckDimessionPut(&row, table->GetIdxCnt()) != 0) {
+            response->set_code(::openmldb::base::ReturnCode::kInvalidDimensionParameter);
+            response->set_msg("invalid dimension parameter");
+            break;
+        }
+        entry.Clear();
+        entry.set_ts(row.time());
+        if (compress) {
+            ::snappy::Compress(row.value().c_str(), row.value().length(), entry.mutable_value());
+        } else {
+            entry.set_value(row.value());
+        }
+        entry.mutable_dimensions()->CopyFrom(row.dimensions());
+        auto st = table->Put(entry.ts(), entry.value(), entry.dimensions(), request->put_if_absent());
+        if (!st.ok()) {
+            if (request->put_if_absent() && absl::IsAlreadyExists(st)) {
+                continue;
+            }
+            LOG(WARNING) << st.ToString();
+            response->set_code(::openmldb::base::ReturnCode::kPutFailed);
+            response->set_msg(st.ToString());
+            break;
+        }
+        entry.set_term(replicator->GetLeaderTerm());
+        // same as Put, the aggregators are updated within the replicator lock
+        bool ok = false;
+        UpdateAggrClosure closure([this, tid, pid, &row, &ok, &entry]() {
+            ok = UpdateAggrs(tid, pid, row.value(), row.dimensions(), entry.log_index());
+        });
+        WaitAggrPending(tid, pid);
+        replicator->AppendEntry(entry, &closure);
+        put_cnt++;
+        if (!ok) {
+            response->set_code(::openmldb::base::ReturnCode::kError);
+            response->set_msg("update aggr failed");
+            break;
+        }
+    }
+    response->set_put_cnt(put_cnt);
+    if (put_cnt > 0 && FLAGS_binlog_notify_on_put) {
+        replicator->Notify();
+    }
+    uint64_t end_time = ::baidu::common::timer::get_micros();
+    if (start_time + FLAGS_put_slow_log_threshold < end_time) {
+        PDLOG(INFO, "slow log[batch put]. rows %d time %lu. tid %u, pid %u", request->rows_size(),
+              end_time - start_time, tid, pid);
+    }
+}
+
 int TabletImpl::CheckTableMeta(const openmldb::api::TableMeta* table_meta, std::string& msg) {
     msg.clear();
     if (table_meta->name().empty()) {
@@ -931,7 +1095,8 @@ int TabletImpl::CheckTableMeta(const openmldb::api::TableMeta* table_meta, std::
 
 int32_t TabletImpl::ScanIndex(const ::openmldb::api::ScanRequest* request, const ::openmldb::api::TableMeta& meta,
                               const std::map<int32_t, std::shared_ptr<Schema>>& vers_schema, bool use_attachment,
-                              CombineIterator* combine_it, butil::IOBuf* io_buf, uint32_t* count, bool* is_finish) {
+                              CombineIterator* combine_it, const ::openmldb::storage::AggrWatermark* watermark,
+                              int64_t watermark_ts, butil::IOBuf* io_buf, uint32_t* count, bool* is_finish) {
     uint32_t limit = request->limit();
     if (combine_it == nullptr || io_buf == nullptr || count == nullptr || is_finish == nullptr) {
         PDLOG(WARNING, "invalid args");
@@ -960,6 +1125,15 @@ int32_t TabletImpl::ScanIndex(const ::openmldb::api::ScanRequest* request, const
         }
         enable_project = true;
     }
+    bool enable_filter = false;
+    ::openmldb::codec::RowFilter row_filter(vers_schema, request->filter());
+    if (request->filter().size() > 0) {
+        if (!row_filter.Init()) {
+            PDLOG(WARNING, "invalid filter");
+            return -1;
+        }
+        enable_filter = true;
+    }
     bool remove_duplicated_record = request->enable_remove_duplicated_record();
     uint64_t last_time = 0;
     uint32_t total_block_size = 0;
@@ -975,15 +1149,34 @@ int32_t TabletImpl::ScanIndex(const ::openmldb::api::ScanRequest* request, const
             combine_it->Next();
             continue;
         }
-        if (combine_it->GetTs() == st && skip_record_num > 0) {
-            skip_record_num--;
-            combine_it->Next();
-            continue;
-        }
         uint64_t ts = combine_it->GetTs();
         if (ts <= et) {
             break;
         }
+        // skip the buckets of a pre-aggr table which miss the rows not applied yet
+        if (watermark != nullptr &&
+            !watermark->IsComplete(reinterpret_cast<const int8_t*>(combine_it->GetValue().data()), watermark_ts)) {
+            combine_it->Next();
+            continue;
+        }
+        if (enable_filter) {
+            // filter before skipping, the skipped records are counted by the client from the returned ones
+            bool matched = false;
+            openmldb::base::Slice data = combine_it->GetValue();
+            if (!row_filter.Match(reinterpret_cast<const int8_t*>(data.data()), data.size(), &matched)) {
+                PDLOG(WARNING, "fail to apply the filter");
+                return -5;
+            }
+            if (!matched) {
+                combine_it->Next();
+                continue;
+            }
+        }
+        if (ts == st && skip_record_num > 0) {
+            skip_record_num--;
+            combine_it->Next();
+            continue;
+        }
         last_time = ts;
         if (enable_project) {
             int8_t* ptr = nullptr;
@@ -1138,6 +1331,7 @@ int32_t TabletImpl::CountIndex(uint64_t expire_time, uint64_t expire_cnt, ::open
 void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequest* request,
                       ::openmldb::api::ScanResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    // not gated, the catalog reads the remote partitions by it for a query which holds a permit already
     uint64_t start_time = ::baidu::common::timer::get_micros();
     if (request->st() < request->et()) {
         response->set_code(::openmldb::base::ReturnCode::kStLessThanEt);
@@ -1203,18 +1397,34 @@ void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequ
     }
     auto table_meta = query_its.begin()->table->GetTableMeta();
     const std::map<int32_t, std::shared_ptr<Schema>> vers_schema = query_its.begin()->table->GetAllVersionSchema();
+    // the buckets of a pre-aggr table are complete before the watermark, as the local reads in the catalog
+    std::shared_ptr<::openmldb::storage::AggrWatermark> watermark;
+    std::optional<int64_t> watermark_ts;
+    for (const auto& query_it : query_its) {
+        auto cur_watermark = query_it.table->GetAggrWatermark();
+        if (!cur_watermark) {
+            continue;
+        }
+        auto ts = cur_watermark->Get(request->pk());
+        if (ts && (!watermark_ts || ts.value() < watermark_ts.value())) {
+            watermark = cur_watermark;
+            watermark_ts = ts;
+        }
+    }
     CombineIterator combine_it(std::move(query_its), request->st(), openmldb::api::GetType::kSubKeyLe, expired_value);
     uint32_t count = 0;
     int32_t code = 0;
     bool is_finish = true;
     if (!request->has_use_attachment() || !request->use_attachment()) {
         butil::IOBuf buf;
-        code = ScanIndex(request, *table_meta, vers_schema, false, &combine_it, &buf, &count, &is_finish);
+        code = ScanIndex(request, *table_meta, vers_schema, false, &combine_it, watermark.get(),
+                         watermark_ts.value_or(0), &buf, &count, &is_finish);
         buf.copy_to(response->mutable_pairs());
     } else {
         auto* cntl = dynamic_cast<brpc::Controller*>(controller);
         butil::IOBuf& buf = cntl->response_attachment();
-        code = ScanIndex(request, *table_meta, vers_schema, true, &combine_it, &buf, &count, &is_finish);
+        code = ScanIndex(request, *table_meta, vers_schema, true, &combine_it, watermark.get(),
+                         watermark_ts.value_or(0), &buf, &count, &is_finish);
         response->set_buf_size(buf.size());
         DLOG(INFO) << " scan " << request->pk() << " with buf size " << buf.size();
     }
@@ -1245,6 +1455,10 @@ void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequ
             response->set_msg("fail to encode data rows");
             response->set_code(::openmldb::base::ReturnCode::kEncodeError);
             return;
+        case -5:
+            response->set_msg("fail to apply the filter");
+            response->set_code(::openmldb::base::ReturnCode::kFailToApplyFilter);
+            return;
         default:
             return;
     }
@@ -1253,6 +1467,12 @@ void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequ
 void TabletImpl::Count(RpcController* controller, const ::openmldb::api::CountRequest* request,
                        ::openmldb::api::CountResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBatchQuery);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     std::shared_ptr<Table> table = GetTable(request->tid(), request->pid());
     if (!table) {
         PDLOG(WARNING, "table does not exist. tid %u, pid %u", request->tid(), request->pid());
@@ -1335,6 +1555,7 @@ void TabletImpl::Count(RpcController* controller, const ::openmldb::api::CountRe
 void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::TraverseRequest* request,
                           ::openmldb::api::TraverseResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    // not gated, the catalog reads the remote partitions by it for a query which holds a permit already
     uint32_t tid = request->tid();
     uint32_t pid = request->pid();
     std::shared_ptr<Table> table = GetTable(tid, pid);
@@ -1401,10 +1622,25 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
     if (request->has_enable_remove_duplicated_record()) {
         remove_duplicated_record = request->enable_remove_duplicated_record();
     }
+    // the buckets of a pre-aggr table are complete before the watermark of their key
+    auto watermark = table->GetAggrWatermark();
+    std::optional<std::string> watermark_pk;
+    std::optional<int64_t> watermark_ts;
+    ::openmldb::codec::RowFilter row_filter(table->GetAllVersionSchema(), request->filter());
+    bool enable_filter = request->filter().size() > 0;
+    if (enable_filter && !row_filter.Init()) {
+        PDLOG(WARNING, "invalid filter. tid %u, pid %u", tid, pid);
+        delete it;
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("invalid filter");
+        return;
+    }
     uint32_t scount = 0;
+    // the filtered records count toward the limit too, so a request never scans the whole partition
+    uint32_t filtered_cnt = 0;
     butil::IOBuf buf;
     for (; it->Valid(); it->Next()) {
-        if (request->limit() > 0 && scount > request->limit() - 1) {
+        if (request->limit() > 0 && scount + filtered_cnt > request->limit() - 1) {
             DEBUGLOG("reache the limit %u ", request->limit());
             break;
         }
@@ -1425,6 +1661,33 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
             }
         }
         openmldb::base::Slice value = it->GetValue();
+        if (watermark) {
+            if (watermark_pk != last_pk) {
+                watermark_pk = last_pk;
+                watermark_ts = watermark->Get(last_pk);
+            }
+            if (watermark_ts && !watermark->IsComplete(reinterpret_cast<const int8_t*>(value.data()),
+                                                       watermark_ts.value())) {
+                continue;
+            }
+        }
+        if (enable_filter) {
+            bool matched = false;
+            if (!row_filter.Match(reinterpret_cast<const int8_t*>(value.data()), value.size(), &matched)) {
+                PDLOG(WARNING, "fail to apply the filter. tid %u, pid %u", tid, pid);
+                delete it;
+                response->set_code(::openmldb::base::ReturnCode::kFailToApplyFilter);
+                response->set_msg("fail to apply the filter");
+                return;
+            }
+            if (!matched) {
+                filtered_cnt++;
+                if (FLAGS_max_traverse_cnt > 0 && it->GetCount() >= FLAGS_max_traverse_cnt) {
+                    break;
+                }
+                continue;
+            }
+        }
         DLOG(INFO) << "encode pk " << it->GetPK() << " ts " << it->GetKey() << " size " << value.size();
         ::openmldb::codec::EncodeFull(it->GetPK(), it->GetKey(), value.data(), value.size(), &buf);
         scount++;
@@ -1443,7 +1706,7 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
         if (last_pk.empty()) {
             is_finish = true;
         }
-    } else if (scount < request->limit()) {
+    } else if (scount + filtered_cnt < request->limit()) {
         is_finish = true;
     }
     buf.copy_to(response->mutable_pairs());
@@ -1458,9 +1721,97 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
     response->set_ts_pos(ts_pos);
 }
 
+void TabletImpl::MultiKeyTraverse(RpcController* controller, const ::openmldb::api::MultiKeyTraverseRequest* request,
+                                  ::openmldb::api::MultiKeyTraverseResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    // not gated, the catalog reads the remote partitions by it for a query which holds a permit already
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table does not exist. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+        response->set_msg("table does not exist");
+        return;
+    }
+    if (table->GetTableStat() == ::openmldb::storage::kLoading) {
+        PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsLoading);
+        response->set_msg("table is loading");
+        return;
+    }
+    std::string index_name;
+    if (request->has_idx_name() && !request->idx_name().empty()) {
+        index_name = request->idx_name();
+    } else {
+        index_name = table->GetPkIndex()->GetName();
+    }
+    auto index_def = table->GetIndex(index_name);
+    if (!index_def || !index_def->IsReady()) {
+        PDLOG(WARNING, "idx name %s not found in table. tid %u, pid %u", index_name.c_str(), tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kIdxNameNotFound);
+        response->set_msg("idx name not found");
+        return;
+    }
+    std::unique_ptr<::openmldb::storage::TableIterator> it(table->NewTraverseIterator(index_def->GetId()));
+    if (!it) {
+        response->set_code(::openmldb::base::ReturnCode::kTsNameNotFound);
+        response->set_msg("create iterator failed");
+        return;
+    }
+    // the buckets of a pre-aggr table are complete before the watermark of their key
+    auto watermark = table->GetAggrWatermark();
+    for (const auto& pk : request->pk()) {
+        auto window = response->add_windows();
+        uint32_t count = 0;
+        uint64_t last_time = 0;
+        uint32_t ts_pos = 0;
+        butil::IOBuf buf;
+        std::optional<int64_t> watermark_ts;
+        if (watermark) {
+            watermark_ts = watermark->Get(pk);
+        }
+        it->Seek(pk, UINT64_MAX);
+        for (; it->Valid() && it->GetPK() == pk; it->Next()) {
+            if (request->limit() > 0 && count >= request->limit()) {
+                break;
+            }
+            if (count > 0 && last_time == it->GetKey()) {
+                ts_pos++;
+            } else {
+                last_time = it->GetKey();
+                ts_pos = 1;
+            }
+            openmldb::base::Slice value = it->GetValue();
+            if (watermark_ts &&
+                !watermark->IsComplete(reinterpret_cast<const int8_t*>(value.data()), watermark_ts.value())) {
+                continue;
+            }
+            ::openmldb::codec::EncodeFull(pk, last_time, value.data(), value.size(), &buf);
+            count++;
+        }
+        buf.copy_to(window->mutable_pairs());
+        window->set_code(::openmldb::base::ReturnCode::kOk);
+        window->set_count(count);
+        window->set_pk(pk);
+        window->set_ts(last_time);
+        window->set_ts_pos(ts_pos);
+        // the key is finished if the iterator moves to the next key
+        window->set_is_finish(!it->Valid() || it->GetPK() != pk);
+    }
+    DLOG(INFO) << "tid " << tid << " pid " << pid << " multi key traverse with " << request->pk_size() << " keys";
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+}
+
 void TabletImpl::Delete(RpcController* controller, const ::openmldb::api::DeleteRequest* request,
                         openmldb::api::GeneralResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kOnlineWrite);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     uint32_t tid = request->tid();
     uint32_t pid = request->pid();
     if (follower_.load(std::memory_order_relaxed)) {
@@ -1541,6 +1892,8 @@ void TabletImpl::Delete(RpcController* controller, const ::openmldb::api::Delete
             return;
         }
     } else {
+        // the rows put before are applied to the aggregators first
+        WaitAggrUpdates(tid, pid);
         auto get_aggregator = [this](std::shared_ptr<Aggrs> aggrs, uint32_t idx) -> std::shared_ptr<Aggregator> {
             if (aggrs) {
                 for (const auto& aggr : *aggrs) {
@@ -1618,6 +1971,20 @@ void TabletImpl::Query(RpcController* ctrl, const openmldb::api::QueryRequest* r
     brpc::ClosureGuard done_guard(done);
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
     butil::IOBuf& buf = cntl->response_attachment();
+    if (request->has_follower_read()) {
+        if (auto status = CheckFollowerRead(request->follower_read()); !status.OK()) {
+            response->set_code(status.GetCode());
+            response->set_msg(status.GetMsg());
+            return;
+        }
+    }
+    WorkloadClass cls = request->is_batch() ? WorkloadClass::kBatchQuery : WorkloadClass::kOnlineRequest;
+    WorkloadPermit permit(workload_scheduler_.get(), cls);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     ProcessQuery(true, ctrl, request, response, &buf);
 }
 
@@ -1652,6 +2019,9 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
         if (request->is_debug()) {
             session.EnableDebug();
         }
+        if (request->profile()) {
+            session.EnableProfile();
+        }
         session.SetParameterSchema(parameter_schema);
         {
             bool ok = engine_->Get(request->sql(), request->db(), session, status);
@@ -1698,6 +2068,9 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
         response->set_schema(session.GetEncodedSchema());
         response->set_byte_size(byte_size);
         response->set_count(count);
+        if (request->profile()) {
+            response->set_profile(session.GetProfileString());
+        }
         response->set_code(::openmldb::base::kOk);
         DLOG(INFO) << "handle batch sql " << request->sql() << " with record cnt " << count << " byte size "
                    << byte_size;
@@ -1706,6 +2079,10 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
         if (request->is_debug()) {
             session.EnableDebug();
         }
+        bool sampled = !is_sub && request->is_procedure() && ShouldProfileDeploy();
+        if (request->profile() || sampled) {
+            session.EnableProfile();
+        }
         if (request->is_procedure()) {
             const std::string& db_name = request->db();
             const std::string& sp_name = request->sp_name();
@@ -1722,7 +2099,14 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
             }
             session.SetCompileInfo(request_compile_info);
             session.SetSpName(sp_name);
-            RunRequestQuery(ctrl, *request, session, *response, *buf);
+            std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info;
+            auto result_cache = sp_cache_->GetResultCache(db_name, sp_name, &sp_info);
+            // the profiled and debugged requests are always run
+            if (result_cache && sp_info && !request->profile() && !sampled && !request->is_debug()) {
+                RunCachedRequestQuery(ctrl, *request, *sp_info, result_cache.get(), session, *response, *buf);
+            } else {
+                RunRequestQuery(ctrl, *request, session, *response, *buf);
+            }
         } else {
             bool ok = engine_->Get(request->sql(), request->db(), session, status);
             if (!ok || session.GetCompileInfo() == nullptr) {
@@ -1737,6 +2121,12 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
         if (response->code() != ::openmldb::base::kOk) {
             DLOG(WARNING) << "fail to run sql " << sql << " error msg: " << response->msg();
         } else {
+            if (request->profile()) {
+                response->set_profile(session.GetProfileString());
+            }
+            if (sampled) {
+                CollectDeployProfile(request->db(), request->sp_name(), *session.GetProfile());
+            }
             DLOG(INFO) << "handle request sql " << sql;
         }
     }
@@ -1756,6 +2146,12 @@ void TabletImpl::SQLBatchRequestQuery(RpcController* ctrl, const openmldb::api::
                                       openmldb::api::SQLBatchRequestQueryResponse* response, Closure* done) {
     DLOG(INFO) << "handle query batch request begin!";
     brpc::ClosureGuard done_guard(done);
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kOnlineRequest);
+    if (!permit.GetStatus().OK()) {
+        response->set_code(permit.GetStatus().GetCode());
+        response->set_msg(permit.GetStatus().GetMsg());
+        return;
+    }
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
     butil::IOBuf& buf = cntl->response_attachment();
     return ProcessBatchRequestQuery(false, ctrl, request, response, buf);
@@ -1995,10 +2391,14 @@ void TabletImpl::ChangeRole(RpcController* controller, const ::openmldb::api::Ch
             }
         }
         PDLOG(INFO, "change to leader. tid[%u] pid[%u] term[%lu]", tid, pid, request->term());
-        if (catalog_->AddTable(*(table->GetTableMeta()), table)) {
-            LOG(INFO) << "add table " << table->GetName() << " to catalog with db " << table->GetDB();
-        } else {
-            LOG(WARNING) << "fail to add table " << table->GetName() << " to catalog with db " << table->GetDB();
+        {
+            std::lock_guard<std::mutex> lock(follower_catalog_mu_);
+            follower_catalog_tables_.erase(std::make_pair(tid, pid));
+            if (catalog_->AddTable(*(table->GetTableMeta()), table)) {
+                LOG(INFO) << "add table " << table->GetName() << " to catalog with db " << table->GetDB();
+            } else {
+                LOG(WARNING) << "fail to add table " << table->GetName() << " to catalog with db " << table->GetDB();
+            }
         }
         if (replicator->AddReplicateNode(real_ep_map) < 0) {
             PDLOG(WARNING, "add replicator failed. tid[%u] pid[%u]", tid, pid);
@@ -2030,6 +2430,9 @@ void TabletImpl::ChangeRole(RpcController* controller, const ::openmldb::api::Ch
         }
         PDLOG(INFO, "change to follower. tid[%u] pid[%u]", tid, pid);
         if (!table->GetDB().empty()) {
+            // it's added back by SchedSyncFollowerCatalog once it catches up with the new leader
+            std::lock_guard<std::mutex> lock(follower_catalog_mu_);
+            follower_catalog_tables_.erase(std::make_pair(tid, pid));
             catalog_->DeleteTable(table->GetDB(), table->GetName(), tid, pid);
         }
     }
@@ -2207,6 +2610,14 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
     uint64_t last_log_offset = replicator->GetOffset();
+    if (request->has_leader_log_offset()) {
+        replicator->SetLeaderLogOffset(request->leader_log_offset());
+        if (request->entries_size() == 0) {
+            // a heartbeat of the leader
+            response->set_log_offset(last_log_offset);
+            return;
+        }
+    }
     if (request->pre_log_index() == 0 && request->entries_size() == 0) {
         response->set_log_offset(last_log_offset);
         if (!FLAGS_zk_cluster.empty() && request->term() > term) {
@@ -2243,6 +2654,133 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
     response->set_log_offset(replicator->GetOffset());
 }
 
+void TabletImpl::SubscribeBinlog(RpcController* controller, const ::openmldb::api::SubscribeBinlogRequest* request,
+                                 ::openmldb::api::SubscribeBinlogResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table does not exist. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+        response->set_msg("table does not exist");
+        return;
+    }
+    if (table->GetTableStat() == ::openmldb::storage::kLoading) {
+        PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsLoading);
+        response->set_msg("table is loading");
+        return;
+    }
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(tid, pid);
+    if (!replicator) {
+        PDLOG(WARNING, "replicator does not exist. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kReplicatorIsNotExist);
+        response->set_msg("replicator does not exist");
+        return;
+    }
+    if (request->offset() == 0 || request->max_cnt() == 0) {
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("offset and max_cnt should be greater than 0");
+        return;
+    }
+    const std::map<int32_t, std::shared_ptr<Schema>> vers_schema = table->GetAllVersionSchema();
+    ::openmldb::codec::RowProject row_project(vers_schema, request->projection());
+    bool enable_project = request->projection().size() > 0;
+    if (enable_project && !row_project.Init()) {
+        PDLOG(WARNING, "invalid project list. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("invalid project list");
+        return;
+    }
+    ::openmldb::codec::RowFilter row_filter(vers_schema, request->filter());
+    bool enable_filter = request->filter().size() > 0;
+    if (enable_filter && !row_filter.Init()) {
+        PDLOG(WARNING, "invalid filter. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("invalid filter");
+        return;
+    }
+    std::vector<::openmldb::api::LogEntry> entries;
+    bool ok = replicator->ReadEntries(request->subscriber(), request->offset(), request->max_cnt(),
+                                      request->max_bytes(), &entries);
+    if (ok && entries.empty() && request->wait_ms() > 0 &&
+        replicator->WaitEntry(request->offset(), request->wait_ms())) {
+        ok = replicator->ReadEntries(request->subscriber(), request->offset(), request->max_cnt(),
+                                     request->max_bytes(), &entries);
+    }
+    if (!ok) {
+        PDLOG(WARNING, "fail to read binlog from offset %lu for %s. tid %u, pid %u", request->offset(),
+              request->subscriber().c_str(), tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kFailToReadBinlog);
+        response->set_msg("fail to read binlog");
+        return;
+    }
+    // the values of snappy tables are compressed in the binlog, the filter and projection read the raw rows
+    bool compressed = table->GetCompressType() == ::openmldb::type::CompressType::kSnappy;
+    std::string raw_value;
+    uint64_t next_offset = request->offset();
+    for (auto& entry : entries) {
+        next_offset = entry.log_index() + 1;
+        bool is_delete = entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete;
+        if (is_delete) {
+            if (!request->skip_delete()) {
+                response->add_entries()->Swap(&entry);
+            }
+            continue;
+        }
+        if (entry.ts() < request->start_ts()) {
+            continue;
+        }
+        const std::string* value = &entry.value();
+        if (compressed && (enable_filter || enable_project)) {
+            raw_value.clear();
+            if (!::snappy::Uncompress(entry.value().data(), entry.value().size(), &raw_value)) {
+                PDLOG(WARNING, "fail to uncompress the entry at offset %lu. tid %u, pid %u", entry.log_index(), tid,
+                      pid);
+                response->set_code(::openmldb::base::ReturnCode::kFailToReadBinlog);
+                response->set_msg("fail to uncompress the binlog entry");
+                return;
+            }
+            value = &raw_value;
+        }
+        const int8_t* row_ptr = reinterpret_cast<const int8_t*>(value->data());
+        bool matched = true;
+        if (enable_filter && !row_filter.Match(row_ptr, value->size(), &matched)) {
+            PDLOG(WARNING, "fail to apply the filter. tid %u, pid %u", tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+            response->set_msg("fail to apply the filter");
+            return;
+        }
+        if (!matched) {
+            continue;
+        }
+        if (enable_project) {
+            int8_t* ptr = nullptr;
+            uint32_t size = 0;
+            if (!row_project.Project(row_ptr, value->size(), &ptr, &size)) {
+                PDLOG(WARNING, "fail to make a projection. tid %u, pid %u", tid, pid);
+                response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+                response->set_msg("fail to make a projection");
+                return;
+            }
+            // the projected value is compressed again, the entries keep the compress type of the table
+            if (compressed) {
+                entry.mutable_value()->clear();
+                ::snappy::Compress(reinterpret_cast<char*>(ptr), size, entry.mutable_value());
+            } else {
+                entry.set_value(reinterpret_cast<char*>(ptr), size);
+            }
+            delete[] ptr;
+        }
+        response->add_entries()->Swap(&entry);
+    }
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    response->set_msg("ok");
+    response->set_next_offset(next_offset);
+    response->set_log_offset(replicator->GetOffset());
+}
+
 void TabletImpl::GetTableSchema(RpcController* controller, const ::openmldb::api::GetTableSchemaRequest* request,
                                 ::openmldb::api::GetTableSchemaResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -2396,6 +2934,16 @@ void TabletImpl::GetTableStatus(RpcController* controller, const ::openmldb::api
                         delete[] stats;
                     }
                     status->set_idx_cnt(record_idx_cnt);
+                    if (auto* metrics = mem_table->GetMetrics(); metrics != nullptr) {
+                        status->set_read_cnt(metrics->reads->get_value());
+                        status->set_write_cnt(metrics->writes->get_value());
+                        for (const auto& hot_key : metrics->GetHotKeys(HOT_KEY_REPORT_NUM)) {
+                            auto* key = status->add_hot_keys();
+                            key->set_idx(hot_key.idx);
+                            key->set_key(hot_key.key);
+                            key->set_cnt(hot_key.cnt);
+                        }
+                    }
                 }
             } else {
                 // status about disk table's data paths
@@ -2457,6 +3005,7 @@ void TabletImpl::SetExpire(RpcController* controller, const ::openmldb::api::Set
 
 void TabletImpl::MakeSnapshotInternal(uint32_t tid, uint32_t pid, uint64_t end_offset,
         std::shared_ptr<::openmldb::api::TaskInfo> task, bool is_force) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     PDLOG(INFO, "MakeSnapshotInternal begin, tid[%u] pid[%u]", tid, pid);
     std::shared_ptr<Table> table;
     std::shared_ptr<Snapshot> snapshot;
@@ -2785,6 +3334,7 @@ void TabletImpl::SendSnapshot(RpcController* controller, const ::openmldb::api::
 
 void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid, uint32_t pid, uint32_t remote_tid,
                                       std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     bool has_error = true;
     do {
         std::shared_ptr<Table> table = GetTable(tid, pid);
@@ -3056,6 +3606,7 @@ void TabletImpl::LoadTable(RpcController* controller, const ::openmldb::api::Loa
 }
 
 int TabletImpl::LoadTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::openmldb::api::TaskInfo> task_ptr) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     do {
         // load snapshot data
         std::shared_ptr<Table> table = GetTable(tid, pid);
@@ -3296,6 +3847,8 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
             PDLOG(INFO, "drop replicator for tid %u, pid %u", tid, pid);
         }
         if (!table->GetDB().empty()) {
+            std::lock_guard<std::mutex> lock(follower_catalog_mu_);
+            follower_catalog_tables_.erase(std::make_pair(tid, pid));
             catalog_->DeleteTable(table->GetDB(), table->GetName(), tid, pid);
         }
         // delete related aggregator
@@ -3436,6 +3989,7 @@ void TabletImpl::TruncateTable(RpcController* controller, const ::openmldb::api:
     brpc::ClosureGuard done_guard(done);
     uint32_t tid = request->tid();
     uint32_t pid = request->pid();
+    WaitAggrUpdates(tid, pid);
     if (auto status = TruncateTableInternal(tid, pid); !status.OK()) {
         base::SetResponseStatus(status, response);
         return;
@@ -4119,6 +4673,16 @@ void TabletImpl::SetTaskStatus(std::shared_ptr<::openmldb::api::TaskInfo>& task_
     task_ptr->set_status(status);
 }
 
+void TabletImpl::SetTaskProgress(const std::shared_ptr<::openmldb::api::TaskInfo>& task_ptr, uint64_t processed_cnt,
+                                 uint64_t total_cnt) {
+    if (!task_ptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    task_ptr->set_processed_cnt(processed_cnt);
+    task_ptr->set_total_cnt(total_cnt);
+}
+
 int TabletImpl::GetTaskStatus(const std::shared_ptr<::openmldb::api::TaskInfo>& task_ptr,
                               ::openmldb::api::TaskStatus* status) {
     if (!task_ptr) {
@@ -4261,22 +4825,93 @@ bool TabletImpl::UpdateAggrs(uint32_t tid, uint32_t pid, const std::string& valu
     if (!aggrs) {
         return true;
     }
+    auto* pool = GetAggrUpdatePool(tid, pid);
+    if (pool == nullptr) {
+        for (auto iter = dimensions.begin(); iter != dimensions.end(); ++iter) {
+            for (const auto& aggr : *aggrs) {
+                if (aggr->GetIndexPos() != iter->idx()) {
+                    continue;
+                }
+                auto ok = aggr->Update(iter->key(), value, log_offset);
+                if (!ok) {
+                    PDLOG(WARNING, "update aggr failed. tid[%u] pid[%u] index[%u] key[%s] value[%s]", tid, pid,
+                          iter->idx(), iter->key().c_str(), value.c_str());
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    // called in the replicator lock, so the rows are queued in the order of the offsets
+    std::vector<std::pair<std::shared_ptr<Aggregator>, std::string>> updates;
     for (auto iter = dimensions.begin(); iter != dimensions.end(); ++iter) {
         for (const auto& aggr : *aggrs) {
-            if (aggr->GetIndexPos() != iter->idx()) {
-                continue;
-            }
-            auto ok = aggr->Update(iter->key(), value, log_offset);
-            if (!ok) {
-                PDLOG(WARNING, "update aggr failed. tid[%u] pid[%u] index[%u] key[%s] value[%s]", tid, pid, iter->idx(),
-                      iter->key().c_str(), value.c_str());
-                return false;
+            if (aggr->GetIndexPos() == iter->idx()) {
+                aggr->AddPending(iter->key(), value);
+                updates.emplace_back(aggr, iter->key());
             }
         }
     }
+    if (updates.empty()) {
+        return true;
+    }
+    pool->AddTask([this, tid, pid, value, log_offset, updates = std::move(updates)]() {
+        for (const auto& [aggr, key] : updates) {
+            // retry in place, the later rows would move the offset of the aggregator past this one and it's never
+            // applied again, not even by the recovery. the row stays pending, so the queries read the base rows
+            for (uint32_t retry = 0; !aggr->Update(key, value, log_offset); retry++) {
+                if (aggr_update_stopped_.load(std::memory_order_relaxed) || !HasAggregator(tid, pid, aggr)) {
+                    PDLOG(WARNING, "update aggr failed and give up. tid[%u] pid[%u] index[%u] key[%s] offset[%lu]",
+                          tid, pid, aggr->GetIndexPos(), key.c_str(), log_offset);
+                    break;
+                }
+                if (retry % 100 == 0) {
+                    PDLOG(WARNING, "update aggr failed, retry %u. tid[%u] pid[%u] index[%u] key[%s] offset[%lu]", retry,
+                          tid, pid, aggr->GetIndexPos(), key.c_str(), log_offset);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_aggr_update_retry_interval_ms));
+            }
+            aggr->RemovePending(key, value);
+        }
+    });
     return true;
 }
 
+bool TabletImpl::HasAggregator(uint32_t tid, uint32_t pid, const std::shared_ptr<Aggregator>& aggr) {
+    std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+    auto aggrs = GetAggregatorsUnLock(tid, pid);
+    return aggrs && std::find(aggrs->begin(), aggrs->end(), aggr) != aggrs->end();
+}
+
+void TabletImpl::WaitAggrPending(uint32_t tid, uint32_t pid) {
+    auto* pool = GetAggrUpdatePool(tid, pid);
+    if (pool == nullptr || pool->PendingNum() < static_cast<int64_t>(FLAGS_aggr_update_max_pending) ||
+        !GetAggregators(tid, pid)) {
+        return;
+    }
+    while (pool->PendingNum() >= static_cast<int64_t>(FLAGS_aggr_update_max_pending)) {
+        bthread_usleep(100);
+    }
+}
+
+ThreadPool* TabletImpl::GetAggrUpdatePool(uint32_t tid, uint32_t pid) {
+    if (aggr_update_pools_.empty()) {
+        return nullptr;
+    }
+    return aggr_update_pools_[(tid + pid) % aggr_update_pools_.size()].get();
+}
+
+void TabletImpl::WaitAggrUpdates(uint32_t tid, uint32_t pid) {
+    auto* pool = GetAggrUpdatePool(tid, pid);
+    if (pool == nullptr) {
+        return;
+    }
+    std::promise<void> applied;
+    auto future = applied.get_future();
+    pool->AddTask([&applied]() { applied.set_value(); });
+    future.wait();
+}
+
 void TabletImpl::ShowMemPool(RpcController* controller, const ::openmldb::api::HttpRequest* request,
                              ::openmldb::api::HttpResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -4388,73 +5023,22 @@ void TabletImpl::RefreshTableInfo() {
     } catch (const std::exception& e) {
         LOG(WARNING) << "value is not integer";
     }
-    std::string db_table_data_path = zk_path_ + "/table/db_table_data";
-    std::vector<std::string> table_datas;
-    if (zk_client_->IsExistNode(db_table_data_path) == 0) {
-        bool ok = zk_client_->GetChildren(db_table_data_path, table_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table list with path " << db_table_data_path;
-            return;
-        }
-    } else {
-        LOG(INFO) << "no tables in db";
+    std::lock_guard<std::mutex> lock(refresh_table_mu_);
+    // only the tables and procedures changed since the last refresh are read from zk
+    if (!catalog_cache_->Refresh(zk_client_)) {
+        LOG(WARNING) << "fail to refresh table and procedure info from zk";
+        return;
     }
     std::vector<::openmldb::nameserver::TableInfo> table_info_vec;
-    for (const auto& node : table_datas) {
-        std::string value;
-        if (!zk_client_->GetNodeValue(db_table_data_path + "/" + node, value)) {
-            LOG(WARNING) << "fail to get table data. node: " << node;
-            continue;
-        }
-        ::openmldb::nameserver::TableInfo table_info;
-        if (!table_info.ParseFromString(value)) {
-            LOG(WARNING) << "fail to parse table proto. node: " << node << " value: " << value;
-            continue;
-        }
-        table_info_vec.push_back(std::move(table_info));
+    table_info_vec.reserve(catalog_cache_->GetTables().size());
+    for (const auto& kv : catalog_cache_->GetTables()) {
+        table_info_vec.push_back(*kv.second);
     }
     // procedure part
-    std::vector<std::string> sp_datas;
-    if (zk_client_->IsExistNode(sp_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(sp_root_path_, sp_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure list with path " << sp_root_path_;
-            return;
-        }
-    } else {
-        DLOG(INFO) << "no procedures in db";
-    }
     openmldb::catalog::Procedures db_sp_map;
-    for (const auto& node : sp_datas) {
-        if (node.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(sp_root_path_ + "/" + node, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure data. node: " << node;
-            continue;
-        }
-        std::string uncompressed;
-        ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
-        ::openmldb::api::ProcedureInfo sp_info_pb;
-        ok = sp_info_pb.ParseFromString(uncompressed);
-        if (!ok) {
-            LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
-            continue;
-        }
-        auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
-        if (!sp_info) {
-            LOG(WARNING) << "convert procedure info failed, sp_name: " << sp_info_pb.sp_name()
-                         << " db: " << sp_info_pb.db_name();
-            continue;
-        }
-        auto it = db_sp_map.find(sp_info->GetDbName());
-        if (it == db_sp_map.end()) {
-            std::map<std::string, std::shared_ptr<hybridse::sdk::ProcedureInfo>> sp_in_db = {
-                {sp_info->GetSpName(), sp_info}};
-            db_sp_map.insert(std::make_pair(sp_info->GetDbName(), sp_in_db));
-        } else {
-            it->second.insert(std::make_pair(sp_info->GetSpName(), sp_info));
-        }
+    for (const auto& kv : catalog_cache_->GetProcedures()) {
+        auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(*kv.second);
+        db_sp_map[sp_info->GetDbName()].emplace(sp_info->GetSpName(), sp_info);
     }
     auto old_db_sp_map = catalog_->GetProcedures();
     bool updated = false;
@@ -4568,7 +5152,9 @@ void TabletImpl::SchedDelBinlog(uint32_t tid, uint32_t pid) {
         // TODO(nauta): need better way to handle aggregator volatile status lost.
         bool deleted = false;
         replicator->DeleteBinlog(&deleted);
+        replicator->RemoveIdleSubscribers();
         if (deleted) {
+            WaitAggrUpdates(tid, pid);
             auto aggrs = GetAggregators(tid, pid);
             if (aggrs) {
                 for (auto& aggr : *aggrs) {
@@ -4813,6 +5399,7 @@ void TabletImpl::SendIndexData(RpcController* controller, const ::openmldb::api:
 void TabletImpl::SendIndexDataInternal(std::shared_ptr<::openmldb::storage::Table> table,
                                        const std::map<uint32_t, std::string>& pid_endpoint_map,
                                        std::shared_ptr<::openmldb::api::TaskInfo> task_ptr) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     uint32_t tid = table->GetId();
     uint32_t pid = table->GetPid();
     std::string db_root_path;
@@ -4904,6 +5491,7 @@ void TabletImpl::ExtractIndexDataInternal(std::shared_ptr<::openmldb::storage::T
                                           const std::vector<::openmldb::common::ColumnKey>& column_keys,
                                           uint32_t partition_num, uint64_t offset, bool dump_data,
                                           std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     uint32_t tid = table->GetId();
     uint32_t pid = table->GetPid();
     std::string db_root_path;
@@ -4999,6 +5587,7 @@ void TabletImpl::LoadIndexData(RpcController* controller, const ::openmldb::api:
 
 void TabletImpl::LoadIndexDataInternal(uint32_t tid, uint32_t pid, uint32_t cur_pid, uint32_t partition_num,
                                        uint64_t last_time, std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
     uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
     if (cur_pid == pid) {
         task_pool_.AddTask(boost::bind(&TabletImpl::LoadIndexDataInternal, this, tid, pid, cur_pid + 1, partition_num,
@@ -5167,6 +5756,187 @@ void TabletImpl::ExtractIndexData(RpcController* controller, const ::openmldb::a
     SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
 }
 
+void TabletImpl::BuildIndexData(RpcController* controller, const ::openmldb::api::BuildIndexDataRequest* request,
+                                ::openmldb::api::GeneralResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    std::shared_ptr<::openmldb::api::TaskInfo> task_ptr;
+    if (request->has_task_info() && request->task_info().IsInitialized()) {
+        if (AddOPTask(request->task_info(), ::openmldb::api::TaskType::kBuildIndexRequest, task_ptr) < 0) {
+            base::SetResponseStatus(-1, "add task failed", response);
+            return;
+        }
+    }
+    do {
+        uint32_t tid = request->tid();
+        uint32_t pid = request->pid();
+        auto table = GetTable(tid, pid);
+        if (!table) {
+            PDLOG(WARNING, "table does not exist. tid %u pid %u", tid, pid);
+            base::SetResponseStatus(base::ReturnCode::kTableIsNotExist, "table does not exist", response);
+            break;
+        }
+        if (table->GetStorageMode() != ::openmldb::common::kMemory) {
+            PDLOG(WARNING, "only support mem_table. tid %u pid %u", tid, pid);
+            base::SetResponseStatus(base::ReturnCode::kOperatorNotSupport, "only support mem_table", response);
+            break;
+        }
+        if (table->GetTableStat() != ::openmldb::storage::kNormal) {
+            PDLOG(WARNING, "table state is %d, cannot build index data. tid %u, pid %u", table->GetTableStat(), tid,
+                  pid);
+            base::SetResponseStatus(base::ReturnCode::kTableStatusIsNotKnormal, "table status is not kNormal",
+                                    response);
+            break;
+        }
+        if (!table->IsLeader()) {
+            PDLOG(WARNING, "table is follower, cannot build index data. tid %u, pid %u", tid, pid);
+            base::SetResponseStatus(base::ReturnCode::kTableIsFollower, "table is follower", response);
+            break;
+        }
+        if (request->column_key_size() == 0 || request->partition_num() == 0) {
+            base::SetResponseStatus(base::ReturnCode::kInvalidParameter, "no index or partition num", response);
+            break;
+        }
+        std::vector<::openmldb::common::ColumnKey> column_keys(request->column_key().begin(),
+                                                               request->column_key().end());
+        std::map<uint32_t, std::string> pid_endpoint_map;
+        for (const auto& pair : request->pairs()) {
+            pid_endpoint_map.emplace(pair.pid(), pair.endpoint());
+        }
+        task_pool_.AddTask(boost::bind(&TabletImpl::BuildIndexDataInternal, this, table, column_keys,
+                                       request->partition_num(), pid_endpoint_map, task_ptr));
+        base::SetResponseOK(response);
+        return;
+    } while (0);
+    SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
+}
+
+void TabletImpl::BuildIndexDataInternal(std::shared_ptr<::openmldb::storage::Table> table,
+                                        const std::vector<::openmldb::common::ColumnKey>& column_keys,
+                                        uint32_t partition_num, const std::map<uint32_t, std::string>& pid_endpoint_map,
+                                        std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    WorkloadPermit permit(workload_scheduler_.get(), WorkloadClass::kBackground);
+    uint32_t tid = table->GetId();
+    uint32_t pid = table->GetPid();
+    auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+    if (!mem_table) {
+        PDLOG(WARNING, "table is not memtable. tid %u, pid %u", tid, pid);
+        SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    // the entries of partitions on the other tablets are sent by rpc, the others are put directly
+    std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>> clients;
+    for (const auto& kv : pid_endpoint_map) {
+        if (kv.first == pid || kv.second == endpoint_) {
+            continue;
+        }
+        std::string real_endpoint = kv.second;
+        if (FLAGS_use_name) {
+            auto tmp_map = std::atomic_load_explicit(&real_ep_map_, std::memory_order_acquire);
+            auto iter = tmp_map->find(kv.second);
+            if (iter == tmp_map->end()) {
+                PDLOG(WARNING, "name %s not found in real_ep_map. tid %u pid %u", kv.second.c_str(), tid, pid);
+                SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
+                return;
+            }
+            real_endpoint = iter->second;
+        }
+        auto client = std::make_shared<::openmldb::client::TabletClient>(kv.second, real_endpoint);
+        if (client->Init() < 0) {
+            PDLOG(WARNING, "init client failed. endpoint %s tid %u pid %u", kv.second.c_str(), tid, pid);
+            SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
+            return;
+        }
+        clients.emplace(kv.first, client);
+    }
+    ::openmldb::storage::IndexBuilder builder(mem_table, column_keys, partition_num);
+    auto status = builder.Init();
+    if (!status.OK()) {
+        PDLOG(WARNING, "init index builder failed. tid %u pid %u msg %s", tid, pid, status.GetMsg().c_str());
+        SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    SetTaskProgress(task, 0, builder.GetTotalCnt());
+    auto handler = [&](uint32_t dst_pid, ::openmldb::storage::IndexEntries* entries) -> base::Status {
+        ::openmldb::api::TaskStatus task_status = ::openmldb::api::TaskStatus::kDoing;
+        if (task && (GetTaskStatus(task, &task_status) < 0 || task_status != ::openmldb::api::TaskStatus::kDoing)) {
+            return {-1, "task is terminated"};
+        }
+        base::Status status;
+        auto iter = clients.find(dst_pid);
+        if (iter != clients.end()) {
+            status = iter->second->PutIndexEntries(tid, dst_pid, entries);
+        } else {
+            status = PutIndexEntriesInternal(tid, dst_pid, *entries);
+        }
+        SetTaskProgress(task, builder.GetScannedCnt(), builder.GetTotalCnt());
+        if (!status.OK()) {
+            return {status.GetCode(), absl::StrCat("put index entries to pid ", dst_pid, " failed. ", status.GetMsg())};
+        }
+        return {};
+    };
+    status = builder.Build(FLAGS_build_index_thread_num, FLAGS_build_index_batch_size,
+                           FLAGS_build_index_max_rows_per_sec, handler);
+    if (status.OK()) {
+        PDLOG(INFO, "build index on table tid[%u] pid[%u] succeed", tid, pid);
+        SetTaskStatus(task, ::openmldb::api::TaskStatus::kDone);
+    } else {
+        PDLOG(WARNING, "fail to build index on table tid[%u] pid[%u] msg[%s]", tid, pid, status.GetMsg().c_str());
+        ::openmldb::api::TaskStatus task_status = ::openmldb::api::TaskStatus::kDoing;
+        // keep the status if it's canceled
+        if (GetTaskStatus(task, &task_status) == 0 && task_status == ::openmldb::api::TaskStatus::kDoing) {
+            SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
+        }
+    }
+}
+
+void TabletImpl::PutIndexEntries(RpcController* controller, const ::openmldb::api::PutIndexEntriesRequest* request,
+                                 ::openmldb::api::GeneralResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    auto status = PutIndexEntriesInternal(request->tid(), request->pid(), request->entries());
+    base::SetResponseStatus(status, response);
+}
+
+base::Status TabletImpl::PutIndexEntriesInternal(
+    uint32_t tid, uint32_t pid, const ::google::protobuf::RepeatedPtrField<::openmldb::api::LogEntry>& entries) {
+    auto table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table does not exist. tid %u pid %u", tid, pid);
+        return {base::ReturnCode::kTableIsNotExist, "table does not exist"};
+    }
+    if (!table->IsLeader()) {
+        return {base::ReturnCode::kTableIsFollower, "table is follower"};
+    }
+    auto replicator = GetReplicator(tid, pid);
+    if (!replicator) {
+        PDLOG(WARNING, "replicator does not exist. tid %u pid %u", tid, pid);
+        return {base::ReturnCode::kReplicatorIsNotExist, "replicator does not exist"};
+    }
+    uint64_t put_cnt = 0;
+    base::Status status;
+    ::openmldb::api::LogEntry entry;
+    for (const auto& cur_entry : entries) {
+        // the row may have been put with the new indexes by the client since the index is added, and a retried
+        // request may carry the entries put already
+        auto st = table->Put(cur_entry.ts(), cur_entry.value(), cur_entry.dimensions(), true);
+        if (absl::IsAlreadyExists(st)) {
+            continue;
+        }
+        if (!st.ok()) {
+            PDLOG(WARNING, "put index entry failed. tid %u pid %u msg %s", tid, pid, st.ToString().c_str());
+            status = {base::ReturnCode::kPutFailed, absl::StrCat("put index entry failed. ", st.ToString())};
+            break;
+        }
+        entry.CopyFrom(cur_entry);
+        entry.set_term(replicator->GetLeaderTerm());
+        replicator->AppendEntry(entry);
+        put_cnt++;
+    }
+    if (put_cnt > 0 && FLAGS_binlog_notify_on_put) {
+        replicator->Notify();
+    }
+    return status;
+}
+
 void TabletImpl::AddIndex(RpcController* controller, const ::openmldb::api::AddIndexRequest* request,
                           ::openmldb::api::GeneralResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -5400,6 +6170,10 @@ void TabletImpl::DropProcedure(RpcController* controller, const ::openmldb::api:
         } else {
             LOG(INFO) << "deleted deploy collector for " << collector_key;
         }
+        s = deploy_runner_collector_->DeleteDeploy(db_name, sp_name);
+        if (!s.ok()) {
+            LOG(ERROR) << "[ERROR] delete deploy runner collector: " << s;
+        }
     }
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
@@ -5451,6 +6225,77 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
     response.set_code(::openmldb::base::kOk);
 }
 
+void TabletImpl::RunCachedRequestQuery(RpcController* ctrl, const openmldb::api::QueryRequest& request,
+                                       const hybridse::sdk::ProcedureInfo& sp_info, ResultCache* result_cache,
+                                       ::hybridse::vm::RequestRunSession& session,
+                                       openmldb::api::QueryResponse& response, butil::IOBuf& buf) {
+    auto& request_buf = dynamic_cast<brpc::Controller*>(ctrl)->request_attachment();
+    if (request_buf.size() < request.row_size()) {
+        RunRequestQuery(ctrl, request, session, response, buf);
+        return;
+    }
+    std::string key;
+    if (request.has_task_id()) {
+        key = absl::StrCat(request.task_id(), ":", request.row_slices(), ":");
+    } else {
+        key = absl::StrCat(":", request.row_slices(), ":");
+    }
+    request_buf.append_to(&key, request.row_size());
+    std::vector<uint64_t> offsets;
+    GetInputOffsets(sp_info, &offsets);
+    std::string value;
+    if (result_cache->Get(key, offsets, &value)) {
+        buf.append(value);
+        if (!request.has_task_id()) {
+            response.set_schema(session.GetEncodedSchema());
+        }
+        response.set_byte_size(value.size());
+        response.set_count(1);
+        response.set_row_slices(1);
+        response.set_code(::openmldb::base::kOk);
+        return;
+    }
+    size_t buf_size = buf.size();
+    RunRequestQuery(ctrl, request, session, response, buf);
+    if (response.code() != ::openmldb::base::kOk) {
+        return;
+    }
+    // the offsets are read before the run, the result is not cached if the input changes in the meantime
+    std::vector<uint64_t> end_offsets;
+    GetInputOffsets(sp_info, &end_offsets);
+    if (end_offsets != offsets) {
+        return;
+    }
+    buf.copy_to(&value, buf.size() - buf_size, buf_size);
+    result_cache->Put(key, offsets, value);
+}
+
+void TabletImpl::GetInputOffsets(const hybridse::sdk::ProcedureInfo& sp_info, std::vector<uint64_t>* offsets) {
+    const auto& dbs = sp_info.GetDbs();
+    const auto& tables = sp_info.GetTables();
+    // resolve the tables out of spin_mutex_, then read all the replicators in one critical section
+    std::vector<uint64_t> tids;
+    for (size_t i = 0; i < tables.size() && i < dbs.size(); i++) {
+        auto handler = std::dynamic_pointer_cast<catalog::TabletTableHandler>(catalog_->GetTable(dbs[i], tables[i]));
+        tids.push_back(handler ? handler->GetTid() : UINT64_MAX);
+    }
+    std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+    for (uint64_t tid : tids) {
+        offsets->push_back(tid);
+        if (tid == UINT64_MAX) {
+            continue;
+        }
+        auto it = replicators_.find(static_cast<uint32_t>(tid));
+        if (it == replicators_.end()) {
+            continue;
+        }
+        for (const auto& kv : it->second) {
+            offsets->push_back(kv.first);
+            offsets->push_back(kv.second->GetOffset());
+        }
+    }
+}
+
 void TabletImpl::CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info) {
     const std::string& db_name = sp_info->GetDbName();
     const std::string& sp_name = sp_info->GetSpName();
@@ -5555,6 +6400,109 @@ void TabletImpl::TryCollectDeployStats(const std::string& db, const std::string&
     DLOG(INFO) << "collect " << db << "." << name << " latency " << time;
 }
 
+bool TabletImpl::ShouldProfileDeploy() {
+    uint32_t interval = FLAGS_deploy_profile_sample_interval;
+    if (interval == 0) {
+        return false;
+    }
+    return deploy_request_cnt_.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+}
+
+base::Status TabletImpl::CheckFollowerRead(const ::openmldb::api::FollowerRead& follower_read) {
+    uint32_t tid = follower_read.tid();
+    uint32_t pid = follower_read.pid();
+    auto table = GetTable(tid, pid);
+    if (!table) {
+        return {::openmldb::base::ReturnCode::kTableIsNotExist, "table does not exist"};
+    }
+    if (table->IsLeader()) {
+        return {};
+    }
+    if (!FLAGS_enable_follower_read) {
+        return {::openmldb::base::ReturnCode::kTableIsFollower, "follower read is disabled"};
+    }
+    auto replicator = GetReplicator(tid, pid);
+    if (!replicator) {
+        return {::openmldb::base::ReturnCode::kReplicatorIsNotExist, "replicator does not exist"};
+    }
+    uint64_t lag = 0;
+    if (!replicator->GetFollowerLag(&lag)) {
+        return {::openmldb::base::ReturnCode::kFollowerLagTooLarge, "the log offset of the leader is unknown"};
+    }
+    if (lag > follower_read.max_lag()) {
+        DLOG(INFO) << "follower of tid " << tid << " pid " << pid << " lags " << lag << " entries";
+        return {::openmldb::base::ReturnCode::kFollowerLagTooLarge,
+                absl::StrCat("follower lags ", lag, " entries behind the leader")};
+    }
+    return {};
+}
+
+void TabletImpl::SchedSyncFollowerCatalog() {
+    std::vector<std::shared_ptr<Table>> followers;
+    {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        for (const auto& tid_kv : tables_) {
+            for (const auto& pid_kv : tid_kv.second) {
+                if (!pid_kv.second->IsLeader() && !pid_kv.second->GetDB().empty()) {
+                    followers.push_back(pid_kv.second);
+                }
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(follower_catalog_mu_);
+        // the partitions dropped or changed to leader are not followed any more
+        for (auto it = follower_catalog_tables_.begin(); it != follower_catalog_tables_.end();) {
+            auto table = GetTable(it->first.first, it->first.second);
+            if (!table || table->IsLeader()) {
+                it = follower_catalog_tables_.erase(it);
+            } else {
+                it++;
+            }
+        }
+        for (const auto& table : followers) {
+            uint32_t tid = table->GetId();
+            uint32_t pid = table->GetPid();
+            // dropped or changed to leader since the tables are copied
+            if (GetTable(tid, pid) != table || table->IsLeader()) {
+                continue;
+            }
+            auto replicator = GetReplicator(tid, pid);
+            uint64_t lag = 0;
+            bool readable = table->GetTableStat() == ::openmldb::storage::kNormal && replicator &&
+                            replicator->GetFollowerLag(&lag) && lag <= FLAGS_follower_read_max_lag;
+            auto key = std::make_pair(tid, pid);
+            auto it = follower_catalog_tables_.find(key);
+            if (readable && (it == follower_catalog_tables_.end() || it->second != table)) {
+                if (catalog_->AddTable(*(table->GetTableMeta()), table)) {
+                    follower_catalog_tables_[key] = table;
+                    LOG(INFO) << "add follower to catalog. tid " << tid << " pid " << pid;
+                }
+            } else if (!readable && it != follower_catalog_tables_.end()) {
+                catalog_->DeleteTable(table->GetDB(), table->GetName(), tid, pid);
+                follower_catalog_tables_.erase(it);
+                LOG(INFO) << "remove follower from catalog. tid " << tid << " pid " << pid << " lag " << lag;
+            }
+        }
+    }
+    task_pool_.DelayTask(FLAGS_follower_read_check_interval, boost::bind(&TabletImpl::SchedSyncFollowerCatalog, this));
+}
+
+void TabletImpl::CollectDeployProfile(const std::string& db, const std::string& name,
+                                      const ::hybridse::vm::RunnerProfile& profile) {
+    for (const auto& kv : profile.GetAll()) {
+        const auto& stat = kv.second;
+        if (stat.run_cnt == 0) {
+            continue;
+        }
+        auto st = deploy_runner_collector_->Collect(db, name, absl::StrCat(kv.first, "_", stat.runner_type),
+                                                    absl::Microseconds(stat.time_us / stat.run_cnt));
+        if (!st.ok()) {
+            DLOG(WARNING) << "collect runner " << kv.first << " of " << db << "." << name << " failed: " << st;
+        }
+    }
+}
+
 void TabletImpl::BulkLoad(RpcController* controller, const ::openmldb::api::BulkLoadRequest* request,
                           ::openmldb::api::GeneralResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -29,6 +29,7 @@
 #include "base/spinlock.h"
 #include "brpc/server.h"
 #include "catalog/tablet_catalog.h"
+#include "catalog/zk_catalog_cache.h"
 #include "common/thread_pool.h"
 #include "nameserver/system_table.h"
 #include "proto/tablet.pb.h"
@@ -42,6 +43,7 @@
 #include "tablet/combine_iterator.h"
 #include "tablet/file_receiver.h"
 #include "tablet/sp_cache.h"
+#include "tablet/workload_scheduler.h"
 #include "vm/engine.h"
 #include "zk/zk_client.h"
 
@@ -85,6 +87,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void Put(RpcController* controller, const ::openmldb::api::PutRequest* request,
              ::openmldb::api::PutResponse* response, Closure* done);
 
+    void BatchPut(RpcController* controller, const ::openmldb::api::BatchPutRequest* request,
+                  ::openmldb::api::BatchPutResponse* response, Closure* done);
+
     void Get(RpcController* controller, const ::openmldb::api::GetRequest* request,
              ::openmldb::api::GetResponse* response, Closure* done);
 
@@ -100,6 +105,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void Traverse(RpcController* controller, const ::openmldb::api::TraverseRequest* request,
                   ::openmldb::api::TraverseResponse* response, Closure* done);
 
+    void MultiKeyTraverse(RpcController* controller, const ::openmldb::api::MultiKeyTraverseRequest* request,
+                          ::openmldb::api::MultiKeyTraverseResponse* response, Closure* done);
+
     void CreateTable(RpcController* controller, const ::openmldb::api::CreateTableRequest* request,
                      ::openmldb::api::CreateTableResponse* response, Closure* done);
 
@@ -124,6 +132,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void AppendEntries(RpcController* controller, const ::openmldb::api::AppendEntriesRequest* request,
                        ::openmldb::api::AppendEntriesResponse* response, Closure* done);
 
+    void SubscribeBinlog(RpcController* controller, const ::openmldb::api::SubscribeBinlogRequest* request,
+                         ::openmldb::api::SubscribeBinlogResponse* response, Closure* done);
+
     void UpdateTableMetaForAddField(RpcController* controller,
                                     const ::openmldb::api::UpdateTableMetaForAddFieldRequest* request,
                                     ::openmldb::api::GeneralResponse* response, Closure* done);
@@ -215,6 +226,12 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void SendIndexData(RpcController* controller, const ::openmldb::api::SendIndexDataRequest* request,
                        ::openmldb::api::GeneralResponse* response, Closure* done);
 
+    void BuildIndexData(RpcController* controller, const ::openmldb::api::BuildIndexDataRequest* request,
+                        ::openmldb::api::GeneralResponse* response, Closure* done);
+
+    void PutIndexEntries(RpcController* controller, const ::openmldb::api::PutIndexEntriesRequest* request,
+                         ::openmldb::api::GeneralResponse* response, Closure* done);
+
     void Query(RpcController* controller, const openmldb::api::QueryRequest* request,
                openmldb::api::QueryResponse* response, Closure* done);
 
@@ -244,7 +261,8 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     int32_t ScanIndex(const ::openmldb::api::ScanRequest* request, const ::openmldb::api::TableMeta& meta,
                       const std::map<int32_t, std::shared_ptr<Schema>>& vers_schema, bool use_attachment,
-                      CombineIterator* combine_it, butil::IOBuf* buf, uint32_t* count, bool* is_finish);
+                      CombineIterator* combine_it, const ::openmldb::storage::AggrWatermark* watermark,
+                      int64_t watermark_ts, butil::IOBuf* buf, uint32_t* count, bool* is_finish);
 
     int32_t CountIndex(uint64_t expire_time, uint64_t expire_cnt, ::openmldb::storage::TTLType ttl_type,
                        ::openmldb::storage::TableIterator* it, const ::openmldb::api::CountRequest* request,
@@ -333,6 +351,16 @@ class TabletImpl : public ::openmldb::api::TabletServer {
                                   const std::vector<::openmldb::common::ColumnKey>& column_key, uint32_t partition_num,
                                   uint64_t offset, bool contain_dump, std::shared_ptr<::openmldb::api::TaskInfo> task);
 
+    void BuildIndexDataInternal(std::shared_ptr<::openmldb::storage::Table> table,
+                                const std::vector<::openmldb::common::ColumnKey>& column_keys, uint32_t partition_num,
+                                const std::map<uint32_t, std::string>& pid_endpoint_map,
+                                std::shared_ptr<::openmldb::api::TaskInfo> task);
+
+    // put the entries of new indexes into the leader partition and its binlog, the entries which are in the table
+    // already are skipped
+    base::Status PutIndexEntriesInternal(uint32_t tid, uint32_t pid,
+                                         const ::google::protobuf::RepeatedPtrField<::openmldb::api::LogEntry>& entries);
+
     void SchedMakeSnapshot();
 
     void GetDiskused();
@@ -370,10 +398,16 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     int GetTaskStatus(const std::shared_ptr<::openmldb::api::TaskInfo>& task_ptr, ::openmldb::api::TaskStatus* status);
 
+    void SetTaskProgress(const std::shared_ptr<::openmldb::api::TaskInfo>& task_ptr, uint64_t processed_cnt,
+                         uint64_t total_cnt);
+
     bool IsExistTaskUnLock(const ::openmldb::api::TaskInfo& task);
 
     int CheckDimessionPut(const ::openmldb::api::PutRequest* request, uint32_t idx_cnt);
 
+    // check if the rows can be put to the table now
+    base::Status CheckPutTable(const std::shared_ptr<Table>& table, uint32_t memory_limit);
+
     // sync log data from page cache to disk
     void SchedSyncDisk(uint32_t tid, uint32_t pid);
 
@@ -414,6 +448,18 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     bool UpdateAggrs(uint32_t tid, uint32_t pid, const std::string& value,
                      const ::openmldb::storage::Dimensions& dimensions, uint64_t log_offset);
 
+    // the pool applying the rows of the partition to its aggregators, null if they are updated on put
+    ThreadPool* GetAggrUpdatePool(uint32_t tid, uint32_t pid);
+
+    // wait for the rows queued before to be applied to the aggregators of the partition
+    void WaitAggrUpdates(uint32_t tid, uint32_t pid);
+
+    // wait while too many rows are queued for the aggregators of the partition, called before the replicator lock
+    void WaitAggrPending(uint32_t tid, uint32_t pid);
+
+    // the aggregator is not removed from the partition, e.g. by dropping its pre-aggr table
+    bool HasAggregator(uint32_t tid, uint32_t pid, const std::shared_ptr<Aggregator>& aggr);
+
     bool CreateAggregatorInternal(const ::openmldb::api::CreateAggregatorRequest* request,
                                   std::string& msg);  // NOLINT
 
@@ -428,10 +474,32 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     // collect deploy statistics into memory
     void TryCollectDeployStats(const std::string& db, const std::string& name, absl::Time start_time);
 
+    // sample the deployment requests to profile by FLAGS_deploy_profile_sample_interval
+    bool ShouldProfileDeploy();
+
+    // export the time of every runner in the profile of a deployment request
+    void CollectDeployProfile(const std::string& db, const std::string& name,
+                              const ::hybridse::vm::RunnerProfile& profile);
+
+    // check that the follower partition of a follower read is within the lag bound of the client
+    base::Status CheckFollowerRead(const ::openmldb::api::FollowerRead& follower_read);
+
+    // add the follower partitions within --follower_read_max_lag to the catalog, and remove the others
+    void SchedSyncFollowerCatalog();
+
     void RunRequestQuery(RpcController* controller, const openmldb::api::QueryRequest& request,
                          ::hybridse::vm::RequestRunSession& session,                  // NOLINT
                          openmldb::api::QueryResponse& response, butil::IOBuf& buf);  // NOLINT
 
+    // run the request of a deployment which enables the result cache, the execution is skipped on a hit
+    void RunCachedRequestQuery(RpcController* controller, const openmldb::api::QueryRequest& request,
+                               const hybridse::sdk::ProcedureInfo& sp_info, ResultCache* result_cache,
+                               ::hybridse::vm::RequestRunSession& session,                  // NOLINT
+                               openmldb::api::QueryResponse& response, butil::IOBuf& buf);  // NOLINT
+
+    // the pids and the log offsets of the local partitions of the input tables of the deployment
+    void GetInputOffsets(const hybridse::sdk::ProcedureInfo& sp_info, std::vector<uint64_t>* offsets);
+
     void CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info);
 
     // refresh the pre-aggr tables info
@@ -452,6 +520,12 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     ThreadPool task_pool_;
     ThreadPool io_pool_;
     ThreadPool snapshot_pool_;
+    // single thread pools, the rows of a partition are applied to its aggregators by one of them in order
+    std::vector<std::unique_ptr<ThreadPool>> aggr_update_pools_;
+    // the failed aggr updates are retried until the tablet stops
+    std::atomic<bool> aggr_update_stopped_ = false;
+    // admission control of the rpcs and the background tasks by workload class
+    std::unique_ptr<WorkloadScheduler> workload_scheduler_;
     std::map<uint64_t, std::list<std::shared_ptr<::openmldb::api::TaskInfo>>> task_map_;
     std::set<std::string> sync_snapshot_set_;
     std::map<std::string, std::shared_ptr<FileReceiver>> file_receiver_map_;
@@ -470,15 +544,22 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::string endpoint_;
     std::shared_ptr<SpCache> sp_cache_;
     std::string notify_path_;
-    std::string sp_root_path_;
+    // guarded by refresh_table_mu_
+    std::unique_ptr<::openmldb::catalog::ZkCatalogCache> catalog_cache_;
+    std::mutex refresh_table_mu_;
     std::string globalvar_changed_notify_path_;
     ::openmldb::type::StartupMode startup_mode_;
 
     std::shared_ptr<std::map<std::string, std::string>> global_variables_;
 
     std::unique_ptr<openmldb::statistics::DeploymentMetricCollector> deploy_collector_;
+    std::unique_ptr<openmldb::statistics::DeploymentRunnerMetricCollector> deploy_runner_collector_;
+    std::atomic<uint64_t> deploy_request_cnt_ = 0;
     std::atomic<uint64_t> memory_used_ = 0;
     std::atomic<uint32_t> system_memory_usage_rate_ = 0;  // [0, 100]
+    // the follower partitions in the catalog and the tables added for them
+    std::mutex follower_catalog_mu_;
+    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<Table>> follower_catalog_tables_;
 };
 
 }  // namespace tablet
@@ -669,6 +669,133 @@ TEST_P(TabletProjectTest, scan_case) {
     }
 }
 
+TEST_P(TabletProjectTest, filter_case) {
+    auto args = GetParam();
+    std::string name = ::openmldb::tablet::GenRand();
+    int tid = rand() % 10000000;  // NOLINT
+    MockClosure closure;
+    // create a table
+    {
+        ::openmldb::api::CreateTableRequest crequest;
+        ::openmldb::api::TableMeta* table_meta = crequest.mutable_table_meta();
+        table_meta->set_name(name);
+        table_meta->set_tid(tid);
+        table_meta->set_pid(0);
+        table_meta->set_seg_cnt(8);
+        table_meta->set_mode(::openmldb::api::TableMode::kTableLeader);
+        table_meta->set_key_entry_max_height(8);
+        table_meta->set_storage_mode(args->storage_mode);
+        Schema* schema = table_meta->mutable_column_desc();
+        schema->CopyFrom(args->schema);
+        ::openmldb::common::ColumnKey* ck = table_meta->add_column_key();
+        ck->CopyFrom(args->ckey);
+        ::openmldb::api::CreateTableResponse cresponse;
+        tablet_.CreateTable(NULL, &crequest, &cresponse, &closure);
+        ASSERT_EQ(0, cresponse.code());
+    }
+    // put a record
+    {
+        ::openmldb::api::PutRequest request;
+        request.set_tid(tid);
+        request.set_pid(0);
+        ::openmldb::api::Dimension* dim = request.add_dimensions();
+        dim->set_idx(0);
+        dim->set_key(args->pk);
+        request.set_value(args->input_row);
+        ::openmldb::api::PutResponse response;
+        tablet_.Put(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    for (auto op : {::openmldb::common::kCmpIsNull, ::openmldb::common::kCmpIsNotNull}) {
+        uint32_t expect_cnt = op == ::openmldb::common::kCmpIsNull ? 0 : 1;
+        ::openmldb::common::FilterCondition filter;
+        filter.set_col_idx(args->plist.Get(0));
+        filter.set_op(op);
+        // scan with filter and projectlist
+        {
+            ::openmldb::api::ScanRequest sr;
+            sr.set_tid(tid);
+            sr.set_pid(0);
+            sr.set_pk(args->pk);
+            sr.set_st(args->ts);
+            sr.set_et(0);
+            sr.mutable_projection()->CopyFrom(args->plist);
+            sr.add_filter()->CopyFrom(filter);
+            auto srp = std::make_shared<::openmldb::api::ScanResponse>();
+            tablet_.Scan(NULL, &sr, srp.get(), &closure);
+            ASSERT_EQ(0, srp->code());
+            ASSERT_EQ(expect_cnt, srp->count());
+            ::openmldb::base::ScanKvIterator kv_it(args->pk, srp);
+            ASSERT_EQ(expect_cnt > 0, kv_it.Valid());
+            if (kv_it.Valid()) {
+                ASSERT_EQ(kv_it.GetValue().size(), args->output_row.size());
+                codec::RowView left(args->output_schema);
+                left.Reset(reinterpret_cast<const int8_t*>(kv_it.GetValue().data()), kv_it.GetValue().size());
+                codec::RowView right(args->output_schema);
+                right.Reset(reinterpret_cast<int8_t*>(args->output_row.data()), args->output_row.size());
+                CompareRow(&left, &right, args->output_schema);
+            }
+        }
+        // traverse with filter, the filtered rows count toward the limit
+        {
+            ::openmldb::api::TraverseRequest sr;
+            sr.set_tid(tid);
+            sr.set_pid(0);
+            sr.set_limit(1);
+            sr.add_filter()->CopyFrom(filter);
+            auto srp = std::make_shared<::openmldb::api::TraverseResponse>();
+            tablet_.Traverse(NULL, &sr, srp.get(), &closure);
+            ASSERT_EQ(0, srp->code());
+            ASSERT_EQ(expect_cnt, srp->count());
+            ASSERT_FALSE(srp->is_finish());
+            ASSERT_EQ(args->pk, srp->pk());
+            ::openmldb::base::TraverseKvIterator kv_it(srp);
+            ASSERT_EQ(expect_cnt > 0, kv_it.Valid());
+            if (kv_it.Valid()) {
+                ASSERT_EQ(args->pk, kv_it.GetPK());
+                ASSERT_EQ(args->input_row, kv_it.GetValue().ToString());
+            }
+            // continue from the position of the filtered row
+            sr.set_pk(srp->pk());
+            sr.set_ts(srp->ts());
+            sr.set_ts_pos(srp->ts_pos());
+            srp = std::make_shared<::openmldb::api::TraverseResponse>();
+            tablet_.Traverse(NULL, &sr, srp.get(), &closure);
+            ASSERT_EQ(0, srp->code());
+            ASSERT_EQ(0u, srp->count());
+            ASSERT_TRUE(srp->is_finish());
+        }
+    }
+    // the invalid filter is rejected
+    {
+        ::openmldb::api::ScanRequest sr;
+        sr.set_tid(tid);
+        sr.set_pid(0);
+        sr.set_pk(args->pk);
+        sr.set_st(args->ts);
+        sr.set_et(0);
+        auto filter = sr.add_filter();
+        filter->set_col_idx(args->schema.size());
+        filter->set_op(::openmldb::common::kCmpEq);
+        filter->set_value("1");
+        ::openmldb::api::ScanResponse srp;
+        tablet_.Scan(NULL, &sr, &srp, &closure);
+        ASSERT_EQ(::openmldb::base::ReturnCode::kInvalidParameter, srp.code());
+    }
+    {
+        ::openmldb::api::TraverseRequest sr;
+        sr.set_tid(tid);
+        sr.set_pid(0);
+        auto filter = sr.add_filter();
+        filter->set_col_idx(args->schema.size());
+        filter->set_op(::openmldb::common::kCmpEq);
+        filter->set_value("1");
+        ::openmldb::api::TraverseResponse srp;
+        tablet_.Traverse(NULL, &sr, &srp, &closure);
+        ASSERT_EQ(::openmldb::base::ReturnCode::kInvalidParameter, srp.code());
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(TabletProjectPrefix, TabletProjectTest, testing::ValuesIn(GenCommonCase()));
 
 }  // namespace tablet
@@ -1460,6 +1460,54 @@ TEST_P(TabletImplTest, Truncate) {
     ASSERT_EQ(0, (signed)srp->count());
 }
 
+TEST_P(TabletImplTest, BatchPut) {
+    ::openmldb::common::StorageMode storage_mode = GetParam();
+    TabletImpl tablet;
+    uint32_t id = counter++;
+    tablet.Init("");
+    ASSERT_EQ(0, CreateDefaultTable("db0", "t0", id, 1, 0, 0, kAbsoluteTime, storage_mode, &tablet));
+    MockClosure closure;
+    ::openmldb::api::BatchPutRequest request;
+    request.set_tid(id);
+    request.set_pid(1);
+    for (int ts = 100; ts < 150; ts++) {
+        auto* row = request.add_rows();
+        PackDefaultDimension("test" + std::to_string(ts % 5), row);
+        row->set_time(ts);
+        row->set_value(::openmldb::test::EncodeKV("test", "test" + std::to_string(ts)));
+    }
+    ::openmldb::api::BatchPutResponse response;
+    tablet.BatchPut(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    ASSERT_EQ(50u, response.put_cnt());
+    ::openmldb::api::TraverseRequest sr;
+    sr.set_tid(id);
+    sr.set_pid(1);
+    sr.set_limit(1000);
+    auto srp = std::make_shared<::openmldb::api::TraverseResponse>();
+    tablet.Traverse(NULL, &sr, srp.get(), &closure);
+    ASSERT_EQ(0, srp->code());
+    ASSERT_EQ(50, (signed)srp->count());
+
+    // the rows before the invalid one are put
+    request.clear_rows();
+    for (int ts = 200; ts < 210; ts++) {
+        auto* row = request.add_rows();
+        PackDefaultDimension(ts == 205 ? "" : "test0", row);
+        row->set_time(ts);
+        row->set_value(::openmldb::test::EncodeKV("test", "test" + std::to_string(ts)));
+    }
+    tablet.BatchPut(NULL, &request, &response, &closure);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kInvalidDimensionParameter, response.code());
+    ASSERT_EQ(5u, response.put_cnt());
+    tablet.Traverse(NULL, &sr, srp.get(), &closure);
+    ASSERT_EQ(55, (signed)srp->count());
+
+    request.set_pid(2);
+    tablet.BatchPut(NULL, &request, &response, &closure);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kTableIsNotExist, response.code());
+}
+
 TEST_P(TabletImplTest, Traverse) {
     ::openmldb::common::StorageMode storage_mode = GetParam();
     TabletImpl tablet;
@@ -1497,6 +1545,80 @@ TEST_P(TabletImplTest, Traverse) {
     ASSERT_FALSE(kv_it.Valid());
 }
 
+TEST_P(TabletImplTest, MultiKeyTraverse) {
+    ::openmldb::common::StorageMode storage_mode = GetParam();
+    TabletImpl tablet;
+    uint32_t id = counter++;
+    tablet.Init("");
+    ASSERT_EQ(0, CreateDefaultTable("db0", "t0", id, 1, 0, 0, kAbsoluteTime, storage_mode, &tablet));
+    MockClosure closure;
+    for (const std::string key : {"key1", "key2", "key3"}) {
+        for (int ts = 9527; ts < 9530; ts++) {
+            ::openmldb::api::PutRequest prequest;
+            PackDefaultDimension(key, &prequest);
+            prequest.set_time(ts);
+            prequest.set_value(::openmldb::test::EncodeKV(key, key + std::to_string(ts)));
+            prequest.set_tid(id);
+            prequest.set_pid(1);
+            ::openmldb::api::PutResponse presponse;
+            tablet.Put(NULL, &prequest, &presponse, &closure);
+            ASSERT_EQ(0, presponse.code());
+        }
+    }
+    ::openmldb::api::MultiKeyTraverseRequest sr;
+    sr.set_tid(id);
+    sr.set_pid(1);
+    sr.add_pk("key2");
+    sr.add_pk("key_not_exist");
+    sr.add_pk("key1");
+    sr.set_limit(100);
+    auto srp = std::make_shared<::openmldb::api::MultiKeyTraverseResponse>();
+    tablet.MultiKeyTraverse(NULL, &sr, srp.get(), &closure);
+    ASSERT_EQ(0, srp->code());
+    ASSERT_EQ(3, srp->windows_size());
+    ASSERT_EQ(0, (signed)srp->windows(1).count());
+    ASSERT_TRUE(srp->windows(1).is_finish());
+    for (int idx : {0, 2}) {
+        auto window = std::shared_ptr<::openmldb::api::TraverseResponse>(srp, srp->mutable_windows(idx));
+        ASSERT_EQ(3, (signed)window->count());
+        ASSERT_TRUE(window->is_finish());
+        ::openmldb::base::TraverseKvIterator kv_it(window);
+        for (int cnt = 0; cnt < 3; cnt++) {
+            uint64_t cur_ts = 9529 - cnt;
+            ASSERT_TRUE(kv_it.Valid());
+            ASSERT_EQ(sr.pk(idx), kv_it.GetPK());
+            ASSERT_EQ(cur_ts, kv_it.GetKey());
+            ASSERT_EQ(sr.pk(idx) + std::to_string(cur_ts), ::openmldb::test::DecodeV(kv_it.GetValue().ToString()));
+            kv_it.Next();
+        }
+        ASSERT_FALSE(kv_it.Valid());
+    }
+    // the window is not complete, it can be continued by Traverse
+    sr.set_limit(2);
+    tablet.MultiKeyTraverse(NULL, &sr, srp.get(), &closure);
+    ASSERT_EQ(0, srp->code());
+    ASSERT_EQ(3, srp->windows_size());
+    const auto& window = srp->windows(0);
+    ASSERT_EQ(2, (signed)window.count());
+    ASSERT_FALSE(window.is_finish());
+    ASSERT_EQ("key2", window.pk());
+    ASSERT_EQ(9528, (signed)window.ts());
+    ::openmldb::api::TraverseRequest tr;
+    tr.set_tid(id);
+    tr.set_pid(1);
+    tr.set_limit(100);
+    tr.set_pk(window.pk());
+    tr.set_ts(window.ts());
+    tr.set_ts_pos(window.ts_pos());
+    auto trp = std::make_shared<::openmldb::api::TraverseResponse>();
+    tablet.Traverse(NULL, &tr, trp.get(), &closure);
+    ASSERT_EQ(0, trp->code());
+    ::openmldb::base::TraverseKvIterator kv_it(trp);
+    ASSERT_TRUE(kv_it.Valid());
+    ASSERT_EQ("key2", kv_it.GetPK());
+    ASSERT_EQ(9527, (signed)kv_it.GetKey());
+}
+
 TEST_P(TabletImplTest, TraverseTTL) {
     ::openmldb::common::StorageMode storage_mode = GetParam();
     // disktable and memtable behave inconsistently with max_traverse_cnt
@@ -5372,6 +5494,60 @@ TEST_P(TabletImplTest, PutCompress) {
     }
 }
 
+TEST_F(TabletImplTest, SubscribeBinlogCompress) {
+    TabletImpl tablet;
+    tablet.Init("");
+    MockClosure closure;
+    uint32_t id = counter++;
+    {
+        ::openmldb::api::CreateTableRequest request;
+        ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+        table_meta->set_name("t0");
+        table_meta->set_tid(id);
+        table_meta->set_pid(0);
+        table_meta->set_mode(::openmldb::api::TableMode::kTableLeader);
+        table_meta->set_compress_type(::openmldb::type::CompressType::kSnappy);
+        AddDefaultSchema(0, 0, ::openmldb::type::TTLType::kAbsoluteTime, table_meta);
+        ::openmldb::api::CreateTableResponse response;
+        tablet.CreateTable(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    ::openmldb::api::SubscribeBinlogRequest request;
+    request.set_tid(id);
+    request.set_pid(0);
+    request.set_subscriber("collector");
+    request.set_offset(1);
+    {
+        // the tail is kept from the first subscription
+        ::openmldb::api::SubscribeBinlogResponse response;
+        tablet.SubscribeBinlog(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        ASSERT_EQ(0, response.entries_size());
+    }
+    PrepareLatestTableData(tablet, id, 0);
+    auto filter = request.add_filter();
+    filter->set_col_idx(1);
+    filter->set_op(::openmldb::common::kCmpEq);
+    filter->set_value("5");
+    request.add_projection(1);
+    ::openmldb::api::SubscribeBinlogResponse response;
+    tablet.SubscribeBinlog(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    ASSERT_EQ(201u, response.next_offset());
+    // the rows of value 5 under the keys 5 and 10
+    ASSERT_EQ(2, response.entries_size());
+    Schema schema;
+    SchemaCodec::SetColumnDesc(schema.Add(), "value", ::openmldb::type::kString);
+    for (const auto& entry : response.entries()) {
+        std::string raw;
+        ASSERT_TRUE(::snappy::Uncompress(entry.value().data(), entry.value().size(), &raw));
+        codec::RowView row_view(schema, reinterpret_cast<const int8_t*>(raw.data()), raw.size());
+        std::string value;
+        ASSERT_EQ(0, row_view.GetStrValue(0, &value));
+        ASSERT_EQ("5", value);
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(TabletMemAndHDD, TabletImplTest,
                          ::testing::Values(::openmldb::common::kMemory, /*::openmldb::common::kSSD,*/
                                            ::openmldb::common::kHDD));
@@ -6280,6 +6456,33 @@ std::vector<DeleteParm> delete_cases = {
 
 INSTANTIATE_TEST_SUITE_P(AggregatorTest, AggregatorDeleteTest, testing::ValuesIn(delete_cases));
 
+TEST_F(TabletImplTest, PutIndexEntries) {
+    uint32_t id = counter++;
+    TabletImpl tablet;
+    tablet.Init("");
+    ASSERT_EQ(0, CreateDefaultTable("db0", "t0", id, 1, 0, 0, ::openmldb::type::kAbsoluteTime,
+                                    ::openmldb::common::StorageMode::kMemory, &tablet));
+    auto put_entries = [&tablet, id](uint32_t idx) {
+        ::openmldb::api::PutIndexEntriesRequest request;
+        request.set_tid(id);
+        request.set_pid(1);
+        auto entry = request.add_entries();
+        entry->set_ts(9527);
+        entry->set_value(::openmldb::test::EncodeKV("test1", "value1"));
+        auto dim = entry->add_dimensions();
+        dim->set_key("test1");
+        dim->set_idx(idx);
+        ::openmldb::api::GeneralResponse response;
+        MockClosure closure;
+        tablet.PutIndexEntries(NULL, &request, &response, &closure);
+        return response.code();
+    };
+    ASSERT_EQ(0, put_entries(0));
+    // the entry put already is skipped
+    ASSERT_EQ(0, put_entries(0));
+    ASSERT_EQ(::openmldb::base::ReturnCode::kPutFailed, put_entries(10));
+}
+
 TEST_F(TabletImplTest, DeleteRange) {
     uint32_t id = counter++;
     MockClosure closure;
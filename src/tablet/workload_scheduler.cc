@@ -0,0 +1,169 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/workload_scheduler.h"
+
+#include <mutex>  // NOLINT
+
+#include "absl/strings/str_cat.h"
+#include "common/timer.h"
+
+namespace openmldb {
+namespace tablet {
+
+WorkloadScheduler::WorkloadScheduler(uint32_t max_concurrency,
+                                     const std::array<WorkloadClassOptions, kWorkloadClassCnt>& options,
+                                     const std::string& metric_prefix)
+    : max_concurrency_(max_concurrency), options_(options) {
+    for (uint32_t i = 0; i < kWorkloadClassCnt; i++) {
+        metrics_[i] = std::make_unique<ClassMetrics>();
+        if (metric_prefix.empty()) {
+            continue;
+        }
+        std::string prefix = absl::StrCat(metric_prefix, "_", GetClassName(static_cast<WorkloadClass>(i)));
+        metrics_[i]->queue.expose(absl::StrCat(prefix, "_queue"));
+        metrics_[i]->latency.expose(absl::StrCat(prefix, "_latency"));
+        metrics_[i]->running.expose(absl::StrCat(prefix, "_running"));
+        metrics_[i]->waiting.expose(absl::StrCat(prefix, "_waiting"));
+        metrics_[i]->rejected.expose(absl::StrCat(prefix, "_rejected"));
+    }
+}
+
+const char* WorkloadScheduler::GetClassName(WorkloadClass cls) {
+    switch (cls) {
+        case WorkloadClass::kOnlineRequest:
+            return "online_request";
+        case WorkloadClass::kOnlineWrite:
+            return "online_write";
+        case WorkloadClass::kBatchQuery:
+            return "batch_query";
+        case WorkloadClass::kBackground:
+            return "background";
+    }
+    return "unknown";
+}
+
+bool WorkloadScheduler::IsLimited(uint32_t cls) const {
+    return max_concurrency_ > 0 || options_[cls].max_concurrency > 0;
+}
+
+bool WorkloadScheduler::HasClassSlot(uint32_t cls) const {
+    return options_[cls].max_concurrency == 0 || running_[cls] < options_[cls].max_concurrency;
+}
+
+bool WorkloadScheduler::CanRun(uint32_t cls) const {
+    if (!HasClassSlot(cls)) {
+        return false;
+    }
+    if (max_concurrency_ == 0) {
+        return true;
+    }
+    if (total_running_ >= max_concurrency_) {
+        return false;
+    }
+    // leave the free slots of the tablet to the waiting tasks of the higher classes which can take them
+    uint32_t higher_waiting = 0;
+    for (uint32_t i = 0; i < cls; i++) {
+        if (HasClassSlot(i)) {
+            higher_waiting += waiting_[i];
+        }
+    }
+    return higher_waiting < max_concurrency_ - total_running_;
+}
+
+base::Status WorkloadScheduler::Acquire(WorkloadClass cls) {
+    uint32_t idx = static_cast<uint32_t>(cls);
+    ClassMetrics* metrics = metrics_[idx].get();
+    if (!IsLimited(idx)) {
+        metrics->queue << 0;
+        metrics->running << 1;
+        return {};
+    }
+    uint64_t start_us = ::baidu::common::timer::get_micros();
+    uint64_t max_queue_us = options_[idx].max_queue_us;
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    if (!CanRun(idx)) {
+        waiting_[idx]++;
+        metrics->waiting << 1;
+        while (!CanRun(idx)) {
+            if (max_queue_us == 0) {
+                cv_.wait(lock);
+                continue;
+            }
+            uint64_t waited_us = ::baidu::common::timer::get_micros() - start_us;
+            if (waited_us >= max_queue_us) {
+                waiting_[idx]--;
+                metrics->waiting << -1;
+                metrics->rejected << 1;
+                // the lower classes may run now that the task does not wait
+                cv_.notify_all();
+                return {base::ReturnCode::kServerOverloaded,
+                        absl::StrCat("server is overloaded, ", GetClassName(cls), " waits for ", waited_us, "us")};
+            }
+            cv_.wait_for(lock, max_queue_us - waited_us);
+        }
+        waiting_[idx]--;
+        metrics->waiting << -1;
+    }
+    running_[idx]++;
+    total_running_++;
+    lock.unlock();
+    metrics->queue << ::baidu::common::timer::get_micros() - start_us;
+    metrics->running << 1;
+    return {};
+}
+
+void WorkloadScheduler::Release(WorkloadClass cls, uint64_t run_us) {
+    uint32_t idx = static_cast<uint32_t>(cls);
+    metrics_[idx]->latency << run_us;
+    metrics_[idx]->running << -1;
+    if (!IsLimited(idx)) {
+        return;
+    }
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    running_[idx]--;
+    total_running_--;
+    // a slot of the class or of the tablet is free, the waiters of all the classes check it
+    cv_.notify_all();
+}
+
+uint32_t WorkloadScheduler::GetRunning(WorkloadClass cls) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    return running_[static_cast<uint32_t>(cls)];
+}
+
+uint32_t WorkloadScheduler::GetWaiting(WorkloadClass cls) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    return waiting_[static_cast<uint32_t>(cls)];
+}
+
+WorkloadPermit::WorkloadPermit(WorkloadScheduler* scheduler, WorkloadClass cls)
+    : scheduler_(scheduler), cls_(cls), status_(), start_us_(0) {
+    if (scheduler_ == nullptr) {
+        return;
+    }
+    status_ = scheduler_->Acquire(cls_);
+    start_us_ = ::baidu::common::timer::get_micros();
+}
+
+WorkloadPermit::~WorkloadPermit() {
+    if (scheduler_ != nullptr && status_.OK()) {
+        scheduler_->Release(cls_, ::baidu::common::timer::get_micros() - start_us_);
+    }
+}
+
+}  // namespace tablet
+}  // namespace openmldb
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_WORKLOAD_SCHEDULER_H_
+#define SRC_TABLET_WORKLOAD_SCHEDULER_H_
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "base/status.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "bvar/bvar.h"
+
+namespace openmldb {
+namespace tablet {
+
+// the classes in the order of priority
+enum class WorkloadClass : uint32_t {
+    // request mode queries, the feature serving
+    kOnlineRequest = 0,
+    kOnlineWrite = 1,
+    // batch mode queries, scans and traverses
+    kBatchQuery = 2,
+    // snapshot making and sending, table and index loading
+    kBackground = 3,
+};
+
+constexpr uint32_t kWorkloadClassCnt = 4;
+
+struct WorkloadClassOptions {
+    // the tasks of the class running at the same time, 0 is unlimited
+    uint32_t max_concurrency = 0;
+    // the longest time a task waits for a slot before it's rejected, 0 waits until a slot is free
+    uint64_t max_queue_us = 0;
+};
+
+// Admission control of the rpcs and the background tasks of the tablet. A task takes a slot of its class and one of
+// the tablet before it runs, and it waits in the queue of its class if there is none. The free slots of the tablet
+// go to the waiting tasks of the higher classes first, so when the tablet is busy the lower classes wait longer and
+// are shed first as their waits time out.
+//
+// The waits block the bthread but not the brpc worker. If no limit applies to a class, the tasks of it only update
+// the metrics
+class WorkloadScheduler {
+ public:
+    // the metrics of the classes are exposed by bvar with the names `<metric_prefix>_<class>_*`, they are not exposed
+    // if metric_prefix is empty
+    WorkloadScheduler(uint32_t max_concurrency, const std::array<WorkloadClassOptions, kWorkloadClassCnt>& options,
+                      const std::string& metric_prefix);
+    WorkloadScheduler(const WorkloadScheduler&) = delete;
+    WorkloadScheduler& operator=(const WorkloadScheduler&) = delete;
+
+    // wait for a slot, the code is kServerOverloaded if none is free before the deadline of the class
+    base::Status Acquire(WorkloadClass cls);
+    // `run_us` is the time the task holds the slot
+    void Release(WorkloadClass cls, uint64_t run_us);
+
+    uint32_t GetRunning(WorkloadClass cls);
+    uint32_t GetWaiting(WorkloadClass cls);
+
+    static const char* GetClassName(WorkloadClass cls);
+
+ private:
+    struct ClassMetrics {
+        // the wait for a slot and the run of the tasks in us
+        bvar::LatencyRecorder queue;
+        bvar::LatencyRecorder latency;
+        bvar::Adder<int64_t> running;
+        bvar::Adder<int64_t> waiting;
+        bvar::Adder<int64_t> rejected;
+    };
+
+    bool IsLimited(uint32_t cls) const;
+    bool HasClassSlot(uint32_t cls) const;
+    // mu_ is held
+    bool CanRun(uint32_t cls) const;
+
+ private:
+    uint32_t max_concurrency_;
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> options_;
+    bthread::Mutex mu_;
+    bthread::ConditionVariable cv_;
+    uint32_t total_running_ = 0;
+    std::array<uint32_t, kWorkloadClassCnt> running_ = {};
+    std::array<uint32_t, kWorkloadClassCnt> waiting_ = {};
+    std::array<std::unique_ptr<ClassMetrics>, kWorkloadClassCnt> metrics_;
+};
+
+// hold a slot of the scheduler in the scope. A null scheduler admits everything
+class WorkloadPermit {
+ public:
+    WorkloadPermit(WorkloadScheduler* scheduler, WorkloadClass cls);
+    ~WorkloadPermit();
+    WorkloadPermit(const WorkloadPermit&) = delete;
+    WorkloadPermit& operator=(const WorkloadPermit&) = delete;
+
+    const base::Status& GetStatus() const { return status_; }
+
+ private:
+    WorkloadScheduler* scheduler_;
+    WorkloadClass cls_;
+    base::Status status_;
+    uint64_t start_us_;
+};
+
+}  // namespace tablet
+}  // namespace openmldb
+
+#endif  // SRC_TABLET_WORKLOAD_SCHEDULER_H_
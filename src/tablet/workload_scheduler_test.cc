@@ -0,0 +1,133 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/workload_scheduler.h"
+
+#include <array>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "base/glog_wrapper.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class WorkloadSchedulerTest : public ::testing::Test {
+ public:
+    WorkloadSchedulerTest() {}
+    ~WorkloadSchedulerTest() {}
+};
+
+static void WaitUntilWaiting(WorkloadScheduler* scheduler, WorkloadClass cls, uint32_t cnt) {
+    while (scheduler->GetWaiting(cls) < cnt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST_F(WorkloadSchedulerTest, Unlimited) {
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> options;
+    WorkloadScheduler scheduler(0, options, "");
+    std::vector<std::unique_ptr<WorkloadPermit>> permits;
+    for (int i = 0; i < 100; i++) {
+        permits.emplace_back(std::make_unique<WorkloadPermit>(&scheduler, WorkloadClass::kBatchQuery));
+        ASSERT_TRUE(permits.back()->GetStatus().OK());
+    }
+    // the slots are not counted without a limit
+    ASSERT_EQ(0u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+    WorkloadPermit permit(nullptr, WorkloadClass::kOnlineRequest);
+    ASSERT_TRUE(permit.GetStatus().OK());
+}
+
+TEST_F(WorkloadSchedulerTest, ClassLimit) {
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> options;
+    options[static_cast<uint32_t>(WorkloadClass::kBatchQuery)].max_concurrency = 2;
+    WorkloadScheduler scheduler(0, options, "");
+    ASSERT_TRUE(scheduler.Acquire(WorkloadClass::kBatchQuery).OK());
+    ASSERT_TRUE(scheduler.Acquire(WorkloadClass::kBatchQuery).OK());
+    ASSERT_EQ(2u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+    // the other classes are not limited by the slots of the batch queries
+    {
+        WorkloadPermit permit(&scheduler, WorkloadClass::kOnlineRequest);
+        ASSERT_TRUE(permit.GetStatus().OK());
+    }
+    std::thread waiter([&scheduler]() {
+        WorkloadPermit permit(&scheduler, WorkloadClass::kBatchQuery);
+        ASSERT_TRUE(permit.GetStatus().OK());
+    });
+    WaitUntilWaiting(&scheduler, WorkloadClass::kBatchQuery, 1);
+    ASSERT_EQ(2u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+    scheduler.Release(WorkloadClass::kBatchQuery, 0);
+    waiter.join();
+    ASSERT_EQ(0u, scheduler.GetWaiting(WorkloadClass::kBatchQuery));
+    ASSERT_EQ(1u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+    scheduler.Release(WorkloadClass::kBatchQuery, 0);
+    ASSERT_EQ(0u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+}
+
+TEST_F(WorkloadSchedulerTest, Priority) {
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> options;
+    WorkloadScheduler scheduler(1, options, "");
+    ASSERT_TRUE(scheduler.Acquire(WorkloadClass::kBatchQuery).OK());
+    std::mutex mu;
+    std::vector<WorkloadClass> order;
+    auto run = [&](WorkloadClass cls) {
+        WorkloadPermit permit(&scheduler, cls);
+        ASSERT_TRUE(permit.GetStatus().OK());
+        std::lock_guard<std::mutex> lock(mu);
+        order.push_back(cls);
+    };
+    std::thread background(run, WorkloadClass::kBackground);
+    WaitUntilWaiting(&scheduler, WorkloadClass::kBackground, 1);
+    std::thread online(run, WorkloadClass::kOnlineRequest);
+    WaitUntilWaiting(&scheduler, WorkloadClass::kOnlineRequest, 1);
+    // the online request comes later but takes the free slot first
+    scheduler.Release(WorkloadClass::kBatchQuery, 0);
+    online.join();
+    background.join();
+    ASSERT_EQ(2u, order.size());
+    ASSERT_EQ(WorkloadClass::kOnlineRequest, order[0]);
+    ASSERT_EQ(WorkloadClass::kBackground, order[1]);
+}
+
+TEST_F(WorkloadSchedulerTest, Reject) {
+    std::array<WorkloadClassOptions, kWorkloadClassCnt> options;
+    options[static_cast<uint32_t>(WorkloadClass::kBatchQuery)].max_queue_us = 10000;
+    WorkloadScheduler scheduler(1, options, "");
+    {
+        WorkloadPermit permit(&scheduler, WorkloadClass::kOnlineWrite);
+        ASSERT_TRUE(permit.GetStatus().OK());
+        WorkloadPermit rejected(&scheduler, WorkloadClass::kBatchQuery);
+        ASSERT_EQ(base::ReturnCode::kServerOverloaded, rejected.GetStatus().GetCode());
+        ASSERT_EQ(0u, scheduler.GetWaiting(WorkloadClass::kBatchQuery));
+    }
+    // the rejected permit does not hold a slot
+    ASSERT_EQ(0u, scheduler.GetRunning(WorkloadClass::kBatchQuery));
+    WorkloadPermit permit(&scheduler, WorkloadClass::kBatchQuery);
+    ASSERT_TRUE(permit.GetStatus().OK());
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}